@@ -95,6 +95,14 @@ AC_CHECK_DECLS([ethtool_cmd_speed, SPEED_UNKNOWN], [], [],
                [#include <linux/ethtool.h>])
 
 
+#
+# Zero-copy socket send (MSG_ZEROCOPY)
+#
+AC_CHECK_DECLS([SO_ZEROCOPY, MSG_ZEROCOPY, SO_EE_ORIGIN_ZEROCOPY], [], [],
+               [#include <sys/socket.h>
+#include <linux/errqueue.h>])
+
+
 #
 # PowerPC query for TB frequency
 #
@@ -266,6 +266,9 @@ static void print_iface_info(uct_worker_h worker, uct_md_h md,
 
         printf("#      device priority: %d\n", iface_attr.priority);
         printf("#     device num paths: %d\n", iface_attr.dev_num_paths);
+        if (iface_attr.numa_node >= 0) {
+            printf("#            numa node: %d\n", iface_attr.numa_node);
+        }
         printf("#              max eps: %s\n",
                ucs_memunits_to_str(iface_attr.max_num_eps, max_eps_str,
                                    sizeof(max_eps_str)));
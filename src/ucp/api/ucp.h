@@ -164,8 +164,10 @@ enum ucp_worker_params_field {
     UCP_WORKER_PARAM_FIELD_CPU_MASK     = UCS_BIT(1), /**< Worker's CPU bitmap */
     UCP_WORKER_PARAM_FIELD_EVENTS       = UCS_BIT(2), /**< Worker's events bitmap */
     UCP_WORKER_PARAM_FIELD_USER_DATA    = UCS_BIT(3), /**< User data */
-    UCP_WORKER_PARAM_FIELD_EVENT_FD     = UCS_BIT(4)  /**< External event file
+    UCP_WORKER_PARAM_FIELD_EVENT_FD     = UCS_BIT(4), /**< External event file
                                                            descriptor */
+    UCP_WORKER_PARAM_FIELD_TAG_SHARD_MASK = UCS_BIT(5) /**< Tag matching
+                                                            shard mask */
 };
 
 
@@ -450,7 +452,13 @@ enum ucp_send_am_flags {
  * no longer needed.
  */
 enum ucp_cb_param_flags {
-    UCP_CB_PARAM_FLAG_DATA = UCS_BIT(0)
+    UCP_CB_PARAM_FLAG_DATA  = UCS_BIT(0),
+    UCP_CB_PARAM_FLAG_ERROR = UCS_BIT(1)  /**< The data could not be received
+                                               into the buffer returned by
+                                               @ref ucp_am_recv_data_callback_t,
+                                               and its contents are undefined.
+                                               The buffer is passed to the
+                                               callback so it can be released. */
 };
 
 
@@ -926,6 +934,29 @@ typedef struct ucp_worker_params {
      */
     int                     event_fd;
 
+    /**
+     * Mask of tag bits which partition the tag space of the worker into
+     * independent matching shards, for example the bits which identify a
+     * communicator. Tags which have the same value of these bits belong to
+     * the same shard. This value is optional.
+     * If it's not set (along with its corresponding bit in the field_mask -
+     * UCP_WORKER_PARAM_FIELD_TAG_SHARD_MASK), or set to 0, all tags are
+     * matched in a single shard.
+     *
+     * On a worker created with @ref UCS_THREAD_MODE_MULTI, each shard has its
+     * own lock, so receives of different shards can be matched by different
+     * threads at the same time. Therefore, a receive request may be completed
+     * by another thread before @ref ucp_tag_recv_nb returns.
+     *
+     * @note The tag_mask of every receive and probe operation on this worker
+     *       must include all bits of this mask, otherwise the operation fails
+     *       with @ref UCS_ERR_INVALID_PARAM.
+     * @note The number of shards is set by UCX_TM_SHARDS environment
+     *       variable. Tag matching offload is not used when there is more
+     *       than one shard.
+     */
+    ucp_tag_t               tag_shard_mask;
+
 } ucp_worker_params_t;
 
 
@@ -1050,6 +1081,43 @@ typedef struct ucp_stream_poll_ep {
 } ucp_stream_poll_ep_t;
 
 
+/**
+ * @ingroup UCP_WORKER
+ * @brief Output parameter of @ref ucp_stream_worker_poll_data function.
+ *
+ * The structure defines a block of received stream data and the endpoint it
+ * was received on.
+ */
+typedef struct ucp_stream_poll_data {
+    /**
+     * Endpoint handle.
+     */
+    ucp_ep_h    ep;
+
+    /**
+     * User data associated with an endpoint passed in
+     * @ref ucp_ep_params_t::user_data.
+     */
+    void        *user_data;
+
+    /**
+     * Pointer to the received data. It has to be released by
+     * @ref ucp_stream_data_release or @ref ucp_stream_data_release_bulk.
+     */
+    void        *data;
+
+    /**
+     * Length of the received data in bytes.
+     */
+    size_t      length;
+
+    /**
+     * Reserved for future use.
+     */
+    unsigned    flags;
+} ucp_stream_poll_data_t;
+
+
 /**
  * @ingroup UCP_MEM
  * @brief Tuning parameters for the UCP memory mapping.
@@ -1401,6 +1469,22 @@ ucs_status_t ucp_worker_query(ucp_worker_h worker,
 void ucp_worker_print_info(ucp_worker_h worker, FILE *stream);
 
 
+/**
+ * @ingroup UCP_WORKER
+ * @brief Release idle memory of the worker.
+ *
+ * This routine releases the memory of the worker's internal pools (requests,
+ * remote keys, bounce and fragment buffers) which is not used by any
+ * outstanding operation. The pools grow on demand, so a burst of outstanding
+ * operations leaves the memory allocated after the burst is over; the
+ * application may call this routine when it expects the worker to be idle for
+ * a while, or periodically.
+ *
+ * @param [in] worker       Worker object whose memory to release.
+ */
+void ucp_worker_release_idle_memory(ucp_worker_h worker);
+
+
 /**
  * @ingroup UCP_WORKER
  * @brief Get the address of the worker object.
@@ -1491,6 +1575,37 @@ ssize_t ucp_stream_worker_poll(ucp_worker_h worker,
                                unsigned flags);
 
 
+/**
+ * @ingroup UCP_WORKER
+ * @brief Poll for streaming data received on all endpoints of a worker.
+ *
+ * This non-blocking routine returns blocks of streaming data which were
+ * received on the endpoints of a worker, as with @ref ucp_stream_recv_data_nb,
+ * for many endpoints in a single call. The data of every endpoint is returned
+ * in the order it was received, and all the data of an endpoint is returned
+ * before the data of the next ready endpoint.
+ *
+ * @param [in]   worker     Worker to poll.
+ * @param [out]  poll_data  Pointer to array of data blocks, should be
+ *                          allocated by user.
+ * @param [in]   max_data   Maximal number of data blocks which should be
+ *                          filled in @a poll_data.
+ * @param [in]   flags      Reserved for future use.
+ *
+ * @return Negative value indicates an error according to @ref ucs_status_t.
+ *         On success, non-negative value (less or equal @a max_data) indicates
+ *         actual number of data blocks filled in @a poll_data array. The
+ *         application is responsible for releasing the data by calling
+ *         @ref ucp_stream_data_release_bulk or @ref ucp_stream_data_release.
+ *
+ * @note The data of an endpoint can't be received both by this routine and
+ *       by @ref ucp_stream_recv_nb at the same time.
+ */
+ssize_t ucp_stream_worker_poll_data(ucp_worker_h worker,
+                                    ucp_stream_poll_data_t *poll_data,
+                                    size_t max_data, unsigned flags);
+
+
 /**
  * @ingroup UCP_WAKEUP
  * @brief Obtain an event file descriptor for event notification.
@@ -2261,6 +2376,30 @@ ucs_status_t ucp_worker_set_am_handler(ucp_worker_h worker, uint16_t id,
                                        uint32_t flags);
 
 
+/**
+ * @ingroup UCP_WORKER
+ * @brief Add user defined callback to place Active Message data.
+ *
+ * This routine installs a user defined callback which selects a receive
+ * buffer for incoming Active Messages with a specific id, which are too large
+ * to be delivered in a single transport packet. This allows receiving the
+ * data directly into user memory without an intermediate copy.
+ *
+ * @param [in]  worker      UCP worker on which to set the callback.
+ * @param [in]  id          Active Message id. The Active Message handler for
+ *                          this id must be set by
+ *                          @ref ucp_worker_set_am_handler, which also clears
+ *                          the previously set data callback.
+ * @param [in]  cb          Data placement callback. NULL to clear.
+ *
+ * @return error code if the worker does not support Active Messages or
+ *         there is no Active Message handler for this id.
+ */
+ucs_status_t ucp_worker_set_am_recv_data_handler(ucp_worker_h worker,
+                                                 uint16_t id,
+                                                 ucp_am_recv_data_callback_t cb);
+
+
 /**
  * @ingroup UCP_COMM
  * @brief Send Active Message.
@@ -3071,6 +3210,25 @@ void ucp_request_cancel(ucp_worker_h worker, void *request);
 void ucp_stream_data_release(ucp_ep_h ep, void *data);
 
 
+/**
+ * @ingroup UCP_COMM
+ * @brief Release many UCP data buffers returned by
+ *        @ref ucp_stream_worker_poll_data.
+ *
+ * @param [in]  worker     Worker the data was received on.
+ * @param [in]  poll_data  Array of data blocks to release, which were returned
+ *                         from @ref ucp_stream_worker_poll_data.
+ * @param [in]  count      Number of data blocks in @a poll_data.
+ *
+ * This routine releases internal UCP data buffers, as
+ * @ref ucp_stream_data_release does for every one of them. The application
+ * can't use these buffers after calling this function.
+ */
+void ucp_stream_data_release_bulk(ucp_worker_h worker,
+                                  const ucp_stream_poll_data_t *poll_data,
+                                  size_t count);
+
+
 /**
  * @ingroup UCP_COMM
  * @brief Release a communications request.
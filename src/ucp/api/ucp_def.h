@@ -506,6 +506,48 @@ typedef ucs_status_t (*ucp_am_callback_t)(void *arg, void *data, size_t length,
                                           ucp_ep_h reply_ep, unsigned flags);
 
 
+/**
+ * @ingroup UCP_ENDPOINT
+ * @brief Callback to select a receive buffer for incoming Active Message.
+ *
+ * This callback is invoked when the first part of an Active Message, which
+ * does not fit into a single transport packet, arrives. It allows the user to
+ * provide a receive buffer, so the data is placed directly into it, instead of
+ * being assembled in a buffer allocated by UCP. When the whole message is
+ * received, the @ref ucp_am_callback_t "Active Message callback" is invoked
+ * with @a data set to the buffer returned by this callback, and without the
+ * UCP_CB_PARAM_FLAG_DATA flag. If the data could not be received, the
+ * callback is invoked with the UCP_CB_PARAM_FLAG_ERROR flag.
+ *
+ * @param [in]  arg        User-defined argument, which was passed to
+ *                         @ref ucp_worker_set_am_handler.
+ * @param [in]  length     Total length of the Active Message data.
+ * @param [in]  reply_ep   If the Active Message is sent with the
+ *                         UCP_AM_SEND_REPLY flag, the sending ep
+ *                         will be passed in. If not, NULL will be passed.
+ * @param [out] buffer_p   Filled with the receive buffer. For the IOV
+ *                         datatype, it points to an array of
+ *                         @ref ucp_dt_iov_t structures.
+ * @param [out] count_p    Filled with the number of elements in the
+ *                         receive buffer.
+ * @param [out] datatype_p Filled with the datatype descriptor for the
+ *                         elements in the receive buffer.
+ *
+ * @return UCS_OK          The data will be placed into the returned buffer,
+ *                         which must be able to hold @a length bytes.
+ * @return Error code      The data will be received into a buffer allocated
+ *                         by UCP, as if this callback was not set.
+ *
+ * @note This callback should be set by
+ *       @ref ucp_worker_set_am_recv_data_handler function.
+ */
+typedef ucs_status_t (*ucp_am_recv_data_callback_t)(void *arg, size_t length,
+                                                    ucp_ep_h reply_ep,
+                                                    void **buffer_p,
+                                                    size_t *count_p,
+                                                    ucp_datatype_t *datatype_p);
+
+
 /**
  * @ingroup UCP_ENDPOINT
  * @brief Tuning parameters for the UCP endpoint.
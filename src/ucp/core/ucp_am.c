@@ -17,28 +17,155 @@
 #include <ucp/core/ucp_worker.h>
 #include <ucp/core/ucp_context.h>
 #include <ucp/proto/proto_am.inl>
+#include <ucp/tag/rndv.h>
 #include <ucp/dt/dt.h>
 #include <ucp/dt/dt.inl>
 
 
-void ucp_am_ep_init(ucp_ep_h ep)
+static ucs_mpool_ops_t ucp_am_reasm_mpool_ops = {
+    .chunk_alloc   = ucs_mpool_chunk_malloc,
+    .chunk_release = ucs_mpool_chunk_free,
+    .obj_init      = NULL,
+    .obj_cleanup   = NULL
+};
+
+static UCS_F_ALWAYS_INLINE unsigned ucp_am_reasm_mp_index(size_t length)
 {
-    ucp_ep_ext_proto_t *ep_ext = ucp_ep_ext_proto(ep);
-    
-    if (ep->worker->context->config.features & UCP_FEATURE_AM) {
-        ucs_list_head_init(&ep_ext->am.started_ams);
+    if (length <= UCS_BIT(UCP_AM_REASM_MP_MIN_SHIFT)) {
+        return 0;
+    }
+
+    return ucs_ilog2(length - 1) + 1 - UCP_AM_REASM_MP_MIN_SHIFT;
+}
+
+static ucp_recv_desc_t *
+ucp_am_reasm_buf_get(ucp_worker_h worker, size_t length)
+{
+    ucp_recv_desc_t *desc;
+
+    if (length <= UCS_BIT(UCP_AM_REASM_MP_MAX_SHIFT)) {
+        desc = ucs_mpool_get_inline(
+                    &worker->am_reasm_mps[ucp_am_reasm_mp_index(length)]);
+        if (ucs_likely(desc != NULL)) {
+            UCP_WORKER_STAT_AM_REASM(worker, BUF_POOL);
+            desc->flags = 0;
+            return desc;
+        }
+    }
+
+    /* Too large for the size classes, or the pool reached its limit */
+    desc = ucs_malloc(length + sizeof(ucp_recv_desc_t),
+                      "ucp recv desc for long AM");
+    if (ucs_unlikely(desc == NULL)) {
+        return NULL;
+    }
+
+    UCP_WORKER_STAT_AM_REASM(worker, BUF_MALLOC);
+    desc->flags = UCP_RECV_DESC_FLAG_MALLOC;
+    return desc;
+}
+
+static void ucp_am_reasm_buf_release(ucp_recv_desc_t *desc)
+{
+    if (desc->flags & UCP_RECV_DESC_FLAG_MALLOC) {
+        ucs_free(desc);
+    } else {
+        ucs_mpool_put_inline(desc);
+    }
+}
+
+static void ucp_am_unfinished_release(ucp_am_unfinished_t *unfinished)
+{
+    if (unfinished->req != NULL) {
+        /* a failed unpack has already finished the generic datatype state */
+        if (unfinished->req->status == UCS_OK) {
+            ucp_request_recv_generic_dt_finish(unfinished->req);
+        }
+        ucp_request_put(unfinished->req);
+    } else {
+        ucp_am_reasm_buf_release(unfinished->all_data);
+    }
+}
+
+ucs_status_t ucp_am_worker_init(ucp_worker_h worker)
+{
+    ucs_status_t status;
+    unsigned i, shift;
+
+    if (!(worker->context->config.features & UCP_FEATURE_AM)) {
+        return UCS_OK;
+    }
+
+    kh_init_inplace(ucp_am_unfinished_hash, &worker->am_unfinished_hash);
+
+    for (i = 0; i < UCP_AM_REASM_MP_COUNT; ++i) {
+        shift  = UCP_AM_REASM_MP_MIN_SHIFT + i;
+        status = ucs_mpool_init(&worker->am_reasm_mps[i], 0,
+                                sizeof(ucp_recv_desc_t) + UCS_BIT(shift), 0,
+                                UCS_SYS_CACHE_LINE_SIZE,
+                                ucs_max(UCP_AM_REASM_MP_CHUNK_SIZE >> shift, 1),
+                                ucs_max(UCP_AM_REASM_MP_MAX_SIZE >> shift, 1),
+                                &ucp_am_reasm_mpool_ops, "ucp_am_reasm_bufs");
+        if (status != UCS_OK) {
+            goto err_cleanup_mpools;
+        }
+    }
+
+    return UCS_OK;
+
+err_cleanup_mpools:
+    while (i-- > 0) {
+        ucs_mpool_cleanup(&worker->am_reasm_mps[i], 0);
+    }
+    kh_destroy_inplace(ucp_am_unfinished_hash, &worker->am_unfinished_hash);
+    return status;
+}
+
+void ucp_am_worker_cleanup(ucp_worker_h worker)
+{
+    ucp_am_unfinished_t unfinished;
+    unsigned i;
+
+    if (!(worker->context->config.features & UCP_FEATURE_AM)) {
+        return;
+    }
+
+    kh_foreach_value(&worker->am_unfinished_hash, unfinished, {
+        ucp_am_unfinished_release(&unfinished);
+    });
+    kh_destroy_inplace(ucp_am_unfinished_hash, &worker->am_unfinished_hash);
+
+    for (i = 0; i < UCP_AM_REASM_MP_COUNT; ++i) {
+        ucs_mpool_cleanup(&worker->am_reasm_mps[i], 1);
     }
 }
 
 void ucp_am_ep_cleanup(ucp_ep_h ep)
 {
-    ucp_ep_ext_proto_t *ep_ext = ucp_ep_ext_proto(ep);
+    ucp_worker_h worker = ep->worker;
+    unsigned count      = 0;
+    khiter_t iter;
+
+    if (!(worker->context->config.features & UCP_FEATURE_AM)) {
+        return;
+    }
 
-    if (ep->worker->context->config.features & UCP_FEATURE_AM) {
-        if (ucs_unlikely(!ucs_list_is_empty(&ep_ext->am.started_ams))) {
-            ucs_warn("worker : %p not all UCP active messages have been" 
-                     "run to completion", ep->worker);
+    for (iter = kh_begin(&worker->am_unfinished_hash);
+         iter != kh_end(&worker->am_unfinished_hash); ++iter) {
+        if (!kh_exist(&worker->am_unfinished_hash, iter) ||
+            (kh_key(&worker->am_unfinished_hash, iter).ep != (uintptr_t)ep)) {
+            continue;
         }
+
+        ucp_am_unfinished_release(&kh_value(&worker->am_unfinished_hash,
+                                            iter));
+        kh_del(ucp_am_unfinished_hash, &worker->am_unfinished_hash, iter);
+        ++count;
+    }
+
+    if (ucs_unlikely(count > 0)) {
+        ucs_warn("worker %p: %u UCP active messages on ep %p have not been "
+                 "run to completion", worker, count, ep);
     }
 }
 
@@ -88,12 +215,74 @@ UCS_PROFILE_FUNC(ucs_status_t, ucp_worker_set_am_handler,
     }
 
     worker->am_cbs[id].cb      = cb;
+    worker->am_cbs[id].data_cb = NULL;
     worker->am_cbs[id].context = arg;
     worker->am_cbs[id].flags   = flags;
 
     return UCS_OK;
 }
 
+UCS_PROFILE_FUNC(ucs_status_t, ucp_worker_set_am_recv_data_handler,
+                 (worker, id, cb),
+                 ucp_worker_h worker, uint16_t id,
+                 ucp_am_recv_data_callback_t cb)
+{
+    UCP_CONTEXT_CHECK_FEATURE_FLAGS(worker->context, UCP_FEATURE_AM,
+                                    return UCS_ERR_INVALID_PARAM);
+
+    if ((id >= worker->am_cb_array_len) || (worker->am_cbs[id].cb == NULL)) {
+        return UCS_ERR_INVALID_PARAM;
+    }
+
+    worker->am_cbs[id].data_cb = cb;
+    return UCS_OK;
+}
+
+/* Initialize the receive request with a buffer provided by the user, if there
+ * is a data placement callback for this id */
+static ucs_status_t
+ucp_am_recv_user_data_init(ucp_worker_h worker, ucp_request_t *req,
+                           uint16_t am_id, size_t length, ucp_ep_h reply_ep)
+{
+    ucp_worker_am_entry_t *am_cb = &worker->am_cbs[am_id];
+    ucp_datatype_t datatype;
+    ucs_status_t status;
+    void *buffer;
+    size_t count;
+
+    if (am_cb->data_cb == NULL) {
+        return UCS_ERR_UNSUPPORTED;
+    }
+
+    status = am_cb->data_cb(am_cb->context, length, reply_ep, &buffer, &count,
+                            &datatype);
+    if (status != UCS_OK) {
+        return status;
+    }
+
+    req->status        = UCS_OK;
+    req->recv.worker   = worker;
+    req->recv.buffer   = buffer;
+    req->recv.datatype = datatype;
+
+    ucp_dt_recv_state_init(&req->recv.state, buffer, datatype, count);
+
+    req->recv.length   = ucp_dt_length(datatype, count, buffer,
+                                       &req->recv.state);
+    req->recv.mem_type = ucp_memory_type_detect(worker->context, buffer,
+                                                req->recv.length);
+
+    if (ucs_unlikely(req->recv.length < length)) {
+        ucs_error("active message with id %u and length %zu does not fit "
+                  "user buffer of length %zu", am_id, length,
+                  req->recv.length);
+        ucp_request_recv_generic_dt_finish(req);
+        return UCS_ERR_MESSAGE_TRUNCATED;
+    }
+
+    return UCS_OK;
+}
+
 static size_t 
 ucp_am_bcopy_pack_args_single(void *dest, void *arg)
 {
@@ -351,6 +540,49 @@ static ucs_status_t ucp_am_zcopy_multi_reply(uct_pending_req_t *self)
                                  ucp_proto_am_zcopy_req_complete, 1);
 }
 
+static size_t ucp_am_rndv_rts_pack(void *dest, void *arg)
+{
+    ucp_rndv_rts_hdr_t *rndv_rts_hdr = dest;
+    ucp_request_t *sreq              = arg;
+    ucp_am_hdr_t am_hdr;
+    size_t packed_size;
+
+    packed_size = ucp_tag_rndv_rts_pack(dest, arg);
+
+    /* Active message header is passed instead of the tag. The length is
+     * carried by the RTS itself. */
+    am_hdr.am_hdr.am_id     = sreq->send.msg_proto.am.am_id;
+    am_hdr.am_hdr.length    = 0;
+    am_hdr.am_hdr.flags     = sreq->send.msg_proto.am.flags;
+    rndv_rts_hdr->super.tag = am_hdr.u64;
+
+    return packed_size;
+}
+
+static ucs_status_t ucp_am_progress_rndv_rts(uct_pending_req_t *self)
+{
+    ucp_request_t *sreq = ucs_container_of(self, ucp_request_t, send.uct);
+    size_t packed_rkey_size;
+
+    packed_rkey_size = ucp_ep_config(sreq->send.ep)->tag.rndv.rkey_size;
+    return ucp_do_am_single(self, UCP_AM_ID_RNDV_AM_RTS, ucp_am_rndv_rts_pack,
+                            sizeof(ucp_rndv_rts_hdr_t) + packed_rkey_size);
+}
+
+static ucs_status_t ucp_am_send_start_rndv(ucp_request_t *sreq)
+{
+    ucp_trace_req(sreq, "start am rndv to %s buffer %p length %zu",
+                  ucp_ep_peer_name(sreq->send.ep), sreq->send.buffer,
+                  sreq->send.length);
+    UCS_PROFILE_REQUEST_EVENT(sreq, "start_rndv", sreq->send.length);
+
+    /* The receiver replies with ATS/RTR, and the data is transferred by the
+     * tag-matching rendezvous protocol over the rma_bw lanes */
+    ucs_assert(sreq->send.lane == ucp_ep_get_am_lane(sreq->send.ep));
+    sreq->send.uct.func = ucp_am_progress_rndv_rts;
+    return ucp_tag_rndv_reg_send_buffer(sreq);
+}
+
 static void ucp_am_send_req_init(ucp_request_t *req, ucp_ep_h ep,
                                  const void *buffer, uintptr_t datatype,
                                  size_t count, uint16_t flags, 
@@ -377,17 +609,24 @@ ucp_am_send_req(ucp_request_t *req, size_t count,
                 ucp_send_callback_t cb, const ucp_request_send_proto_t *proto)
 {
     
+    size_t rndv_thresh  = ucp_ep_config(req->send.ep)->am_u.rndv_thresh;
     size_t zcopy_thresh = ucp_proto_get_zcopy_threshold(req, msg_config,
-                                                        count, SIZE_MAX);
+                                                        count, rndv_thresh);
     ssize_t max_short   = ucp_am_get_short_max(req, msg_config);
     ucs_status_t status;
     
     status = ucp_request_send_start(req, max_short, 
-                                    zcopy_thresh, SIZE_MAX,
+                                    zcopy_thresh, rndv_thresh,
                                     count, msg_config,
                                     proto);
     if (status != UCS_OK) {
-       return UCS_STATUS_PTR(status);
+        if (status == UCS_ERR_NO_PROGRESS) {
+            ucs_assert(req->send.length >= rndv_thresh);
+            status = ucp_am_send_start_rndv(req);
+        }
+        if (status != UCS_OK) {
+            return UCS_STATUS_PTR(status);
+        }
     }
 
     /* Start the request.
@@ -552,36 +791,35 @@ ucp_am_handler(void *am_arg, void *am_data, size_t am_length,
                                  am_flags);    
 }
 
-static ucp_am_unfinished_t *
-ucp_am_find_unfinished(ucp_worker_h worker, ucp_ep_h ep, 
-                       ucp_ep_ext_proto_t *ep_ext, 
-                       ucp_am_long_hdr_t *hdr, size_t am_length)
+static void
+ucp_am_unfinished_copy_data(ucp_am_unfinished_t *unfinished,
+                            ucp_am_long_hdr_t *long_hdr, size_t length)
 {
-    ucp_am_unfinished_t *unfinished;
-    /* TODO make this hash table for faster lookup */
-    ucs_list_for_each(unfinished, &ep_ext->am.started_ams, list) {
-        if (unfinished->msg_id == hdr->msg_id) {
-            return unfinished;
-        }
+    ucp_request_t *req = unfinished->req;
+
+    unfinished->left -= length;
+
+    if (req == NULL) {
+        memcpy(UCS_PTR_BYTE_OFFSET(unfinished->all_data + 1, long_hdr->offset),
+               long_hdr + 1, length);
+    } else if (ucs_likely(req->status == UCS_OK)) {
+        /* on failure, the generic datatype state is finished by the unpack,
+         * and the rest of the fragments are dropped */
+        req->status = ucp_request_recv_data_unpack(req, long_hdr + 1, length,
+                                                   long_hdr->offset,
+                                                   unfinished->left == 0);
     }
-    
-    return NULL;
 }
 
-static ucs_status_t
-ucp_am_handle_unfinished(ucp_worker_h worker,
-                         ucp_am_unfinished_t *unfinished, 
-                         ucp_am_long_hdr_t *long_hdr, 
-                         size_t am_length, ucp_ep_h reply_ep) 
+static void
+ucp_am_handle_unfinished(ucp_worker_h worker, ucp_am_unfinished_t *unfinished,
+                         ucp_am_long_hdr_t *long_hdr, ucp_ep_h reply_ep)
 {
-    uint16_t am_id;
+    uint16_t am_id     = long_hdr->am_id;
+    ucp_request_t *req = unfinished->req;
     ucs_status_t status;
 
-    memcpy(UCS_PTR_BYTE_OFFSET(unfinished->all_data + 1, long_hdr->offset),
-           long_hdr + 1, am_length - sizeof(*long_hdr));
-    unfinished->left -= am_length - sizeof(*long_hdr);
-    if (unfinished->left == 0) {
-        am_id = long_hdr->am_id;
+    if (req == NULL) {
         status = worker->am_cbs[am_id].cb(worker->am_cbs[am_id].context,
                                           unfinished->all_data + 1,
                                           long_hdr->total_size,
@@ -589,13 +827,55 @@ ucp_am_handle_unfinished(ucp_worker_h worker,
                                           UCP_CB_PARAM_FLAG_DATA);
 
         if (status != UCS_INPROGRESS) {
-            ucs_free(unfinished->all_data);
+            ucp_am_reasm_buf_release(unfinished->all_data);
+        }
+    } else {
+        if (ucs_unlikely(req->status != UCS_OK)) {
+            ucs_error("failed to unpack active message with id %u: %s",
+                      am_id, ucs_status_string(req->status));
+        }
+        worker->am_cbs[am_id].cb(worker->am_cbs[am_id].context,
+                                 req->recv.buffer, long_hdr->total_size,
+                                 reply_ep, (req->status == UCS_OK) ? 0 :
+                                           UCP_CB_PARAM_FLAG_ERROR);
+        ucp_request_put(req);
+    }
+}
+
+static ucs_status_t
+ucp_am_unfinished_init(ucp_worker_h worker, ucp_am_unfinished_t *unfinished,
+                       ucp_am_long_hdr_t *long_hdr, ucp_ep_h reply_ep)
+{
+    ucp_request_t *req;
+
+    /* If I am first, I get the buffer for everyone to go into - either from
+     * the user, or allocate it myself
+     */
+    unfinished->req      = NULL;
+    unfinished->all_data = NULL;
+    unfinished->left     = long_hdr->total_size;
+
+    /* Do not take a request if there is no data placement callback */
+    req = (worker->am_cbs[long_hdr->am_id].data_cb != NULL) ?
+          ucp_request_get(worker) : NULL;
+    if (req != NULL) {
+        if (ucp_am_recv_user_data_init(worker, req, long_hdr->am_id,
+                                       long_hdr->total_size,
+                                       reply_ep) == UCS_OK) {
+            req->flags      = UCP_REQUEST_FLAG_RECV |
+                              UCP_REQUEST_FLAG_RECV_AM_USER_DATA;
+            unfinished->req = req;
+            return UCS_OK;
         }
 
-        ucs_list_del(&unfinished->list);
-        ucs_free(unfinished);
+        ucp_request_put(req);
     }
-    
+
+    unfinished->all_data = ucp_am_reasm_buf_get(worker, long_hdr->total_size);
+    if (ucs_unlikely(unfinished->all_data == NULL)) {
+        return UCS_ERR_NO_MEMORY;
+    }
+
     return UCS_OK;
 }
 
@@ -605,12 +885,11 @@ ucp_am_long_handler_common(void *am_arg, void *am_data, size_t am_length,
 {
     ucp_worker_h worker         = (ucp_worker_h)am_arg;
     ucp_am_long_hdr_t *long_hdr = (ucp_am_long_hdr_t *)am_data;
-    ucp_ep_h ep                 = ucp_worker_get_ep_by_ptr(worker, 
-                                                           long_hdr->ep);
-    ucp_ep_ext_proto_t *ep_ext  = ucp_ep_ext_proto(ep);
-    ucp_recv_desc_t *all_data;
-    size_t left;
     ucp_am_unfinished_t *unfinished;
+    ucp_am_unfinished_key_t key;
+    ucs_status_t status;
+    khiter_t iter;
+    int ret;
 
     if (ucs_unlikely((long_hdr->am_id >= worker->am_cb_array_len) ||
                      (worker->am_cbs[long_hdr->am_id].cb == NULL))) {
@@ -619,49 +898,37 @@ ucp_am_long_handler_common(void *am_arg, void *am_data, size_t am_length,
         return UCS_OK;
     }
 
-    /* if there are multiple messages,
-     * we first check to see if any of the other messages
-     * have arrived. If any messages have arrived,
-     * we copy ourselves into the buffer and leave
-     */
-    unfinished = ucp_am_find_unfinished(worker, ep, ep_ext, long_hdr, am_length);
-    
-    if (unfinished) {
-        return ucp_am_handle_unfinished(worker, unfinished, 
-                                        long_hdr, am_length,
-                                        reply_ep);
-    }
-    
-    /* If I am first, I make the buffer for everyone to go into,
-     * copy myself in, and put myself on the list so people can find me
+    /* Find the message by the endpoint and message id. If this is the first
+     * arrived fragment, add a new entry to the hash so the rest of the
+     * fragments can find it.
      */
-    all_data = ucs_malloc(long_hdr->total_size + sizeof(ucp_recv_desc_t),
-                          "ucp recv desc for long AM");
-    if (ucs_unlikely(all_data == NULL)) {
+    key.ep     = long_hdr->ep;
+    key.msg_id = long_hdr->msg_id;
+    iter       = kh_put(ucp_am_unfinished_hash, &worker->am_unfinished_hash,
+                        key, &ret);
+    if (ucs_unlikely(ret < 0)) {
         return UCS_ERR_NO_MEMORY;
     }
 
-    all_data->flags = UCP_RECV_DESC_FLAG_MALLOC;
-
-    left = long_hdr->total_size - (am_length -
-                                   sizeof(ucp_am_long_hdr_t));
-    
-    memcpy(UCS_PTR_BYTE_OFFSET(all_data + 1, long_hdr->offset),
-           long_hdr + 1, am_length - sizeof(ucp_am_long_hdr_t));
-    
-    /* Can't use a desc for this because of the buffer */
-    unfinished           = ucs_malloc(sizeof(ucp_am_unfinished_t),
-                                         "unfinished UCP AM");
-    if (ucs_unlikely(unfinished == NULL)) {
-        ucs_free(all_data);
-        return UCS_ERR_NO_MEMORY;
+    unfinished = &kh_value(&worker->am_unfinished_hash, iter);
+    if (ret == 0) {
+        UCP_WORKER_STAT_AM_REASM(worker, HIT);
+    } else {
+        UCP_WORKER_STAT_AM_REASM(worker, MISS);
+        status = ucp_am_unfinished_init(worker, unfinished, long_hdr,
+                                        reply_ep);
+        if (ucs_unlikely(status != UCS_OK)) {
+            kh_del(ucp_am_unfinished_hash, &worker->am_unfinished_hash, iter);
+            return status;
+        }
     }
 
-    unfinished->all_data = all_data;
-    unfinished->left     = left;
-    unfinished->msg_id   = long_hdr->msg_id;
-
-    ucs_list_add_head(&ep_ext->am.started_ams, &unfinished->list);
+    ucp_am_unfinished_copy_data(unfinished, long_hdr,
+                                am_length - sizeof(ucp_am_long_hdr_t));
+    if (unfinished->left == 0) {
+        ucp_am_handle_unfinished(worker, unfinished, long_hdr, reply_ep);
+        kh_del(ucp_am_unfinished_hash, &worker->am_unfinished_hash, iter);
+    }
 
     return UCS_OK;
 }
@@ -687,6 +954,132 @@ ucp_am_long_handler(void *am_arg, void *am_data, size_t am_length,
                                       NULL); 
 }
 
+static void ucp_am_rndv_recv_completed(void *request, ucs_status_t status,
+                                       ucp_tag_recv_info_t *info)
+{
+    ucp_request_t *rreq   = (ucp_request_t*)request - 1;
+    ucp_worker_h worker   = rreq->recv.worker;
+    int is_user_data      = rreq->flags & UCP_REQUEST_FLAG_RECV_AM_USER_DATA;
+    ucp_recv_desc_t *desc = NULL;
+    ucp_am_hdr_t am_hdr;
+    uint16_t am_id;
+
+    if (rreq->recv.buffer == NULL) {
+        /* The message was dropped */
+        return;
+    }
+
+    if (!is_user_data) {
+        desc = (ucp_recv_desc_t*)rreq->recv.buffer - 1;
+    }
+
+    am_hdr.u64 = info->sender_tag;
+    am_id      = am_hdr.am_hdr.am_id;
+
+    if (ucs_unlikely((am_id >= worker->am_cb_array_len) ||
+                     (worker->am_cbs[am_id].cb == NULL))) {
+        ucs_warn("UCP Active Message was received with id : %u, but there"
+                 "is no registered callback for that id", am_id);
+        ucs_free(desc);
+        return;
+    }
+
+    if (ucs_unlikely(status != UCS_OK)) {
+        ucs_error("failed to receive active message with id %u: %s", am_id,
+                  ucs_status_string(status));
+        if (!is_user_data) {
+            ucs_free(desc);
+            return;
+        }
+    }
+
+    if (is_user_data) {
+        /* the user buffer is returned to the callback also on failure */
+        worker->am_cbs[am_id].cb(worker->am_cbs[am_id].context,
+                                 rreq->recv.buffer, info->length,
+                                 rreq->recv.tag.am_reply_ep,
+                                 (status == UCS_OK) ? 0 :
+                                 UCP_CB_PARAM_FLAG_ERROR);
+        return;
+    }
+
+    status = worker->am_cbs[am_id].cb(worker->am_cbs[am_id].context,
+                                      desc + 1, info->length,
+                                      rreq->recv.tag.am_reply_ep,
+                                      UCP_CB_PARAM_FLAG_DATA);
+    if (status != UCS_INPROGRESS) {
+        ucs_free(desc);
+    }
+}
+
+static ucs_status_t
+ucp_am_rndv_rts_handler(void *am_arg, void *am_data, size_t am_length,
+                        unsigned am_flags)
+{
+    ucp_worker_h worker              = am_arg;
+    ucp_rndv_rts_hdr_t *rndv_rts_hdr = am_data;
+    ucp_recv_desc_t *desc;
+    ucp_am_hdr_t am_hdr;
+    ucp_request_t *rreq;
+    ucp_ep_h reply_ep;
+    uint16_t am_id;
+
+    am_hdr.u64 = rndv_rts_hdr->super.tag;
+    am_id      = am_hdr.am_hdr.am_id;
+
+    rreq = ucp_request_get(worker);
+    if (ucs_unlikely(rreq == NULL)) {
+        ucs_error("failed to allocate active message rendezvous request");
+        return UCS_OK;
+    }
+
+    reply_ep = (am_hdr.am_hdr.flags & UCP_AM_SEND_REPLY) ?
+               ucp_worker_get_ep_by_ptr(worker, rndv_rts_hdr->sreq.ep_ptr) :
+               NULL;
+
+    rreq->flags                = UCP_REQUEST_FLAG_RECV |
+                                 UCP_REQUEST_FLAG_CALLBACK |
+                                 UCP_REQUEST_FLAG_RELEASED;
+    rreq->recv.tag.cb          = ucp_am_rndv_recv_completed;
+    rreq->recv.tag.am_reply_ep = reply_ep;
+
+    if (ucs_unlikely((am_id >= worker->am_cb_array_len) ||
+                     (worker->am_cbs[am_id].cb == NULL))) {
+        ucs_warn("UCP Active Message was received with id : %u, but there"
+                 "is no registered callback for that id", am_id);
+        desc = NULL;
+    } else if (ucp_am_recv_user_data_init(worker, rreq, am_id,
+                                          rndv_rts_hdr->size,
+                                          reply_ep) == UCS_OK) {
+        /* The data is fetched directly to the user buffer */
+        rreq->flags |= UCP_REQUEST_FLAG_RECV_AM_USER_DATA;
+        goto out;
+    } else {
+        desc = ucs_malloc(rndv_rts_hdr->size + sizeof(ucp_recv_desc_t),
+                          "ucp recv desc for rndv AM");
+        if (ucs_unlikely(desc == NULL)) {
+            ucs_error("worker %p could not allocate %zu bytes for active "
+                      "message on callback : %u", worker, rndv_rts_hdr->size,
+                      am_id);
+        } else {
+            desc->flags = UCP_RECV_DESC_FLAG_MALLOC;
+        }
+    }
+
+    /* If there is no receive buffer, the rendezvous is completed as truncated
+     * to release the send request on the remote side */
+    rreq->recv.worker                 = worker;
+    rreq->recv.buffer                 = (desc != NULL) ? (desc + 1) : NULL;
+    rreq->recv.datatype               = ucp_dt_make_contig(1);
+    rreq->recv.length                 = (desc != NULL) ? rndv_rts_hdr->size : 0;
+    rreq->recv.mem_type               = UCS_MEMORY_TYPE_HOST;
+    rreq->recv.state.dt.contig.md_map = 0;
+
+out:
+    ucp_rndv_matched(worker, rreq, rndv_rts_hdr);
+    return UCS_OK;
+}
+
 UCP_DEFINE_AM(UCP_FEATURE_AM, UCP_AM_ID_SINGLE,
               ucp_am_handler, NULL, 0);
 UCP_DEFINE_AM(UCP_FEATURE_AM, UCP_AM_ID_MULTI,
@@ -695,6 +1088,8 @@ UCP_DEFINE_AM(UCP_FEATURE_AM, UCP_AM_ID_SINGLE_REPLY,
               ucp_am_handler_reply, NULL, 0);
 UCP_DEFINE_AM(UCP_FEATURE_AM, UCP_AM_ID_MULTI_REPLY,
               ucp_am_long_handler_reply, NULL, 0);
+UCP_DEFINE_AM(UCP_FEATURE_AM, UCP_AM_ID_RNDV_AM_RTS,
+              ucp_am_rndv_rts_handler, NULL, 0);
 
 const ucp_request_send_proto_t ucp_am_proto = {
     .contig_short           = ucp_am_contig_short,
@@ -4,10 +4,26 @@
  * See file LICENSE for terms.
  */
 
+#ifndef UCP_AM_H_
+#define UCP_AM_H_
+
 #include "ucp_ep.h"
 
+#include <ucs/datastruct/khash.h>
+
+
 #define UCP_AM_CB_BLOCK_SIZE 16
 
+/* Reassembly buffers of multi-fragment AM's are taken from memory pools of
+ * power-of-2 size classes from 2^UCP_AM_REASM_MP_MIN_SHIFT to
+ * 2^UCP_AM_REASM_MP_MAX_SHIFT bytes. Larger messages use malloc. */
+#define UCP_AM_REASM_MP_MIN_SHIFT  14
+#define UCP_AM_REASM_MP_MAX_SHIFT  20
+#define UCP_AM_REASM_MP_COUNT      (UCP_AM_REASM_MP_MAX_SHIFT - \
+                                    UCP_AM_REASM_MP_MIN_SHIFT + 1)
+#define UCP_AM_REASM_MP_CHUNK_SIZE UCS_MBYTE       /* Pool grow granularity */
+#define UCP_AM_REASM_MP_MAX_SIZE   (64 * UCS_MBYTE) /* Max. memory per pool */
+
 
 typedef union {
     struct {
@@ -42,12 +58,36 @@ typedef struct {
 } UCS_S_PACKED ucp_am_long_hdr_t;
 
 typedef struct {
-    ucs_list_link_t   list;       /* entry into list of unfinished AM's */
-    ucp_recv_desc_t  *all_data;   /* buffer for all parts of the AM */
+    uintptr_t         ep;         /* end point ptr the AM is received on */
     uint64_t          msg_id;     /* way to match up all parts of AM */
+} ucp_am_unfinished_key_t;
+
+typedef struct {
+    ucp_recv_desc_t  *all_data;   /* buffer for all parts of the AM */
+    ucp_request_t    *req;        /* request to receive the AM to a user
+                                     buffer, NULL if all_data is used */
     size_t            left;
 } ucp_am_unfinished_t;
 
-void ucp_am_ep_init(ucp_ep_h ep);
+
+static UCS_F_ALWAYS_INLINE khint_t
+ucp_am_unfinished_hash_func(ucp_am_unfinished_key_t key)
+{
+    return kh_int64_hash_func(key.ep ^ key.msg_id);
+}
+
+#define ucp_am_unfinished_hash_equal(_key1, _key2) \
+    (((_key1).ep == (_key2).ep) && ((_key1).msg_id == (_key2).msg_id))
+
+KHASH_INIT(ucp_am_unfinished_hash, ucp_am_unfinished_key_t,
+           ucp_am_unfinished_t, 1, ucp_am_unfinished_hash_func,
+           ucp_am_unfinished_hash_equal);
+
+
+ucs_status_t ucp_am_worker_init(ucp_worker_h worker);
+
+void ucp_am_worker_cleanup(ucp_worker_h worker);
 
 void ucp_am_ep_cleanup(ucp_ep_h ep);
+
+#endif
@@ -131,6 +131,20 @@ static ucs_config_field_t ucp_config_table[] = {
    "is zero or negative",
    ucs_offsetof(ucp_config_t, ctx.rndv_thresh_fallback), UCS_CONFIG_TYPE_MEMUNITS},
 
+  {"AM_RNDV_THRESH", "auto",
+   "Threshold for switching from eager to rendezvous protocol in ucp_am_send_nb().\n"
+   "\"auto\" means using the same threshold as the tag-matching rendezvous\n"
+   "protocol.",
+   ucs_offsetof(ucp_config_t, ctx.am_rndv_thresh), UCS_CONFIG_TYPE_MEMUNITS},
+
+  {"STREAM_RNDV_THRESH", "inf",
+   "Threshold for switching from eager to rendezvous protocol in ucp_stream_send_nb().\n"
+   "With rendezvous, the receiver fetches the data directly to the buffer of a\n"
+   "posted ucp_stream_recv_nb() if it is large enough. \"auto\" means using the\n"
+   "same threshold as the tag-matching rendezvous protocol, \"inf\" disables\n"
+   "stream rendezvous.",
+   ucs_offsetof(ucp_config_t, ctx.stream_rndv_thresh), UCS_CONFIG_TYPE_MEMUNITS},
+
   {"RNDV_PERF_DIFF", "1",
    "The percentage allowed for performance difference between rendezvous and "
    "the eager_zcopy protocol",
@@ -157,6 +171,19 @@ static ucs_config_field_t ucp_config_table[] = {
    " auto      - runtime automatically chooses optimal scheme to use.\n",
    ucs_offsetof(ucp_config_t, ctx.rndv_mode), UCS_CONFIG_TYPE_ENUM(ucp_rndv_modes)},
 
+  {"RNDV_ADAPTIVE", "n",
+   "Measure the performance of eager and rendezvous sends at runtime, and retune\n"
+   "the rendezvous threshold and the scheme according to the measurements. Only\n"
+   "the settings which are \"auto\" are retuned. Eager sends are measured only\n"
+   "if they are synchronous, so the threshold is retuned only by applications\n"
+   "which use synchronous sends.",
+   ucs_offsetof(ucp_config_t, ctx.rndv_adaptive), UCS_CONFIG_TYPE_BOOL},
+
+  {"RNDV_ADAPTIVE_INTERVAL", "1024",
+   "Number of measured sends between retunes of the rendezvous thresholds,\n"
+   "used if RNDV_ADAPTIVE is enabled.",
+   ucs_offsetof(ucp_config_t, ctx.rndv_adaptive_interval), UCS_CONFIG_TYPE_UINT},
+
   {"ZCOPY_THRESH", "auto",
    "Threshold for switching from buffer copy to zero copy protocol",
    ucs_offsetof(ucp_config_t, ctx.zcopy_thresh), UCS_CONFIG_TYPE_MEMUNITS},
@@ -229,6 +256,11 @@ static ucs_config_field_t ucp_config_table[] = {
    "mode will be used for messages sent with eager protocol only.",
    ucs_offsetof(ucp_config_t, ctx.tm_sw_rndv), UCS_CONFIG_TYPE_BOOL},
 
+  {"TM_SHARDS", "16",
+   "Number of tag matching shards on a worker which was created with a tag shard\n"
+   "mask. Each shard is matched under a separate lock. Rounded up to a power of 2.",
+   ucs_offsetof(ucp_config_t, ctx.tm_num_shards), UCS_CONFIG_TYPE_UINT},
+
   {"NUM_EPS", "auto",
    "An optimization hint of how many endpoints would be created on this context.\n"
    "Does not affect semantics, but only transport selection criteria and the\n"
@@ -247,6 +279,14 @@ static ucs_config_field_t ucp_config_table[] = {
    "RNDV fragment size \n",
    ucs_offsetof(ucp_config_t, ctx.rndv_frag_size), UCS_CONFIG_TYPE_MEMUNITS},
 
+  {"RNDV_FRAG_REG_THRESH", "inf",
+   "Minimal size of a host memory rendezvous message whose send buffer is\n"
+   "registered in RNDV_FRAG_SIZE fragments, instead of registering the whole\n"
+   "buffer before sending the RTS. Every fragment is registered while the\n"
+   "previous ones are transferred by put_zcopy, and deregistered when its\n"
+   "transfer is completed. Used only if RNDV_SCHEME is \"auto\".",
+   ucs_offsetof(ucp_config_t, ctx.rndv_frag_reg_thresh), UCS_CONFIG_TYPE_MEMUNITS},
+
   {"MEMTYPE_CACHE", "y",
    "Enable memory type (cuda/rocm) cache \n",
    ucs_offsetof(ucp_config_t, ctx.enable_memtype_cache), UCS_CONFIG_TYPE_BOOL},
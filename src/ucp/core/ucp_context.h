@@ -43,6 +43,12 @@ typedef struct ucp_context_config {
     /** Threshold for switching UCP to rendezvous protocol in case the calculated
      *  threshold is zero or negative */
     size_t                                 rndv_thresh_fallback;
+    /** Threshold for switching UCP to rendezvous protocol in
+     *  ucp_am_send_nb() */
+    size_t                                 am_rndv_thresh;
+    /** Threshold for switching UCP to rendezvous protocol in
+     *  ucp_stream_send_nb() */
+    size_t                                 stream_rndv_thresh;
     /** The percentage allowed for performance difference between rendezvous
      *  and the eager_zcopy protocol */
     double                                 rndv_perf_diff;
@@ -50,12 +56,18 @@ typedef struct ucp_context_config {
     size_t                                 zcopy_thresh;
     /** Communication scheme in RNDV protocol */
     ucp_rndv_mode_t                        rndv_mode;
+    /** Retune rendezvous thresholds from runtime measurements */
+    int                                    rndv_adaptive;
+    /** Number of measured sends between rendezvous retunes */
+    unsigned                               rndv_adaptive_interval;
     /** Estimation of bcopy bandwidth */
     double                                 bcopy_bw;
     /** Segment size in the worker pre-registered memory pool */
     size_t                                 seg_size;
     /** RNDV pipeline fragment size */
     size_t                                 rndv_frag_size;
+    /** Minimal size of host memory RNDV send buffer registered by fragments */
+    size_t                                 rndv_frag_reg_thresh;
     /** Threshold for using tag matching offload capabilities. Smaller buffers
      *  will not be posted to the transport. */
     size_t                                 tm_thresh;
@@ -66,6 +78,8 @@ typedef struct ucp_context_config {
     size_t                                 tm_max_bb_size;
     /** Enabling SW rndv protocol with tag offload mode */
     int                                    tm_sw_rndv;
+    /** Number of tag matching shards, if a tag shard mask is set */
+    unsigned                               tm_num_shards;
     /** Pack debug information in worker address */
     int                                    address_debug_info;
     /** Maximal size of worker name for debugging */
@@ -21,6 +21,7 @@
 #include <ucp/tag/eager.h>
 #include <ucp/tag/offload.h>
 #include <ucp/tag/rndv.h>
+#include <ucp/tag/rndv_est.h>
 #include <ucp/stream/stream.h>
 #include <ucp/core/ucp_listener.h>
 #include <ucs/datastruct/queue.h>
@@ -119,7 +120,6 @@ ucs_status_t ucp_ep_new(ucp_worker_h worker, const char *peer_name,
            sizeof(ucp_ep_ext_gen(ep)->ep_match));
 
     ucp_stream_ep_init(ep);
-    ucp_am_ep_init(ep);
 
     for (lane = 0; lane < UCP_MAX_LANES; ++lane) {
         ep->uct_eps[lane] = NULL;
@@ -1219,6 +1219,49 @@ static void ucp_ep_config_set_am_rndv_thresh(ucp_worker_h worker,
               config->tag.rndv.am_thresh, config->tag.rndv_send_nbr.am_thresh);
 }
 
+static void ucp_ep_config_set_user_am_rndv_thresh(ucp_worker_h worker,
+                                                  ucp_ep_config_t *config)
+{
+    ucp_context_h context = worker->context;
+    size_t rndv_thresh;
+
+    if (!ucp_ep_config_test_rndv_support(config)) {
+        /* Disable RNDV */
+        rndv_thresh = SIZE_MAX;
+    } else if (context->config.ext.am_rndv_thresh == UCS_MEMUNITS_AUTO) {
+        /* auto - follow the threshold of tag-matching RMA rendezvous */
+        rndv_thresh = config->tag.rndv.rma_thresh;
+    } else {
+        rndv_thresh = context->config.ext.am_rndv_thresh;
+    }
+
+    /* Empty messages are always sent eagerly */
+    config->am_u.rndv_thresh = ucp_ep_thresh(rndv_thresh, 1, SIZE_MAX);
+    ucs_trace("user active message rndv threshold is %zu",
+              config->am_u.rndv_thresh);
+}
+
+static void ucp_ep_config_set_stream_rndv_thresh(ucp_worker_h worker,
+                                                 ucp_ep_config_t *config)
+{
+    ucp_context_h context = worker->context;
+    size_t rndv_thresh;
+
+    if (!ucp_ep_config_test_rndv_support(config)) {
+        /* Disable RNDV */
+        rndv_thresh = SIZE_MAX;
+    } else if (context->config.ext.stream_rndv_thresh == UCS_MEMUNITS_AUTO) {
+        /* auto - follow the threshold of tag-matching RMA rendezvous */
+        rndv_thresh = config->tag.rndv.rma_thresh;
+    } else {
+        rndv_thresh = context->config.ext.stream_rndv_thresh;
+    }
+
+    /* Empty messages are always sent eagerly */
+    config->stream.rndv_thresh = ucp_ep_thresh(rndv_thresh, 1, SIZE_MAX);
+    ucs_trace("stream rndv threshold is %zu", config->stream.rndv_thresh);
+}
+
 static void ucp_ep_config_set_rndv_thresh(ucp_worker_t *worker,
                                           ucp_ep_config_t *config,
                                           ucp_lane_index_t *lanes,
@@ -1441,8 +1484,10 @@ ucs_status_t ucp_ep_config_init(ucp_worker_h worker, ucp_ep_config_t *config,
 
     config->tag.rndv.rkey_ptr_dst_mds   = 0;
     config->stream.proto                = &ucp_stream_am_proto;
+    config->stream.rndv_thresh          = SIZE_MAX;
     config->am_u.proto                  = &ucp_am_proto;
     config->am_u.reply_proto            = &ucp_am_reply_proto;
+    config->am_u.rndv_thresh            = SIZE_MAX;
     max_rndv_thresh                     = SIZE_MAX;
     max_am_rndv_thresh                  = SIZE_MAX;
     min_am_rndv_thresh                  = 0;
@@ -1642,6 +1687,9 @@ ucs_status_t ucp_ep_config_init(ucp_worker_h worker, ucp_ep_config_t *config,
             ucp_ep_config_set_am_rndv_thresh(worker, iface_attr, md_attr, config,
                                              min_am_rndv_thresh,
                                              max_am_rndv_thresh);
+
+            ucp_ep_config_set_user_am_rndv_thresh(worker, config);
+            ucp_ep_config_set_stream_rndv_thresh(worker, config);
         } else {
             /* Stub endpoint */
             config->am.max_bcopy = UCP_MIN_BCOPY;
@@ -1720,11 +1768,18 @@ ucs_status_t ucp_ep_config_init(ucp_worker_h worker, ucp_ep_config_t *config,
         }
     }
 
+    status = ucp_rndv_est_init(worker, config);
+    if (status != UCS_OK) {
+        ucs_free(config->key.dst_md_cmpts);
+        return status;
+    }
+
     return UCS_OK;
 }
 
 void ucp_ep_config_cleanup(ucp_worker_h worker, ucp_ep_config_t *config)
 {
+    ucp_rndv_est_cleanup(config);
     ucs_free(config->key.dst_md_cmpts);
 }
 
@@ -1937,6 +1992,22 @@ static void ucp_ep_config_print(FILE *stream, ucp_worker_h worker,
     }
     fprintf(stream, "#\n");
 
+    if (context->config.features & UCP_FEATURE_AM) {
+        ucp_ep_config_print_tag_proto(stream, "am_send",
+                                      config->am.max_short,
+                                      config->am.zcopy_thresh[0],
+                                      config->am_u.rndv_thresh,
+                                      config->am_u.rndv_thresh);
+    }
+
+    if (context->config.features & UCP_FEATURE_STREAM) {
+        ucp_ep_config_print_tag_proto(stream, "stream_send",
+                                      config->am.max_short,
+                                      config->am.zcopy_thresh[0],
+                                      config->stream.rndv_thresh,
+                                      config->stream.rndv_thresh);
+    }
+
     if (context->config.features & UCP_FEATURE_TAG) {
         ucp_ep_config_print_tag_proto(stream, "tag_send",
                                       config->tag.eager.max_short,
@@ -1970,7 +2041,8 @@ static void ucp_ep_config_print(FILE *stream, ucp_worker_h worker,
          }
      }
 
-     if (context->config.features & (UCP_FEATURE_TAG|UCP_FEATURE_RMA)) {
+     if (context->config.features & (UCP_FEATURE_TAG|UCP_FEATURE_RMA|
+                                     UCP_FEATURE_AM)) {
          fprintf(stream, "#\n");
          fprintf(stream, "# %23s: mds ", "rma_bw");
          ucs_for_each_bit(md_index, config->key.rma_bw_md_map) {
@@ -1978,7 +2050,7 @@ static void ucp_ep_config_print(FILE *stream, ucp_worker_h worker,
          }
      }
 
-     if (context->config.features & UCP_FEATURE_TAG) {
+     if (context->config.features & (UCP_FEATURE_TAG|UCP_FEATURE_AM)) {
          fprintf(stream, "rndv_rkey_size %zu\n", config->tag.rndv.rkey_size);
      }
 }
@@ -52,6 +52,9 @@ enum {
     UCP_EP_FLAG_CLOSED                 = UCS_BIT(10),/* EP was closed */
     UCP_EP_FLAG_CLOSE_REQ_VALID        = UCS_BIT(11),/* close protocol is started and
                                                         close_req is valid */
+    UCP_EP_FLAG_STREAM_SEND_RNDV       = UCS_BIT(12),/* Stream rendezvous send is in
+                                                        progress, next sends are
+                                                        queued in ext.stream.send_q */
 
     /* DEBUG bits */
     UCP_EP_FLAG_CONNECT_REQ_SENT       = UCS_BIT(16),/* DEBUG: Connection request was sent */
@@ -263,6 +266,8 @@ typedef struct ucp_ep_config {
             ucp_lane_index_t put_zcopy_lanes[UCP_MAX_LANES];
             /* BW based scale factor */
             double           scale[UCP_MAX_LANES];
+            /* Runtime estimator which retunes the thresholds, or NULL */
+            struct ucp_rndv_est *est;
         } rndv;
 
         /* special thresholds for the ucp_tag_send_nbr() */
@@ -288,12 +293,16 @@ typedef struct ucp_ep_config {
         /* Protocols used for stream operations
          * (currently it's only AM based). */
         const ucp_request_send_proto_t   *proto;
+        /* Threshold for switching from eager to rendezvous protocol */
+        size_t                           rndv_thresh;
     } stream;
     
     struct {
         /* Protocols used for am operations */
         const ucp_request_send_proto_t   *proto;
         const ucp_request_send_proto_t   *reply_proto;
+        /* Threshold for switching from eager to rendezvous protocol */
+        size_t                           rndv_thresh;
     } am_u;
 
 } ucp_ep_config_t;
@@ -371,11 +380,9 @@ typedef struct {
         ucs_list_link_t           ready_list;    /* List entry in worker's EP list */
         ucs_queue_head_t          match_q;       /* Queue of receive data or requests,
                                                     depends on UCP_EP_FLAG_STREAM_HAS_DATA */
+        ucs_queue_head_t          send_q;        /* Queue of send requests waiting
+                                                    for a rendezvous send to complete */
     } stream;
-
-    struct {
-        ucs_list_link_t           started_ams;
-    } am;
 } ucp_ep_ext_proto_t;
 
 
@@ -33,17 +33,20 @@
 enum {
     UCP_REQUEST_FLAG_COMPLETED            = UCS_BIT(0),
     UCP_REQUEST_FLAG_RELEASED             = UCS_BIT(1),
+    UCP_REQUEST_FLAG_SEND_STREAM_RNDV     = UCS_BIT(2),
     UCP_REQUEST_FLAG_EXPECTED             = UCS_BIT(3),
     UCP_REQUEST_FLAG_LOCAL_COMPLETED      = UCS_BIT(4),
     UCP_REQUEST_FLAG_REMOTE_COMPLETED     = UCS_BIT(5),
     UCP_REQUEST_FLAG_CALLBACK             = UCS_BIT(6),
     UCP_REQUEST_FLAG_RECV                 = UCS_BIT(7),
     UCP_REQUEST_FLAG_SYNC                 = UCS_BIT(8),
+    UCP_REQUEST_FLAG_RNDV_EST             = UCS_BIT(9),
     UCP_REQUEST_FLAG_OFFLOADED            = UCS_BIT(10),
     UCP_REQUEST_FLAG_BLOCK_OFFLOAD        = UCS_BIT(11),
     UCP_REQUEST_FLAG_STREAM_RECV_WAITALL  = UCS_BIT(12),
     UCP_REQUEST_FLAG_SEND_AM              = UCS_BIT(13),
     UCP_REQUEST_FLAG_SEND_TAG             = UCS_BIT(14),
+    UCP_REQUEST_FLAG_RECV_AM_USER_DATA    = UCS_BIT(15),
 #if UCS_ENABLE_ASSERT
     UCP_REQUEST_FLAG_STREAM_RECV          = UCS_BIT(16),
     UCP_REQUEST_DEBUG_FLAG_EXTERNAL       = UCS_BIT(17),
@@ -96,7 +99,9 @@ enum {
  */
 enum {
     UCP_RDESC_HASH_LIST = 0,
-    UCP_RDESC_ALL_LIST  = 1
+    UCP_RDESC_ALL_LIST  = 1,
+    UCP_RDESC_WILD_LIST = 2,
+    UCP_RDESC_LAST_LIST
 };
 
 
@@ -139,6 +144,14 @@ struct ucp_request {
                     } am;
                 } msg_proto;
 
+                struct {
+                    ucs_queue_elem_t     queue;    /* Element in the endpoint
+                                                      queue of stream sends
+                                                      waiting for rendezvous */
+                    size_t               count;    /* Number of datatype
+                                                      elements to send */
+                } stream;
+
                 struct {
                     uint64_t      remote_addr; /* Remote address */
                     ucp_rkey_h    rkey;     /* Remote memory key */
@@ -235,6 +248,11 @@ struct ucp_request {
             ucp_lane_index_t      pending_lane; /* Lane on which request was moved
                                                  * to pending state */
             ucp_lane_index_t      lane;     /* Lane on which this request is being sent */
+            /* Rendezvous estimator state, used if UCP_REQUEST_FLAG_RNDV_EST is
+             * set */
+            uint8_t               rndv_est_proto; /* Protocol used for the send,
+                                                     ucp_rndv_est_proto_t */
+            ucs_time_t            rndv_est_start; /* Time the send was started */
             uct_pending_req_t     uct;      /* UCT pending request */
             ucp_mem_desc_t        *mdesc;
         } send;
@@ -254,7 +272,15 @@ struct ucp_request {
                 struct {
                     ucp_tag_t               tag;      /* Expected tag */
                     ucp_tag_t               tag_mask; /* Expected tag mask */
-                    uint64_t                sn;       /* Tag match sequence */
+                    /* Can use union, because rendezvous receive of an
+                     * active message does not go through tag matching. */
+                    union {
+                        uint64_t            sn;       /* Tag match sequence */
+                        ucp_ep_h            am_reply_ep; /* Reply endpoint of
+                                                            active message */
+                        ucp_ep_h            stream_ep; /* Endpoint of stream
+                                                          rendezvous receive */
+                    };
                     ucp_tag_recv_callback_t cb;       /* Completion callback */
                     ucp_tag_recv_info_t     info;     /* Completion info to fill */
                     ssize_t                 remaining; /* How much more data to be received */
@@ -267,6 +293,9 @@ struct ucp_request {
                                                                 multi-fragment
                                                                 non-contig unexpected
                                                                 message in tag offload flow. */
+                        ucp_request_t       *stream_req; /* Stream receive request
+                                                            which the rendezvous
+                                                            data is fetched to */
                     };
                     ucp_worker_iface_t      *wiface;  /* Cached iface this request
                                                          is received on. Used in
@@ -314,7 +343,7 @@ struct ucp_request {
  */
 struct ucp_recv_desc {
     union {
-        ucs_list_link_t     tag_list[2];    /* Hash list TAG-element */
+        ucs_list_link_t     tag_list[UCP_RDESC_LAST_LIST]; /* Hash list TAG-element */
         ucs_queue_elem_t    stream_queue;   /* Queue STREAM-element */
         ucs_queue_elem_t    tag_frag_queue; /* Tag fragments queue */
     };
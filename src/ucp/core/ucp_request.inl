@@ -13,6 +13,8 @@
 
 #include <ucp/core/ucp_worker.h>
 #include <ucp/dt/dt.h>
+#include <ucp/tag/rndv_est.h>
+#include <ucp/stream/stream.h>
 #include <ucs/profile/profile.h>
 #include <ucs/datastruct/mpool.inl>
 #include <ucp/dt/dt.inl>
@@ -94,6 +96,23 @@ ucp_request_complete_send(ucp_request_t *req, ucs_status_t status)
                   req, req + 1, UCP_REQUEST_FLAGS_ARG(req->flags),
                   ucs_status_string(status));
     UCS_PROFILE_REQUEST_EVENT(req, "complete_send", status);
+    if (ucs_unlikely(req->flags & UCP_REQUEST_FLAG_RNDV_EST)) {
+        /* the flag must not stay set if the request is reused */
+        req->flags &= ~UCP_REQUEST_FLAG_RNDV_EST;
+        if (status == UCS_OK) {
+            ucp_rndv_est_send_completed(req);
+        }
+    }
+    if (ucs_unlikely(req->flags & UCP_REQUEST_FLAG_SEND_STREAM_RNDV)) {
+        /* stream sends which were queued behind the rendezvous can be started
+         * now, the request may be released by the callback */
+        ucp_ep_h ep = req->send.ep;
+
+        req->flags &= ~UCP_REQUEST_FLAG_SEND_STREAM_RNDV;
+        ucp_request_complete(req, send.cb, status);
+        ucp_stream_send_resume(ep);
+        return;
+    }
     ucp_request_complete(req, send.cb, status);
 }
 
@@ -92,6 +92,10 @@ enum {
     UCP_AM_ID_SINGLE_REPLY      =  25, /* For user defined AM when a reply
                                           is needed */
     UCP_AM_ID_MULTI_REPLY       =  26,
+    UCP_AM_ID_RNDV_AM_RTS       =  27, /* Ready-to-Send for user defined AM
+                                          which is sent with rendezvous */
+    UCP_AM_ID_STREAM_RNDV_RTS   =  28, /* Ready-to-Send for STREAM data
+                                          which is sent with rendezvous */
     UCP_AM_ID_LAST
 };
 
@@ -19,6 +19,7 @@
 #include <ucp/wireup/wireup_ep.h>
 #include <ucp/tag/eager.h>
 #include <ucp/tag/offload.h>
+#include <ucp/tag/rndv_est.h>
 #include <ucp/stream/stream.h>
 #include <ucs/config/parser.h>
 #include <ucs/datastruct/mpool.inl>
@@ -69,7 +70,11 @@ static ucs_stats_class_t ucp_worker_stats_class = {
         [UCP_WORKER_STAT_TAG_RX_EAGER_CHUNK_EXP]   = "rx_eager_chunk_exp",
         [UCP_WORKER_STAT_TAG_RX_EAGER_CHUNK_UNEXP] = "rx_eager_chunk_unexp",
         [UCP_WORKER_STAT_TAG_RX_RNDV_EXP]          = "rx_rndv_rts_exp",
-        [UCP_WORKER_STAT_TAG_RX_RNDV_UNEXP]        = "rx_rndv_rts_unexp"
+        [UCP_WORKER_STAT_TAG_RX_RNDV_UNEXP]        = "rx_rndv_rts_unexp",
+        [UCP_WORKER_STAT_AM_RX_REASM_HIT]          = "rx_am_reasm_hit",
+        [UCP_WORKER_STAT_AM_RX_REASM_MISS]         = "rx_am_reasm_miss",
+        [UCP_WORKER_STAT_AM_RX_REASM_BUF_POOL]     = "rx_am_reasm_buf_pool",
+        [UCP_WORKER_STAT_AM_RX_REASM_BUF_MALLOC]   = "rx_am_reasm_buf_malloc"
     }
 };
 #endif
@@ -1555,6 +1560,46 @@ static void ucp_worker_print_used_tls(const ucp_ep_config_key_t *key,
     ucs_info("%s", info);
 }
 
+/* Fill the array with all memory pools of the worker, return their number */
+static unsigned ucp_worker_get_mpools(ucp_worker_h worker,
+                                      ucs_mpool_t **mps)
+{
+    unsigned i, count = 0;
+
+    mps[count++] = &worker->req_mp;
+    mps[count++] = &worker->rkey_mp;
+    mps[count++] = &worker->am_mp;
+    mps[count++] = &worker->reg_mp;
+    mps[count++] = &worker->rndv_frag_mp;
+
+    if (worker->context->config.features & UCP_FEATURE_AM) {
+        for (i = 0; i < UCP_AM_REASM_MP_COUNT; ++i) {
+            mps[count++] = &worker->am_reasm_mps[i];
+        }
+    }
+
+    ucs_assert(count <= UCP_WORKER_MAX_MPOOLS);
+    return count;
+}
+
+static ucs_status_t ucp_worker_mpools_stats_alloc(ucp_worker_h worker)
+{
+    ucs_mpool_t *mps[UCP_WORKER_MAX_MPOOLS];
+    ucs_status_t status;
+    unsigned i, count;
+
+    count = ucp_worker_get_mpools(worker, mps);
+    for (i = 0; i < count; ++i) {
+        status = ucs_mpool_stats_alloc(mps[i],
+                                       UCS_STATS_RVAL(worker->stats));
+        if (status != UCS_OK) {
+            return status;
+        }
+    }
+
+    return UCS_OK;
+}
+
 static ucs_status_t ucp_worker_init_mpools(ucp_worker_h worker)
 {
     size_t           max_mp_entry_size = 0;
@@ -1661,6 +1706,8 @@ ucs_status_t ucp_worker_create(ucp_context_h context,
                                ucp_worker_h *worker_p)
 {
     ucs_thread_mode_t uct_thread_mode;
+    ucp_tag_t tag_shard_mask;
+    unsigned num_tag_shards;
     unsigned config_count;
     unsigned name_length;
     ucp_worker_h worker;
@@ -1793,7 +1840,17 @@ ucs_status_t ucp_worker_create(ucp_context_h context,
     }
 
     /* Initialize tag matching */
-    status = ucp_tag_match_init(&worker->tm);
+    if (params->field_mask & UCP_WORKER_PARAM_FIELD_TAG_SHARD_MASK) {
+        tag_shard_mask = params->tag_shard_mask;
+    } else {
+        tag_shard_mask = 0;
+    }
+
+    num_tag_shards = ucs_roundup_pow2(ucs_max(context->config.ext.tm_num_shards,
+                                              1));
+    status = ucp_tag_match_init(&worker->tm, context->config.tag_sender_mask,
+                                tag_shard_mask, num_tag_shards,
+                                worker->flags & UCP_WORKER_FLAG_MT);
     if (status != UCS_OK) {
         goto err_wakeup_cleanup;
     }
@@ -1822,6 +1879,18 @@ ucs_status_t ucp_worker_create(ucp_context_h context,
         goto err_close_cms;
     }
 
+    /* Init AM reassembly state */
+    status = ucp_am_worker_init(worker);
+    if (status != UCS_OK) {
+        goto err_mpools_cleanup;
+    }
+
+    /* Report memory usage of the pools; released by mpool cleanup */
+    status = ucp_worker_mpools_stats_alloc(worker);
+    if (status != UCS_OK) {
+        goto err_am_cleanup;
+    }
+
     /* Select atomic resources */
     ucp_worker_init_atomic_tls(worker);
 
@@ -1833,6 +1902,12 @@ ucs_status_t ucp_worker_create(ucp_context_h context,
     *worker_p = worker;
     return UCS_OK;
 
+err_am_cleanup:
+    ucp_am_worker_cleanup(worker);
+err_mpools_cleanup:
+    ucs_mpool_cleanup(&worker->am_mp, 1);
+    ucs_mpool_cleanup(&worker->reg_mp, 1);
+    ucs_mpool_cleanup(&worker->rndv_frag_mp, 1);
 err_close_cms:
     ucp_worker_close_cms(worker);
 err_close_ifaces:
@@ -1891,6 +1966,7 @@ void ucp_worker_destroy(ucp_worker_h worker)
     UCS_ASYNC_UNBLOCK(&worker->async);
 
     ucp_worker_destroy_ep_configs(worker);
+    ucp_am_worker_cleanup(worker);
     ucs_mpool_cleanup(&worker->am_mp, 1);
     ucs_mpool_cleanup(&worker->reg_mp, 1);
     ucs_mpool_cleanup(&worker->rndv_frag_mp, 1);
@@ -2169,6 +2245,25 @@ void ucp_worker_release_address(ucp_worker_h worker, ucp_address_t *address)
 }
 
 
+void ucp_worker_release_idle_memory(ucp_worker_h worker)
+{
+    ucs_mpool_t *mps[UCP_WORKER_MAX_MPOOLS];
+    unsigned i, count, num_released;
+
+    UCP_WORKER_THREAD_CS_ENTER_CONDITIONAL(worker);
+
+    count        = ucp_worker_get_mpools(worker, mps);
+    num_released = 0;
+    for (i = 0; i < count; ++i) {
+        num_released += ucs_mpool_shrink(mps[i]);
+    }
+
+    ucs_debug("worker %p: released %u idle memory pool chunks", worker,
+              num_released);
+
+    UCP_WORKER_THREAD_CS_EXIT_CONDITIONAL(worker);
+}
+
 void ucp_worker_print_info(ucp_worker_h worker, FILE *stream)
 {
     ucp_context_h context = worker->context;
@@ -2208,6 +2303,8 @@ void ucp_worker_print_info(ucp_worker_h worker, FILE *stream)
         fprintf(stream, "\n");
     }
 
+    ucp_rndv_est_print(worker, stream);
+
     fprintf(stream, "#\n");
 
     UCP_WORKER_THREAD_CS_EXIT_CONDITIONAL(worker);
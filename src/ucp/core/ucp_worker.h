@@ -9,6 +9,7 @@
 #define UCP_WORKER_H_
 
 #include "ucp_ep.h"
+#include "ucp_am.h"
 #include "ucp_context.h"
 #include "ucp_thread.h"
 
@@ -25,6 +26,9 @@
  * because it is common for all cases and protocols (TAG, STREAM). */
 #define UCP_WORKER_HEADROOM_PRIV_SIZE 32
 
+/* Maximal number of memory pools of a worker */
+#define UCP_WORKER_MAX_MPOOLS         (5 + UCP_AM_REASM_MP_COUNT)
+
 
 #if ENABLE_MT
 
@@ -95,6 +99,14 @@ enum {
 
     UCP_WORKER_STAT_TAG_RX_RNDV_EXP,
     UCP_WORKER_STAT_TAG_RX_RNDV_UNEXP,
+
+    /* Multi-fragment active messages: lookups of in-progress messages which
+     * found (hit) or did not find (miss) a reassembly entry, and reassembly
+     * buffers which were taken from a memory pool or allocated by malloc */
+    UCP_WORKER_STAT_AM_RX_REASM_HIT,
+    UCP_WORKER_STAT_AM_RX_REASM_MISS,
+    UCP_WORKER_STAT_AM_RX_REASM_BUF_POOL,
+    UCP_WORKER_STAT_AM_RX_REASM_BUF_MALLOC,
     UCP_WORKER_STAT_LAST
 };
 
@@ -145,6 +157,10 @@ enum {
     UCS_STATS_UPDATE_COUNTER((_worker)->stats, \
                              UCP_WORKER_STAT_TAG_RX_RNDV_##_is_exp, 1);
 
+#define UCP_WORKER_STAT_AM_REASM(_worker, _name) \
+    UCS_STATS_UPDATE_COUNTER((_worker)->stats, \
+                             UCP_WORKER_STAT_AM_RX_REASM_##_name, 1);
+
 #define UCP_WORKER_STAT_TAG_OFFLOAD(_worker, _name) \
     UCS_STATS_UPDATE_COUNTER((_worker)->tm_offload_stats, \
                              UCP_WORKER_STAT_TAG_OFFLOAD_##_name, 1);
@@ -193,9 +209,10 @@ struct ucp_worker_cm {
  * Data that is stored about each callback registered with a worker
  */
 typedef struct ucp_worker_am_entry {
-    ucp_am_callback_t     cb;
-    void                 *context;
-    uint32_t              flags;
+    ucp_am_callback_t            cb;
+    ucp_am_recv_data_callback_t  data_cb;
+    void                        *context;
+    uint32_t                     flags;
 } ucp_worker_am_entry_t;
 
 /**
@@ -238,6 +255,10 @@ typedef struct ucp_worker {
     ucs_mpool_t                   rndv_frag_mp;  /* Memory pool for RNDV fragments */
     ucp_tag_match_t               tm;            /* Tag-matching queues and offload info */
     uint64_t                      am_message_id; /* For matching long am's */
+    khash_t(ucp_am_unfinished_hash) am_unfinished_hash; /* In-progress long
+                                                    am's, by ep and message id */
+    ucs_mpool_t                   am_reasm_mps[UCP_AM_REASM_MP_COUNT]; /* Size-class
+                                                    pools for long am reassembly */
     ucp_ep_h                      mem_type_ep[UCS_MEMORY_TYPE_LAST];/* memory type eps */
 
     UCS_STATS_NODE_DECLARE(stats)
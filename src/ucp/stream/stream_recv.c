@@ -14,6 +14,7 @@
 #include <ucp/core/ucp_request.h>
 #include <ucp/core/ucp_request.inl>
 #include <ucp/stream/stream.h>
+#include <ucp/tag/rndv.h>
 
 #include <ucs/datastruct/mpool.inl>
 #include <ucs/profile/profile.h>
@@ -91,23 +92,26 @@ ucp_stream_rdesc_get(ucp_ep_ext_proto_t *ep_ext)
     return rdesc;
 }
 
+static UCS_F_ALWAYS_INLINE void *
+ucp_stream_rdesc_to_data(ucp_recv_desc_t *rdesc, size_t *length)
+{
+    ucp_stream_am_data_t *am_data = ucp_stream_rdesc_am_data(rdesc);
+
+    *length         = rdesc->length;
+    am_data->rdesc  = rdesc;
+    return am_data + 1;
+}
+
 static UCS_F_ALWAYS_INLINE ucs_status_ptr_t
 ucp_stream_recv_data_nb_nolock(ucp_ep_h ep, size_t *length)
 {
     ucp_ep_ext_proto_t   *ep_ext = ucp_ep_ext_proto(ep);
-    ucp_recv_desc_t      *rdesc;
-    ucp_stream_am_data_t *am_data;
 
     if (ucs_unlikely(!ucp_stream_ep_has_data(ep_ext))) {
         return UCS_STATUS_PTR(UCS_OK);
     }
 
-    rdesc = ucp_stream_rdesc_dequeue(ep_ext);
-
-    *length         = rdesc->length;
-    am_data         = ucp_stream_rdesc_am_data(rdesc);
-    am_data->rdesc  = rdesc;
-    return am_data + 1;
+    return ucp_stream_rdesc_to_data(ucp_stream_rdesc_dequeue(ep_ext), length);
 }
 
 UCS_PROFILE_FUNC(ucs_status_ptr_t, ucp_stream_recv_data_nb, (ep, length),
@@ -125,6 +129,16 @@ UCS_PROFILE_FUNC(ucs_status_ptr_t, ucp_stream_recv_data_nb, (ep, length),
     return status_ptr;
 }
 
+static UCS_F_ALWAYS_INLINE void ucp_stream_rdesc_release(ucp_recv_desc_t *rdesc)
+{
+    if (ucs_unlikely(rdesc->flags & UCP_RECV_DESC_FLAG_MALLOC)) {
+        /* rendezvous data descriptor */
+        ucs_free(rdesc);
+    } else {
+        ucp_recv_desc_release(rdesc);
+    }
+}
+
 static UCS_F_ALWAYS_INLINE void
 ucp_stream_rdesc_dequeue_and_release(ucp_recv_desc_t *rdesc,
                                      ucp_ep_ext_proto_t *ep_ext)
@@ -134,7 +148,7 @@ ucp_stream_rdesc_dequeue_and_release(ucp_recv_desc_t *rdesc,
                                                       ucp_recv_desc_t,
                                                       stream_queue));
     ucp_stream_rdesc_dequeue(ep_ext);
-    ucp_recv_desc_release(rdesc);
+    ucp_stream_rdesc_release(rdesc);
 }
 
 UCS_PROFILE_FUNC_VOID(ucp_stream_data_release, (ep, data),
@@ -144,11 +158,65 @@ UCS_PROFILE_FUNC_VOID(ucp_stream_data_release, (ep, data),
 
     UCP_WORKER_THREAD_CS_ENTER_CONDITIONAL(ep->worker);
 
-    ucp_recv_desc_release(rdesc);
+    ucp_stream_rdesc_release(rdesc);
 
     UCP_WORKER_THREAD_CS_EXIT_CONDITIONAL(ep->worker);
 }
 
+UCS_PROFILE_FUNC(ssize_t, ucp_stream_worker_poll_data,
+                 (worker, poll_data, max_data, flags), ucp_worker_h worker,
+                 ucp_stream_poll_data_t *poll_data, size_t max_data,
+                 unsigned flags)
+{
+    ssize_t            count = 0;
+    ucp_ep_ext_proto_t *ep_ext;
+    ucp_ep_h           ep;
+    void               *user_data;
+
+    UCP_CONTEXT_CHECK_FEATURE_FLAGS(worker->context, UCP_FEATURE_STREAM,
+                                    return UCS_ERR_INVALID_PARAM);
+
+    UCP_WORKER_THREAD_CS_ENTER_CONDITIONAL(worker);
+
+    while ((count < max_data) && !ucs_list_is_empty(&worker->stream_ready_eps)) {
+        ep_ext    = ucs_list_head(&worker->stream_ready_eps, ucp_ep_ext_proto_t,
+                                  stream.ready_list);
+        ep        = ucp_ep_from_ext_proto(ep_ext);
+        user_data = ucp_ep_ext_gen(ep)->user_data;
+
+        /* The endpoint is removed from the ready list when its last data
+         * descriptor is dequeued */
+        do {
+            poll_data[count].ep        = ep;
+            poll_data[count].user_data = user_data;
+            poll_data[count].data      =
+                    ucp_stream_rdesc_to_data(ucp_stream_rdesc_dequeue(ep_ext),
+                                             &poll_data[count].length);
+            poll_data[count].flags     = 0;
+            ++count;
+        } while ((count < max_data) && ucp_stream_ep_has_data(ep_ext));
+    }
+
+    UCP_WORKER_THREAD_CS_EXIT_CONDITIONAL(worker);
+
+    return count;
+}
+
+UCS_PROFILE_FUNC_VOID(ucp_stream_data_release_bulk,
+                      (worker, poll_data, count), ucp_worker_h worker,
+                      const ucp_stream_poll_data_t *poll_data, size_t count)
+{
+    size_t i;
+
+    UCP_WORKER_THREAD_CS_ENTER_CONDITIONAL(worker);
+
+    for (i = 0; i < count; ++i) {
+        ucp_stream_rdesc_release(ucp_stream_rdesc_from_data(poll_data[i].data));
+    }
+
+    UCP_WORKER_THREAD_CS_EXIT_CONDITIONAL(worker);
+}
+
 static UCS_F_ALWAYS_INLINE ssize_t
 ucp_stream_rdata_unpack(const void *rdata, size_t length, ucp_request_t *dst_req)
 {
@@ -345,46 +413,72 @@ out:
     return req;
 }
 
+/* Returns how many bytes of the data were consumed by the expected requests */
+static UCS_F_ALWAYS_INLINE size_t
+ucp_stream_rdata_process_expected(ucp_ep_ext_proto_t *ep_ext,
+                                  const void *rdata, size_t length)
+{
+    size_t         offset = 0;
+    ucp_request_t *req;
+    ssize_t        unpacked;
+
+    if (ucp_stream_ep_has_data(ep_ext)) {
+        return 0;
+    }
+
+    while (!ucs_queue_is_empty(&ep_ext->stream.match_q)) {
+        req      = ucs_queue_head_elem_non_empty(&ep_ext->stream.match_q,
+                                                 ucp_request_t, recv.queue);
+        unpacked = ucp_stream_rdata_unpack(UCS_PTR_BYTE_OFFSET(rdata, offset),
+                                           length - offset, req);
+        if (ucs_unlikely(unpacked < 0)) {
+            ucs_fatal("failed to unpack from rdata %p with offset %zu to request %p",
+                      rdata, offset, req);
+        }
+
+        offset += unpacked;
+        if (offset == length) {
+            if (ucp_request_can_complete_stream_recv(req)) {
+                ucp_request_complete_stream_recv(req, ep_ext, UCS_OK);
+            }
+            break;
+        }
+
+        /* This request is full, try next one */
+        ucs_assert(ucp_request_can_complete_stream_recv(req));
+        ucp_request_complete_stream_recv(req, ep_ext, UCS_OK);
+    }
+
+    return offset;
+}
+
+static UCS_F_ALWAYS_INLINE void
+ucp_stream_rdesc_enqueue(ucp_ep_ext_proto_t *ep_ext, ucp_recv_desc_t *rdesc)
+{
+    ucp_ep_from_ext_proto(ep_ext)->flags |= UCP_EP_FLAG_STREAM_HAS_DATA;
+    ucs_queue_push(&ep_ext->stream.match_q, &rdesc->stream_queue);
+}
+
 static UCS_F_ALWAYS_INLINE ucs_status_t
 ucp_stream_am_data_process(ucp_worker_t *worker, ucp_ep_ext_proto_t *ep_ext,
                            ucp_stream_am_data_t *am_data, size_t length,
                            unsigned am_flags)
 {
     ucp_recv_desc_t  rdesc_tmp;
-    void            *payload;
     ucp_recv_desc_t *rdesc;
-    ucp_request_t   *req;
-    ssize_t          unpacked;
-
-    rdesc_tmp.length         = length;
-    rdesc_tmp.payload_offset = sizeof(*am_data); /* add sizeof(*rdesc) only if
-                                                    am_data wont be handled in
-                                                    place */
+    size_t           offset;
 
     /* First, process expected requests */
-    if (!ucp_stream_ep_has_data(ep_ext)) {
-        while (!ucs_queue_is_empty(&ep_ext->stream.match_q)) {
-            req      = ucs_queue_head_elem_non_empty(&ep_ext->stream.match_q,
-                                                     ucp_request_t, recv.queue);
-            payload  = UCS_PTR_BYTE_OFFSET(am_data, rdesc_tmp.payload_offset);
-            unpacked = ucp_stream_rdata_unpack(payload, rdesc_tmp.length, req);
-            if (ucs_unlikely(unpacked < 0)) {
-                ucs_fatal("failed to unpack from am_data %p with offset %u to request %p",
-                          am_data, rdesc_tmp.payload_offset, req);
-            } else if (unpacked == rdesc_tmp.length) {
-                if (ucp_request_can_complete_stream_recv(req)) {
-                    ucp_request_complete_stream_recv(req, ep_ext, UCS_OK);
-                }
-                return UCS_OK;
-            }
-            ucp_stream_rdesc_advance(&rdesc_tmp, unpacked, ep_ext);
-            /* This request is full, try next one */
-            ucs_assert(ucp_request_can_complete_stream_recv(req));
-            ucp_request_complete_stream_recv(req, ep_ext, UCS_OK);
-        }
+    offset = ucp_stream_rdata_process_expected(ep_ext, am_data + 1, length);
+    if (offset == length) {
+        return UCS_OK;
     }
 
-    ucs_assert(rdesc_tmp.length > 0);
+    rdesc_tmp.length         = length - offset;
+    rdesc_tmp.payload_offset = sizeof(*am_data) + offset; /* add sizeof(*rdesc)
+                                                             only if am_data
+                                                             wont be handled in
+                                                             place */
 
     /* Now, enqueue the rest of data */
     if (ucs_likely(!(am_flags & UCT_CB_PARAM_FLAG_DESC))) {
@@ -407,9 +501,7 @@ ucp_stream_am_data_process(ucp_worker_t *worker, ucp_ep_ext_proto_t *ep_ext,
         rdesc->flags          = UCP_RECV_DESC_FLAG_UCT_DESC;
     }
 
-    ucp_ep_from_ext_proto(ep_ext)->flags |= UCP_EP_FLAG_STREAM_HAS_DATA;
-    ucs_queue_push(&ep_ext->stream.match_q, &rdesc->stream_queue);
-
+    ucp_stream_rdesc_enqueue(ep_ext, rdesc);
     return UCS_INPROGRESS;
 }
 
@@ -421,6 +513,7 @@ void ucp_stream_ep_init(ucp_ep_h ep)
         ep_ext->stream.ready_list.prev = NULL;
         ep_ext->stream.ready_list.next = NULL;
         ucs_queue_head_init(&ep_ext->stream.match_q);
+        ucs_queue_head_init(&ep_ext->stream.send_q);
     }
 }
 
@@ -454,6 +547,14 @@ void ucp_stream_ep_cleanup(ucp_ep_h ep)
                                             ucp_request_t, recv.queue);
         ucp_request_complete_stream_recv(req, ep_ext, UCS_ERR_CANCELED);
     }
+
+    /* cancel sends which are waiting for a rendezvous */
+    while (!ucs_queue_is_empty(&ep_ext->stream.send_q)) {
+        req = ucs_queue_pull_elem_non_empty(&ep_ext->stream.send_q,
+                                            ucp_request_t, send.stream.queue);
+        ucp_request_send_generic_dt_finish(req);
+        ucp_request_complete_send(req, UCS_ERR_CANCELED);
+    }
 }
 
 void ucp_stream_ep_activate(ucp_ep_h ep)
@@ -504,6 +605,177 @@ ucp_stream_am_handler(void *am_arg, void *am_data, size_t am_length,
     return (am_flags & UCT_CB_PARAM_FLAG_DESC) ? UCS_INPROGRESS : UCS_OK;
 }
 
+/* Stream data which can't be received breaks the byte stream, so the endpoint
+ * is failed rather than dropping the data */
+static void ucp_stream_rndv_set_ep_failed(ucp_ep_h ep, ucs_status_t status)
+{
+    ucs_error("ep %p: failed to receive stream rendezvous data: %s", ep,
+              ucs_status_string(status));
+    ucp_worker_set_ep_failed(ep->worker, ep, ucp_ep_get_am_uct_ep(ep),
+                             ucp_ep_get_am_lane(ep), status);
+}
+
+static void ucp_stream_rndv_recv_completed(void *request, ucs_status_t status,
+                                           ucp_tag_recv_info_t *info)
+{
+    ucp_request_t *rreq         = (ucp_request_t*)request - 1;
+    ucp_request_t *req          = rreq->recv.tag.stream_req;
+    ucp_ep_h ep                 = rreq->recv.tag.stream_ep;
+    ucp_ep_ext_proto_t *ep_ext  = ucp_ep_ext_proto(ep);
+    ucp_recv_desc_t *rdesc;
+    size_t offset;
+
+    if (rreq->recv.buffer == NULL) {
+        /* The data was dropped */
+        return;
+    }
+
+    if (req != NULL) {
+        /* The data was fetched directly to the user buffer */
+        if (ucs_likely(status == UCS_OK)) {
+            req->recv.stream.offset += info->length;
+            if (!ucp_request_can_complete_stream_recv(req)) {
+                /* WAITALL request waits for more data */
+                ucs_queue_push_head(&ep_ext->stream.match_q, &req->recv.queue);
+                return;
+            }
+        }
+
+        req->recv.stream.length = req->recv.stream.offset;
+        ucs_trace_req("completing stream receive request %p (%p) count %zu, %s",
+                      req, req + 1, req->recv.stream.length,
+                      ucs_status_string(status));
+        ucp_request_complete(req, recv.stream.cb, status,
+                             req->recv.stream.length);
+        return;
+    }
+
+    rdesc = (ucp_recv_desc_t*)((ucp_stream_am_data_t*)rreq->recv.buffer - 1) - 1;
+
+    if (ucs_unlikely(status != UCS_OK)) {
+        ucs_free(rdesc);
+        ucp_stream_rndv_set_ep_failed(ep, status);
+        return;
+    }
+
+    if (ucs_unlikely(ep->flags & UCP_EP_FLAG_CLOSED)) {
+        ucs_trace_data("ep %p: stream is invalid", ep);
+        ucs_free(rdesc);
+        return;
+    }
+
+    /* Requests could be posted while the data was fetched */
+    offset = ucp_stream_rdata_process_expected(ep_ext, rreq->recv.buffer,
+                                               info->length);
+    if (offset == info->length) {
+        ucs_free(rdesc);
+        return;
+    }
+
+    rdesc->length         = info->length - offset;
+    rdesc->payload_offset = sizeof(*rdesc) + sizeof(ucp_stream_am_data_t) +
+                            offset;
+    rdesc->priv_length    = 0;
+    rdesc->flags          = UCP_RECV_DESC_FLAG_MALLOC;
+    ucp_stream_rdesc_enqueue(ep_ext, rdesc);
+
+    if (!ucp_stream_ep_is_queued(ep_ext) && (ep->flags & UCP_EP_FLAG_USED)) {
+        ucp_stream_ep_enqueue(ep_ext, ep->worker);
+    }
+}
+
+static UCS_F_ALWAYS_INLINE int
+ucp_stream_rndv_is_direct(ucp_ep_ext_proto_t *ep_ext, size_t length)
+{
+    ucp_request_t *req;
+
+    if (ucp_stream_ep_has_data(ep_ext) ||
+        ucs_queue_is_empty(&ep_ext->stream.match_q)) {
+        return 0;
+    }
+
+    req = ucs_queue_head_elem_non_empty(&ep_ext->stream.match_q, ucp_request_t,
+                                        recv.queue);
+    return UCP_DT_IS_CONTIG(req->recv.datatype) &&
+           ((req->recv.stream.offset + length) <= req->recv.length);
+}
+
+static ucs_status_t
+ucp_stream_rndv_rts_handler(void *am_arg, void *am_data, size_t am_length,
+                            unsigned am_flags)
+{
+    ucp_worker_h worker              = am_arg;
+    ucp_rndv_rts_hdr_t *rndv_rts_hdr = am_data;
+    ucp_ep_ext_proto_t *ep_ext;
+    ucp_recv_desc_t *rdesc;
+    ucp_request_t *rreq, *req;
+    ucp_ep_h ep;
+
+    ep     = ucp_worker_get_ep_by_ptr(worker, rndv_rts_hdr->sreq.ep_ptr);
+    ep_ext = ucp_ep_ext_proto(ep);
+
+    rreq = ucp_request_get(worker);
+    if (ucs_unlikely(rreq == NULL)) {
+        ucp_stream_rndv_set_ep_failed(ep, UCS_ERR_NO_MEMORY);
+        return UCS_OK;
+    }
+
+    rreq->flags                       = UCP_REQUEST_FLAG_RECV |
+                                        UCP_REQUEST_FLAG_CALLBACK |
+                                        UCP_REQUEST_FLAG_RELEASED;
+    rreq->recv.tag.cb                 = ucp_stream_rndv_recv_completed;
+    rreq->recv.tag.stream_ep          = ep;
+    rreq->recv.tag.stream_req         = NULL;
+    rreq->recv.worker                 = worker;
+    rreq->recv.datatype               = ucp_dt_make_contig(1);
+    rreq->recv.state.dt.contig.md_map = 0;
+
+    /* The sender does not send more stream data on this endpoint until the
+     * rendezvous is completed, so the data is fetched to the head request if
+     * there is no other data before it */
+    if (ucs_unlikely(ep->flags & UCP_EP_FLAG_CLOSED)) {
+        ucs_trace_data("ep %p: stream is invalid", ep);
+        rdesc = NULL;
+    } else if (ucp_stream_rndv_is_direct(ep_ext, rndv_rts_hdr->size)) {
+        req = ucs_queue_pull_elem_non_empty(&ep_ext->stream.match_q,
+                                            ucp_request_t, recv.queue);
+        ucs_trace_req("ep %p: fetching %zu stream bytes to request %p", ep,
+                      rndv_rts_hdr->size, req);
+        rreq->recv.tag.stream_req = req;
+        rreq->recv.buffer         = UCS_PTR_BYTE_OFFSET(req->recv.buffer,
+                                                        req->recv.stream.offset);
+        rreq->recv.length         = rndv_rts_hdr->size;
+        rreq->recv.mem_type       = req->recv.mem_type;
+        goto out;
+    } else if (ucs_unlikely(rndv_rts_hdr->size > UINT32_MAX)) {
+        /* does not fit into the length of a receive descriptor */
+        ucp_request_put(rreq);
+        ucp_stream_rndv_set_ep_failed(ep, UCS_ERR_EXCEEDS_LIMIT);
+        return UCS_OK;
+    } else {
+        rdesc = ucs_malloc(sizeof(*rdesc) + sizeof(ucp_stream_am_data_t) +
+                           rndv_rts_hdr->size, "ucp stream rndv desc");
+        if (ucs_unlikely(rdesc == NULL)) {
+            ucp_request_put(rreq);
+            ucp_stream_rndv_set_ep_failed(ep, UCS_ERR_NO_MEMORY);
+            return UCS_OK;
+        }
+    }
+
+    /* If the endpoint is closed, the rendezvous is completed as truncated to
+     * release the send request on the remote side */
+    rreq->recv.buffer   = (rdesc != NULL) ?
+                          UCS_PTR_BYTE_OFFSET(rdesc, sizeof(*rdesc) +
+                                              sizeof(ucp_stream_am_data_t)) :
+                          NULL;
+    rreq->recv.length   = (rdesc != NULL) ? rndv_rts_hdr->size : 0;
+    rreq->recv.mem_type = UCS_MEMORY_TYPE_HOST;
+
+out:
+    ucp_rndv_matched(worker, rreq, rndv_rts_hdr);
+    return UCS_OK;
+}
+
 static void ucp_stream_am_dump(ucp_worker_h worker, uct_am_trace_type_t type,
                                uint8_t id, const void *data, size_t length,
                                char *buffer, size_t max)
@@ -523,4 +795,8 @@ static void ucp_stream_am_dump(ucp_worker_h worker, uct_am_trace_type_t type,
 UCP_DEFINE_AM(UCP_FEATURE_STREAM, UCP_AM_ID_STREAM_DATA, ucp_stream_am_handler,
               ucp_stream_am_dump, 0);
 
+UCP_DEFINE_AM(UCP_FEATURE_STREAM, UCP_AM_ID_STREAM_RNDV_RTS,
+              ucp_stream_rndv_rts_handler, NULL, 0);
+
 UCP_DEFINE_AM_PROXY(UCP_AM_ID_STREAM_DATA);
+UCP_DEFINE_AM_PROXY(UCP_AM_ID_STREAM_RNDV_RTS);
@@ -14,6 +14,7 @@
 #include <ucp/core/ucp_context.h>
 #include <ucp/proto/proto_am.inl>
 #include <ucp/stream/stream.h>
+#include <ucp/tag/rndv.h>
 #include <ucp/dt/dt.h>
 #include <ucp/dt/dt.inl>
 
@@ -47,18 +48,80 @@ static void ucp_stream_send_req_init(ucp_request_t* req, ucp_ep_h ep,
                                 sizeof(req->send.msg_proto.tag));
 }
 
+static size_t ucp_stream_rndv_rts_pack(void *dest, void *arg)
+{
+    ucp_rndv_rts_hdr_t *rndv_rts_hdr = dest;
+    size_t packed_size;
+
+    packed_size = ucp_tag_rndv_rts_pack(dest, arg);
+
+    /* Stream data is not matched by tag, the receiver finds the endpoint by
+     * the ep_ptr field of the RTS */
+    rndv_rts_hdr->super.tag = 0;
+    return packed_size;
+}
+
+static ucs_status_t ucp_stream_progress_rndv_rts(uct_pending_req_t *self)
+{
+    ucp_request_t *sreq = ucs_container_of(self, ucp_request_t, send.uct);
+    size_t packed_rkey_size;
+
+    packed_rkey_size = ucp_ep_config(sreq->send.ep)->tag.rndv.rkey_size;
+    return ucp_do_am_single(self, UCP_AM_ID_STREAM_RNDV_RTS,
+                            ucp_stream_rndv_rts_pack,
+                            sizeof(ucp_rndv_rts_hdr_t) + packed_rkey_size);
+}
+
+static ucs_status_t ucp_stream_send_start_rndv(ucp_request_t *sreq)
+{
+    ucp_ep_h ep = sreq->send.ep;
+    ucs_status_t status;
+
+    ucp_trace_req(sreq, "start stream rndv to %s buffer %p length %zu",
+                  ucp_ep_peer_name(ep), sreq->send.buffer, sreq->send.length);
+    UCS_PROFILE_REQUEST_EVENT(sreq, "start_rndv", sreq->send.length);
+
+    /* The receiver fetches the data with the tag-matching rendezvous protocol,
+     * directly to the posted receive buffer if possible */
+    ucs_assert(sreq->send.lane == ucp_ep_get_am_lane(ep));
+    sreq->send.uct.func = ucp_stream_progress_rndv_rts;
+    status              = ucp_tag_rndv_reg_send_buffer(sreq);
+    if (status != UCS_OK) {
+        return status;
+    }
+
+    /* Following stream sends are queued until the rendezvous is completed, to
+     * keep the order of the stream data on the receiver */
+    sreq->flags |= UCP_REQUEST_FLAG_SEND_STREAM_RNDV;
+    ep->flags   |= UCP_EP_FLAG_STREAM_SEND_RNDV;
+    return UCS_OK;
+}
+
+static ucs_status_t ucp_stream_send_req_start(ucp_request_t *req, size_t count)
+{
+    ucp_ep_config_t *config = ucp_ep_config(req->send.ep);
+    size_t rndv_thresh      = config->stream.rndv_thresh;
+    size_t zcopy_thresh     = ucp_proto_get_zcopy_threshold(req, &config->am,
+                                                            count, rndv_thresh);
+    ssize_t max_short       = ucp_proto_get_short_max(req, &config->am);
+    ucs_status_t status;
+
+    status = ucp_request_send_start(req, max_short, zcopy_thresh, rndv_thresh,
+                                    count, &config->am, config->stream.proto);
+    if (status == UCS_ERR_NO_PROGRESS) {
+        ucs_assert(req->send.length >= rndv_thresh);
+        status = ucp_stream_send_start_rndv(req);
+    }
+
+    return status;
+}
+
 static UCS_F_ALWAYS_INLINE ucs_status_ptr_t
-ucp_stream_send_req(ucp_request_t *req, size_t count,
-                    const ucp_ep_msg_config_t* msg_config,
-                    ucp_send_callback_t cb, const ucp_request_send_proto_t *proto)
+ucp_stream_send_req(ucp_request_t *req, size_t count, ucp_send_callback_t cb)
 {
-    size_t zcopy_thresh = ucp_proto_get_zcopy_threshold(req, msg_config,
-                                                        count, SIZE_MAX);
-    ssize_t max_short   = ucp_proto_get_short_max(req, msg_config);
+    ucs_status_t status;
 
-    ucs_status_t status = ucp_request_send_start(req, max_short, zcopy_thresh,
-                                                 SIZE_MAX, count, msg_config,
-                                                 proto);
+    status = ucp_stream_send_req_start(req, count);
     if (status != UCS_OK) {
         return UCS_STATUS_PTR(status);
     }
@@ -110,6 +173,7 @@ UCS_PROFILE_FUNC(ucs_status_ptr_t, ucp_stream_send_nb,
     }
 
     if (ucs_likely(UCP_DT_IS_CONTIG(datatype)) &&
+        ucs_likely(!(ep->flags & UCP_EP_FLAG_STREAM_SEND_RNDV)) &&
         ucp_memory_type_cache_is_empty(ep->worker->context)) {
         length = ucp_contig_dt_length(datatype, count);
         if (ucs_likely((ssize_t)length <= ucp_ep_config(ep)->am.max_short)) {
@@ -131,14 +195,53 @@ UCS_PROFILE_FUNC(ucs_status_ptr_t, ucp_stream_send_nb,
 
     ucp_stream_send_req_init(req, ep, buffer, datatype, count, flags);
 
-    ret = ucp_stream_send_req(req, count, &ucp_ep_config(ep)->am, cb,
-                              ucp_ep_config(ep)->stream.proto);
+    if (ucs_unlikely(ep->flags & UCP_EP_FLAG_STREAM_SEND_RNDV)) {
+        /* Wait for the rendezvous send in progress */
+        req->send.stream.count = count;
+        ucs_queue_push(&ucp_ep_ext_proto(ep)->stream.send_q,
+                       &req->send.stream.queue);
+        ucp_request_set_callback(req, send.cb, cb)
+        ucs_trace_req("queued stream send request %p", req);
+        ret = req + 1;
+        goto out;
+    }
+
+    ret = ucp_stream_send_req(req, count, cb);
 
 out:
     UCP_WORKER_THREAD_CS_EXIT_CONDITIONAL(ep->worker);
     return ret;
 }
 
+void ucp_stream_send_resume(ucp_ep_h ep)
+{
+    ucp_ep_ext_proto_t *ep_ext = ucp_ep_ext_proto(ep);
+    ucp_request_t *req;
+    ucs_status_t status;
+
+    ep->flags &= ~UCP_EP_FLAG_STREAM_SEND_RNDV;
+    if (ep->flags & UCP_EP_FLAG_FAILED) {
+        /* queued sends are canceled by ucp_stream_ep_cleanup() */
+        return;
+    }
+
+    /* Start the queued sends, until one of them starts a rendezvous again */
+    while (!(ep->flags & UCP_EP_FLAG_STREAM_SEND_RNDV) &&
+           !ucs_queue_is_empty(&ep_ext->stream.send_q)) {
+        req    = ucs_queue_pull_elem_non_empty(&ep_ext->stream.send_q,
+                                               ucp_request_t,
+                                               send.stream.queue);
+        status = ucp_stream_send_req_start(req, req->send.stream.count);
+        if (status != UCS_OK) {
+            ucp_request_complete_send(req, status);
+            continue;
+        }
+
+        ucs_trace_req("starting queued stream send request %p", req);
+        ucp_request_send(req, 0);
+    }
+}
+
 static ucs_status_t ucp_stream_contig_am_short(uct_pending_req_t *self)
 {
     ucp_request_t  *req   = ucs_container_of(self, ucp_request_t, send.uct);
@@ -44,14 +44,18 @@ static UCS_F_ALWAYS_INLINE ucs_status_t
 ucp_eager_offload_handler(void *arg, void *data, size_t length,
                           unsigned tl_flags, uint16_t flags, ucp_tag_t recv_tag)
 {
-    ucp_worker_t *worker = arg;
+    ucp_worker_t *worker         = arg;
+    ucp_tag_match_shard_t *shard = ucp_tag_match_get_shard(&worker->tm,
+                                                           recv_tag);
     ucp_request_t *req;
     ucp_recv_desc_t *rdesc;
     ucp_tag_t *rdesc_hdr;
     ucs_status_t status;
 
-    req = ucp_tag_exp_search(&worker->tm, recv_tag);
+    ucp_tag_match_shard_lock(&worker->tm, shard);
+    req = ucp_tag_exp_search(shard, recv_tag);
     if (req != NULL) {
+        ucp_tag_match_shard_unlock(&worker->tm, shard);
         ucp_eager_expected_handler(worker, req, data, length, recv_tag, flags);
         req->recv.tag.info.length = length;
         status = ucp_request_recv_data_unpack(req, data, length, 0, 1);
@@ -64,8 +68,9 @@ ucp_eager_offload_handler(void *arg, void *data, size_t length,
         if (!UCS_STATUS_IS_ERR(status)) {
             rdesc_hdr  = (ucp_tag_t*)(rdesc + 1);
             *rdesc_hdr = recv_tag;
-            ucp_tag_unexp_recv(&worker->tm, rdesc, recv_tag);
+            ucp_tag_unexp_recv(shard, rdesc, recv_tag);
         }
+        ucp_tag_match_shard_unlock(&worker->tm, shard);
     }
 
     return status;
@@ -78,6 +83,7 @@ ucp_eager_tagged_handler(void *arg, void *data, size_t length, unsigned am_flags
     ucp_worker_h worker        = arg;
     ucp_eager_hdr_t *eager_hdr = data;
     ucp_eager_first_hdr_t *eagerf_hdr;
+    ucp_tag_match_shard_t *shard;
     ucp_recv_desc_t *rdesc;
     ucp_request_t *req;
     ucs_status_t status;
@@ -89,9 +95,12 @@ ucp_eager_tagged_handler(void *arg, void *data, size_t length, unsigned am_flags
 
     recv_tag = eager_hdr->super.tag;
     recv_len = length - hdr_len;
+    shard    = ucp_tag_match_get_shard(&worker->tm, recv_tag);
 
-    req = ucp_tag_exp_search(&worker->tm, recv_tag);
+    ucp_tag_match_shard_lock(&worker->tm, shard);
+    req = ucp_tag_exp_search(shard, recv_tag);
     if (req != NULL) {
+        ucp_tag_match_shard_unlock(&worker->tm, shard);
         ucp_eager_expected_handler(worker, req, data, recv_len, recv_tag, flags);
 
         if (flags & UCP_RECV_DESC_FLAG_EAGER_SYNC) {
@@ -123,8 +132,9 @@ ucp_eager_tagged_handler(void *arg, void *data, size_t length, unsigned am_flags
         status = ucp_recv_desc_init(worker, data, length, 0, am_flags, hdr_len,
                                     flags, priv_length, &rdesc);
         if (!UCS_STATUS_IS_ERR(status)) {
-            ucp_tag_unexp_recv(&worker->tm, rdesc, recv_tag);
+            ucp_tag_unexp_recv(shard, rdesc, recv_tag);
         }
+        ucp_tag_match_shard_unlock(&worker->tm, shard);
     }
 
     return status;
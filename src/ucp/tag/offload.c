@@ -25,7 +25,12 @@ void ucp_tag_offload_iface_activate(ucp_worker_iface_t *iface)
     ucp_worker_t *worker   = iface->worker;
     ucp_context_t *context = worker->context;
 
-    if (worker->tm.offload.iface == NULL) {
+    if (worker->tm.num_shards > 1) {
+        /* Offloaded receives would be matched by the transport outside of
+         * the shard locks, so keep matching all tags in software */
+        ucs_debug("tag offload is disabled on worker %p with %u tag matching "
+                  "shards", worker, worker->tm.num_shards);
+    } else if (worker->tm.offload.iface == NULL) {
         ucs_assert(worker->tm.offload.thresh       == SIZE_MAX);
         ucs_assert(worker->tm.offload.zcopy_thresh == SIZE_MAX);
         ucs_assert(worker->tm.offload.iface        == NULL);
@@ -81,10 +86,16 @@ UCS_PROFILE_FUNC_VOID(ucp_tag_offload_tag_consumed, (self),
                       uct_tag_context_t *self)
 {
     ucp_request_t *req = ucs_container_of(self, ucp_request_t, recv.uct_ctx);
-    ucs_queue_head_t *queue;
-
-    queue = &ucp_tag_exp_get_req_queue(&req->recv.worker->tm, req)->queue;
-    ucs_queue_remove(queue, &req->recv.queue);
+    ucp_tag_match_shard_t *shard;
+    ucp_request_queue_t *req_queue;
+
+    shard     = ucp_tag_match_get_shard(&req->recv.worker->tm,
+                                        req->recv.tag.tag);
+    req_queue = ucp_tag_exp_get_req_queue(shard, req);
+    ucs_queue_remove(&req_queue->queue, &req->recv.queue);
+    if (req_queue != &shard->expected.wildcard) {
+        --shard->expected.hash.count;
+    }
 }
 
 /* Message is scattered to user buffer by the transport, complete the request */
@@ -358,7 +369,9 @@ ucp_tag_offload_do_post(ucp_request_t *req)
 static UCS_F_ALWAYS_INLINE int
 ucp_tag_offload_post_sw_reqs(ucp_request_t *req, ucp_request_queue_t *req_queue)
 {
-    ucp_worker_t *worker = req->recv.worker;
+    ucp_worker_t *worker         = req->recv.worker;
+    ucp_tag_match_shard_t *shard = ucp_tag_match_get_shard(&worker->tm,
+                                                           req->recv.tag.tag);
     ucs_status_t status;
     ucp_request_t *req_exp;
     ucp_worker_iface_t *wiface;
@@ -399,7 +412,7 @@ ucp_tag_offload_post_sw_reqs(ucp_request_t *req, ucp_request_queue_t *req_queue)
             return 0;
         }
         --req_queue->sw_count;
-        --worker->tm.expected.sw_all_count;
+        --shard->expected.sw_all_count;
     }
 
     return 1;
@@ -408,8 +421,10 @@ ucp_tag_offload_post_sw_reqs(ucp_request_t *req, ucp_request_queue_t *req_queue)
 UCS_PROFILE_FUNC(int, ucp_tag_offload_post, (req, req_queue),
                  ucp_request_t *req, ucp_request_queue_t *req_queue)
 {
-    ucp_worker_t *worker   = req->recv.worker;
-    ucp_context_t *context = worker->context;
+    ucp_worker_t *worker         = req->recv.worker;
+    ucp_context_t *context       = worker->context;
+    ucp_tag_match_shard_t *shard = ucp_tag_match_get_shard(&worker->tm,
+                                                           req->recv.tag.tag);
 
     if (!UCP_DT_IS_CONTIG(req->recv.datatype)) {
         /* Non-contig buffers not supported yet. */
@@ -422,13 +437,13 @@ UCS_PROFILE_FUNC(int, ucp_tag_offload_post, (req, req_queue),
             /* Sender rank wildcard */
             UCP_WORKER_STAT_TAG_OFFLOAD(worker, BLOCK_WILDCARD);
             return 0;
-        } else if (worker->tm.expected.sw_all_count) {
+        } else if (shard->expected.sw_all_count) {
             /* There are some requests which must be completed in SW.
              * Do not post tags to HW until they are completed. */
             UCP_WORKER_STAT_TAG_OFFLOAD(worker, BLOCK_SW_PEND);
             return 0;
         }
-    } else if (worker->tm.expected.wildcard.sw_count ||
+    } else if (shard->expected.wildcard.sw_count ||
                (req_queue->sw_count && !ucp_tag_offload_post_sw_reqs(req, req_queue))) {
         /* There are some requests which must be completed in SW */
         UCP_WORKER_STAT_TAG_OFFLOAD(worker, BLOCK_SW_PEND);
@@ -561,7 +576,9 @@ ucs_status_t ucp_tag_offload_sw_rndv(uct_pending_req_t *self)
     packed_len   = ucp_tag_rndv_rts_pack(rndv_rts_hdr, req);
     ucs_assert((rndv_rts_hdr->address != 0) || !UCP_DT_IS_CONTIG(req->send.datatype) ||
                !ucp_rndv_is_get_zcopy(req->send.mem_type,
-                                      ep->worker->context->config.ext.rndv_mode));
+                                      ep->worker->context->config.ext.rndv_mode) ||
+               ucp_rndv_is_frag_reg(ep->worker->context, req->send.mem_type,
+                                    req->send.length));
     return uct_ep_tag_rndv_request(ep->uct_eps[req->send.lane],
                                    req->send.msg_proto.tag.tag,
                                    rndv_rts_hdr, packed_len, 0);
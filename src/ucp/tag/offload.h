@@ -83,8 +83,8 @@ void ucp_tag_offload_sync_send_ack(ucp_worker_h worker, uintptr_t ep_ptr,
 void ucp_tag_offload_iface_activate(ucp_worker_iface_t *wiface);
 
 static UCS_F_ALWAYS_INLINE void
-ucp_tag_offload_try_post(ucp_worker_t *worker, ucp_request_t *req,
-                         ucp_request_queue_t *req_queue)
+ucp_tag_offload_try_post(ucp_worker_t *worker, ucp_tag_match_shard_t *shard,
+                         ucp_request_t *req, ucp_request_queue_t *req_queue)
 {
     if (ucs_unlikely(req->recv.length >= worker->tm.offload.thresh)) {
         if (ucp_tag_offload_post(req, req_queue)) {
@@ -92,7 +92,7 @@ ucp_tag_offload_try_post(ucp_worker_t *worker, ucp_request_t *req,
         }
     }
 
-    ++worker->tm.expected.sw_all_count;
+    ++shard->expected.sw_all_count;
     ++req_queue->sw_count;
     req_queue->block_count += !!(req->flags & UCP_REQUEST_FLAG_BLOCK_OFFLOAD);
 }
@@ -22,17 +22,22 @@ ucp_tag_message_h ucp_tag_probe_nb(ucp_worker_h worker, ucp_tag_t tag,
                                    ucp_tag_recv_info_t *info)
 {
     ucp_context_h UCS_V_UNUSED context = worker->context;
+    ucp_tag_match_shard_t *shard;
     ucp_recv_desc_t *rdesc;
     uint16_t flags;
 
     UCP_CONTEXT_CHECK_FEATURE_FLAGS(worker->context, UCP_FEATURE_TAG,
                                     return NULL);
+    UCP_TAG_MATCH_CHECK_SHARD_MASK(&worker->tm, tag_mask, return NULL);
     UCP_WORKER_THREAD_CS_ENTER_CONDITIONAL(worker);
 
     ucs_trace_req("probe_nb tag %"PRIx64"/%"PRIx64" remove=%d", tag, tag_mask,
                   remove);
 
-    rdesc = ucp_tag_unexp_search(&worker->tm, tag, tag_mask, remove, "probe");
+    shard = ucp_tag_match_get_shard(&worker->tm, tag);
+    ucp_tag_match_shard_lock(&worker->tm, shard);
+    rdesc = ucp_tag_unexp_search(shard, tag, tag_mask, remove, "probe");
+    ucp_tag_match_shard_unlock(&worker->tm, shard);
     if (rdesc != NULL) {
         flags            = rdesc->flags;
         info->sender_tag = ucp_rdesc_get_tag(rdesc);
@@ -9,6 +9,7 @@
 #endif
 
 #include "rndv.h"
+#include "rndv_est.h"
 #include "tag_match.inl"
 #include "offload.h"
 
@@ -51,6 +52,22 @@ ucp_rndv_req_get_zcopy_rma_lane(ucp_request_t *rndv_req, ucp_lane_map_t ignore,
                                  rndv_req->send.rndv_get.rkey, ignore, uct_rkey_p);
 }
 
+static int ucp_rndv_is_send_get_zcopy(ucp_request_t *sreq)
+{
+    ucp_context_h context = sreq->send.ep->worker->context;
+
+    /* large host buffers are registered by fragments after the RTR, so the
+     * receiver is not asked to fetch them with get_zcopy. Also, the estimator
+     * may select put_zcopy scheme for the request. */
+    return UCP_DT_IS_CONTIG(sreq->send.datatype) &&
+           ucp_rndv_is_get_zcopy(sreq->send.mem_type,
+                                 context->config.ext.rndv_mode) &&
+           !ucp_rndv_is_frag_reg(context, sreq->send.mem_type,
+                                 sreq->send.length) &&
+           (!(sreq->flags & UCP_REQUEST_FLAG_RNDV_EST) ||
+            (sreq->send.rndv_est_proto == UCP_RNDV_EST_PROTO_RNDV_GET));
+}
+
 size_t ucp_tag_rndv_rts_pack(void *dest, void *arg)
 {
     ucp_request_t *sreq              = arg;   /* send request */
@@ -64,9 +81,7 @@ size_t ucp_tag_rndv_rts_pack(void *dest, void *arg)
     rndv_rts_hdr->size             = sreq->send.length;
 
     /* Pack remote keys (which can be empty list) */
-    if (UCP_DT_IS_CONTIG(sreq->send.datatype) &&
-        ucp_rndv_is_get_zcopy(sreq->send.mem_type,
-                              worker->context->config.ext.rndv_mode)) {
+    if (ucp_rndv_is_send_get_zcopy(sreq)) {
         /* pack rkey, ask target to do get_zcopy */
         rndv_rts_hdr->address = (uintptr_t)sreq->send.buffer;
         packed_rkey_size = ucp_rkey_pack_uct(worker->context,
@@ -160,9 +175,7 @@ ucs_status_t ucp_tag_rndv_reg_send_buffer(ucp_request_t *sreq)
     ucp_md_map_t md_map;
     ucs_status_t status;
 
-    if (UCP_DT_IS_CONTIG(sreq->send.datatype) &&
-        ucp_rndv_is_get_zcopy(sreq->send.mem_type,
-                              ep->worker->context->config.ext.rndv_mode)) {
+    if (ucp_rndv_is_send_get_zcopy(sreq)) {
 
         /* register a contiguous buffer for rma_get */
         md_map = ucp_ep_config(ep)->key.rma_bw_md_map;
@@ -200,6 +213,9 @@ ucs_status_t ucp_tag_send_start_rndv(ucp_request_t *sreq)
         status = ucp_tag_offload_start_rndv(sreq);
     } else {
         ucs_assert(sreq->send.lane == ucp_ep_get_am_lane(ep));
+        if (sreq->flags & UCP_REQUEST_FLAG_RNDV_EST) {
+            sreq->send.rndv_est_proto = ucp_rndv_est_rndv_proto(sreq);
+        }
         sreq->send.uct.func = ucp_proto_progress_rndv_rts;
         status              = ucp_tag_rndv_reg_send_buffer(sreq);
     }
@@ -835,12 +851,17 @@ ucs_status_t ucp_rndv_process_rts(void *arg, void *data, size_t length,
 {
     ucp_worker_h worker                = arg;
     ucp_rndv_rts_hdr_t *rndv_rts_hdr   = data;
+    ucp_tag_match_shard_t *shard;
     ucp_recv_desc_t *rdesc;
     ucp_request_t *rreq;
     ucs_status_t status;
 
-    rreq = ucp_tag_exp_search(&worker->tm, rndv_rts_hdr->super.tag);
+    shard = ucp_tag_match_get_shard(&worker->tm, rndv_rts_hdr->super.tag);
+
+    ucp_tag_match_shard_lock(&worker->tm, shard);
+    rreq = ucp_tag_exp_search(shard, rndv_rts_hdr->super.tag);
     if (rreq != NULL) {
+        ucp_tag_match_shard_unlock(&worker->tm, shard);
         ucp_rndv_matched(worker, rreq, rndv_rts_hdr);
 
         /* Cancel req in transport if it was offloaded, because it arrived
@@ -854,8 +875,9 @@ ucs_status_t ucp_rndv_process_rts(void *arg, void *data, size_t length,
                                     sizeof(*rndv_rts_hdr),
                                     UCP_RECV_DESC_FLAG_RNDV, 0, &rdesc);
         if (!UCS_STATUS_IS_ERR(status)) {
-            ucp_tag_unexp_recv(&worker->tm, rdesc, rndv_rts_hdr->super.tag);
+            ucp_tag_unexp_recv(shard, rdesc, rndv_rts_hdr->super.tag);
         }
+        ucp_tag_match_shard_unlock(&worker->tm, shard);
     }
 
     return status;
@@ -1041,10 +1063,18 @@ UCS_PROFILE_FUNC_VOID(ucp_rndv_frag_send_put_completion, (self, status),
 {
     ucp_request_t *freq = ucs_container_of(self, ucp_request_t, send.state.uct_comp);
     ucp_request_t *req  = freq->send.rndv_put.sreq;
+    ucp_request_t *sreq = req->send.rndv_put.sreq;
+    ucp_md_index_t md_index;
 
-    /* release memory descriptor */
+    /* release memory descriptor, or the registration of the fragment if it
+     * was not registered as a part of the send buffer */
     if (freq->send.mdesc) {
         ucs_mpool_put_inline((void *)freq->send.mdesc);
+    } else {
+        md_index = ucp_ep_md_index(freq->send.ep, freq->send.lane);
+        if (!(sreq->send.state.dt.dt.contig.md_map & UCS_BIT(md_index))) {
+            ucp_request_send_buffer_dereg(freq);
+        }
     }
 
     req->send.state.dt.offset += freq->send.length;
@@ -1177,10 +1207,17 @@ static ucs_status_t ucp_rndv_pipeline(ucp_request_t *sreq,
                                                                         offset);
             freq->send.datatype                   = ucp_dt_make_contig(1);
             freq->send.mem_type                   = UCS_MEMORY_TYPE_HOST;
-            freq->send.state.dt.dt.contig.memh[0] =
+            if (sreq->send.state.dt.dt.contig.md_map & UCS_BIT(md_index)) {
+                freq->send.state.dt.dt.contig.memh[0] =
                         ucp_memh_map2uct(sreq->send.state.dt.dt.contig.memh,
                                          sreq->send.state.dt.dt.contig.md_map, md_index);
-            freq->send.state.dt.dt.contig.md_map  = UCS_BIT(md_index);
+                freq->send.state.dt.dt.contig.md_map  = UCS_BIT(md_index);
+            } else {
+                /* the send buffer is not registered, so the fragment is
+                 * registered when it is sent, while the previous fragments are
+                 * in flight */
+                freq->send.state.dt.dt.contig.md_map  = 0;
+            }
             freq->send.length                     = length;
             freq->send.uct.func                   = ucp_rndv_progress_rma_put_zcopy;
             freq->send.rndv_put.sreq              = fsreq;
@@ -1326,7 +1363,9 @@ UCS_PROFILE_FUNC(ucs_status_t, ucp_rndv_rtr_handler,
         }
 
         is_pipeline_rndv = ((!UCP_MEM_IS_ACCESSIBLE_FROM_CPU(sreq->send.mem_type) ||
-                             (sreq->send.length != rndv_rtr_hdr->size)) &&
+                             (sreq->send.length != rndv_rtr_hdr->size) ||
+                             ucp_rndv_is_frag_reg(context, sreq->send.mem_type,
+                                                  sreq->send.length)) &&
                             (context->config.ext.rndv_mode != UCP_RNDV_MODE_PUT_ZCOPY));
 
         sreq->send.lane = ucp_rkey_find_rma_lane(ep->worker->context, ep_config,
@@ -1337,8 +1376,11 @@ UCS_PROFILE_FUNC(ucs_status_t, ucp_rndv_rtr_handler,
                                                  sreq->send.rndv_put.rkey, 0,
                                                  &sreq->send.rndv_put.uct_rkey);
         if (sreq->send.lane != UCP_NULL_LANE) {
+            sreq->send.rndv_est_proto = UCP_RNDV_EST_PROTO_RNDV_PUT;
+
             /*
-             * Try pipeline protocol for non-host memory, if PUT_ZCOPY protocol is
+             * Try pipeline protocol for non-host memory, or for host memory
+             * which is registered by fragments, if PUT_ZCOPY protocol is
              * not explicitly required. If pipeline is UNSUPPORTED, fallback to
              * PUT_ZCOPY anyway.
              */
@@ -1375,6 +1417,7 @@ UCS_PROFILE_FUNC(ucs_status_t, ucp_rndv_rtr_handler,
 
     /* switch to AM */
     sreq->send.msg_proto.tag.rreq_ptr = rndv_rtr_hdr->rreq_ptr;
+    sreq->send.rndv_est_proto         = UCP_RNDV_EST_PROTO_RNDV_AM;
 
     if (UCP_DT_IS_CONTIG(sreq->send.datatype) &&
         (sreq->send.length >=
@@ -1483,14 +1526,18 @@ static void ucp_rndv_dump(ucp_worker_h worker, uct_am_trace_type_t type,
 
 UCP_DEFINE_AM(UCP_FEATURE_TAG, UCP_AM_ID_RNDV_RTS, ucp_rndv_rts_handler,
               ucp_rndv_dump, 0);
-UCP_DEFINE_AM(UCP_FEATURE_TAG, UCP_AM_ID_RNDV_ATS, ucp_rndv_ats_handler,
-              ucp_rndv_dump, 0);
-UCP_DEFINE_AM(UCP_FEATURE_TAG, UCP_AM_ID_RNDV_ATP, ucp_rndv_atp_handler,
-              ucp_rndv_dump, 0);
-UCP_DEFINE_AM(UCP_FEATURE_TAG, UCP_AM_ID_RNDV_RTR, ucp_rndv_rtr_handler,
-              ucp_rndv_dump, 0);
-UCP_DEFINE_AM(UCP_FEATURE_TAG, UCP_AM_ID_RNDV_DATA, ucp_rndv_data_handler,
-              ucp_rndv_dump, 0);
+UCP_DEFINE_AM(UCP_FEATURE_TAG | UCP_FEATURE_AM | UCP_FEATURE_STREAM,
+              UCP_AM_ID_RNDV_ATS,
+              ucp_rndv_ats_handler, ucp_rndv_dump, 0);
+UCP_DEFINE_AM(UCP_FEATURE_TAG | UCP_FEATURE_AM | UCP_FEATURE_STREAM,
+              UCP_AM_ID_RNDV_ATP,
+              ucp_rndv_atp_handler, ucp_rndv_dump, 0);
+UCP_DEFINE_AM(UCP_FEATURE_TAG | UCP_FEATURE_AM | UCP_FEATURE_STREAM,
+              UCP_AM_ID_RNDV_RTR,
+              ucp_rndv_rtr_handler, ucp_rndv_dump, 0);
+UCP_DEFINE_AM(UCP_FEATURE_TAG | UCP_FEATURE_AM | UCP_FEATURE_STREAM,
+              UCP_AM_ID_RNDV_DATA,
+              ucp_rndv_data_handler, ucp_rndv_dump, 0);
 
 UCP_DEFINE_AM_PROXY(UCP_AM_ID_RNDV_RTS);
 UCP_DEFINE_AM_PROXY(UCP_AM_ID_RNDV_ATS);
@@ -69,4 +69,13 @@ static UCS_F_ALWAYS_INLINE int ucp_rndv_is_get_zcopy(ucs_memory_type_t mem_type,
               UCP_MEM_IS_ROCM(mem_type))));
 }
 
+static UCS_F_ALWAYS_INLINE int ucp_rndv_is_frag_reg(ucp_context_h context,
+                                                    ucs_memory_type_t mem_type,
+                                                    size_t length)
+{
+    return ((context->config.ext.rndv_mode == UCP_RNDV_MODE_AUTO) &&
+            UCP_MEM_IS_ACCESSIBLE_FROM_CPU(mem_type) &&
+            (length >= context->config.ext.rndv_frag_reg_thresh));
+}
+
 #endif
@@ -0,0 +1,378 @@
+/**
+ * Copyright (C) Mellanox Technologies Ltd. 2001-2020.  ALL RIGHTS RESERVED.
+ *
+ * See file LICENSE for terms.
+ */
+
+#ifdef HAVE_CONFIG_H
+#  include "config.h"
+#endif
+
+#include "rndv_est.h"
+
+#include <ucp/core/ucp_ep.h>
+#include <ucp/core/ucp_ep.inl>
+#include <ucp/core/ucp_worker.h>
+#include <ucp/core/ucp_context.h>
+#include <ucp/core/ucp_request.h>
+#include <ucs/arch/bitops.h>
+#include <ucs/debug/log.h>
+#include <ucs/debug/memtrack.h>
+#include <ucs/sys/string.h>
+#include <ucs/time/time.h>
+
+
+/* Every this number of sends, a send near the threshold uses the other
+ * protocol, so both protocols keep being measured */
+#define UCP_RNDV_EST_EXPLORE_INTERVAL  16
+
+/* Maximal distance, in buckets, of an exploring send from the threshold */
+#define UCP_RNDV_EST_EXPLORE_BUCKETS   2
+
+/* Minimal number of measurements of a protocol in a bucket to compare it */
+#define UCP_RNDV_EST_MIN_SAMPLES       4
+
+
+static const char *ucp_rndv_est_proto_names[] = {
+    [UCP_RNDV_EST_PROTO_EAGER]    = "eager",
+    [UCP_RNDV_EST_PROTO_RNDV_GET] = "rndv/get",
+    [UCP_RNDV_EST_PROTO_RNDV_PUT] = "rndv/put",
+    [UCP_RNDV_EST_PROTO_RNDV_AM]  = "rndv/am"
+};
+
+
+static UCS_F_ALWAYS_INLINE unsigned ucp_rndv_est_bucket(size_t length)
+{
+    return ucs_ilog2_or0(length);
+}
+
+static double ucp_rndv_est_bw(const ucp_rndv_est_t *est,
+                              ucp_rndv_est_proto_t proto, unsigned bucket)
+{
+    const ucp_rndv_est_entry_t *entry = &est->entries[proto][bucket];
+
+    if ((entry->count < UCP_RNDV_EST_MIN_SAMPLES) || (entry->time <= 0)) {
+        return 0;
+    }
+
+    return entry->bytes / entry->time;
+}
+
+static size_t ucp_rndv_est_bucket_thresh(unsigned bucket)
+{
+    return (bucket < (UCP_RNDV_EST_NUM_BUCKETS - 1)) ? UCS_BIT(bucket) :
+           SIZE_MAX;
+}
+
+static size_t ucp_rndv_est_adjust_thresh(const ucp_rndv_est_t *est,
+                                         size_t static_thresh, size_t new_thresh)
+{
+    /* Do not enable a rendezvous which is disabled on the configuration */
+    if (static_thresh == SIZE_MAX) {
+        return SIZE_MAX;
+    }
+
+    return ucs_max(new_thresh, est->min_thresh);
+}
+
+static void ucp_rndv_est_retune(ucp_context_h context, ucp_ep_config_t *config)
+{
+    ucp_rndv_est_t *est = config->tag.rndv.est;
+    size_t thresh       = 0;
+    double eager_bw, rndv_bw, get_bw, put_bw;
+    ucp_rndv_est_entry_t *entry;
+    ucp_rndv_est_proto_t proto;
+    int bucket;
+
+    if (context->config.ext.rndv_thresh == UCS_MEMUNITS_AUTO) {
+        /* The threshold is the smallest bucket from which rendezvous is faster
+         * than eager in all larger buckets with measurements of both */
+        for (bucket = UCP_RNDV_EST_NUM_BUCKETS - 1; bucket >= 0; --bucket) {
+            eager_bw = ucp_rndv_est_bw(est, UCP_RNDV_EST_PROTO_EAGER, bucket);
+            rndv_bw  = ucs_max(ucp_rndv_est_bw(est, UCP_RNDV_EST_PROTO_RNDV_GET,
+                                               bucket),
+                               ucs_max(ucp_rndv_est_bw(est,
+                                                       UCP_RNDV_EST_PROTO_RNDV_PUT,
+                                                       bucket),
+                                       ucp_rndv_est_bw(est,
+                                                       UCP_RNDV_EST_PROTO_RNDV_AM,
+                                                       bucket)));
+            if ((eager_bw == 0) || (rndv_bw == 0)) {
+                continue;
+            }
+
+            if (rndv_bw <= eager_bw) {
+                if (thresh == 0) {
+                    thresh = ucp_rndv_est_bucket_thresh(bucket + 1);
+                }
+                break;
+            }
+
+            thresh = ucp_rndv_est_bucket_thresh(bucket);
+        }
+
+        if (thresh != 0) {
+            config->tag.rndv.rma_thresh =
+                    ucp_rndv_est_adjust_thresh(est, est->static_rma_thresh,
+                                               thresh);
+            config->tag.rndv.am_thresh  =
+                    ucp_rndv_est_adjust_thresh(est, est->static_am_thresh,
+                                               thresh);
+        }
+    }
+
+    if (context->config.ext.rndv_mode == UCP_RNDV_MODE_AUTO) {
+        for (bucket = 0; bucket < UCP_RNDV_EST_NUM_BUCKETS; ++bucket) {
+            get_bw = ucp_rndv_est_bw(est, UCP_RNDV_EST_PROTO_RNDV_GET, bucket);
+            put_bw = ucp_rndv_est_bw(est, UCP_RNDV_EST_PROTO_RNDV_PUT, bucket);
+            if ((get_bw == 0) || (put_bw == 0)) {
+                continue;
+            }
+
+            if (put_bw > get_bw) {
+                est->put_buckets |= UCS_BIT(bucket);
+            } else {
+                est->put_buckets &= ~UCS_BIT(bucket);
+            }
+        }
+    }
+
+    /* Age the measurements */
+    for (proto = 0; proto < UCP_RNDV_EST_PROTO_LAST; ++proto) {
+        for (bucket = 0; bucket < UCP_RNDV_EST_NUM_BUCKETS; ++bucket) {
+            entry         = &est->entries[proto][bucket];
+            entry->count /= 2;
+            entry->bytes /= 2;
+            entry->time  /= 2;
+        }
+    }
+
+    ++est->num_retunes;
+    ucs_debug("ep_config %p: retuned rndv thresholds rma %zu am %zu put "
+              "buckets 0x%"PRIx64, config, config->tag.rndv.rma_thresh,
+              config->tag.rndv.am_thresh, est->put_buckets);
+}
+
+ucs_status_t ucp_rndv_est_init(ucp_worker_h worker, ucp_ep_config_t *config)
+{
+    ucp_context_h context = worker->context;
+    ucp_lane_index_t lanes[2];
+    uct_iface_attr_t *iface_attr;
+    ucp_rsc_index_t rsc_index;
+    ucp_rndv_est_t *est;
+    int i;
+
+    config->tag.rndv.est = NULL;
+
+    /* Tag offload has its own rendezvous protocol, which is not measured */
+    if (!context->config.ext.rndv_adaptive ||
+        !(context->config.features & UCP_FEATURE_TAG) ||
+        (config->key.am_lane == UCP_NULL_LANE) ||
+        (config->key.lanes[config->key.am_lane].rsc_index == UCP_NULL_RESOURCE) ||
+        ucp_ep_is_tag_offload_enabled(config) ||
+        !ucp_ep_config_test_rndv_support(config)) {
+        return UCS_OK;
+    }
+
+    est = ucs_calloc(1, sizeof(*est), "ucp_rndv_est");
+    if (est == NULL) {
+        ucs_error("failed to allocate rendezvous estimator");
+        return UCS_ERR_NO_MEMORY;
+    }
+
+    /* Rendezvous must not be used below the minimal zcopy size of the lanes */
+    lanes[0]        = config->key.am_lane;
+    lanes[1]        = config->key.rma_bw_lanes[0];
+    est->min_thresh = 1;
+    for (i = 0; i < ucs_static_array_size(lanes); ++i) {
+        if (lanes[i] == UCP_NULL_LANE) {
+            continue;
+        }
+
+        rsc_index = config->key.lanes[lanes[i]].rsc_index;
+        if (rsc_index == UCP_NULL_RESOURCE) {
+            continue;
+        }
+
+        iface_attr      = ucp_worker_iface_get_attr(worker, rsc_index);
+        est->min_thresh = ucs_max(est->min_thresh,
+                                  ucs_max(iface_attr->cap.am.min_zcopy,
+                                          iface_attr->cap.get.min_zcopy));
+    }
+
+    est->static_rma_thresh = config->tag.rndv.rma_thresh;
+    est->static_am_thresh  = config->tag.rndv.am_thresh;
+    config->tag.rndv.est   = est;
+    return UCS_OK;
+}
+
+void ucp_rndv_est_cleanup(ucp_ep_config_t *config)
+{
+    ucs_free(config->tag.rndv.est);
+}
+
+void ucp_rndv_est_send_start(ucp_request_t *req, size_t *rndv_rma_thresh,
+                             size_t *rndv_am_thresh)
+{
+    ucp_rndv_est_t *est = ucp_ep_config(req->send.ep)->tag.rndv.est;
+    size_t length       = req->send.length;
+    size_t thresh       = ucs_min(*rndv_rma_thresh, *rndv_am_thresh);
+    unsigned bucket, thresh_bucket;
+
+    if (length == 0) {
+        return;
+    }
+
+    req->flags              |= UCP_REQUEST_FLAG_RNDV_EST;
+    req->send.rndv_est_start = ucs_get_time();
+    req->send.rndv_est_proto = UCP_RNDV_EST_PROTO_EAGER;
+
+    if ((++est->num_sends % UCP_RNDV_EST_EXPLORE_INTERVAL) != 0) {
+        return;
+    }
+
+    bucket        = ucp_rndv_est_bucket(length);
+    thresh_bucket = ucp_rndv_est_bucket(thresh);
+    if ((bucket + UCP_RNDV_EST_EXPLORE_BUCKETS < thresh_bucket) ||
+        (bucket > thresh_bucket + UCP_RNDV_EST_EXPLORE_BUCKETS)) {
+        return;
+    }
+
+    if (length >= thresh) {
+        /* explore eager protocol, it is measured only by synchronous sends */
+        if (!(req->flags & UCP_REQUEST_FLAG_SYNC)) {
+            return;
+        }
+
+        *rndv_rma_thresh = SIZE_MAX;
+        *rndv_am_thresh  = SIZE_MAX;
+    } else if (length >= est->min_thresh) {
+        /* explore rendezvous protocol */
+        if (*rndv_rma_thresh != SIZE_MAX) {
+            *rndv_rma_thresh = length;
+        }
+        if (*rndv_am_thresh != SIZE_MAX) {
+            *rndv_am_thresh = length;
+        }
+    }
+}
+
+ucp_rndv_est_proto_t ucp_rndv_est_rndv_proto(ucp_request_t *sreq)
+{
+    ucp_rndv_est_t *est = ucp_ep_config(sreq->send.ep)->tag.rndv.est;
+    int is_put;
+
+    if ((est == NULL) ||
+        (sreq->send.ep->worker->context->config.ext.rndv_mode !=
+         UCP_RNDV_MODE_AUTO)) {
+        return UCP_RNDV_EST_PROTO_RNDV_GET;
+    }
+
+    is_put = !!(est->put_buckets &
+                UCS_BIT(ucp_rndv_est_bucket(sreq->send.length)));
+
+    /* explore the other scheme */
+    if ((++est->num_rndv % UCP_RNDV_EST_EXPLORE_INTERVAL) == 0) {
+        is_put = !is_put;
+    }
+
+    return is_put ? UCP_RNDV_EST_PROTO_RNDV_PUT : UCP_RNDV_EST_PROTO_RNDV_GET;
+}
+
+void ucp_rndv_est_send_completed(ucp_request_t *req)
+{
+    ucp_ep_config_t *config = ucp_ep_config(req->send.ep);
+    ucp_context_h context   = req->send.ep->worker->context;
+    ucp_rndv_est_t *est     = config->tag.rndv.est;
+    ucp_rndv_est_entry_t *entry;
+    ucs_time_t elapsed;
+
+    /* The endpoint could be reconfigured after the send was started */
+    if (est == NULL) {
+        return;
+    }
+
+    /* A rendezvous send completes after the remote side acknowledged the data,
+     * while an eager send completes when the data was sent out, unless it is
+     * synchronous. Compare only sends which waited for the remote side. */
+    if ((req->send.rndv_est_proto == UCP_RNDV_EST_PROTO_EAGER) &&
+        !(req->flags & UCP_REQUEST_FLAG_SYNC)) {
+        return;
+    }
+
+    elapsed = ucs_get_time() - req->send.rndv_est_start;
+
+    ucs_assert(req->send.rndv_est_proto < UCP_RNDV_EST_PROTO_LAST);
+    entry = &est->entries[req->send.rndv_est_proto]
+                         [ucp_rndv_est_bucket(req->send.length)];
+    ++entry->count;
+    entry->bytes += req->send.length;
+    entry->time  += ucs_time_to_sec(elapsed);
+
+    if (++est->num_samples >= context->config.ext.rndv_adaptive_interval) {
+        ucp_rndv_est_retune(context, config);
+        est->num_samples = 0;
+    }
+}
+
+static void ucp_rndv_est_print_config(const ucp_ep_config_t *config,
+                                      unsigned cfg_index, FILE *stream)
+{
+    const ucp_rndv_est_t *est = config->tag.rndv.est;
+    char min_str[16], max_str[16];
+    const ucp_rndv_est_entry_t *entry;
+    ucp_rndv_est_proto_t proto;
+    unsigned bucket;
+    int has_data;
+
+    fprintf(stream, "#\n");
+    fprintf(stream, "# rndv estimator of ep_config[%u]: rma thresh %zu, "
+            "am thresh %zu, retuned %u times\n", cfg_index,
+            config->tag.rndv.rma_thresh, config->tag.rndv.am_thresh,
+            est->num_retunes);
+    fprintf(stream, "# %19s", "size");
+    for (proto = 0; proto < UCP_RNDV_EST_PROTO_LAST; ++proto) {
+        fprintf(stream, " %22s", ucp_rndv_est_proto_names[proto]);
+    }
+    fprintf(stream, "\n");
+
+    for (bucket = 0; bucket < UCP_RNDV_EST_NUM_BUCKETS; ++bucket) {
+        has_data = 0;
+        for (proto = 0; proto < UCP_RNDV_EST_PROTO_LAST; ++proto) {
+            has_data |= (est->entries[proto][bucket].count > 0);
+        }
+        if (!has_data) {
+            continue;
+        }
+
+        ucs_memunits_to_str(UCS_BIT(bucket), min_str, sizeof(min_str));
+        ucs_memunits_to_str(ucp_rndv_est_bucket_thresh(bucket + 1), max_str,
+                            sizeof(max_str));
+        fprintf(stream, "# %c[%8s..%8s)",
+                (est->put_buckets & UCS_BIT(bucket)) ? 'p' : ' ',
+                min_str, max_str);
+        for (proto = 0; proto < UCP_RNDV_EST_PROTO_LAST; ++proto) {
+            entry = &est->entries[proto][bucket];
+            if ((entry->count == 0) || (entry->time <= 0)) {
+                fprintf(stream, " %22s", "-");
+            } else {
+                fprintf(stream, " %9.2fMB/s %7.2fus",
+                        entry->bytes / entry->time / UCS_MBYTE,
+                        entry->time * UCS_USEC_PER_SEC / entry->count);
+            }
+        }
+        fprintf(stream, "\n");
+    }
+}
+
+void ucp_rndv_est_print(ucp_worker_h worker, FILE *stream)
+{
+    unsigned cfg_index;
+
+    for (cfg_index = 0; cfg_index < worker->ep_config_count; ++cfg_index) {
+        if (worker->ep_config[cfg_index].tag.rndv.est != NULL) {
+            ucp_rndv_est_print_config(&worker->ep_config[cfg_index], cfg_index,
+                                      stream);
+        }
+    }
+}
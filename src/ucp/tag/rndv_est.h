@@ -0,0 +1,83 @@
+/**
+ * Copyright (C) Mellanox Technologies Ltd. 2001-2020.  ALL RIGHTS RESERVED.
+ *
+ * See file LICENSE for terms.
+ */
+
+#ifndef UCP_RNDV_EST_H_
+#define UCP_RNDV_EST_H_
+
+#include <ucp/core/ucp_types.h>
+#include <ucs/type/status.h>
+#include <stdint.h>
+#include <stdio.h>
+
+
+struct ucp_ep_config;
+
+
+/* Number of message size buckets, the bucket of a message is log2 of its size */
+#define UCP_RNDV_EST_NUM_BUCKETS   64
+
+
+/**
+ * Protocols measured by the rendezvous estimator
+ */
+typedef enum {
+    UCP_RNDV_EST_PROTO_EAGER,    /* Eager protocol */
+    UCP_RNDV_EST_PROTO_RNDV_GET, /* Rendezvous, receiver fetches the data */
+    UCP_RNDV_EST_PROTO_RNDV_PUT, /* Rendezvous, sender writes the data */
+    UCP_RNDV_EST_PROTO_RNDV_AM,  /* Rendezvous, sender sends active messages */
+    UCP_RNDV_EST_PROTO_LAST
+} ucp_rndv_est_proto_t;
+
+
+/**
+ * Measurements of a protocol in a message size bucket
+ */
+typedef struct {
+    uint64_t                  count;  /* Number of completed sends */
+    double                    bytes;  /* Total size of completed sends */
+    double                    time;   /* Total time of completed sends, seconds */
+} ucp_rndv_est_entry_t;
+
+
+/**
+ * Online estimator of eager and rendezvous protocols performance, for an
+ * endpoint configuration. The measurements are aged by half on every retune,
+ * so the thresholds follow the recent behavior. Eager sends are measured only
+ * if they are synchronous, since they complete after the remote side received
+ * the data like rendezvous sends do.
+ */
+typedef struct ucp_rndv_est {
+    ucp_rndv_est_entry_t      entries[UCP_RNDV_EST_PROTO_LAST]
+                                     [UCP_RNDV_EST_NUM_BUCKETS];
+    uint64_t                  put_buckets;  /* Buckets in which rendezvous put
+                                               is faster than get */
+    size_t                    min_thresh;   /* Minimal rendezvous threshold */
+    size_t                    static_rma_thresh; /* Configured RMA threshold */
+    size_t                    static_am_thresh;  /* Configured AM threshold */
+    unsigned                  num_sends;    /* Counter of measured sends */
+    unsigned                  num_rndv;     /* Counter of rendezvous sends */
+    unsigned                  num_samples;  /* Completed sends since the last
+                                               retune */
+    unsigned                  num_retunes;  /* How many times the thresholds
+                                               were retuned */
+} ucp_rndv_est_t;
+
+
+ucs_status_t ucp_rndv_est_init(ucp_worker_h worker,
+                               struct ucp_ep_config *config);
+
+void ucp_rndv_est_cleanup(struct ucp_ep_config *config);
+
+void ucp_rndv_est_send_start(ucp_request_t *req, size_t *rndv_rma_thresh,
+                             size_t *rndv_am_thresh);
+
+ucp_rndv_est_proto_t ucp_rndv_est_rndv_proto(ucp_request_t *sreq);
+
+void ucp_rndv_est_send_completed(ucp_request_t *req);
+
+void ucp_rndv_est_print(ucp_worker_h worker, FILE *stream);
+
+#endif
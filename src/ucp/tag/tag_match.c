@@ -12,37 +12,208 @@
 #include <ucp/tag/offload.h>
 
 
-ucs_status_t ucp_tag_match_init(ucp_tag_match_t *tm)
+typedef void (*ucp_tag_match_hash_bucket_init_func_t)(void *bucket);
+
+
+static void ucp_tag_exp_bucket_init(void *bucket)
 {
-    size_t hash_size, bucket;
+    ucp_request_queue_t *req_queue = bucket;
 
-    hash_size = ucs_roundup_pow2(UCP_TAG_MATCH_HASH_SIZE);
+    req_queue->sw_count    = 0;
+    req_queue->block_count = 0;
+    ucs_queue_head_init(&req_queue->queue);
+}
 
-    tm->expected.sn           = 0;
-    tm->expected.sw_all_count = 0;
-    ucs_queue_head_init(&tm->expected.wildcard.queue);
-    ucs_list_head_init(&tm->unexpected.all);
+static void ucp_tag_unexp_bucket_init(void *bucket)
+{
+    ucs_list_head_init((ucs_list_link_t*)bucket);
+}
+
+static ucs_status_t
+ucp_tag_match_hash_add_segment(ucp_tag_match_hash_t *hash, size_t bucket_size,
+                               ucp_tag_match_hash_bucket_init_func_t init_func,
+                               const char *name)
+{
+    void **segments;
+    void *segment;
+    size_t bucket;
 
-    tm->expected.hash = ucs_malloc(sizeof(*tm->expected.hash) * hash_size,
-                                   "ucp_tm_exp_hash");
-    if (tm->expected.hash == NULL) {
+    segments = ucs_realloc(hash->segments,
+                           sizeof(*segments) * (hash->num_segments + 1), name);
+    if (segments == NULL) {
         return UCS_ERR_NO_MEMORY;
     }
 
-    tm->unexpected.hash = ucs_malloc(sizeof(*tm->unexpected.hash) * hash_size,
+    hash->segments = segments;
+
+    segment = ucs_malloc(bucket_size * UCP_TAG_MATCH_HASH_SEG_SIZE, name);
+    if (segment == NULL) {
+        return UCS_ERR_NO_MEMORY;
+    }
+
+    for (bucket = 0; bucket < UCP_TAG_MATCH_HASH_SEG_SIZE; ++bucket) {
+        init_func(UCS_PTR_BYTE_OFFSET(segment, bucket * bucket_size));
+    }
+
+    hash->segments[hash->num_segments++] = segment;
+    return UCS_OK;
+}
+
+static ucs_status_t
+ucp_tag_match_hash_init(ucp_tag_match_hash_t *hash, size_t bucket_size,
+                        ucp_tag_match_hash_bucket_init_func_t init_func,
+                        const char *name)
+{
+    hash->segments     = NULL;
+    hash->num_segments = 0;
+    hash->level_size   = UCP_TAG_MATCH_HASH_SEG_SIZE;
+    hash->split        = 0;
+    hash->count        = 0;
+
+    return ucp_tag_match_hash_add_segment(hash, bucket_size, init_func, name);
+}
+
+static void ucp_tag_match_hash_cleanup(ucp_tag_match_hash_t *hash)
+{
+    while (hash->num_segments > 0) {
+        ucs_free(hash->segments[--hash->num_segments]);
+    }
+    ucs_free(hash->segments);
+}
+
+/*
+ * Advance the split pointer of the hash by one bucket, allocating a new segment
+ * if needed. After this, the entries of bucket 'old_index' should be
+ * redistributed between 'old_index' and 'new_index' according to the updated
+ * hash function.
+ *
+ * @return Nonzero if a bucket was split.
+ */
+static int
+ucp_tag_match_hash_split_start(ucp_tag_match_hash_t *hash, size_t bucket_size,
+                               ucp_tag_match_hash_bucket_init_func_t init_func,
+                               const char *name, size_t *old_index_p,
+                               size_t *new_index_p)
+{
+    size_t new_index = hash->level_size + hash->split;
+    ucs_status_t status;
+
+    if ((new_index >> UCP_TAG_MATCH_HASH_SEG_SHIFT) >= hash->num_segments) {
+        status = ucp_tag_match_hash_add_segment(hash, bucket_size, init_func,
+                                                name);
+        if (status != UCS_OK) {
+            /* Not fatal, the hash will just have a higher load */
+            ucs_debug("failed to grow %s to %zu buckets: %s", name,
+                      new_index + 1, ucs_status_string(status));
+            return 0;
+        }
+    }
+
+    *old_index_p = hash->split;
+    *new_index_p = new_index;
+
+    if (++hash->split == hash->level_size) {
+        hash->level_size <<= 1;
+        hash->split       = 0;
+    }
+
+    return 1;
+}
+
+static ucs_status_t
+ucp_tag_match_shard_init(ucp_tag_match_shard_t *shard, uint64_t tag_sender_mask)
+{
+    ucs_status_t status;
+
+    status = ucs_spinlock_init(&shard->lock, 0);
+    if (status != UCS_OK) {
+        return status;
+    }
+
+    shard->expected.sn           = 0;
+    shard->expected.sw_all_count = 0;
+    ucs_queue_head_init(&shard->expected.wildcard.queue);
+    ucs_list_head_init(&shard->unexpected.all);
+
+    status = ucp_tag_match_hash_init(&shard->expected.hash,
+                                     sizeof(ucp_request_queue_t),
+                                     ucp_tag_exp_bucket_init,
+                                     "ucp_tm_exp_hash");
+    if (status != UCS_OK) {
+        goto err_cleanup_exp_hash;
+    }
+
+    status = ucp_tag_match_hash_init(&shard->unexpected.hash,
+                                     sizeof(ucs_list_link_t),
+                                     ucp_tag_unexp_bucket_init,
                                      "ucp_tm_unexp_hash");
-    if (tm->unexpected.hash == NULL) {
-        ucs_free(tm->expected.hash);
+    if (status != UCS_OK) {
+        goto err_cleanup_unexp_hash;
+    }
+
+    /* Receives which match any sender use a mask without the sender bits */
+    shard->unexpected.wild_mask    = (tag_sender_mask != 0) ? ~tag_sender_mask :
+                                     UCP_TAG_MATCH_WILD_INDEX_MASK;
+    shard->unexpected.wild_indexed = 0;
+    status = ucp_tag_match_hash_init(&shard->unexpected.wild_hash,
+                                     sizeof(ucs_list_link_t),
+                                     ucp_tag_unexp_bucket_init,
+                                     "ucp_tm_unexp_wild_hash");
+    if (status != UCS_OK) {
+        goto err_cleanup_unexp_wild_hash;
+    }
+
+    return UCS_OK;
+
+err_cleanup_unexp_wild_hash:
+    ucp_tag_match_hash_cleanup(&shard->unexpected.wild_hash);
+err_cleanup_unexp_hash:
+    ucp_tag_match_hash_cleanup(&shard->unexpected.hash);
+err_cleanup_exp_hash:
+    ucp_tag_match_hash_cleanup(&shard->expected.hash);
+    ucs_spinlock_destroy(&shard->lock);
+    return status;
+}
+
+static void ucp_tag_match_shard_cleanup(ucp_tag_match_shard_t *shard)
+{
+    ucp_tag_match_hash_cleanup(&shard->unexpected.wild_hash);
+    ucp_tag_match_hash_cleanup(&shard->unexpected.hash);
+    ucp_tag_match_hash_cleanup(&shard->expected.hash);
+    ucs_spinlock_destroy(&shard->lock);
+}
+
+ucs_status_t ucp_tag_match_init(ucp_tag_match_t *tm, uint64_t tag_sender_mask,
+                                ucp_tag_t shard_mask, unsigned num_shards,
+                                int is_mt)
+{
+    ucs_status_t status;
+    unsigned i;
+
+    if (shard_mask == 0) {
+        num_shards = 1;
+    }
+
+    ucs_assert(ucs_is_pow2(num_shards));
+
+    tm->shards = ucs_calloc(num_shards, sizeof(*tm->shards), "ucp_tm_shards");
+    if (tm->shards == NULL) {
         return UCS_ERR_NO_MEMORY;
     }
 
-    for (bucket = 0; bucket < hash_size; ++bucket) {
-        tm->expected.hash[bucket].sw_count    = 0;
-        tm->expected.hash[bucket].block_count = 0;
-        ucs_queue_head_init(&tm->expected.hash[bucket].queue);
-        ucs_list_head_init(&tm->unexpected.hash[bucket]);
+    for (i = 0; i < num_shards; ++i) {
+        status = ucp_tag_match_shard_init(&tm->shards[i], tag_sender_mask);
+        if (status != UCS_OK) {
+            goto err_cleanup_shards;
+        }
     }
 
+    tm->num_shards  = num_shards;
+    tm->shard_shift = 64 - ucs_ilog2(num_shards);
+    tm->shard_mask  = (num_shards > 1) ? shard_mask : 0;
+    tm->flags       = (is_mt && (num_shards > 1)) ?
+                      UCP_TAG_MATCH_FLAG_MT_SHARDS : 0;
+
     kh_init_inplace(ucp_tag_frag_hash, &tm->frag_hash);
     ucs_queue_head_init(&tm->offload.sync_reqs);
     kh_init_inplace(ucp_tag_offload_hash, &tm->offload.tag_hash);
@@ -50,35 +221,157 @@ ucs_status_t ucp_tag_match_init(ucp_tag_match_t *tm)
     tm->offload.zcopy_thresh = SIZE_MAX;
     tm->offload.iface        = NULL;
     return UCS_OK;
+
+err_cleanup_shards:
+    while (i > 0) {
+        ucp_tag_match_shard_cleanup(&tm->shards[--i]);
+    }
+    ucs_free(tm->shards);
+    return status;
 }
 
 void ucp_tag_match_cleanup(ucp_tag_match_t *tm)
 {
+    unsigned i;
+
     kh_destroy_inplace(ucp_tag_offload_hash, &tm->offload.tag_hash);
     kh_destroy_inplace(ucp_tag_frag_hash, &tm->frag_hash);
-    ucs_free(tm->unexpected.hash);
-    ucs_free(tm->expected.hash);
+    for (i = 0; i < tm->num_shards; ++i) {
+        ucp_tag_match_shard_cleanup(&tm->shards[i]);
+    }
+    ucs_free(tm->shards);
+}
+
+void ucp_tag_exp_hash_split(ucp_tag_match_shard_t *shard)
+{
+    ucp_tag_match_hash_t *hash = &shard->expected.hash;
+    ucp_request_queue_t *old_queue, *new_queue;
+    size_t old_index, new_index;
+    ucs_queue_head_t queue;
+    ucp_request_t *req;
+
+    if (!ucp_tag_match_hash_split_start(hash, sizeof(ucp_request_queue_t),
+                                        ucp_tag_exp_bucket_init,
+                                        "ucp_tm_exp_hash", &old_index,
+                                        &new_index)) {
+        return;
+    }
+
+    old_queue = ucp_tag_match_hash_bucket(hash, ucp_request_queue_t, old_index);
+    new_queue = ucp_tag_match_hash_bucket(hash, ucp_request_queue_t, new_index);
+
+    /* Both resulting queues preserve the original order, so they remain
+     * sorted by sequence number, as required by ucp_tag_exp_search_all() */
+    ucs_queue_head_init(&queue);
+    ucs_queue_splice(&queue, &old_queue->queue);
+    ucs_queue_for_each_extract(req, &queue, recv.queue, 1) {
+        if (ucp_tag_match_hash_index(hash, req->recv.tag.tag) == old_index) {
+            ucs_queue_push(&old_queue->queue, &req->recv.queue);
+            continue;
+        }
+
+        ucs_assert(ucp_tag_match_hash_index(hash, req->recv.tag.tag) ==
+                   new_index);
+        ucs_queue_push(&new_queue->queue, &req->recv.queue);
+        if (!(req->flags & UCP_REQUEST_FLAG_OFFLOADED)) {
+            --old_queue->sw_count;
+            ++new_queue->sw_count;
+            if (req->flags & UCP_REQUEST_FLAG_BLOCK_OFFLOAD) {
+                --old_queue->block_count;
+                ++new_queue->block_count;
+            }
+        }
+    }
+}
+
+void ucp_tag_unexp_hash_split(ucp_tag_match_hash_t *hash, int i_list,
+                              ucp_tag_t key_mask)
+{
+    ucs_list_link_t *old_list, *new_list;
+    ucp_recv_desc_t *rdesc, *tmp;
+    size_t old_index, new_index;
+    ucp_tag_t key;
+
+    if (!ucp_tag_match_hash_split_start(hash, sizeof(ucs_list_link_t),
+                                        ucp_tag_unexp_bucket_init,
+                                        "ucp_tm_unexp_hash", &old_index,
+                                        &new_index)) {
+        return;
+    }
+
+    old_list = ucp_tag_match_hash_bucket(hash, ucs_list_link_t, old_index);
+    new_list = ucp_tag_match_hash_bucket(hash, ucs_list_link_t, new_index);
+
+    ucs_list_for_each_safe(rdesc, tmp, old_list, tag_list[i_list]) {
+        key = ucp_rdesc_get_tag(rdesc) & key_mask;
+        if (ucp_tag_match_hash_index(hash, key) == new_index) {
+            ucs_list_del(&rdesc->tag_list[i_list]);
+            ucs_list_add_tail(new_list, &rdesc->tag_list[i_list]);
+        }
+    }
+}
+
+void ucp_tag_unexp_wild_index_build(ucp_tag_match_shard_t *shard)
+{
+    ucp_tag_match_hash_t *wild_hash = &shard->unexpected.wild_hash;
+    ucp_recv_desc_t *rdesc;
+
+    ucs_assert(!shard->unexpected.wild_indexed);
+    ucs_assert(wild_hash->count == 0);
+
+    /* Keep the arrival order in every wild list */
+    ucs_list_for_each(rdesc, &shard->unexpected.all,
+                      tag_list[UCP_RDESC_ALL_LIST]) {
+        ucs_list_add_tail(ucp_tag_unexp_get_wild_list_for_tag(
+                                  shard, ucp_rdesc_get_tag(rdesc)),
+                          &rdesc->tag_list[UCP_RDESC_WILD_LIST]);
+        ++wild_hash->count;
+        if (ucp_tag_match_hash_is_overloaded(wild_hash)) {
+            ucp_tag_unexp_hash_split(wild_hash, UCP_RDESC_WILD_LIST,
+                                     shard->unexpected.wild_mask);
+        }
+    }
+
+    ucs_debug("shard %p: built wild index of %zu unexpected tags", shard,
+              wild_hash->count);
+    shard->unexpected.wild_indexed = 1;
 }
 
 int ucp_tag_unexp_is_empty(ucp_tag_match_t *tm)
 {
-    return ucs_list_is_empty(&tm->unexpected.all);
+    unsigned i;
+
+    for (i = 0; i < tm->num_shards; ++i) {
+        if (!ucs_list_is_empty(&tm->shards[i].unexpected.all)) {
+            return 0;
+        }
+    }
+
+    return 1;
 }
 
 int ucp_tag_exp_remove(ucp_tag_match_t *tm, ucp_request_t *req)
 {
-    ucp_request_queue_t *req_queue = ucp_tag_exp_get_req_queue(tm, req);
+    ucp_tag_match_shard_t *shard = ucp_tag_match_get_shard(tm,
+                                                           req->recv.tag.tag);
+    ucp_request_queue_t *req_queue;
     ucs_queue_iter_t iter;
     ucp_request_t *qreq;
 
+    ucp_tag_match_shard_lock(tm, shard);
+
+    req_queue = ucp_tag_exp_get_req_queue(shard, req);
     ucs_queue_for_each_safe(qreq, iter, &req_queue->queue, recv.queue) {
         if (qreq == req) {
             ucp_tag_offload_try_cancel(req->recv.worker, req, 0);
-            ucp_tag_exp_delete(req, tm, req_queue, iter);
+            ucp_tag_exp_delete(req, shard, req_queue, iter);
+            ucp_tag_match_shard_unlock(tm, shard);
             return 1;
         }
     }
 
+    ucp_tag_match_shard_unlock(tm, shard);
+
     ucs_assert(!(req->flags & UCP_REQUEST_FLAG_COMPLETED));
     ucs_trace_req("can't remove req %p (already matched)", req);
 
@@ -92,8 +385,8 @@ static inline uint64_t ucp_tag_exp_req_seq(ucs_queue_iter_t iter)
 }
 
 ucp_request_t*
-ucp_tag_exp_search_all(ucp_tag_match_t *tm, ucp_request_queue_t *req_queue,
-                       ucp_tag_t tag)
+ucp_tag_exp_search_all(ucp_tag_match_shard_t *shard,
+                       ucp_request_queue_t *req_queue, ucp_tag_t tag)
 {
     ucs_queue_head_t *hash_queue = &req_queue->queue;
     ucp_request_queue_t *queue;
@@ -102,10 +395,10 @@ ucp_tag_exp_search_all(ucp_tag_match_t *tm, ucp_request_queue_t *req_queue,
     ucp_request_t *req;
 
     *hash_queue->ptail                 = NULL;
-    *tm->expected.wildcard.queue.ptail = NULL;
+    *shard->expected.wildcard.queue.ptail = NULL;
 
     hash_iter = ucs_queue_iter_begin(hash_queue);
-    wild_iter = ucs_queue_iter_begin(&tm->expected.wildcard.queue);
+    wild_iter = ucs_queue_iter_begin(&shard->expected.wildcard.queue);
 
     hash_sn = ucp_tag_exp_req_seq(hash_iter);
     wild_sn = ucp_tag_exp_req_seq(wild_iter);
@@ -118,13 +411,13 @@ ucp_tag_exp_search_all(ucp_tag_match_t *tm, ucp_request_queue_t *req_queue,
         } else {
             iter  = &wild_iter;
             sn_p  = &wild_sn;
-            queue = &tm->expected.wildcard;
+            queue = &shard->expected.wildcard;
         }
 
         req = ucs_container_of(**iter, ucp_request_t, recv.queue);
         if (ucp_tag_is_match(tag, req->recv.tag.tag, req->recv.tag.tag_mask)) {
             ucs_trace_req("matched received tag %"PRIx64" to req %p", tag, req);
-            ucp_tag_exp_delete(req, tm, queue, *iter);
+            ucp_tag_exp_delete(req, shard, queue, *iter);
             return req;
         }
 
@@ -135,7 +428,7 @@ ucp_tag_exp_search_all(ucp_tag_match_t *tm, ucp_request_queue_t *req_queue,
     ucs_assertv((hash_sn == ULONG_MAX) && (wild_sn == ULONG_MAX),
                 "hash_seq=%lu wild_seq=%lu", hash_sn, wild_sn);
     ucs_assert(ucs_queue_iter_end(hash_queue, hash_iter));
-    ucs_assert(ucs_queue_iter_end(&tm->expected.wildcard.queue, wild_iter));
+    ucs_assert(ucs_queue_iter_end(&shard->expected.wildcard.queue, wild_iter));
     return NULL;
 }
 
@@ -13,10 +13,34 @@
 #include <ucs/datastruct/khash.h>
 #include <ucs/sys/compiler_def.h>
 #include <ucs/stats/stats.h>
+#include <ucs/type/spinlock.h>
 
 
 #define UCP_TAG_MASK_FULL     0xffffffffffffffffUL  /* All 1-s */
 
+/* Expected and unexpected tag hash tables are using linear hashing: when the
+ * average number of entries per bucket exceeds UCP_TAG_MATCH_HASH_MAX_LOAD,
+ * a single bucket is split in two, so the table grows gradually without a
+ * full rehash. Buckets are allocated in segments and never move in memory. */
+#define UCP_TAG_MATCH_HASH_SEG_SHIFT  10   /* log2 of buckets per segment */
+#define UCP_TAG_MATCH_HASH_SEG_SIZE   UCS_BIT(UCP_TAG_MATCH_HASH_SEG_SHIFT)
+#define UCP_TAG_MATCH_HASH_MAX_LOAD   2
+
+/* Default mask of the tag bits which index unexpected messages for wildcard
+ * receives, if the tag sender mask is not set */
+#define UCP_TAG_MATCH_WILD_INDEX_MASK 0xffffffff00000000UL
+
+
+/**
+ * Tag-matching context flags
+ */
+enum {
+    UCP_TAG_MATCH_FLAG_MT_SHARDS = UCS_BIT(0) /**< Each shard is protected by
+                                                   its own lock, and may be
+                                                   accessed without the worker
+                                                   lock */
+};
+
 
 KHASH_INIT(ucp_tag_offload_hash, ucp_tag_t, ucp_worker_iface_t *, 1,
            kh_int64_hash_func, kh_int64_hash_equal);
@@ -42,6 +66,21 @@ typedef struct {
 } ucp_request_queue_t;
 
 
+/**
+ * Tag hash table, which is resized by linear hashing. A bucket index is
+ * calculated using 'level_size' buckets, or twice that for buckets which
+ * were already split in the current round.
+ */
+typedef struct {
+    void                  **segments;     /* Array of bucket segments */
+    unsigned              num_segments;   /* Number of allocated segments */
+    size_t                level_size;     /* Number of buckets at the start of
+                                             the current round, power of 2 */
+    size_t                split;          /* Next bucket to split */
+    size_t                count;          /* Number of entries in the hash */
+} ucp_tag_match_hash_t;
+
+
 /**
  * Hash table entry for tag message fragments
  */
@@ -56,14 +95,20 @@ KHASH_INIT(ucp_tag_frag_hash, uint64_t, ucp_tag_frag_match_t, 1,
 
 
 /**
- * Tag-matching context
+ * Tag-matching shard: expected and unexpected queues of the tags which have the
+ * same value of the shard mask bits. A message can only be matched by receives
+ * from the same shard, so different shards can be matched concurrently.
  */
-typedef struct ucp_tag_match {
+typedef struct ucp_tag_match_shard {
+
+    /* Lock, used if UCP_TAG_MATCH_FLAG_MT_SHARDS is set */
+    ucs_spinlock_t            lock;
 
     /* Expected queue */
     struct {
         ucp_request_queue_t   wildcard;   /* Expected wildcard requests */
-        ucp_request_queue_t   *hash;      /* Hash table of expected non-wild tags */
+        ucp_tag_match_hash_t  hash;       /* Hash table of expected non-wild tags,
+                                             bucket is ucp_request_queue_t */
         uint64_t              sn;
         unsigned              sw_all_count; /* Number of all expected requests which
                                                are not posted to offload */
@@ -72,9 +117,35 @@ typedef struct ucp_tag_match {
     /* Unexpected queue */
     struct {
         ucs_list_link_t       all;        /* Linked list of all tags */
-        ucs_list_link_t       *hash;      /* Hash table of unexpected tags */
+        ucp_tag_match_hash_t  hash;       /* Hash table of unexpected tags,
+                                             bucket is ucs_list_link_t */
+        ucp_tag_t             wild_mask;  /* Tag bits used as the key of
+                                             'wild_hash' */
+        ucp_tag_match_hash_t  wild_hash;  /* Hash table of unexpected tags by
+                                             'wild_mask' bits, to search for
+                                             receives with a partial tag mask
+                                             which includes these bits */
+        int                   wild_indexed; /* Whether 'wild_hash' is built, done
+                                               on the first receive which can
+                                               use it */
     } unexpected;
 
+} ucp_tag_match_shard_t;
+
+
+/**
+ * Tag-matching context
+ */
+typedef struct ucp_tag_match {
+
+    /* Matching shards */
+    ucp_tag_match_shard_t     *shards;     /* Array of shards */
+    unsigned                  num_shards;  /* Number of shards, power of 2 */
+    unsigned                  shard_shift; /* Shift of the tag hash value which
+                                              selects the shard */
+    ucp_tag_t                 shard_mask;  /* Tag bits which select the shard */
+    unsigned                  flags;       /* UCP_TAG_MATCH_FLAG_xx */
+
     /* Hash for fragment assembly, the key is a globally unique tag message id */
     khash_t(ucp_tag_frag_hash) frag_hash;
 
@@ -101,17 +172,26 @@ typedef struct ucp_tag_match {
 } ucp_tag_match_t;
 
 
-ucs_status_t ucp_tag_match_init(ucp_tag_match_t *tm);
+ucs_status_t ucp_tag_match_init(ucp_tag_match_t *tm, uint64_t tag_sender_mask,
+                                ucp_tag_t shard_mask, unsigned num_shards,
+                                int is_mt);
 
 void ucp_tag_match_cleanup(ucp_tag_match_t *tm);
 
 int ucp_tag_exp_remove(ucp_tag_match_t *tm, ucp_request_t *req);
 
+void ucp_tag_exp_hash_split(ucp_tag_match_shard_t *shard);
+
+void ucp_tag_unexp_hash_split(ucp_tag_match_hash_t *hash, int i_list,
+                              ucp_tag_t key_mask);
+
+void ucp_tag_unexp_wild_index_build(ucp_tag_match_shard_t *shard);
+
 int ucp_tag_unexp_is_empty(ucp_tag_match_t *tm);
 
 ucp_request_t*
-ucp_tag_exp_search_all(ucp_tag_match_t *tm, ucp_request_queue_t *req_queue,
-                       ucp_tag_t tag);
+ucp_tag_exp_search_all(ucp_tag_match_shard_t *shard,
+                       ucp_request_queue_t *req_queue, ucp_tag_t tag);
 
 void ucp_tag_frag_list_process_queue(ucp_tag_match_t *tm, ucp_request_t *req,
                                      uint64_t msg_id
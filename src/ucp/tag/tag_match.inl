@@ -20,11 +20,6 @@
 #include <inttypes.h>
 
 
-/* Hash size is a prime number just below 1024. Prime number for even distribution,
- * and small enough to fit L1 cache. */
-#define UCP_TAG_MATCH_HASH_SIZE     1021
-
-
 static UCS_F_ALWAYS_INLINE
 int ucp_tag_is_specific_source(ucp_context_t *context, ucp_tag_t tag_mask)
 {
@@ -44,82 +39,181 @@ int ucp_tag_is_match(ucp_tag_t tag, ucp_tag_t exp_tag, ucp_tag_t tag_mask)
 static UCS_F_ALWAYS_INLINE size_t
 ucp_tag_match_calc_hash(ucp_tag_t tag)
 {
-    /* Compute two 32-bit modulo and combine their result */
-    return ((uint32_t)tag % UCP_TAG_MATCH_HASH_SIZE) ^
-           ((uint32_t)(tag >> 32) % UCP_TAG_MATCH_HASH_SIZE);
+    /* Mix all bits of the tag into the low bits, which select the bucket
+     * (64-bit finalizer of MurmurHash3) */
+    tag ^= tag >> 33;
+    tag *= 0xff51afd7ed558ccdul;
+    tag ^= tag >> 33;
+    tag *= 0xc4ceb9fe1a85ec53ul;
+    tag ^= tag >> 33;
+    return tag;
+}
+
+static UCS_F_ALWAYS_INLINE size_t
+ucp_tag_match_hash_index(const ucp_tag_match_hash_t *hash, ucp_tag_t tag)
+{
+    size_t hash_value = ucp_tag_match_calc_hash(tag);
+    size_t index      = hash_value & (hash->level_size - 1);
+
+    if (index < hash->split) {
+        /* The bucket was already split in this round */
+        index = hash_value & ((hash->level_size << 1) - 1);
+    }
+
+    return index;
+}
+
+static UCS_F_ALWAYS_INLINE size_t
+ucp_tag_match_hash_num_buckets(const ucp_tag_match_hash_t *hash)
+{
+    return hash->level_size + hash->split;
+}
+
+#define ucp_tag_match_hash_bucket(_hash, _type, _index) \
+    (((_type*)(_hash)->segments[(_index) >> UCP_TAG_MATCH_HASH_SEG_SHIFT]) + \
+     ((_index) & (UCP_TAG_MATCH_HASH_SEG_SIZE - 1)))
+
+static UCS_F_ALWAYS_INLINE int
+ucp_tag_match_hash_is_overloaded(const ucp_tag_match_hash_t *hash)
+{
+    return hash->count > (UCP_TAG_MATCH_HASH_MAX_LOAD *
+                          ucp_tag_match_hash_num_buckets(hash));
+}
+
+static UCS_F_ALWAYS_INLINE ucp_tag_match_shard_t*
+ucp_tag_match_get_shard(ucp_tag_match_t *tm, ucp_tag_t tag)
+{
+    if (ucs_likely(tm->num_shards == 1)) {
+        return tm->shards;
+    }
+
+    /* Use the high bits of the hash value, since the low bits select the
+     * bucket inside the shard */
+    return &tm->shards[ucp_tag_match_calc_hash(tag & tm->shard_mask) >>
+                       tm->shard_shift];
+}
+
+/* Whether all tags which match this mask belong to the same shard */
+static UCS_F_ALWAYS_INLINE int
+ucp_tag_match_is_shard_mask(ucp_tag_match_t *tm, ucp_tag_t tag_mask)
+{
+    return (tag_mask & tm->shard_mask) == tm->shard_mask;
+}
+
+#define UCP_TAG_MATCH_CHECK_SHARD_MASK(_tm, _tag_mask, _action) \
+    do { \
+        if (ENABLE_PARAMS_CHECK && \
+            ucs_unlikely(!ucp_tag_match_is_shard_mask(_tm, _tag_mask))) { \
+            ucs_error("tag mask 0x%"PRIx64" does not include the tag shard " \
+                      "mask 0x%"PRIx64, (ucp_tag_t)(_tag_mask), \
+                      (_tm)->shard_mask); \
+            _action; \
+        } \
+    } while (0)
+
+static UCS_F_ALWAYS_INLINE void
+ucp_tag_match_shard_lock(ucp_tag_match_t *tm, ucp_tag_match_shard_t *shard)
+{
+    if (tm->flags & UCP_TAG_MATCH_FLAG_MT_SHARDS) {
+        ucs_spin_lock(&shard->lock);
+    }
+}
+
+static UCS_F_ALWAYS_INLINE void
+ucp_tag_match_shard_unlock(ucp_tag_match_t *tm, ucp_tag_match_shard_t *shard)
+{
+    if (tm->flags & UCP_TAG_MATCH_FLAG_MT_SHARDS) {
+        ucs_spin_unlock(&shard->lock);
+    }
 }
 
 static UCS_F_ALWAYS_INLINE ucp_request_queue_t*
-ucp_tag_exp_get_queue_for_tag(ucp_tag_match_t *tm, ucp_tag_t tag)
+ucp_tag_exp_get_queue_for_tag(ucp_tag_match_shard_t *shard, ucp_tag_t tag)
 {
-    return &tm->expected.hash[ucp_tag_match_calc_hash(tag)];
+    ucp_tag_match_hash_t *hash = &shard->expected.hash;
+
+    return ucp_tag_match_hash_bucket(hash, ucp_request_queue_t,
+                                     ucp_tag_match_hash_index(hash, tag));
 }
 
 static UCS_F_ALWAYS_INLINE ucp_request_queue_t*
-ucp_tag_exp_get_queue(ucp_tag_match_t *tm, ucp_tag_t tag, ucp_tag_t tag_mask)
+ucp_tag_exp_get_queue(ucp_tag_match_shard_t *shard, ucp_tag_t tag,
+                      ucp_tag_t tag_mask)
 {
     if (tag_mask == UCP_TAG_MASK_FULL) {
-        return ucp_tag_exp_get_queue_for_tag(tm, tag);
+        return ucp_tag_exp_get_queue_for_tag(shard, tag);
     } else {
-        return &tm->expected.wildcard;
+        return &shard->expected.wildcard;
     }
 }
 
 static UCS_F_ALWAYS_INLINE ucp_request_queue_t*
-ucp_tag_exp_get_req_queue(ucp_tag_match_t *tm, ucp_request_t *req)
+ucp_tag_exp_get_req_queue(ucp_tag_match_shard_t *shard, ucp_request_t *req)
 {
-    return ucp_tag_exp_get_queue(tm, req->recv.tag.tag, req->recv.tag.tag_mask);
+    return ucp_tag_exp_get_queue(shard, req->recv.tag.tag,
+                                 req->recv.tag.tag_mask);
 }
 
 static UCS_F_ALWAYS_INLINE void
-ucp_tag_exp_push(ucp_tag_match_t *tm, ucp_request_queue_t *req_queue,
+ucp_tag_exp_push(ucp_tag_match_shard_t *shard, ucp_request_queue_t *req_queue,
                  ucp_request_t *req)
 {
-    req->recv.tag.sn = tm->expected.sn++;
+    req->recv.tag.sn = shard->expected.sn++;
     ucs_queue_push(&req_queue->queue, &req->recv.queue);
+
+    if (req_queue != &shard->expected.wildcard) {
+        ++shard->expected.hash.count;
+        if (ucs_unlikely(ucp_tag_match_hash_is_overloaded(
+                                &shard->expected.hash))) {
+            ucp_tag_exp_hash_split(shard);
+        }
+    }
 }
 
 static UCS_F_ALWAYS_INLINE void
-ucp_tag_exp_add(ucp_tag_match_t *tm, ucp_request_t *req)
+ucp_tag_exp_add(ucp_tag_match_shard_t *shard, ucp_request_t *req)
 {
-    ucp_tag_exp_push(tm, ucp_tag_exp_get_req_queue(tm, req), req);
+    ucp_tag_exp_push(shard, ucp_tag_exp_get_req_queue(shard, req), req);
 }
 
 static UCS_F_ALWAYS_INLINE void
-ucp_tag_exp_delete(ucp_request_t *req, ucp_tag_match_t *tm,
+ucp_tag_exp_delete(ucp_request_t *req, ucp_tag_match_shard_t *shard,
                    ucp_request_queue_t *req_queue, ucs_queue_iter_t iter)
 {
     if (!(req->flags & UCP_REQUEST_FLAG_OFFLOADED)) {
-        --tm->expected.sw_all_count;
+        --shard->expected.sw_all_count;
         --req_queue->sw_count;
         if (req->flags & UCP_REQUEST_FLAG_BLOCK_OFFLOAD) {
             --req_queue->block_count;
         }
     }
+    if (req_queue != &shard->expected.wildcard) {
+        --shard->expected.hash.count;
+    }
     ucs_queue_del_iter(&req_queue->queue, iter);
 }
 
 static UCS_F_ALWAYS_INLINE ucp_request_t *
-ucp_tag_exp_search(ucp_tag_match_t *tm, ucp_tag_t tag)
+ucp_tag_exp_search(ucp_tag_match_shard_t *shard, ucp_tag_t tag)
 {
     ucp_request_queue_t *req_queue;
     ucs_queue_iter_t iter;
     ucp_request_t *req;
 
-    if (ucs_unlikely(!ucs_queue_is_empty(&tm->expected.wildcard.queue))) {
-        req_queue = ucp_tag_exp_get_queue_for_tag(tm, tag);
-        return ucp_tag_exp_search_all(tm, req_queue, tag);
+    if (ucs_unlikely(!ucs_queue_is_empty(&shard->expected.wildcard.queue))) {
+        req_queue = ucp_tag_exp_get_queue_for_tag(shard, tag);
+        return ucp_tag_exp_search_all(shard, req_queue, tag);
     }
 
     /* fast path - wildcard queue is empty, search only the specific queue */
-    req_queue = ucp_tag_exp_get_queue_for_tag(tm, tag);
+    req_queue = ucp_tag_exp_get_queue_for_tag(shard, tag);
     ucs_queue_for_each_safe(req, iter, &req_queue->queue, recv.queue) {
         req = ucs_container_of(*iter, ucp_request_t, recv.queue);
         ucs_trace_data("checking req %p tag %"PRIx64"/%"PRIx64" with tag %"PRIx64,
                        req, req->recv.tag.tag, req->recv.tag.tag_mask, tag);
         if (ucp_tag_is_match(tag, req->recv.tag.tag, req->recv.tag.tag_mask)) {
             ucs_trace_req("matched received tag %"PRIx64" to req %p", tag, req);
-            ucp_tag_exp_delete(req, tm, req_queue, iter);
+            ucp_tag_exp_delete(req, shard, req_queue, iter);
             return req;
         }
     }
@@ -132,29 +226,79 @@ static UCS_F_ALWAYS_INLINE ucp_tag_t ucp_rdesc_get_tag(ucp_recv_desc_t *rdesc)
 }
 
 static UCS_F_ALWAYS_INLINE ucs_list_link_t*
-ucp_tag_unexp_get_list_for_tag(ucp_tag_match_t *tm, ucp_tag_t tag)
+ucp_tag_unexp_get_list_for_tag(ucp_tag_match_shard_t *shard, ucp_tag_t tag)
+{
+    ucp_tag_match_hash_t *hash = &shard->unexpected.hash;
+
+    return ucp_tag_match_hash_bucket(hash, ucs_list_link_t,
+                                     ucp_tag_match_hash_index(hash, tag));
+}
+
+static UCS_F_ALWAYS_INLINE ucs_list_link_t*
+ucp_tag_unexp_get_wild_list_for_tag(ucp_tag_match_shard_t *shard, ucp_tag_t tag)
+{
+    ucp_tag_match_hash_t *wild_hash = &shard->unexpected.wild_hash;
+    size_t index;
+
+    index = ucp_tag_match_hash_index(wild_hash,
+                                     tag & shard->unexpected.wild_mask);
+    return ucp_tag_match_hash_bucket(wild_hash, ucs_list_link_t, index);
+}
+
+/* Whether a receive with this tag mask can be searched in the wild hash */
+static UCS_F_ALWAYS_INLINE int
+ucp_tag_unexp_is_wild_indexed(ucp_tag_match_shard_t *shard, ucp_tag_t tag_mask)
 {
-    return &tm->unexpected.hash[ucp_tag_match_calc_hash(tag)];
+    return (tag_mask & shard->unexpected.wild_mask) ==
+           shard->unexpected.wild_mask;
 }
 
 static UCS_F_ALWAYS_INLINE void
-ucp_tag_unexp_remove(ucp_recv_desc_t *rdesc)
+ucp_tag_unexp_remove(ucp_tag_match_shard_t *shard, ucp_recv_desc_t *rdesc)
 {
+    --shard->unexpected.hash.count;
     ucs_list_del(&rdesc->tag_list[UCP_RDESC_HASH_LIST]);
     ucs_list_del(&rdesc->tag_list[UCP_RDESC_ALL_LIST] );
+    if (ucs_unlikely(shard->unexpected.wild_indexed)) {
+        --shard->unexpected.wild_hash.count;
+        ucs_list_del(&rdesc->tag_list[UCP_RDESC_WILD_LIST]);
+    }
 }
 
 static UCS_F_ALWAYS_INLINE void
-ucp_tag_unexp_recv(ucp_tag_match_t *tm, ucp_recv_desc_t *rdesc, ucp_tag_t tag)
+ucp_tag_unexp_recv(ucp_tag_match_shard_t *shard, ucp_recv_desc_t *rdesc,
+                   ucp_tag_t tag)
 {
     ucs_list_link_t *hash_list;
 
-    hash_list = ucp_tag_unexp_get_list_for_tag(tm, tag);
-    ucs_list_add_tail(hash_list,           &rdesc->tag_list[UCP_RDESC_HASH_LIST]);
-    ucs_list_add_tail(&tm->unexpected.all, &rdesc->tag_list[UCP_RDESC_ALL_LIST]);
+    hash_list = ucp_tag_unexp_get_list_for_tag(shard, tag);
+    ucs_list_add_tail(hash_list,              &rdesc->tag_list[UCP_RDESC_HASH_LIST]);
+    ucs_list_add_tail(&shard->unexpected.all, &rdesc->tag_list[UCP_RDESC_ALL_LIST]);
 
     ucs_trace_req("unexp "UCP_RECV_DESC_FMT" tag %"PRIx64,
                   UCP_RECV_DESC_ARG(rdesc), tag);
+
+    ++shard->unexpected.hash.count;
+    if (ucs_unlikely(ucp_tag_match_hash_is_overloaded(
+                                &shard->unexpected.hash))) {
+        ucp_tag_unexp_hash_split(&shard->unexpected.hash, UCP_RDESC_HASH_LIST,
+                                 UCP_TAG_MASK_FULL);
+    }
+
+    /* The wild index is maintained only after a wildcard receive was posted */
+    if (ucs_likely(!shard->unexpected.wild_indexed)) {
+        return;
+    }
+
+    ucs_list_add_tail(ucp_tag_unexp_get_wild_list_for_tag(shard, tag),
+                      &rdesc->tag_list[UCP_RDESC_WILD_LIST]);
+    ++shard->unexpected.wild_hash.count;
+    if (ucs_unlikely(ucp_tag_match_hash_is_overloaded(
+                                &shard->unexpected.wild_hash))) {
+        ucp_tag_unexp_hash_split(&shard->unexpected.wild_hash,
+                                 UCP_RDESC_WILD_LIST,
+                                 shard->unexpected.wild_mask);
+    }
 }
 
 static UCS_F_ALWAYS_INLINE ucp_recv_desc_t*
@@ -168,26 +312,37 @@ ucp_tag_unexp_list_next(ucp_recv_desc_t *rdesc, int i_list)
  * otherwise return NULL
  */
 static UCS_F_ALWAYS_INLINE ucp_recv_desc_t*
-ucp_tag_unexp_search(ucp_tag_match_t *tm, ucp_tag_t tag, uint64_t tag_mask,
-                     int remove, const char *title)
+ucp_tag_unexp_search(ucp_tag_match_shard_t *shard, ucp_tag_t tag,
+                     uint64_t tag_mask, int remove, const char *title)
 {
     ucp_recv_desc_t *rdesc;
     ucs_list_link_t *list;
     int i_list;
 
     /* fast check of global unexpected queue */
-    if (ucs_list_is_empty(&tm->unexpected.all)) {
+    if (ucs_list_is_empty(&shard->unexpected.all)) {
         return NULL;
     }
 
     if (tag_mask == UCP_TAG_MASK_FULL) {
-        list = ucp_tag_unexp_get_list_for_tag(tm, tag);
+        list = ucp_tag_unexp_get_list_for_tag(shard, tag);
         if (ucs_list_is_empty(list)) {
             return NULL;
         }
         i_list = UCP_RDESC_HASH_LIST;
+    } else if (ucp_tag_unexp_is_wild_indexed(shard, tag_mask)) {
+        if (ucs_unlikely(!shard->unexpected.wild_indexed)) {
+            ucp_tag_unexp_wild_index_build(shard);
+        }
+
+        /* all tags which can match are in the same list of the wild hash */
+        list = ucp_tag_unexp_get_wild_list_for_tag(shard, tag);
+        if (ucs_list_is_empty(list)) {
+            return NULL;
+        }
+        i_list = UCP_RDESC_WILD_LIST;
     } else {
-        list   = &tm->unexpected.all;
+        list   = &shard->unexpected.all;
         i_list = UCP_RDESC_ALL_LIST;
     }
 
@@ -202,7 +357,7 @@ ucp_tag_unexp_search(ucp_tag_match_t *tm, ucp_tag_t tag, uint64_t tag_mask,
                           "%s tag %"PRIx64"/%"PRIx64, UCP_RECV_DESC_ARG(rdesc),
                           title, tag, tag_mask);
             if (remove) {
-                ucp_tag_unexp_remove(rdesc);
+                ucp_tag_unexp_remove(shard, rdesc);
             }
             return rdesc;
         }
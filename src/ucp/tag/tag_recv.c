@@ -42,6 +42,7 @@ ucp_tag_recv_common(ucp_worker_h worker, void *buffer, size_t count,
 {
     unsigned common_flags = UCP_REQUEST_FLAG_RECV | UCP_REQUEST_FLAG_EXPECTED;
     ucp_eager_first_hdr_t *eagerf_hdr;
+    ucp_tag_match_shard_t *shard;
     ucp_request_queue_t *req_queue;
     ucs_memory_type_t mem_type;
     size_t hdr_len, recv_len;
@@ -111,13 +112,14 @@ ucp_tag_recv_common(ucp_worker_h worker, void *buffer, size_t count,
     if (ucs_unlikely(rdesc == NULL)) {
         /* If not found on unexpected, wait until it arrives.
          * If was found but need this receive request for later completion, save it */
-        req_queue = ucp_tag_exp_get_queue(&worker->tm, tag, tag_mask);
+        shard     = ucp_tag_match_get_shard(&worker->tm, tag);
+        req_queue = ucp_tag_exp_get_queue(shard, tag, tag_mask);
 
         /* If offload supported, post this tag to transport as well.
          * TODO: need to distinguish the cases when posting is not needed. */
-        ucp_tag_offload_try_post(worker, req, req_queue);
+        ucp_tag_offload_try_post(worker, shard, req, req_queue);
 
-        ucp_tag_exp_push(&worker->tm, req_queue, req);
+        ucp_tag_exp_push(shard, req_queue, req);
 
         ucs_trace_req("%s returning expected request %p (%p)", debug_name, req,
                       req + 1);
@@ -154,6 +156,49 @@ ucp_tag_recv_common(ucp_worker_h worker, void *buffer, size_t count,
                                     UCS_STATS_ARG(UCP_WORKER_STAT_TAG_RX_EAGER_CHUNK_UNEXP));
 }
 
+/*
+ * Match a receive with the unexpected queue, or post it to the expected queue.
+ * Must be called with the worker lock held. If tag matching shards have their
+ * own locks, the worker lock is released while the shard is searched, so other
+ * threads can post receives to other shards at the same time.
+ */
+static UCS_F_ALWAYS_INLINE void
+ucp_tag_recv_match(ucp_worker_h worker, void *buffer, size_t count,
+                   uintptr_t datatype, ucp_tag_t tag, ucp_tag_t tag_mask,
+                   ucp_request_t *req, uint32_t req_flags,
+                   ucp_tag_recv_callback_t cb, const char *debug_name)
+{
+    ucp_tag_match_shard_t *shard = ucp_tag_match_get_shard(&worker->tm, tag);
+    ucp_recv_desc_t *rdesc;
+
+    if (ucs_likely(!(worker->tm.flags & UCP_TAG_MATCH_FLAG_MT_SHARDS))) {
+        rdesc = ucp_tag_unexp_search(shard, tag, tag_mask, 1, debug_name);
+        ucp_tag_recv_common(worker, buffer, count, datatype, tag, tag_mask,
+                            req, req_flags, cb, rdesc, debug_name);
+        return;
+    }
+
+    UCP_WORKER_THREAD_CS_EXIT_CONDITIONAL(worker);
+
+    ucs_spin_lock(&shard->lock);
+    rdesc = ucp_tag_unexp_search(shard, tag, tag_mask, 1, debug_name);
+    if (rdesc == NULL) {
+        /* Posting an expected receive does not touch any worker resources */
+        ucp_tag_recv_common(worker, buffer, count, datatype, tag, tag_mask,
+                            req, req_flags, cb, NULL, debug_name);
+    }
+    ucs_spin_unlock(&shard->lock);
+
+    UCP_WORKER_THREAD_CS_ENTER_CONDITIONAL(worker);
+
+    if (rdesc != NULL) {
+        /* The descriptor was removed from the shard, so it's owned by this
+         * thread, but receiving the data requires the worker lock */
+        ucp_tag_recv_common(worker, buffer, count, datatype, tag, tag_mask,
+                            req, req_flags, cb, rdesc, debug_name);
+    }
+}
+
 UCS_PROFILE_FUNC(ucs_status_t, ucp_tag_recv_nbr,
                  (worker, buffer, count, datatype, tag, tag_mask, request),
                  ucp_worker_h worker, void *buffer, size_t count,
@@ -161,16 +206,15 @@ UCS_PROFILE_FUNC(ucs_status_t, ucp_tag_recv_nbr,
                  void *request)
 {
     ucp_request_t *req = (ucp_request_t *)request - 1;
-    ucp_recv_desc_t *rdesc;
 
     UCP_CONTEXT_CHECK_FEATURE_FLAGS(worker->context, UCP_FEATURE_TAG,
                                     return UCS_ERR_INVALID_PARAM);
+    UCP_TAG_MATCH_CHECK_SHARD_MASK(&worker->tm, tag_mask,
+                                   return UCS_ERR_INVALID_PARAM);
     UCP_WORKER_THREAD_CS_ENTER_CONDITIONAL(worker);
 
-    rdesc = ucp_tag_unexp_search(&worker->tm, tag, tag_mask, 1, "recv_nbr");
-    ucp_tag_recv_common(worker, buffer, count, datatype, tag, tag_mask,
-                        req, UCP_REQUEST_DEBUG_FLAG_EXTERNAL, NULL, rdesc,
-                        "recv_nbr");
+    ucp_tag_recv_match(worker, buffer, count, datatype, tag, tag_mask, req,
+                       UCP_REQUEST_DEBUG_FLAG_EXTERNAL, NULL, "recv_nbr");
 
     UCP_WORKER_THREAD_CS_EXIT_CONDITIONAL(worker);
     return UCS_OK;
@@ -182,19 +226,19 @@ UCS_PROFILE_FUNC(ucs_status_ptr_t, ucp_tag_recv_nb,
                  uintptr_t datatype, ucp_tag_t tag, ucp_tag_t tag_mask,
                  ucp_tag_recv_callback_t cb)
 {
-    ucp_recv_desc_t *rdesc;
     ucs_status_ptr_t ret;
     ucp_request_t *req;
 
     UCP_CONTEXT_CHECK_FEATURE_FLAGS(worker->context, UCP_FEATURE_TAG,
                                     return UCS_STATUS_PTR(UCS_ERR_INVALID_PARAM));
+    UCP_TAG_MATCH_CHECK_SHARD_MASK(&worker->tm, tag_mask,
+                                   return UCS_STATUS_PTR(UCS_ERR_INVALID_PARAM));
     UCP_WORKER_THREAD_CS_ENTER_CONDITIONAL(worker);
 
     req = ucp_request_get(worker);
     if (ucs_likely(req != NULL)) {
-        rdesc = ucp_tag_unexp_search(&worker->tm, tag, tag_mask, 1, "recv_nb");
-        ucp_tag_recv_common(worker, buffer, count, datatype, tag, tag_mask, req,
-                            UCP_REQUEST_FLAG_CALLBACK, cb, rdesc,"recv_nb");
+        ucp_tag_recv_match(worker, buffer, count, datatype, tag, tag_mask, req,
+                           UCP_REQUEST_FLAG_CALLBACK, cb, "recv_nb");
         ret = req + 1;
     } else {
         ret = UCS_STATUS_PTR(UCS_ERR_NO_MEMORY);
@@ -11,6 +11,7 @@
 #include "tag_match.h"
 #include "eager.h"
 #include "rndv.h"
+#include "rndv_est.h"
 
 #include <ucp/core/ucp_ep.h>
 #include <ucp/core/ucp_worker.h>
@@ -191,6 +192,7 @@ UCS_PROFILE_FUNC(ucs_status_ptr_t, ucp_tag_send_nb,
                  ucp_ep_h ep, const void *buffer, size_t count,
                  uintptr_t datatype, ucp_tag_t tag, ucp_send_callback_t cb)
 {
+    size_t rndv_rma_thresh, rndv_am_thresh;
     ucs_status_t status;
     ucp_request_t *req;
     ucs_status_ptr_t ret;
@@ -217,10 +219,15 @@ UCS_PROFILE_FUNC(ucs_status_ptr_t, ucp_tag_send_nb,
 
     ucp_tag_send_req_init(req, ep, buffer, datatype, count, tag, 0);
 
+    rndv_rma_thresh = ucp_ep_config(ep)->tag.rndv.rma_thresh;
+    rndv_am_thresh  = ucp_ep_config(ep)->tag.rndv.am_thresh;
+    if (ucs_unlikely(ucp_ep_config(ep)->tag.rndv.est != NULL)) {
+        ucp_rndv_est_send_start(req, &rndv_rma_thresh, &rndv_am_thresh);
+    }
+
     ret = ucp_tag_send_req(req, count, &ucp_ep_config(ep)->tag.eager,
-                           ucp_ep_config(ep)->tag.rndv.rma_thresh,
-                           ucp_ep_config(ep)->tag.rndv.am_thresh,
-                           cb, ucp_ep_config(ep)->tag.proto, 1);
+                           rndv_rma_thresh, rndv_am_thresh, cb,
+                           ucp_ep_config(ep)->tag.proto, 1);
 out:
     UCP_WORKER_THREAD_CS_EXIT_CONDITIONAL(ep->worker);
     return ret;
@@ -269,6 +276,7 @@ UCS_PROFILE_FUNC(ucs_status_ptr_t, ucp_tag_send_sync_nb,
                  ucp_ep_h ep, const void *buffer, size_t count,
                  uintptr_t datatype, ucp_tag_t tag, ucp_send_callback_t cb)
 {
+    size_t rndv_rma_thresh, rndv_am_thresh;
     ucp_request_t *req;
     ucs_status_ptr_t ret;
     ucs_status_t status;
@@ -300,10 +308,15 @@ UCS_PROFILE_FUNC(ucs_status_ptr_t, ucp_tag_send_sync_nb,
     ucp_tag_send_req_init(req, ep, buffer, datatype, count, tag,
                           UCP_REQUEST_FLAG_SYNC);
 
+    rndv_rma_thresh = ucp_ep_config(ep)->tag.rndv.rma_thresh;
+    rndv_am_thresh  = ucp_ep_config(ep)->tag.rndv.am_thresh;
+    if (ucs_unlikely(ucp_ep_config(ep)->tag.rndv.est != NULL)) {
+        ucp_rndv_est_send_start(req, &rndv_rma_thresh, &rndv_am_thresh);
+    }
+
     ret = ucp_tag_send_req(req, count, &ucp_ep_config(ep)->tag.eager,
-                           ucp_ep_config(ep)->tag.rndv.rma_thresh,
-                           ucp_ep_config(ep)->tag.rndv.am_thresh,
-                           cb, ucp_ep_config(ep)->tag.sync_proto, 1);
+                           rndv_rma_thresh, rndv_am_thresh, cb,
+                           ucp_ep_config(ep)->tag.sync_proto, 1);
 out:
     UCP_WORKER_THREAD_CS_EXIT_CONDITIONAL(ep->worker);
     return ret;
@@ -1179,12 +1179,19 @@ ucp_wireup_add_rma_bw_lanes(const ucp_wireup_select_params_t *select_params,
     ucp_wireup_select_bw_info_t bw_info;
     ucs_memory_type_t mem_type;
     size_t added_lanes;
+    uint64_t rndv_features;
     uint64_t md_reg_flag;
     uint8_t i;
 
+    /* Stream uses rendezvous only if its threshold is set */
+    rndv_features = UCP_FEATURE_TAG | UCP_FEATURE_AM;
+    if (context->config.ext.stream_rndv_thresh != UCS_MEMUNITS_INF) {
+        rndv_features |= UCP_FEATURE_STREAM;
+    }
+
     if (ep_init_flags & UCP_EP_INIT_FLAG_MEM_TYPE) {
         md_reg_flag = 0;
-    } else if (ucp_ep_get_context_features(ep) & UCP_FEATURE_TAG) {
+    } else if (ucp_ep_get_context_features(ep) & rndv_features) {
         /* if needed for RNDV, need only access for remote registered memory */
         md_reg_flag = UCT_MD_FLAG_REG;
     } else {
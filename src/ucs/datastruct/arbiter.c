@@ -8,19 +8,39 @@
 
 #include <ucs/debug/assert.h>
 #include <ucs/debug/log.h>
+#include <ucs/sys/math.h>
+#include <limits.h>
 
 
 void ucs_arbiter_init(ucs_arbiter_t *arbiter)
 {
     ucs_list_head_init(&arbiter->list);
+    arbiter->elem_cost = 1;
 }
 
 void ucs_arbiter_group_init(ucs_arbiter_group_t *group)
 {
-    group->tail = NULL;
+    group->tail    = NULL;
+    group->weight  = 0;
+    group->deficit = 0;
     UCS_ARBITER_GROUP_GUARD_INIT(group);
 }
 
+/* Number of rounds until a group in debt gets positive credit */
+static UCS_F_ALWAYS_INLINE unsigned
+ucs_arbiter_group_debt_rounds(const ucs_arbiter_group_t *group)
+{
+    ucs_assert((group->weight != 0) && (group->deficit <= 0));
+    return ((unsigned)-group->deficit / group->weight) + 1;
+}
+
+void ucs_arbiter_group_set_weight(ucs_arbiter_group_t *group, unsigned weight)
+{
+    ucs_assert(weight <= INT_MAX);
+    group->weight  = weight;
+    group->deficit = 0;
+}
+
 void ucs_arbiter_cleanup(ucs_arbiter_t *arbiter)
 {
     ucs_assert_always(ucs_arbiter_is_empty(arbiter));
@@ -201,18 +221,51 @@ void ucs_arbiter_group_schedule_nonempty(ucs_arbiter_t *arbiter,
     UCS_ARBITER_GROUP_ARBITER_SET(group, arbiter);
 }
 
+/*
+ * Every scheduled group, including 'group' which was extracted from the list,
+ * is weighted and in debt. Add to all of them the credit of the rounds which
+ * would be skipped until the first group gets positive credit, instead of
+ * going over the list for every such round.
+ */
+static void ucs_arbiter_repay_debts(ucs_arbiter_t *arbiter,
+                                    ucs_arbiter_group_t *group)
+{
+    unsigned rounds = ucs_arbiter_group_debt_rounds(group);
+    ucs_arbiter_elem_t *elem;
+
+    ucs_list_for_each(elem, &arbiter->list, list) {
+        if (elem->group->weight == 0) {
+            return;
+        }
+        rounds = ucs_min(rounds, ucs_arbiter_group_debt_rounds(elem->group));
+    }
+
+    /* the last round is added by the caller as usual */
+    if (--rounds == 0) {
+        return;
+    }
+
+    ucs_trace_poll("arbiter %p: skipping %u rounds of debt", arbiter, rounds);
+    group->deficit += rounds * group->weight;
+    ucs_list_for_each(elem, &arbiter->list, list) {
+        elem->group->deficit += rounds * elem->group->weight;
+    }
+}
+
 void ucs_arbiter_dispatch_nonempty(ucs_arbiter_t *arbiter, unsigned per_group,
                                    ucs_arbiter_callback_t cb, void *cb_arg)
 {
     ucs_arbiter_elem_t *group_head, *group_tail, *next_elem;
     ucs_arbiter_cb_result_t result;
     unsigned group_dispatch_count;
-    ucs_arbiter_group_t *group;
+    ucs_arbiter_group_t *group, *first_skipped;
     UCS_LIST_HEAD(resched_list);
     int sched_group;
 
     ucs_assert(!ucs_list_is_empty(&arbiter->list));
 
+    first_skipped = NULL;
+
     for (;;) {
         group_head = ucs_list_extract_head(&arbiter->list, ucs_arbiter_elem_t,
                                            list);
@@ -229,6 +282,33 @@ void ucs_arbiter_dispatch_nonempty(ucs_arbiter_t *arbiter, unsigned per_group,
         group                = group_head->group;
         UCS_ARBITER_GROUP_GUARD_CHECK(group);
 
+        if (group->weight != 0) {
+            /* Deficit round-robin: add the credit of this round. Unused credit
+             * of a group which stopped early is not accumulated, and the debt
+             * of the only scheduled group is forgiven, since there is nobody
+             * to yield to. */
+            if (ucs_list_is_empty(&arbiter->list)) {
+                group->deficit = group->weight;
+            } else {
+                if (group == first_skipped) {
+                    /* all groups are in debt, run the idle rounds at once */
+                    ucs_arbiter_repay_debts(arbiter, group);
+                }
+
+                group->deficit = ucs_min(group->deficit, 0) + group->weight;
+                if (group->deficit <= 0) {
+                    /* still in debt, skip the group in this round */
+                    if (first_skipped == NULL) {
+                        first_skipped = group;
+                    }
+                    ucs_list_add_tail(&arbiter->list, &group_head->list);
+                    continue;
+                }
+            }
+        }
+
+        first_skipped = NULL;
+
         do {
             /* zero pointer to next elem here because:
              * 1. if the element is removed from the arbiter it must be kept in
@@ -241,17 +321,29 @@ void ucs_arbiter_dispatch_nonempty(ucs_arbiter_t *arbiter, unsigned per_group,
             ucs_assert(group_head->group == group);
 
             ucs_trace_poll("dispatching arbiter element %p", group_head);
+            arbiter->elem_cost = 1;
             UCS_ARBITER_GROUP_GUARD_ENTER(group);
             result = cb(arbiter, group_head, cb_arg);
             UCS_ARBITER_GROUP_GUARD_EXIT(group);
             ucs_trace_poll("dispatch result: %d", result);
             ++group_dispatch_count;
 
+            if ((group->weight != 0) &&
+                ((result == UCS_ARBITER_CB_RESULT_REMOVE_ELEM) ||
+                 (result == UCS_ARBITER_CB_RESULT_NEXT_GROUP))) {
+                /* charge only the work which was done; the credit is positive,
+                 * so it can't underflow, and every element costs at least 1 to
+                 * guarantee moving to the next group */
+                group->deficit -= ucs_min(ucs_max(arbiter->elem_cost, 1),
+                                          INT_MAX);
+            }
+
             if (result == UCS_ARBITER_CB_RESULT_REMOVE_ELEM) {
                 group_tail = group->tail;
                 if (group_head == group_tail) {
                     /* Last element */
                     group->tail = NULL; /* Group is empty now */
+                    group->deficit = 0; /* Idle group does not keep credit */
                     sched_group = 0;
                     group_head  = NULL; /* for debugging */
                     UCS_ARBITER_GROUP_ARBITER_SET(group, NULL);
@@ -287,9 +379,12 @@ void ucs_arbiter_dispatch_nonempty(ucs_arbiter_t *arbiter, unsigned per_group,
                         ucs_bug("unexpected return value from arbiter callback");
                     }
                     break;
+                } else if (group->weight != 0) {
+                    break;
                 }
             }
-        } while (group_dispatch_count < per_group);
+        } while ((group->weight == 0) ? (group_dispatch_count < per_group) :
+                                        (group->deficit > 0));
 
         if (sched_group) {
             /* the group could be scheduled again from dispatch callback */
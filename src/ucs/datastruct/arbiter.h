@@ -33,6 +33,19 @@
  *  - all except last element point to the next element in same group, and the
  *    last one points to the first (next).
  *
+ * Weighted groups:
+ *  By default, up to "per_group" elements of a group are dispatched every time
+ *  the group reaches the head of the arbiter (plain round-robin). A group may be
+ *  given a weight, in which case it is scheduled by deficit round-robin: every
+ *  time the group reaches the head of the arbiter it receives "weight" credits,
+ *  and its elements are dispatched as long as it has positive credit. Every
+ *  dispatched element costs 1 credit, unless the dispatch callback reports its
+ *  actual cost (for example, the number of bytes sent) by
+ *  ucs_arbiter_elem_charge(). A group which overdrafts its credit is skipped in
+ *  the following rounds until its debt is repaid, so the bandwidth is shared
+ *  between weighted groups in proportion to their weights. If all groups are in
+ *  debt, the credit of the skipped rounds is added to all of them at once.
+ *
  * Note:
  *  Every elements holds 4 pointers. It could be done with 3 pointers, so that
  *  the pointer to the previous group is put instead of "next" pointer in the last
@@ -145,6 +158,8 @@ typedef ucs_arbiter_cb_result_t (*ucs_arbiter_callback_t)(ucs_arbiter_t *arbiter
  */
 struct ucs_arbiter {
     ucs_list_link_t         list;
+    size_t                  elem_cost;  /* Cost of the element being dispatched,
+                                           used by weighted groups */
 };
 
 
@@ -153,6 +168,8 @@ struct ucs_arbiter {
  */
 struct ucs_arbiter_group {
     ucs_arbiter_elem_t      *tail;
+    unsigned                weight;     /* Credit per round, 0 - not weighted */
+    int                     deficit;    /* Current credit of a weighted group */
     UCS_ARBITER_GROUP_GUARD_DEFINE;
     UCS_ARBITER_GROUP_ARBITER_DEFINE;
 };
@@ -187,6 +204,17 @@ void ucs_arbiter_group_init(ucs_arbiter_group_t *group);
 void ucs_arbiter_group_cleanup(ucs_arbiter_group_t *group);
 
 
+/**
+ * Set the weight of a group, to schedule it by deficit round-robin.
+ *
+ * @param [in]  group    Group to set the weight for.
+ * @param [in]  weight   Credit the group receives every round, in the units of
+ *                       @ref ucs_arbiter_elem_charge (for example, bytes).
+ *                       0 restores plain round-robin scheduling of the group.
+ */
+void ucs_arbiter_group_set_weight(ucs_arbiter_group_t *group, unsigned weight);
+
+
 /**
  * Initialize an element object.
  *
@@ -387,7 +415,8 @@ ucs_arbiter_group_push_head_elem(ucs_arbiter_t *arbiter,
 /**
  * Dispatch work elements in the arbiter. For every group, up to per_group work
  * elements are dispatched, as long as the callback returns REMOVE_ELEM or
- * NEXT_GROUP. Then, the same is done for the next group, until either the
+ * NEXT_GROUP; weighted groups are dispatched while they have credit instead,
+ * and NEXT_GROUP moves to the next group. Then, the same is done for the next group, until either the
  * arbiter becomes empty or the callback returns STOP. If a group is either out
  * of elements, or its callback returns REMOVE_GROUP, it will be removed until
  * ucs_arbiter_group_schedule() is used to put it back on the arbiter.
@@ -407,6 +436,22 @@ ucs_arbiter_dispatch(ucs_arbiter_t *arbiter, unsigned per_group,
 }
 
 
+/**
+ * Report the cost of the element being dispatched, to be charged from the credit
+ * of its group if the group is weighted. May be called only from the dispatch
+ * callback; if not called, the element costs 1. The cost is charged only if the
+ * callback returns REMOVE_ELEM or NEXT_GROUP.
+ *
+ * @param [in]  arbiter  Arbiter passed to the dispatch callback.
+ * @param [in]  cost     Cost of the dispatched element, for example the number
+ *                       of bytes it has sent.
+ */
+static inline void ucs_arbiter_elem_charge(ucs_arbiter_t *arbiter, size_t cost)
+{
+    arbiter->elem_cost = cost;
+}
+
+
 /**
  * @return Group the element belongs to.
  */
@@ -12,10 +12,41 @@
 #include "mpool.inl"
 #include "queue.h"
 
+#include <ucs/datastruct/list.h>
+#include <ucs/datastruct/ptr_array.h>
 #include <ucs/debug/log.h>
+#include <ucs/debug/memtrack.h>
 #include <ucs/sys/math.h>
 #include <ucs/sys/checker.h>
 #include <ucs/sys/sys.h>
+#include <ucm/api/ucm.h>
+#include <sys/mman.h>
+
+
+/* Names of memory pool stats counters */
+enum {
+    UCS_MPOOL_STAT_ELEMS,           /* number of elements in all chunks */
+    UCS_MPOOL_STAT_PEAK_ELEMS,      /* maximal number of elements */
+    UCS_MPOOL_STAT_BYTES,           /* total size of all chunks */
+    UCS_MPOOL_STAT_PEAK_BYTES,      /* maximal total size of chunks */
+    UCS_MPOOL_STAT_CHUNKS_RELEASED, /* number of chunks released by shrink */
+    UCS_MPOOL_STAT_LAST
+};
+
+
+#if ENABLE_STATS
+static ucs_stats_class_t ucs_mpool_stats_class = {
+    .name = "mpool",
+    .num_counters = UCS_MPOOL_STAT_LAST,
+    .counter_names = {
+        [UCS_MPOOL_STAT_ELEMS]           = "elems",
+        [UCS_MPOOL_STAT_PEAK_ELEMS]      = "peak_elems",
+        [UCS_MPOOL_STAT_BYTES]           = "bytes",
+        [UCS_MPOOL_STAT_PEAK_BYTES]      = "peak_bytes",
+        [UCS_MPOOL_STAT_CHUNKS_RELEASED] = "chunks_released"
+    }
+};
+#endif
 
 
 static inline unsigned ucs_mpool_elem_total_size(ucs_mpool_data_t *data)
@@ -31,6 +62,21 @@ static inline ucs_mpool_elem_t *ucs_mpool_chunk_elem(ucs_mpool_data_t *data,
                                elem_index * ucs_mpool_elem_total_size(data));
 }
 
+static void ucs_mpool_update_usage(ucs_mpool_t *mp)
+{
+    ucs_mpool_data_t *data = mp->data;
+
+    data->peak_elems = ucs_max(data->peak_elems, data->num_elems);
+    data->peak_bytes = ucs_max(data->peak_bytes, data->num_bytes);
+
+    UCS_STATS_SET_COUNTER(data->stats, UCS_MPOOL_STAT_ELEMS, data->num_elems);
+    UCS_STATS_SET_COUNTER(data->stats, UCS_MPOOL_STAT_PEAK_ELEMS,
+                          data->peak_elems);
+    UCS_STATS_SET_COUNTER(data->stats, UCS_MPOOL_STAT_BYTES, data->num_bytes);
+    UCS_STATS_SET_COUNTER(data->stats, UCS_MPOOL_STAT_PEAK_BYTES,
+                          data->peak_bytes);
+}
+
 static void ucs_mpool_chunk_leak_check(ucs_mpool_t *mp, ucs_mpool_chunk_t *chunk)
 {
     ucs_mpool_elem_t *elem;
@@ -76,6 +122,14 @@ ucs_status_t ucs_mpool_init(ucs_mpool_t *mp, size_t priv_size,
     mp->data->chunks          = NULL;
     mp->data->ops             = ops;
     mp->data->name            = ucs_strdup(name, "mpool_data_name");
+    mp->data->num_chunks      = 0;
+    mp->data->num_elems       = 0;
+    mp->data->peak_elems      = 0;
+    mp->data->num_bytes       = 0;
+    mp->data->peak_bytes      = 0;
+#if ENABLE_STATS
+    mp->data->stats           = NULL;
+#endif
 
     if (mp->data->name == NULL) {
         ucs_error("Failed to allocate memory pool data name");
@@ -139,6 +193,8 @@ void ucs_mpool_cleanup(ucs_mpool_t *mp, int leak_check)
         data->ops->chunk_release(mp, chunk);
     }
 
+    UCS_STATS_NODE_FREE(data->stats);
+
     ucs_debug("mpool %s destroyed", ucs_mpool_name(mp));
 
     ucs_free(data->name);
@@ -200,6 +256,7 @@ void ucs_mpool_grow(ucs_mpool_t *mp, unsigned num_elems)
     chunk->elems     = UCS_PTR_BYTE_OFFSET(chunk + 1, chunk_padding);
     chunk->num_elems = ucs_min(data->quota, (chunk_size - chunk_padding - sizeof(*chunk)) /
                        ucs_mpool_elem_total_size(data));
+    chunk->size      = chunk_size;
 
     ucs_debug("mpool %s: allocated chunk %p of %lu bytes with %u elements",
               ucs_mpool_name(mp), chunk, chunk_size, chunk->num_elems);
@@ -219,6 +276,11 @@ void ucs_mpool_grow(ucs_mpool_t *mp, unsigned num_elems)
     chunk->next  = data->chunks;
     data->chunks = chunk;
 
+    ++data->num_chunks;
+    data->num_elems += chunk->num_elems;
+    data->num_bytes += chunk_size;
+    ucs_mpool_update_usage(mp);
+
     if (data->quota == UINT_MAX) {
         /* Infinite memory pool */
     } else if (data->quota >= chunk->num_elems) {
@@ -230,6 +292,163 @@ void ucs_mpool_grow(ucs_mpool_t *mp, unsigned num_elems)
     VALGRIND_MAKE_MEM_NOACCESS(chunk + 1, chunk_size - sizeof(*chunk));
 }
 
+static int ucs_mpool_chunk_compare(const void *elem1, const void *elem2)
+{
+    const ucs_mpool_chunk_t *chunk1 = *(ucs_mpool_chunk_t* const*)elem1;
+    const ucs_mpool_chunk_t *chunk2 = *(ucs_mpool_chunk_t* const*)elem2;
+
+    return (chunk1->elems < chunk2->elems) ? -1 :
+           (chunk1->elems > chunk2->elems) ?  1 : 0;
+}
+
+/* Find the chunk which contains the element, in an array of chunks sorted by
+ * the address of their elements */
+static unsigned ucs_mpool_chunk_find(ucs_mpool_chunk_t **chunks,
+                                     unsigned num_chunks,
+                                     ucs_mpool_elem_t *elem)
+{
+    unsigned low = 0, high = num_chunks - 1, mid;
+
+    while (low < high) {
+        mid = (low + high + 1) / 2;
+        if ((void*)elem < chunks[mid]->elems) {
+            high = mid - 1;
+        } else {
+            low  = mid;
+        }
+    }
+
+    ucs_assert((void*)elem >= chunks[low]->elems);
+    return low;
+}
+
+static void ucs_mpool_chunk_release(ucs_mpool_t *mp, ucs_mpool_chunk_t *chunk)
+{
+    ucs_mpool_data_t *data = mp->data;
+    ucs_mpool_elem_t *elem;
+    unsigned i;
+    void *obj;
+
+    if (data->ops->obj_cleanup != NULL) {
+        for (i = 0; i < chunk->num_elems; ++i) {
+            elem = ucs_mpool_chunk_elem(data, chunk, i);
+            obj  = elem + 1;
+            VALGRIND_MEMPOOL_ALLOC(mp, obj, data->elem_size - sizeof(ucs_mpool_elem_t));
+            VALGRIND_MAKE_MEM_DEFINED(obj, data->elem_size - sizeof(ucs_mpool_elem_t));
+            data->ops->obj_cleanup(mp, obj);
+            VALGRIND_MEMPOOL_FREE(mp, obj);
+        }
+    }
+
+    if (data->quota != UINT_MAX) {
+        data->quota += chunk->num_elems;
+    }
+
+    --data->num_chunks;
+    data->num_elems -= chunk->num_elems;
+    data->num_bytes -= chunk->size;
+
+    ucs_debug("mpool %s: releasing chunk %p of %zu bytes with %u elements",
+              ucs_mpool_name(mp), chunk, chunk->size, chunk->num_elems);
+    data->ops->chunk_release(mp, chunk);
+}
+
+unsigned ucs_mpool_shrink(ucs_mpool_t *mp)
+{
+    ucs_mpool_data_t *data = mp->data;
+    unsigned num_released  = 0;
+    ucs_mpool_elem_t *elem, **elem_p, *tail;
+    ucs_mpool_chunk_t **chunks, *chunk;
+    unsigned i, num_chunks, *num_free;
+
+    num_chunks = data->num_chunks;
+    if ((mp->freelist == NULL) || (num_chunks == 0)) {
+        return 0;
+    }
+
+    chunks = ucs_malloc(num_chunks * (sizeof(*chunks) + sizeof(*num_free)),
+                        "mpool_shrink");
+    if (chunks == NULL) {
+        ucs_debug("mpool %s: failed to allocate chunks array",
+                  ucs_mpool_name(mp));
+        return 0;
+    }
+
+    num_free = (unsigned*)(chunks + num_chunks);
+    i        = 0;
+    for (chunk = data->chunks; chunk != NULL; chunk = chunk->next) {
+        chunks[i]   = chunk;
+        num_free[i] = 0;
+        ++i;
+    }
+    ucs_assert(i == num_chunks);
+
+    qsort(chunks, num_chunks, sizeof(*chunks), ucs_mpool_chunk_compare);
+
+    /* Count the free elements of every chunk */
+    for (elem = mp->freelist; elem != NULL; elem = elem->next) {
+        VALGRIND_MAKE_MEM_DEFINED(elem, sizeof *elem);
+        ++num_free[ucs_mpool_chunk_find(chunks, num_chunks, elem)];
+    }
+
+    for (i = 0; i < num_chunks; ++i) {
+        num_released += (num_free[i] == chunks[i]->num_elems);
+    }
+
+    if (num_released == 0) {
+        goto out;
+    }
+
+    /* Remove the elements of idle chunks from the freelist */
+    tail   = NULL;
+    elem_p = &mp->freelist;
+    while ((elem = *elem_p) != NULL) {
+        i = ucs_mpool_chunk_find(chunks, num_chunks, elem);
+        if (num_free[i] == chunks[i]->num_elems) {
+            *elem_p = elem->next;
+        } else {
+            tail    = elem;
+            elem_p  = &elem->next;
+        }
+    }
+    data->tail = tail;
+
+    /* Release idle chunks and rebuild the list of the remaining ones */
+    data->chunks = NULL;
+    for (i = num_chunks; i-- > 0; ) {
+        chunk = chunks[i];
+        if (num_free[i] == chunk->num_elems) {
+            ucs_mpool_chunk_release(mp, chunk);
+        } else {
+            chunk->next  = data->chunks;
+            data->chunks = chunk;
+        }
+    }
+
+    UCS_STATS_UPDATE_COUNTER(data->stats, UCS_MPOOL_STAT_CHUNKS_RELEASED,
+                             num_released);
+    ucs_mpool_update_usage(mp);
+
+out:
+    ucs_free(chunks);
+    return num_released;
+}
+
+ucs_status_t ucs_mpool_stats_alloc(ucs_mpool_t *mp,
+                                   ucs_stats_node_t *stats_parent)
+{
+    ucs_status_t status;
+
+    status = UCS_STATS_NODE_ALLOC(&mp->data->stats, &ucs_mpool_stats_class,
+                                  stats_parent, "-%s", ucs_mpool_name(mp));
+    if (status != UCS_OK) {
+        return status;
+    }
+
+    ucs_mpool_update_usage(mp);
+    return UCS_OK;
+}
+
 void *ucs_mpool_get_grow(ucs_mpool_t *mp)
 {
     ucs_mpool_data_t *data = mp->data;
@@ -242,6 +461,380 @@ void *ucs_mpool_get_grow(ucs_mpool_t *mp)
     return ucs_mpool_get(mp);
 }
 
+/**
+ * Per-thread cache of a thread-safe memory pool.
+ */
+typedef struct ucs_mpool_mt_cache {
+    ucs_mpool_mt_t         *mp;       /* Memory pool of the cache, or NULL if the
+                                         slot is unused */
+    ucs_mpool_elem_t       *freelist; /* List of available elements, the most
+                                         recently released first */
+    ucs_mpool_elem_t       *tail;     /* Least recently released element */
+    unsigned               count;     /* Number of elements in the freelist */
+} ucs_mpool_mt_cache_t;
+
+
+/**
+ * Caches of all thread-safe memory pools used by a thread, indexed by the pool
+ * index. Allocated by the original mmap(), so a cache can be created from a
+ * memory event handler, as the rcache does.
+ */
+typedef struct ucs_mpool_mt_thread {
+    ucs_list_link_t        list;       /* Entry in the global threads list */
+    size_t                 size;       /* Size of the mapping */
+    unsigned               num_caches; /* Number of slots in 'caches' */
+    ucs_mpool_mt_cache_t   caches[0];
+} ucs_mpool_mt_thread_t;
+
+
+/* Per-thread caches of all thread-safe memory pools */
+typedef struct ucs_mpool_mt_global_context {
+    pthread_key_t          tls_key;    /* Caches of the current thread */
+    pthread_mutex_t        mutex;      /* Protects the pools index, the threads
+                                          list, and the caches of other
+                                          threads */
+    ucs_ptr_array_t        pools;      /* Indexes of the thread-safe pools */
+    ucs_list_link_t        threads;    /* Threads which have caches */
+} ucs_mpool_mt_global_context_t;
+
+
+static ucs_mpool_mt_global_context_t ucs_mpool_mt_global_ctx = {
+    .mutex   = PTHREAD_MUTEX_INITIALIZER,
+    .threads = UCS_LIST_INITIALIZER(&ucs_mpool_mt_global_ctx.threads,
+                                    &ucs_mpool_mt_global_ctx.threads)
+};
+
+
+/* Move the free elements of the cache, except the 'keep' most recently released
+ * ones, to the shared pool. The least recently used elements are moved, since
+ * they are the least likely to be in the CPU cache. Must be called with the
+ * pool lock held. */
+static void ucs_mpool_mt_cache_flush(ucs_mpool_mt_cache_t *cache,
+                                     unsigned keep)
+{
+    ucs_mpool_t *shared = &cache->mp->super;
+    ucs_mpool_elem_t *first, *last;
+    unsigned i;
+
+    if (cache->count <= keep) {
+        return;
+    }
+
+    if (keep == 0) {
+        first           = cache->freelist;
+        last            = NULL;
+        cache->freelist = NULL;
+    } else {
+        last = cache->freelist;
+        for (i = 1; i < keep; ++i) {
+            last = last->next;
+        }
+        first      = last->next;
+        last->next = NULL;
+    }
+
+    cache->tail->next = shared->freelist;
+    shared->freelist  = first;
+    cache->tail       = last;
+    cache->count      = keep;
+}
+
+/* Move up to 'batch_size' elements from the shared pool to an empty cache, and
+ * grow the shared pool if needed. Return the number of moved elements. */
+static unsigned ucs_mpool_mt_cache_refill(ucs_mpool_mt_cache_t *cache)
+{
+    ucs_mpool_mt_t *mp  = cache->mp;
+    ucs_mpool_t *shared = &mp->super;
+    ucs_mpool_elem_t *last;
+    unsigned count;
+
+    ucs_assert(cache->count == 0);
+
+    ucs_spin_lock(&mp->lock);
+
+    if (shared->freelist == NULL) {
+        ucs_mpool_grow(shared, shared->data->elems_per_chunk);
+        if (shared->freelist == NULL) {
+            ucs_spin_unlock(&mp->lock);
+            return 0;
+        }
+    }
+
+    last = shared->freelist;
+    VALGRIND_MAKE_MEM_DEFINED(last, sizeof *last);
+    for (count = 1; (count < mp->batch_size) && (last->next != NULL); ++count) {
+        last = last->next;
+        VALGRIND_MAKE_MEM_DEFINED(last, sizeof *last);
+    }
+
+    cache->freelist  = shared->freelist;
+    cache->tail      = last;
+    cache->count     = count;
+    shared->freelist = last->next;
+    last->next       = NULL;
+
+    ucs_spin_unlock(&mp->lock);
+    return count;
+}
+
+/* Called on thread exit, returns the free elements to the shared pools */
+static void ucs_mpool_mt_thread_destroy(void *arg)
+{
+    ucs_mpool_mt_thread_t *thread = arg;
+    ucs_mpool_mt_cache_t *cache;
+    int ret;
+
+    pthread_mutex_lock(&ucs_mpool_mt_global_ctx.mutex);
+    for (cache = thread->caches; cache < thread->caches + thread->num_caches;
+         ++cache) {
+        if (cache->mp != NULL) {
+            ucs_spin_lock(&cache->mp->lock);
+            ucs_mpool_mt_cache_flush(cache, 0);
+            ucs_spin_unlock(&cache->mp->lock);
+        }
+    }
+    ucs_list_del(&thread->list);
+    pthread_mutex_unlock(&ucs_mpool_mt_global_ctx.mutex);
+
+    ret = ucm_orig_munmap(thread, thread->size);
+    if (ret != 0) {
+        ucs_warn("munmap(%p, %zu) failed: %m", thread, thread->size);
+    }
+}
+
+/* Replace the caches table of the current thread by a larger one, which has a
+ * slot for the pool 'index'. Must be called with the global mutex held. */
+static ucs_mpool_mt_thread_t *
+ucs_mpool_mt_thread_expand(ucs_mpool_mt_thread_t *thread, unsigned index)
+{
+    ucs_mpool_mt_thread_t *new_thread;
+    unsigned num_caches;
+    size_t size;
+    int ret;
+
+    num_caches = index + 1;
+    if (thread != NULL) {
+        num_caches = ucs_max(num_caches, 2 * thread->num_caches);
+    }
+
+    size       = ucs_align_up_pow2(sizeof(*new_thread) +
+                                   (num_caches * sizeof(ucs_mpool_mt_cache_t)),
+                                   ucs_get_page_size());
+    new_thread = ucm_orig_mmap(NULL, size, PROT_READ | PROT_WRITE,
+                               MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (new_thread == MAP_FAILED) {
+        ucs_error("mmap(size=%zu) failed: %m", size);
+        return NULL;
+    }
+
+    /* The mapping is zeroed, so the new slots are unused */
+    new_thread->size       = size;
+    new_thread->num_caches = (size - sizeof(*new_thread)) /
+                             sizeof(ucs_mpool_mt_cache_t);
+    if (thread != NULL) {
+        memcpy(new_thread->caches, thread->caches,
+               thread->num_caches * sizeof(ucs_mpool_mt_cache_t));
+    }
+
+    ret = pthread_setspecific(ucs_mpool_mt_global_ctx.tls_key, new_thread);
+    if (ret != 0) {
+        ucs_error("pthread_setspecific() failed: %s", strerror(ret));
+        ucm_orig_munmap(new_thread, size);
+        return NULL;
+    }
+
+    ucs_list_add_tail(&ucs_mpool_mt_global_ctx.threads, &new_thread->list);
+    if (thread != NULL) {
+        ucs_list_del(&thread->list);
+        ucm_orig_munmap(thread, thread->size);
+    }
+
+    return new_thread;
+}
+
+static UCS_F_NOINLINE ucs_mpool_mt_cache_t *
+ucs_mpool_mt_cache_create(ucs_mpool_mt_t *mp, ucs_mpool_mt_thread_t *thread)
+{
+    ucs_mpool_mt_cache_t *cache;
+
+    pthread_mutex_lock(&ucs_mpool_mt_global_ctx.mutex);
+
+    if ((thread == NULL) || (mp->index >= thread->num_caches)) {
+        thread = ucs_mpool_mt_thread_expand(thread, mp->index);
+        if (thread == NULL) {
+            pthread_mutex_unlock(&ucs_mpool_mt_global_ctx.mutex);
+            return NULL;
+        }
+    }
+
+    cache = &thread->caches[mp->index];
+    ucs_assert(cache->mp == NULL);
+    cache->mp       = mp;
+    cache->freelist = NULL;
+    cache->tail     = NULL;
+    cache->count    = 0;
+
+    pthread_mutex_unlock(&ucs_mpool_mt_global_ctx.mutex);
+    return cache;
+}
+
+static UCS_F_ALWAYS_INLINE ucs_mpool_mt_cache_t *
+ucs_mpool_mt_cache_get(ucs_mpool_mt_t *mp)
+{
+    ucs_mpool_mt_thread_t *thread;
+
+    thread = pthread_getspecific(ucs_mpool_mt_global_ctx.tls_key);
+    if (ucs_likely((thread != NULL) && (mp->index < thread->num_caches) &&
+                   (thread->caches[mp->index].mp == mp))) {
+        return &thread->caches[mp->index];
+    }
+
+    return ucs_mpool_mt_cache_create(mp, thread);
+}
+
+ucs_status_t ucs_mpool_mt_init(ucs_mpool_mt_t *mp, size_t priv_size,
+                               size_t elem_size, size_t align_offset,
+                               size_t alignment, unsigned elems_per_chunk,
+                               unsigned max_elems, unsigned batch_size,
+                               ucs_mpool_ops_t *ops, const char *name)
+{
+    ucs_status_t status;
+    uint32_t placeholder;
+
+    if (batch_size == 0) {
+        ucs_error("Invalid memory pool parameter(s)");
+        return UCS_ERR_INVALID_PARAM;
+    }
+
+    status = ucs_mpool_init(&mp->super, priv_size, elem_size, align_offset,
+                            alignment, elems_per_chunk, max_elems, ops, name);
+    if (status != UCS_OK) {
+        return status;
+    }
+
+    status = ucs_spinlock_init(&mp->lock, 0);
+    if (status != UCS_OK) {
+        ucs_mpool_cleanup(&mp->super, 0);
+        return status;
+    }
+
+    mp->batch_size = batch_size;
+
+    pthread_mutex_lock(&ucs_mpool_mt_global_ctx.mutex);
+    mp->index = ucs_ptr_array_insert(&ucs_mpool_mt_global_ctx.pools, mp,
+                                     &placeholder);
+    pthread_mutex_unlock(&ucs_mpool_mt_global_ctx.mutex);
+    return UCS_OK;
+}
+
+void ucs_mpool_mt_cleanup(ucs_mpool_mt_t *mp, int leak_check)
+{
+    ucs_mpool_mt_thread_t *thread;
+    ucs_mpool_mt_cache_t *cache;
+
+    /* Release the caches of the threads which are still alive */
+    pthread_mutex_lock(&ucs_mpool_mt_global_ctx.mutex);
+    ucs_list_for_each(thread, &ucs_mpool_mt_global_ctx.threads, list) {
+        if (mp->index >= thread->num_caches) {
+            continue;
+        }
+
+        cache = &thread->caches[mp->index];
+        if (cache->mp == mp) {
+            ucs_mpool_mt_cache_flush(cache, 0);
+            cache->mp = NULL;
+        }
+    }
+    ucs_ptr_array_remove(&ucs_mpool_mt_global_ctx.pools, mp->index, 0);
+    pthread_mutex_unlock(&ucs_mpool_mt_global_ctx.mutex);
+
+    ucs_spinlock_destroy(&mp->lock);
+    ucs_mpool_cleanup(&mp->super, leak_check);
+}
+
+void *ucs_mpool_mt_get(ucs_mpool_mt_t *mp)
+{
+    ucs_mpool_mt_cache_t *cache;
+    ucs_mpool_elem_t *elem;
+    void *obj;
+
+    cache = ucs_mpool_mt_cache_get(mp);
+    if (ucs_unlikely(cache == NULL)) {
+        return NULL;
+    }
+
+    if (ucs_unlikely(cache->count == 0) &&
+        (ucs_mpool_mt_cache_refill(cache) == 0)) {
+        return NULL;
+    }
+
+    elem            = cache->freelist;
+    cache->freelist = elem->next;
+    --cache->count;
+    elem->mpool     = &mp->super;
+
+    obj = elem + 1;
+    VALGRIND_MEMPOOL_ALLOC(&mp->super, obj,
+                           mp->super.data->elem_size - sizeof(ucs_mpool_elem_t));
+    return obj;
+}
+
+void ucs_mpool_mt_put(void *obj)
+{
+    ucs_mpool_elem_t *elem = ucs_mpool_obj_to_elem(obj);
+    ucs_mpool_mt_t *mp     = ucs_container_of(elem->mpool, ucs_mpool_mt_t,
+                                              super);
+    ucs_mpool_mt_cache_t *cache;
+
+    VALGRIND_MEMPOOL_FREE(&mp->super, obj);
+
+    cache = ucs_mpool_mt_cache_get(mp);
+    if (ucs_unlikely(cache == NULL)) {
+        /* return the element directly to the shared pool */
+        ucs_spin_lock(&mp->lock);
+        ucs_mpool_add_to_freelist(&mp->super, elem, 0);
+        ucs_spin_unlock(&mp->lock);
+        return;
+    }
+
+    elem->next      = cache->freelist;
+    cache->freelist = elem;
+    if (cache->count == 0) {
+        cache->tail = elem;
+    }
+
+    if (++cache->count > (2 * mp->batch_size)) {
+        ucs_spin_lock(&mp->lock);
+        ucs_mpool_mt_cache_flush(cache, mp->batch_size);
+        ucs_spin_unlock(&mp->lock);
+    }
+}
+
+void ucs_mpool_global_init()
+{
+    pthread_key_create(&ucs_mpool_mt_global_ctx.tls_key,
+                       ucs_mpool_mt_thread_destroy);
+    ucs_ptr_array_init(&ucs_mpool_mt_global_ctx.pools, 0, "mpool_mt_pools");
+}
+
+void ucs_mpool_global_cleanup()
+{
+    ucs_mpool_mt_thread_t *thread, *tmp;
+
+    pthread_key_delete(ucs_mpool_mt_global_ctx.tls_key);
+
+    /* Release the caches of threads which did not exit, such as the main
+     * thread. Their free elements were returned by ucs_mpool_mt_cleanup(). */
+    pthread_mutex_lock(&ucs_mpool_mt_global_ctx.mutex);
+    ucs_list_for_each_safe(thread, tmp, &ucs_mpool_mt_global_ctx.threads,
+                           list) {
+        ucs_list_del(&thread->list);
+        ucm_orig_munmap(thread, thread->size);
+    }
+    ucs_ptr_array_cleanup(&ucs_mpool_mt_global_ctx.pools);
+    pthread_mutex_unlock(&ucs_mpool_mt_global_ctx.mutex);
+}
+
 ucs_status_t ucs_mpool_chunk_malloc(ucs_mpool_t *mp, size_t *size_p, void **chunk_p)
 {
     *chunk_p = ucs_malloc(*size_p, ucs_mpool_name(mp));
@@ -8,6 +8,10 @@
 #define UCS_MPOOL_H_
 
 #include <stddef.h>
+#include <pthread.h>
+#include <ucs/datastruct/list_types.h>
+#include <ucs/stats/stats.h>
+#include <ucs/type/spinlock.h>
 #include <ucs/type/status.h>
 #include <ucs/sys/compiler_def.h>
 
@@ -20,6 +24,7 @@ typedef union  ucs_mpool_elem    ucs_mpool_elem_t;
 typedef struct ucs_mpool         ucs_mpool_t;
 typedef struct ucs_mpool_data    ucs_mpool_data_t;
 typedef struct ucs_mpool_ops     ucs_mpool_ops_t;
+typedef struct ucs_mpool_mt      ucs_mpool_mt_t;
 
 
 /**
@@ -55,6 +60,7 @@ struct ucs_mpool_chunk {
     ucs_mpool_chunk_t      *next;      /* Next chunk */
     void                   *elems;     /* Array of elements */
     unsigned               num_elems;  /* How many elements */
+    size_t                 size;       /* Size of the chunk memory */
 };
 
 
@@ -80,6 +86,29 @@ struct ucs_mpool_data {
     ucs_mpool_chunk_t      *chunks;         /* List of allocated chunks */
     ucs_mpool_ops_t        *ops;            /* Memory pool operations */
     char                   *name;           /* Name - used for debugging */
+    unsigned               num_chunks;      /* Number of allocated chunks */
+    unsigned               num_elems;       /* Number of elements in all chunks */
+    unsigned               peak_elems;      /* Maximal value of num_elems */
+    size_t                 num_bytes;       /* Total size of allocated chunks */
+    size_t                 peak_bytes;      /* Maximal value of num_bytes */
+    UCS_STATS_NODE_DECLARE(stats)
+};
+
+
+/**
+ * Thread-safe memory pool. Every thread gets and puts elements using its own
+ * cache of free elements, without locking. A cache is refilled from the shared
+ * pool, or flushed back to it, in batches of 'batch_size' elements under a lock.
+ * Elements may be returned to the pool by a thread other than the one which
+ * allocated them.
+ */
+struct ucs_mpool_mt {
+    ucs_mpool_t            super;       /* Shared pool, protected by 'lock' */
+    ucs_spinlock_t         lock;        /* Protects the shared pool */
+    unsigned               index;       /* Index of the pool cache in the
+                                           per-thread caches table */
+    unsigned               batch_size;  /* How many elements are moved between
+                                           a cache and the shared pool at once */
 };
 
 
@@ -215,6 +244,32 @@ void ucs_mpool_put(void *obj);
 void ucs_mpool_grow(ucs_mpool_t *mp, unsigned num_elems);
 
 
+/**
+ * Release the chunks of the memory pool all elements of which are free, to
+ * return the memory of a past allocation burst. The released elements may be
+ * allocated again later, subject to the pool quota.
+ *
+ * @param mp               Memory pool structure.
+ *
+ * @return Number of released chunks.
+ */
+unsigned ucs_mpool_shrink(ucs_mpool_t *mp);
+
+
+/**
+ * Allocate a statistics node of the memory pool, which reports the current and
+ * peak number of elements and bytes allocated by the pool. The node is released
+ * by @ref ucs_mpool_cleanup.
+ *
+ * @param mp               Memory pool structure.
+ * @param stats_parent     Parent statistics node.
+ *
+ * @return UCS status code.
+ */
+ucs_status_t ucs_mpool_stats_alloc(ucs_mpool_t *mp,
+                                   ucs_stats_node_t *stats_parent);
+
+
 /**
  * Allocate and object and grow the memory pool if necessary.
  * Used internally by ucs_mpool_get().
@@ -226,6 +281,55 @@ void ucs_mpool_grow(ucs_mpool_t *mp, unsigned num_elems);
 void *ucs_mpool_get_grow(ucs_mpool_t *mp);
 
 
+/**
+ * Initialize a thread-safe memory pool.
+ * The parameters are the same as for @ref ucs_mpool_init, and the memory pool
+ * operations are called with the shared pool @a mp->super.
+ * @param batch_size       How many elements are moved between a per-thread
+ *                          cache and the shared pool at once. A cache holds up
+ *                          to twice this number of free elements.
+ * @return UCS status code.
+ */
+ucs_status_t ucs_mpool_mt_init(ucs_mpool_mt_t *mp, size_t priv_size,
+                               size_t elem_size, size_t align_offset,
+                               size_t alignment, unsigned elems_per_chunk,
+                               unsigned max_elems, unsigned batch_size,
+                               ucs_mpool_ops_t *ops, const char *name);
+
+
+/**
+ * Cleanup a thread-safe memory pool and release all its memory. Must not be
+ * called concurrently with other operations on the pool.
+ * @param mp               Memory pool structure.
+ * @param leak_check       Whether to check for leaks (object which were not
+ *                          returned to the pool).
+ */
+void ucs_mpool_mt_cleanup(ucs_mpool_mt_t *mp, int leak_check);
+
+
+/**
+ * Get an element from the thread-safe memory pool.
+ * @param mp               Memory pool structure.
+ * @return New allocated object, or NULL if cannot allocate.
+ */
+void *ucs_mpool_mt_get(ucs_mpool_mt_t *mp);
+
+
+/**
+ * Return an object to the thread-safe memory pool it was allocated from.
+ * @param obj              Object to return.
+ */
+void ucs_mpool_mt_put(void *obj);
+
+
+/**
+ * Global initialization and cleanup of the per-thread caches of thread-safe
+ * memory pools.
+ */
+void ucs_mpool_global_init();
+void ucs_mpool_global_cleanup();
+
+
 /**
  * heap-based chunk allocator.
  */
@@ -10,12 +10,18 @@
 
 #include "pgtable.h"
 
+#include <ucs/arch/atomic.h>
 #include <ucs/arch/bitops.h>
+#include <ucs/arch/cpu.h>
+#include <ucs/datastruct/list.h>
+#include <ucs/datastruct/queue.h>
 #include <ucs/debug/assert.h>
 #include <ucs/debug/log.h>
 #include <ucs/debug/memtrack.h>
 #include <ucs/sys/math.h>
+#include <pthread.h>
 #include <string.h>
+#include <sched.h>
 
 
 #define ucs_pgt_entry_clear(_pte) \
@@ -65,6 +71,44 @@
         (ucs_pgt_dir_t*)ucs_pgt_entry_value(_pte); \
     })
 
+/* Read a field which may be modified concurrently */
+#define ucs_pgt_read_once(_field) \
+    (*(const volatile typeof(_field)*)&(_field))
+
+
+/* State of a thread which performs concurrent lookups. Placed on a separate
+ * cache line, to avoid false sharing between readers. */
+typedef struct ucs_pgtable_reader {
+    volatile uint64_t       epoch;       /* Global epoch when the current reader
+                                            section was started, or 0 if the
+                                            thread is not in a reader section */
+    int                     registered;  /* Whether added to the readers list */
+    ucs_list_link_t         list;        /* Entry in the global readers list */
+} UCS_V_ALIGNED(UCS_SYS_CACHE_LINE_SIZE) ucs_pgtable_reader_t;
+
+
+/* Global list of threads which perform concurrent lookups */
+typedef struct ucs_pgtable_global_context {
+    pthread_key_t           tls_key;     /* Unregisters readers on thread exit */
+    pthread_mutex_t         mutex;       /* Protects the readers list */
+    ucs_list_link_t         readers;     /* List of registered readers */
+    volatile unsigned       num_readers; /* Number of registered readers */
+    volatile uint64_t       epoch;       /* Advanced to release deferred
+                                            objects */
+} ucs_pgtable_global_context_t;
+
+
+static ucs_pgtable_global_context_t ucs_pgtable_global_ctx = {
+    .mutex       = PTHREAD_MUTEX_INITIALIZER,
+    .readers     = UCS_LIST_INITIALIZER(&ucs_pgtable_global_ctx.readers,
+                                        &ucs_pgtable_global_ctx.readers),
+    .num_readers = 0,
+    .epoch       = 1
+};
+
+
+static __thread ucs_pgtable_reader_t ucs_pgtable_reader;
+
 
 static inline ucs_pgt_dir_t* ucs_pgt_dir_alloc(ucs_pgtable_t *pgtable)
 {
@@ -77,12 +121,23 @@ static inline ucs_pgt_dir_t* ucs_pgt_dir_alloc(ucs_pgtable_t *pgtable)
 
     ucs_pgt_check_ptr(pgd);
     memset(pgd, 0, sizeof(*pgd));
+
+    /* Concurrent readers must observe the directory initialized */
+    ucs_memory_cpu_store_fence();
     return pgd;
 }
 
+static void ucs_pgt_dir_deferred_release(ucs_pgtable_t *pgtable,
+                                         ucs_pgt_deferred_t *deferred)
+{
+    pgtable->pgd_release_cb(pgtable, ucs_container_of(deferred, ucs_pgt_dir_t,
+                                                      deferred));
+}
+
 static inline void ucs_pgt_dir_release(ucs_pgtable_t *pgtable, ucs_pgt_dir_t* pgd)
 {
-    pgtable->pgd_release_cb(pgtable, pgd);
+    /* Concurrent readers may still access the directory */
+    ucs_pgtable_defer(pgtable, &pgd->deferred, ucs_pgt_dir_deferred_release);
 }
 
 static inline void ucs_pgt_address_advance(ucs_pgt_addr_t *address_p,
@@ -93,6 +148,90 @@ static inline void ucs_pgt_address_advance(ucs_pgt_addr_t *address_p,
     *address_p += 1ul << order;
 }
 
+void ucs_pgtable_defer(ucs_pgtable_t *pgtable, ucs_pgt_deferred_t *deferred,
+                       ucs_pgt_deferred_cb_t cb)
+{
+    /* Order removing the object from the page table before reading the epoch.
+     * Readers which observe the next epoch can't find the object anymore. */
+    ucs_memory_bus_fence();
+    deferred->epoch = ucs_pgtable_global_ctx.epoch + 1;
+    deferred->cb    = cb;
+    ucs_queue_push(&pgtable->deferred, &deferred->queue);
+}
+
+void ucs_pgtable_progress(ucs_pgtable_t *pgtable)
+{
+    uint64_t epoch, min_epoch, reader_epoch;
+    ucs_pgtable_reader_t *reader;
+    ucs_pgt_deferred_t *deferred;
+
+    if (ucs_queue_is_empty(&pgtable->deferred)) {
+        return;
+    }
+
+    /* Start the epoch of the newest deferred object, once for all of them.
+     * The global epoch could be advanced meanwhile by another page table. */
+    deferred = ucs_queue_tail_elem_non_empty(&pgtable->deferred,
+                                             ucs_pgt_deferred_t, queue);
+    epoch    = deferred->epoch;
+    ucs_atomic_cswap64(&ucs_pgtable_global_ctx.epoch, epoch - 1, epoch);
+    ucs_memory_bus_fence();
+
+    /* Find the oldest running reader section */
+    min_epoch = UINT64_MAX;
+    if (ucs_pgtable_global_ctx.num_readers > 0) {
+        if (pthread_mutex_trylock(&ucs_pgtable_global_ctx.mutex) != 0) {
+            return; /* Readers list is being modified, try next time */
+        }
+
+        ucs_list_for_each(reader, &ucs_pgtable_global_ctx.readers, list) {
+            reader_epoch = reader->epoch;
+            if (reader_epoch != 0) {
+                min_epoch = ucs_min(min_epoch, reader_epoch);
+            }
+        }
+
+        pthread_mutex_unlock(&ucs_pgtable_global_ctx.mutex);
+    }
+
+    /* Release the objects which were deferred before the oldest reader
+     * section has started. The queue is ordered by epoch. */
+    while (!ucs_queue_is_empty(&pgtable->deferred)) {
+        deferred = ucs_queue_head_elem_non_empty(&pgtable->deferred,
+                                                 ucs_pgt_deferred_t, queue);
+        if (deferred->epoch > min_epoch) {
+            break;
+        }
+
+        ucs_queue_pull_non_empty(&pgtable->deferred);
+        deferred->cb(pgtable, deferred);
+    }
+}
+
+void ucs_pgtable_update_begin(ucs_pgtable_t *pgtable)
+{
+    if (pgtable->update_depth++ > 0) {
+        return;
+    }
+
+    ucs_assertv(!(pgtable->seq & 1), "seq=%u", pgtable->seq);
+    ++pgtable->seq;
+    ucs_memory_cpu_store_fence();
+}
+
+void ucs_pgtable_update_end(ucs_pgtable_t *pgtable)
+{
+    ucs_assert(pgtable->update_depth > 0);
+    if (--pgtable->update_depth > 0) {
+        return;
+    }
+
+    ucs_memory_cpu_store_fence();
+    ++pgtable->seq;
+
+    ucs_pgtable_progress(pgtable);
+}
+
 static void ucs_pgt_entry_dump_recurs(const ucs_pgtable_t *pgtable, unsigned indent,
                                       const ucs_pgt_entry_t *pte, unsigned pte_index,
                                       ucs_pgt_addr_t base, ucs_pgt_addr_t mask,
@@ -165,6 +304,7 @@ static void ucs_pgtable_expand(ucs_pgtable_t *pgtable)
         pgd->entries[(pgtable->base >> pgtable->shift) & UCS_PGT_ENTRY_MASK] =
                         pgtable->root;
         pgd->count = 1;
+        ucs_memory_cpu_store_fence();
         ucs_pgt_entry_set_dir(&pgtable->root, pgd);
     }
 
@@ -415,6 +555,7 @@ ucs_status_t ucs_pgtable_insert(ucs_pgtable_t *pgtable, ucs_pgt_region_t *region
     }
 
     ucs_assert(address != end);
+    ucs_pgtable_update_begin(pgtable);
     while (address < end) {
         order = ucs_pgtable_get_next_page_order(address, end);
         status = ucs_pgtable_insert_page(pgtable, address, order, region);
@@ -425,6 +566,7 @@ ucs_status_t ucs_pgtable_insert(ucs_pgtable_t *pgtable, ucs_pgt_region_t *region
         ucs_pgt_address_advance(&address, order);
     }
     ++pgtable->num_regions;
+    ucs_pgtable_update_end(pgtable);
 
     ucs_pgtable_trace(pgtable, "insert");
     return UCS_OK;
@@ -438,6 +580,7 @@ err:
         ucs_pgtable_remove_page(pgtable, address, order, region);
         ucs_pgt_address_advance(&address, order);
     }
+    ucs_pgtable_update_end(pgtable);
     return status;
 }
 
@@ -456,11 +599,13 @@ ucs_status_t ucs_pgtable_remove(ucs_pgtable_t *pgtable, ucs_pgt_region_t *region
         return UCS_ERR_NO_ELEM;
     }
 
+    ucs_pgtable_update_begin(pgtable);
     while (address < end) {
         order = ucs_pgtable_get_next_page_order(address, end);
         status = ucs_pgtable_remove_page(pgtable, address, order, region);
         if (status != UCS_OK) {
             ucs_assert(address == region->start); /* Cannot be partially removed */
+            ucs_pgtable_update_end(pgtable);
             return status;
         }
 
@@ -469,6 +614,7 @@ ucs_status_t ucs_pgtable_remove(ucs_pgtable_t *pgtable, ucs_pgt_region_t *region
 
     ucs_assert(pgtable->num_regions > 0);
     --pgtable->num_regions;
+    ucs_pgtable_update_end(pgtable);
 
     ucs_pgtable_trace(pgtable, "remove");
     return UCS_OK;
@@ -507,6 +653,113 @@ ucs_pgt_region_t *ucs_pgtable_lookup(const ucs_pgtable_t *pgtable,
     }
 }
 
+ucs_status_t ucs_pgtable_lookup_concurrent(const ucs_pgtable_t *pgtable,
+                                           ucs_pgt_addr_t address,
+                                           ucs_pgt_region_t **region_p)
+{
+    ucs_pgt_region_t *region;
+    ucs_pgt_addr_t value;
+    ucs_pgt_dir_t *dir;
+    unsigned shift;
+    uint32_t seq;
+
+    ucs_trace_func("pgtable=%p address=0x%lx", pgtable, address);
+
+    seq = pgtable->seq;
+    if (seq & 1) {
+        return UCS_ERR_BUSY;
+    }
+
+    ucs_memory_cpu_load_fence();
+
+    /* Same as ucs_pgtable_lookup(), but every entry is read only once, since it
+     * may be changed concurrently. The result is validated by the sequence
+     * number, so intermediate values are only required to be safe to access.
+     */
+    region = NULL;
+    if ((address & ucs_pgt_read_once(pgtable->mask)) ==
+        ucs_pgt_read_once(pgtable->base)) {
+        value = ucs_pgt_read_once(pgtable->root.value);
+        shift = ucs_pgt_read_once(pgtable->shift);
+        for (;;) {
+            if (value & UCS_PGT_ENTRY_FLAG_REGION) {
+                region = (ucs_pgt_region_t*)(value & UCS_PGT_ENTRY_PTR_MASK);
+                break;
+            } else if ((value & UCS_PGT_ENTRY_FLAG_DIR) &&
+                       (shift >= UCS_PGT_ENTRY_SHIFT)) {
+                dir    = (ucs_pgt_dir_t*)(value & UCS_PGT_ENTRY_PTR_MASK);
+                shift -= UCS_PGT_ENTRY_SHIFT;
+                value  = ucs_pgt_read_once(
+                            dir->entries[(address >> shift) & UCS_PGT_ENTRY_MASK].value);
+            } else {
+                break;
+            }
+        }
+    }
+
+    ucs_memory_cpu_load_fence();
+    if (pgtable->seq != seq) {
+        return UCS_ERR_BUSY;
+    }
+
+    *region_p = region;
+    return UCS_OK;
+}
+
+static UCS_F_NOINLINE void
+ucs_pgtable_reader_register(ucs_pgtable_reader_t *reader)
+{
+    pthread_mutex_lock(&ucs_pgtable_global_ctx.mutex);
+    ucs_list_add_tail(&ucs_pgtable_global_ctx.readers, &reader->list);
+    ++ucs_pgtable_global_ctx.num_readers;
+    pthread_mutex_unlock(&ucs_pgtable_global_ctx.mutex);
+
+    reader->registered = 1;
+    pthread_setspecific(ucs_pgtable_global_ctx.tls_key, reader);
+}
+
+static void ucs_pgtable_reader_unregister(ucs_pgtable_reader_t *reader)
+{
+    ucs_assert(reader->epoch == 0);
+    ucs_list_del(&reader->list);
+    --ucs_pgtable_global_ctx.num_readers;
+    reader->registered = 0;
+}
+
+static void ucs_pgtable_reader_key_destr(void *data)
+{
+    pthread_mutex_lock(&ucs_pgtable_global_ctx.mutex);
+    ucs_pgtable_reader_unregister(data);
+    pthread_mutex_unlock(&ucs_pgtable_global_ctx.mutex);
+}
+
+void ucs_pgtable_reader_enter()
+{
+    ucs_pgtable_reader_t *reader = &ucs_pgtable_reader;
+
+    if (ucs_unlikely(!reader->registered)) {
+        ucs_pgtable_reader_register(reader);
+    }
+
+    ucs_assert(reader->epoch == 0); /* reader sections must not be nested */
+    reader->epoch = ucs_pgtable_global_ctx.epoch;
+
+    /* Make the reader section visible before accessing the page table */
+    ucs_memory_bus_fence();
+}
+
+void ucs_pgtable_reader_exit()
+{
+    ucs_pgtable_reader_t *reader = &ucs_pgtable_reader;
+
+    ucs_assert(reader->registered);
+    ucs_assert(reader->epoch != 0);
+
+    /* Complete accessing the page table before leaving the section */
+    ucs_memory_cpu_fence();
+    reader->epoch = 0;
+}
+
 static void ucs_pgtable_search_recurs(const ucs_pgtable_t *pgtable,
                                       ucs_pgt_addr_t address, unsigned order,
                                       const ucs_pgt_entry_t *pte, unsigned shift,
@@ -630,6 +883,8 @@ void ucs_pgtable_purge(ucs_pgtable_t *pgtable, ucs_pgt_search_callback_t cb,
                 "next_region=%p all_regions=%p num_regions=%u",
                 next_region, all_regions, num_regions);
 
+    /* Release the removed directories in one batch */
+    ucs_pgtable_update_begin(pgtable);
     for (i = 0; i < num_regions; ++i) {
         region = all_regions[i];
         status = ucs_pgtable_remove(pgtable, region);
@@ -639,6 +894,7 @@ void ucs_pgtable_purge(ucs_pgtable_t *pgtable, ucs_pgt_search_callback_t cb,
         }
         cb(pgtable, region, arg);
     }
+    ucs_pgtable_update_end(pgtable);
 
     ucs_free(all_regions);
 
@@ -665,6 +921,9 @@ ucs_status_t ucs_pgtable_init(ucs_pgtable_t *pgtable,
     ucs_pgt_entry_clear(&pgtable->root);
     ucs_pgtable_reset(pgtable);
     pgtable->num_regions    = 0;
+    pgtable->seq            = 0;
+    pgtable->update_depth   = 0;
+    ucs_queue_head_init(&pgtable->deferred);
     pgtable->pgd_alloc_cb   = alloc_cb;
     pgtable->pgd_release_cb = release_cb;
     return UCS_OK;
@@ -675,4 +934,36 @@ void ucs_pgtable_cleanup(ucs_pgtable_t *pgtable)
     if (pgtable->num_regions != 0) {
         ucs_warn("page table not empty during cleanup");
     }
+
+    ucs_assert(pgtable->update_depth == 0);
+
+    /* Wait until concurrent readers finish accessing the deferred objects */
+    for (;;) {
+        ucs_pgtable_progress(pgtable);
+        if (ucs_queue_is_empty(&pgtable->deferred)) {
+            break;
+        }
+
+        sched_yield();
+    }
+}
+
+void ucs_pgtable_global_init()
+{
+    pthread_key_create(&ucs_pgtable_global_ctx.tls_key,
+                       ucs_pgtable_reader_key_destr);
+}
+
+void ucs_pgtable_global_cleanup()
+{
+    ucs_pgtable_reader_t *reader, *tmp;
+
+    pthread_key_delete(ucs_pgtable_global_ctx.tls_key);
+
+    /* Release readers of threads which did not exit, such as the main thread */
+    pthread_mutex_lock(&ucs_pgtable_global_ctx.mutex);
+    ucs_list_for_each_safe(reader, tmp, &ucs_pgtable_global_ctx.readers, list) {
+        ucs_pgtable_reader_unregister(reader);
+    }
+    pthread_mutex_unlock(&ucs_pgtable_global_ctx.mutex);
 }
@@ -8,8 +8,10 @@
 #define UCS_PGTABLE_H_
 
 #include <ucs/config/types.h>
+#include <ucs/datastruct/queue_types.h>
 #include <ucs/sys/compiler_def.h>
 #include <ucs/type/status.h>
+#include <stdint.h>
 
 /*
  * The Page Table data structure organizes non-overlapping regions of memory in
@@ -19,6 +21,19 @@
  * UCS_PGT_PTE_FLAG_REGION bit), or another entry (indicated by UCS_PGT_PTE_FLAG_DIR),
  * or be empty - if none of these bits is set.
  *
+ * Concurrent lookups:
+ * Modifications of the page table must be serialized by the user, but lookups
+ * may run concurrently with them, without taking any lock, by using
+ * @ref ucs_pgtable_lookup_concurrent inside a reader section, which is
+ * delimited by @ref ucs_pgtable_reader_enter and @ref ucs_pgtable_reader_exit.
+ * Every modification increments a sequence number, which allows the reader to
+ * detect that it may have observed a partially updated page table. Memory of
+ * directories and regions which were removed from the page table must be kept
+ * valid until all reader sections which could observe them are finished. The
+ * page table does not wait for it: removed directories, as well as regions
+ * passed to @ref ucs_pgtable_defer, are queued with the current epoch, and
+ * released in batches by @ref ucs_pgtable_progress once no reader section
+ * which started before the epoch is still running.
  */
 
 
@@ -58,6 +73,7 @@ typedef struct ucs_pgtable         ucs_pgtable_t;
 typedef struct ucs_pgt_region      ucs_pgt_region_t;
 typedef struct ucs_pgt_entry       ucs_pgt_entry_t;
 typedef struct ucs_pgt_dir         ucs_pgt_dir_t;
+typedef struct ucs_pgt_deferred    ucs_pgt_deferred_t;
 
 
 /**
@@ -82,6 +98,17 @@ typedef void (*ucs_pgt_dir_release_callback_t)(const ucs_pgtable_t *pgtable,
                                                ucs_pgt_dir_t *pgdir);
 
 
+/**
+ * Callback for releasing an object whose release was deferred by
+ * @ref ucs_pgtable_defer.
+ *
+ * @param [in]  pgtable   Page table which deferred the release.
+ * @param [in]  deferred  Deferred release element embedded in the object.
+ */
+typedef void (*ucs_pgt_deferred_cb_t)(ucs_pgtable_t *pgtable,
+                                      ucs_pgt_deferred_t *deferred);
+
+
 /**
  * Callback for searching for regions in the page table.
  *
@@ -120,12 +147,26 @@ struct ucs_pgt_entry {
 };
 
 
+/**
+ * Object which can't be released until concurrent readers stop accessing it.
+ */
+struct ucs_pgt_deferred {
+    ucs_queue_elem_t               queue;       /**< Element in the page table
+                                                     deferred queue */
+    uint64_t                       epoch;       /**< Readers which started at
+                                                     this epoch, or later, can't
+                                                     access the object */
+    ucs_pgt_deferred_cb_t          cb;          /**< Release callback */
+};
+
+
 /**
  * Page table directory.
  */
 struct ucs_pgt_dir {
     ucs_pgt_entry_t                entries[UCS_PGT_ENTRIES_PER_DIR];
     unsigned                       count;       /**< Number of valid entries */
+    ucs_pgt_deferred_t             deferred;    /**< Deferred release element */
 };
 
 
@@ -140,6 +181,11 @@ struct ucs_pgtable {
     ucs_pgt_addr_t                 mask;        /**< mask for page table address range */
     unsigned                       shift;       /**< page table address span is 2**shift */
     unsigned                       num_regions; /**< total number of regions */
+    volatile uint32_t              seq;         /**< modification sequence number,
+                                                     odd while being modified */
+    unsigned                       update_depth; /**< nesting of update sections */
+    ucs_queue_head_t               deferred;    /**< objects to release after
+                                                     a grace period */
     ucs_pgt_dir_alloc_callback_t   pgd_alloc_cb;
     ucs_pgt_dir_release_callback_t pgd_release_cb;
 };
@@ -160,7 +206,8 @@ ucs_status_t ucs_pgtable_init(ucs_pgtable_t *pgtable,
                               ucs_pgt_dir_release_callback_t release_cb);
 
 /**
- * Cleanup the page table and release all associated memory.
+ * Cleanup the page table and release all associated memory. Waits until all
+ * deferred objects are released.
  *
  * @param [in]  pgtable     Page table to initialize.
  */
@@ -177,6 +224,8 @@ void ucs_pgtable_cleanup(ucs_pgtable_t *pgtable);
  * @return UCS_OK - region was added.
  *         UCS_ERR_INVALID_PARAM - memory region address in invalid (misaligned or empty)
  *         UCS_ERR_ALREADY_EXISTS - the region overlaps with existing region.
+ *         If the region was not added, concurrent readers may still access
+ *         it, so its memory must be released by @ref ucs_pgtable_defer.
  *
  */
 ucs_status_t ucs_pgtable_insert(ucs_pgtable_t *pgtable, ucs_pgt_region_t *region);
@@ -187,7 +236,10 @@ ucs_status_t ucs_pgtable_insert(ucs_pgtable_t *pgtable, ucs_pgt_region_t *region
  *
  * @param [in]  pgtable     Page table to remove the region from.
  * @param [in]  region      Memory region to remove. This must be the same pointer
- *                           passed to @ref ucs_pgtable_insert.
+ *                           passed to @ref ucs_pgtable_insert. Concurrent
+ *                           readers may still access the region when the
+ *                           function returns, so its memory must be released
+ *                           by @ref ucs_pgtable_defer.
  *
  * @return UCS_OK - region was removed.
  *         UCS_ERR_INVALID_PARAM - memory region address in invalid (misaligned or empty)
@@ -209,6 +261,84 @@ ucs_pgt_region_t *ucs_pgtable_lookup(const ucs_pgtable_t *pgtable,
                                      ucs_pgt_addr_t address);
 
 
+/**
+ * Find a region which contains the given address, concurrently with page table
+ * modifications. Must be called inside a reader section.
+ *
+ * @param [in]  pgtable     Page table to search the address in.
+ * @param [in]  address     Address to search.
+ * @param [out] region_p    Filled with the region which contains 'address', or
+ *                           with NULL if not found. The region remains valid
+ *                           until the reader section is finished.
+ *
+ * @return UCS_OK - the lookup result is consistent.
+ *         UCS_ERR_BUSY - the page table was modified during the lookup, and
+ *                        the result is unknown. The caller should repeat the
+ *                        lookup while holding the lock which serializes the
+ *                        modifications.
+ */
+ucs_status_t ucs_pgtable_lookup_concurrent(const ucs_pgtable_t *pgtable,
+                                           ucs_pgt_addr_t address,
+                                           ucs_pgt_region_t **region_p);
+
+
+/**
+ * Start a reader section of the calling thread, which allows using
+ * @ref ucs_pgtable_lookup_concurrent. Reader sections must not be nested, and
+ * the thread must not clean up any page table inside a reader section.
+ */
+void ucs_pgtable_reader_enter(void);
+
+
+/**
+ * Finish the reader section of the calling thread. Regions which were found
+ * inside the section must not be accessed after it, unless they are protected
+ * by other means (for example, a reference count).
+ */
+void ucs_pgtable_reader_exit(void);
+
+
+/**
+ * Release an object which was removed from the page table, after all reader
+ * sections which could observe it are finished. Must be called with the lock
+ * which serializes the modifications of the page table.
+ *
+ * @param [in]  pgtable     Page table the object was removed from.
+ * @param [in]  deferred    Deferred release element embedded in the object.
+ * @param [in]  cb          Callback which releases the object.
+ */
+void ucs_pgtable_defer(ucs_pgtable_t *pgtable, ucs_pgt_deferred_t *deferred,
+                       ucs_pgt_deferred_cb_t cb);
+
+
+/**
+ * Release the deferred objects which can't be accessed by readers anymore.
+ * Does not wait for running reader sections. Called after each modification
+ * of the page table, and must be called with the same lock.
+ *
+ * @param [in]  pgtable     Page table to release the deferred objects of.
+ */
+void ucs_pgtable_progress(ucs_pgtable_t *pgtable);
+
+
+/**
+ * Start an update section, in which several modifications of the page table
+ * are observed by concurrent readers as a single one. Update sections may be
+ * nested.
+ *
+ * @param [in]  pgtable     Page table which is going to be modified.
+ */
+void ucs_pgtable_update_begin(ucs_pgtable_t *pgtable);
+
+
+/**
+ * Finish an update section which was started by @ref ucs_pgtable_update_begin.
+ *
+ * @param [in]  pgtable     Page table which was modified.
+ */
+void ucs_pgtable_update_end(ucs_pgtable_t *pgtable);
+
+
 /**
  * Search for all regions overlapping with a given address range.
  *
@@ -231,6 +361,8 @@ void ucs_pgtable_search_range(const ucs_pgtable_t *pgtable,
  * @param [in]  cb          Callback to be called for every region, after it (and
  *                           all others) are removed.
  *                           The callback must not modify the page table.
+ *                           Concurrent readers may still access the region, so
+ *                           its memory must be released by @ref ucs_pgtable_defer.
  * @param [in]  arg         User-defined argument to the callback.
  */
 void ucs_pgtable_purge(ucs_pgtable_t *pgtable, ucs_pgt_search_callback_t cb,
@@ -246,6 +378,13 @@ void ucs_pgtable_purge(ucs_pgtable_t *pgtable, ucs_pgt_search_callback_t cb,
 void ucs_pgtable_dump(const ucs_pgtable_t *pgtable, ucs_log_level_t log_level);
 
 
+/**
+ * Global initialization and cleanup of concurrent readers support.
+ */
+void ucs_pgtable_global_init();
+void ucs_pgtable_global_cleanup();
+
+
 /**
  * @return >Number of regions currently present in the page table.
  */
@@ -44,6 +44,21 @@ static void ucs_memtype_cache_pgt_dir_release(const ucs_pgtable_t *pgtable,
     ucs_free(dir);
 }
 
+static void ucs_memtype_cache_region_release(ucs_pgtable_t *pgtable,
+                                             ucs_pgt_deferred_t *deferred)
+{
+    ucs_free(ucs_container_of(deferred, ucs_memtype_cache_region_t, deferred));
+}
+
+/* Lock must be held in write mode */
+static void ucs_memtype_cache_region_defer(ucs_memtype_cache_t *memtype_cache,
+                                           ucs_memtype_cache_region_t *region)
+{
+    /* Concurrent lookups may still access the region */
+    ucs_pgtable_defer(&memtype_cache->pgtable, &region->deferred,
+                      ucs_memtype_cache_region_release);
+}
+
 /*
  * - Lock must be held in write mode
  * - start, end must be aligned to page size
@@ -78,7 +93,7 @@ static void ucs_memtype_cache_insert(ucs_memtype_cache_t *memtype_cache,
     if (status != UCS_OK) {
         ucs_error("failed to insert region " UCS_PGT_REGION_FMT ": %s",
                   UCS_PGT_REGION_ARG(&region->super), ucs_status_string(status));
-        ucs_free(region);
+        ucs_memtype_cache_region_defer(memtype_cache, region);
         return;
     }
 
@@ -133,6 +148,10 @@ UCS_PROFILE_FUNC_VOID(ucs_memtype_cache_update_internal,
 
     pthread_rwlock_wrlock(&memtype_cache->lock);
 
+    /* concurrent lookups should not observe the range without a memory type
+     * while it's being replaced */
+    ucs_pgtable_update_begin(&memtype_cache->pgtable);
+
     /* find and remove all regions which intersect with new one */
     ucs_pgtable_search_range(&memtype_cache->pgtable, search_start, search_end,
                              ucs_memtype_cache_region_collect_callback,
@@ -186,10 +205,11 @@ UCS_PROFILE_FUNC_VOID(ucs_memtype_cache_update_internal,
                                      region->mem_type);
         }
 
-        ucs_free(region);
+        ucs_memtype_cache_region_defer(memtype_cache, region);
     }
 
 out_unlock:
+    ucs_pgtable_update_end(&memtype_cache->pgtable);
     pthread_rwlock_unlock(&memtype_cache->lock);
 }
 
@@ -238,35 +258,54 @@ static void ucs_memtype_cache_purge(ucs_memtype_cache_t *memtype_cache)
     ucs_pgtable_purge(&memtype_cache->pgtable,
                       ucs_memtype_cache_region_collect_callback, &region_list);
     ucs_list_for_each_safe(region, tmp, &region_list, list) {
-        ucs_free(region);
+        ucs_memtype_cache_region_defer(memtype_cache, region);
     }
 }
 
+static ucs_status_t
+ucs_memtype_cache_region_type(const ucs_pgt_region_t *pgt_region,
+                              ucs_pgt_addr_t start, size_t size,
+                              ucs_memory_type_t *mem_type_p)
+{
+    const ucs_memtype_cache_region_t *region;
+
+    if (pgt_region == NULL) {
+        return UCS_ERR_NO_ELEM;
+    }
+
+    region      = ucs_derived_of(pgt_region, ucs_memtype_cache_region_t);
+    *mem_type_p = ((pgt_region->end >= (start + size)) ?
+                   region->mem_type : UCS_MEMORY_TYPE_LAST);
+    return UCS_OK;
+}
+
 UCS_PROFILE_FUNC(ucs_status_t, ucs_memtype_cache_lookup,
                  (memtype_cache, address, size, mem_type_p),
                  ucs_memtype_cache_t *memtype_cache, const void *address,
                  size_t size, ucs_memory_type_t *mem_type_p)
 {
     const ucs_pgt_addr_t start = (uintptr_t)address;
-    ucs_memtype_cache_region_t *region;
     ucs_pgt_region_t *pgt_region;
     ucs_status_t status;
 
-    pthread_rwlock_rdlock(&memtype_cache->lock);
+    /* Fast path: lookup without taking the lock */
+    ucs_pgtable_reader_enter();
+    status = UCS_PROFILE_CALL(ucs_pgtable_lookup_concurrent,
+                              &memtype_cache->pgtable, start, &pgt_region);
+    if (ucs_likely(status == UCS_OK)) {
+        status = ucs_memtype_cache_region_type(pgt_region, start, size,
+                                               mem_type_p);
+        ucs_pgtable_reader_exit();
+        return status;
+    }
+    ucs_pgtable_reader_exit();
 
+    /* Slow path: the page table is being updated */
+    pthread_rwlock_rdlock(&memtype_cache->lock);
     pgt_region = UCS_PROFILE_CALL(ucs_pgtable_lookup, &memtype_cache->pgtable,
                                   start);
-    if (pgt_region == NULL) {
-        status = UCS_ERR_NO_ELEM;
-        goto out_unlock;
-    }
-
-    region      = ucs_derived_of(pgt_region, ucs_memtype_cache_region_t);
-    *mem_type_p = ((pgt_region->end >= (start + size)) ?
-                   region->mem_type : UCS_MEMORY_TYPE_LAST);
-    status      = UCS_OK;
-
-out_unlock:
+    status     = ucs_memtype_cache_region_type(pgt_region, start, size,
+                                               mem_type_p);
     pthread_rwlock_unlock(&memtype_cache->lock);
     return status;
 }
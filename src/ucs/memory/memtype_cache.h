@@ -26,6 +26,8 @@ struct ucs_memtype_cache_region {
     ucs_pgt_region_t    super;    /**< Base class - page table region */
     ucs_list_link_t     list;     /**< List element */
     ucs_memory_type_t   mem_type; /**< Memory type the address belongs to */
+    ucs_pgt_deferred_t  deferred; /**< Releases the region after concurrent
+                                       lookups finish */
 };
 
 
@@ -8,6 +8,8 @@
 
 #include <ucs/debug/assert.h>
 #include <ucs/debug/log.h>
+#include <ucs/sys/math.h>
+#include <ucs/sys/sys.h>
 #include <stdint.h>
 #include <sched.h>
 
@@ -67,4 +69,68 @@ int ucs_numa_node_of_cpu(int cpu)
     return cpu_numa_nodes[cpu] - 1;
 }
 
+ucs_status_t ucs_numa_mem_bind(void *address, size_t length,
+                               ucs_numa_policy_t policy, int node)
+{
+    struct bitmask *nodemask;
+    uintptr_t start, end;
+    ucs_status_t status;
+    int mode, ret;
+
+    switch (policy) {
+    case UCS_NUMA_POLICY_BIND:
+        mode = MPOL_BIND;
+        break;
+    case UCS_NUMA_POLICY_PREFERRED:
+        mode = MPOL_PREFERRED;
+        break;
+    default:
+        return UCS_ERR_INVALID_PARAM;
+    }
+
+    if ((node < 0) || (numa_available() < 0)) {
+        return UCS_ERR_UNSUPPORTED;
+    }
+
+    nodemask = numa_allocate_nodemask();
+    if (nodemask == NULL) {
+        return UCS_ERR_NO_MEMORY;
+    }
+
+    numa_bitmask_clearall(nodemask);
+    numa_bitmask_setbit(nodemask, node);
+
+    start = ucs_align_down_pow2((uintptr_t)address, ucs_get_page_size());
+    end   = ucs_align_up_pow2((uintptr_t)address + length, ucs_get_page_size());
+
+    /* move the pages which were already touched by another node */
+    ret = mbind((void*)start, end - start, mode, numa_nodemask_p(nodemask),
+                numa_nodemask_size(nodemask), MPOL_MF_MOVE);
+    if (ret < 0) {
+        ucs_debug("mbind(0x%lx..0x%lx, mode=%d, node=%d) failed: %m", start,
+                  end, mode, node);
+        status = UCS_ERR_IO_ERROR;
+    } else {
+        ucs_trace("0x%lx..0x%lx: numa policy set to %d, node %d", start, end,
+                  mode, node);
+        status = UCS_OK;
+    }
+
+    numa_free_nodemask(nodemask);
+    return status;
+}
+
+#else
+
+int ucs_numa_node_of_cpu(int cpu)
+{
+    return -1;
+}
+
+ucs_status_t ucs_numa_mem_bind(void *address, size_t length,
+                               ucs_numa_policy_t policy, int node)
+{
+    return UCS_ERR_UNSUPPORTED;
+}
+
 #endif
@@ -12,6 +12,7 @@
 #endif
 
 #include <ucs/debug/memtrack.h>
+#include <ucs/type/status.h>
 
 #if HAVE_NUMA
 #include <numaif.h>
@@ -59,7 +60,26 @@ typedef enum {
 extern const char *ucs_numa_policy_names[];
 
 
+/**
+ * @return NUMA node of the given CPU, or -1 if NUMA support is not available.
+ */
 int ucs_numa_node_of_cpu(int cpu);
 
 
+/**
+ * Set the NUMA memory policy of an address range to the given node, and move
+ * the pages which were already allocated on other nodes.
+ *
+ * @param [in] address  Start of the address range.
+ * @param [in] length   Length of the address range.
+ * @param [in] policy   Memory policy, must not be UCS_NUMA_POLICY_DEFAULT.
+ * @param [in] node     NUMA node to place the memory on.
+ *
+ * @return UCS_OK if the policy was set, UCS_ERR_UNSUPPORTED if NUMA support
+ *         is not available, or another error if setting the policy failed.
+ */
+ucs_status_t ucs_numa_mem_bind(void *address, size_t length,
+                               ucs_numa_policy_t policy, int node);
+
+
 #endif
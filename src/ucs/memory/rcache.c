@@ -6,6 +6,7 @@
 
 
 #include <ucs/arch/atomic.h>
+#include <ucs/arch/cpu.h>
 #include <ucs/type/class.h>
 #include <ucs/datastruct/queue.h>
 #include <ucs/debug/log.h>
@@ -20,6 +21,10 @@
 #include "rcache.h"
 #include "rcache_int.h"
 
+/* Number of invalidation entries moved between a thread cache and the shared
+ * pool at once */
+#define UCS_RCACHE_INV_MP_BATCH 16
+
 #define ucs_rcache_region_log(_level, _message, ...) \
     do { \
         if (ucs_log_is_enabled(_level)) { \
@@ -41,6 +46,12 @@
     ((_region)->priv)
 
 
+/* Region LRU flags */
+enum {
+    UCS_RCACHE_LRU_FLAG_IN_LIST = UCS_BIT(0) /* Region is in the LRU list */
+};
+
+
 typedef struct ucs_rcache_inv_entry {
     ucs_queue_elem_t         queue;
     ucs_pgt_addr_t           start;
@@ -63,6 +74,8 @@ static ucs_stats_class_t ucs_rcache_stats_class = {
         [UCS_RCACHE_PUTS]               = "puts",
         [UCS_RCACHE_REGS]               = "mem_regs",
         [UCS_RCACHE_DEREGS]             = "mem_deregs",
+        [UCS_RCACHE_EVICTS]             = "regions_evicted",
+        [UCS_RCACHE_OVER_LIMIT]         = "over_limit",
     }
 };
 #endif
@@ -158,7 +171,7 @@ static ucs_mpool_ops_t ucs_rcache_mp_ops = {
     .obj_cleanup   = NULL
 };
 
-/* Lock must be held for read */
+/* Region must be held */
 static void ucs_rcache_region_validate_pfn(ucs_rcache_t *rcache,
                                            ucs_rcache_region_t *region)
 {
@@ -197,6 +210,69 @@ static void ucs_rcache_find_regions(ucs_rcache_t *rcache, ucs_pgt_addr_t from,
                              ucs_rcache_region_collect_callback, list);
 }
 
+static inline int ucs_rcache_is_limited(ucs_rcache_t *rcache)
+{
+    return (rcache->params.max_regions != ULONG_MAX) ||
+           (rcache->params.max_size != SIZE_MAX);
+}
+
+/* Lock must be held */
+static inline int ucs_rcache_is_over_limit(ucs_rcache_t *rcache, size_t size)
+{
+    return (rcache->num_regions >= rcache->params.max_regions) ||
+           ((rcache->total_size + size) > rcache->params.max_size);
+}
+
+/* Lock must be held in write mode */
+static void ucs_rcache_region_lru_add(ucs_rcache_t *rcache,
+                                      ucs_rcache_region_t *region)
+{
+    if (!ucs_rcache_is_limited(rcache)) {
+        return;
+    }
+
+    ucs_spin_lock(&rcache->lru_lock);
+    ucs_assert(!(region->lru_flags & UCS_RCACHE_LRU_FLAG_IN_LIST));
+    ucs_list_add_tail(&rcache->lru_list, &region->lru_list);
+    region->lru_flags |= UCS_RCACHE_LRU_FLAG_IN_LIST;
+    ucs_spin_unlock(&rcache->lru_lock);
+}
+
+/* Lock must be held in write mode */
+static void ucs_rcache_region_lru_remove(ucs_rcache_t *rcache,
+                                         ucs_rcache_region_t *region)
+{
+    if (!ucs_rcache_is_limited(rcache)) {
+        return;
+    }
+
+    ucs_spin_lock(&rcache->lru_lock);
+    if (region->lru_flags & UCS_RCACHE_LRU_FLAG_IN_LIST) {
+        ucs_list_del(&region->lru_list);
+        region->lru_flags &= ~UCS_RCACHE_LRU_FLAG_IN_LIST;
+    }
+    ucs_spin_unlock(&rcache->lru_lock);
+}
+
+/* Region must be held */
+static void ucs_rcache_region_lru_touch(ucs_rcache_t *rcache,
+                                        ucs_rcache_region_t *region)
+{
+    ucs_spin_lock(&rcache->lru_lock);
+    if (region->lru_flags & UCS_RCACHE_LRU_FLAG_IN_LIST) {
+        /* move to the tail */
+        ucs_list_del(&region->lru_list);
+        ucs_list_add_tail(&rcache->lru_list, &region->lru_list);
+    }
+    ucs_spin_unlock(&rcache->lru_lock);
+}
+
+static void ucs_rcache_region_deferred_release(ucs_pgtable_t *pgtable,
+                                               ucs_pgt_deferred_t *deferred)
+{
+    ucs_free(ucs_container_of(deferred, ucs_rcache_region_t, deferred));
+}
+
 /* Lock must be held in write mode */
 static void ucs_mem_region_destroy_internal(ucs_rcache_t *rcache,
                                             ucs_rcache_region_t *region)
@@ -205,15 +281,22 @@ static void ucs_mem_region_destroy_internal(ucs_rcache_t *rcache,
 
     ucs_assert(region->refcount == 0);
     ucs_assert(!(region->flags & UCS_RCACHE_REGION_FLAG_PGTABLE));
+    ucs_assert(!(region->lru_flags & UCS_RCACHE_LRU_FLAG_IN_LIST));
 
     if (region->flags & UCS_RCACHE_REGION_FLAG_REGISTERED) {
         UCS_STATS_UPDATE_COUNTER(rcache->stats, UCS_RCACHE_DEREGS, 1);
         UCS_PROFILE_CODE("mem_dereg") {
             rcache->params.ops->mem_dereg(rcache->params.context, rcache, region);
         }
+
+        ucs_assert(rcache->num_regions > 0);
+        --rcache->num_regions;
+        rcache->total_size -= region->super.end - region->super.start;
     }
 
-    ucs_free(region);
+    /* Concurrent lookups may still access the region */
+    ucs_pgtable_defer(&rcache->pgtable, &region->deferred,
+                      ucs_rcache_region_deferred_release);
 }
 
 static inline void ucs_rcache_region_put_internal(ucs_rcache_t *rcache,
@@ -230,6 +313,7 @@ static inline void ucs_rcache_region_put_internal(ucs_rcache_t *rcache,
         }
         ucs_mem_region_destroy_internal(rcache, region);
         if (lock) {
+            ucs_pgtable_progress(&rcache->pgtable);
             pthread_rwlock_unlock(&rcache->lock);
         }
     } else {
@@ -255,6 +339,7 @@ static void ucs_rcache_region_invalidate(ucs_rcache_t *rcache,
                                    ucs_status_string(status));
         }
         region->flags &= ~UCS_RCACHE_REGION_FLAG_PGTABLE;
+        ucs_rcache_region_lru_remove(rcache, region);
     } else {
         ucs_assert(!must_be_in_pgt);
     }
@@ -279,6 +364,55 @@ static void ucs_rcache_invalidate_range(ucs_rcache_t *rcache, ucs_pgt_addr_t sta
     }
 }
 
+/*
+ * Invalidate least recently used regions, which are not used by anyone but the
+ * page table, until a new region of the given size fits in the cache limits.
+ * Lock must be held in write mode.
+ */
+static void ucs_rcache_lru_evict(ucs_rcache_t *rcache, size_t size)
+{
+    unsigned long num_to_check = rcache->num_regions;
+    ucs_rcache_region_t *region;
+
+    if (!ucs_rcache_is_over_limit(rcache, size)) {
+        return;
+    }
+
+    /* every region on the list is checked at most once */
+    ucs_spin_lock(&rcache->lru_lock);
+    while (!ucs_list_is_empty(&rcache->lru_list) && (num_to_check-- > 0)) {
+        region = ucs_list_head(&rcache->lru_list, ucs_rcache_region_t,
+                               lru_list);
+        ucs_list_del(&region->lru_list);
+
+        if (region->refcount > 1) {
+            /* region is in use, move it to the tail */
+            ucs_list_add_tail(&rcache->lru_list, &region->lru_list);
+            continue;
+        }
+
+        region->lru_flags &= ~UCS_RCACHE_LRU_FLAG_IN_LIST;
+        ucs_spin_unlock(&rcache->lru_lock);
+
+        /* the region is not destroyed if a fast-path lookup holds it now */
+        ucs_rcache_region_trace(rcache, region, "evict");
+        UCS_STATS_UPDATE_COUNTER(rcache->stats, UCS_RCACHE_EVICTS, 1);
+        ucs_rcache_region_invalidate(rcache, region, 1, 0);
+
+        if (!ucs_rcache_is_over_limit(rcache, size)) {
+            return;
+        }
+
+        ucs_spin_lock(&rcache->lru_lock);
+    }
+    ucs_spin_unlock(&rcache->lru_lock);
+
+    ucs_debug("%s: %lu regions of %zu bytes exceed the cache limits, and no "
+              "unused regions can be evicted", rcache->name,
+              rcache->num_regions, rcache->total_size);
+    UCS_STATS_UPDATE_COUNTER(rcache->stats, UCS_RCACHE_OVER_LIMIT, 1);
+}
+
 /* Lock must be held in write mode */
 static void ucs_rcache_check_inv_queue(ucs_rcache_t *rcache)
 {
@@ -298,10 +432,9 @@ static void ucs_rcache_check_inv_queue(ucs_rcache_t *rcache)
         ucs_recursive_spin_unlock(&rcache->inv_lock);
 
         ucs_rcache_invalidate_range(rcache, entry->start, entry->end);
+        ucs_mpool_mt_put(entry);
 
         ucs_recursive_spin_lock(&rcache->inv_lock);
-
-        ucs_mpool_put(entry); /* Must be done with the lock held */
     }
     ucs_recursive_spin_unlock(&rcache->inv_lock);
 }
@@ -329,18 +462,20 @@ static void ucs_rcache_unmapped_callback(ucm_event_type_t event_type,
 
     ucs_trace_func("%s: event vm_unmapped 0x%lx..0x%lx", rcache->name, start, end);
 
-    ucs_recursive_spin_lock(&rcache->inv_lock);
-    entry = ucs_mpool_get(&rcache->inv_mp);
-    if (entry != NULL) {
-        /* Add region to invalidation list */
-        entry->start = start;
-        entry->end   = end;
-        ucs_queue_push(&rcache->inv_q, &entry->queue);
-        UCS_STATS_UPDATE_COUNTER(rcache->stats, UCS_RCACHE_UNMAPS, 1);
-    } else {
+    entry = ucs_mpool_mt_get(&rcache->inv_mp);
+    if (entry == NULL) {
         ucs_error("Failed to allocate invalidation entry for 0x%lx..0x%lx, "
                   "data corruption may occur", start, end);
+        return;
     }
+
+    /* Add region to invalidation list */
+    entry->start = start;
+    entry->end   = end;
+
+    ucs_recursive_spin_lock(&rcache->inv_lock);
+    ucs_queue_push(&rcache->inv_q, &entry->queue);
+    UCS_STATS_UPDATE_COUNTER(rcache->stats, UCS_RCACHE_UNMAPS, 1);
     ucs_recursive_spin_unlock(&rcache->inv_lock);
 }
 
@@ -360,6 +495,7 @@ static void ucs_rcache_purge(ucs_rcache_t *rcache)
     ucs_list_for_each_safe(region, tmp, &region_list, list) {
         if (region->flags & UCS_RCACHE_REGION_FLAG_PGTABLE) {
             region->flags &= ~UCS_RCACHE_REGION_FLAG_PGTABLE;
+            ucs_rcache_region_lru_remove(rcache, region);
             ucs_atomic_add32(&region->refcount, (uint32_t)-1);
         }
         if (region->refcount > 0) {
@@ -502,6 +638,9 @@ retry:
         goto out_unlock;
     }
 
+    /* Make room for the new region, if the cache size is limited */
+    ucs_rcache_lru_evict(rcache, end - start);
+
     /* Allocate structure for new region */
     error = ucs_posix_memalign((void **)&region,
                                ucs_max(sizeof(void *), UCS_PGT_ENTRY_MIN_ALIGN),
@@ -515,13 +654,19 @@ retry:
 
     memset(region, 0, rcache->params.region_struct_size);
 
+    /* Concurrent lookups may find the region as soon as it's inserted to the
+     * page table, so initialize it before, and set the registered flag last */
     region->super.start = start;
     region->super.end   = end;
+    region->prot        = prot;
+    region->flags       = UCS_RCACHE_REGION_FLAG_PGTABLE;
+    region->refcount    = 1;
     status = UCS_PROFILE_CALL(ucs_pgtable_insert, &rcache->pgtable, &region->super);
     if (status != UCS_OK) {
         ucs_error("failed to insert region " UCS_PGT_REGION_FMT ": %s",
                   UCS_PGT_REGION_ARG(&region->super), ucs_status_string(status));
-        ucs_free(region);
+        ucs_pgtable_defer(&rcache->pgtable, &region->deferred,
+                          ucs_rcache_region_deferred_release);
         goto out_unlock;
     }
 
@@ -530,9 +675,6 @@ retry:
      */
     UCS_STATS_UPDATE_COUNTER(rcache->stats, UCS_RCACHE_REGS, 1);
 
-    region->prot     = prot;
-    region->flags    = UCS_RCACHE_REGION_FLAG_PGTABLE;
-    region->refcount = 1;
     region->status = status =
         UCS_PROFILE_NAMED_CALL("mem_reg", rcache->params.ops->mem_reg,
                                rcache->params.context, rcache, arg, region,
@@ -556,15 +698,23 @@ retry:
         }
     }
 
-    region->flags   |= UCS_RCACHE_REGION_FLAG_REGISTERED;
-    region->refcount = 2; /* Page-table + user */
-
     if (ucs_global_opts.rcache_check_pfn) {
         ucs_rcache_region_pfn(region) = ucs_sys_get_pfn(region->super.start);
     } else {
         ucs_rcache_region_pfn(region) = 0;
     }
 
+    /* Page-table + user */
+    ucs_atomic_add32(&region->refcount, 1);
+
+    /* Make the region visible to fast-path lookups */
+    ucs_memory_cpu_store_fence();
+    region->flags |= UCS_RCACHE_REGION_FLAG_REGISTERED;
+
+    ++rcache->num_regions;
+    rcache->total_size += end - start;
+    ucs_rcache_region_lru_add(rcache, region);
+
     UCS_STATS_UPDATE_COUNTER(rcache->stats, UCS_RCACHE_MISSES, 1);
 
     ucs_rcache_region_trace(rcache, region, "created");
@@ -572,6 +722,7 @@ retry:
 out_set_region:
     *region_p = region;
 out_unlock:
+    ucs_pgtable_progress(&rcache->pgtable);
     pthread_rwlock_unlock(&rcache->lock);
     return status;
 }
@@ -582,39 +733,64 @@ void ucs_rcache_region_hold(ucs_rcache_t *rcache, ucs_rcache_region_t *region)
     ucs_rcache_region_trace(rcache, region, "hold");
 }
 
+/* Hold a region found by a concurrent lookup, unless it's being destroyed */
+static UCS_F_ALWAYS_INLINE int
+ucs_rcache_region_try_hold(ucs_rcache_t *rcache, ucs_rcache_region_t *region)
+{
+    uint32_t refcount;
+
+    do {
+        refcount = region->refcount;
+        if (refcount == 0) {
+            return 0;
+        }
+    } while (ucs_atomic_cswap32(&region->refcount, refcount,
+                                refcount + 1) != refcount);
+
+    ucs_rcache_region_trace(rcache, region, "hold");
+    return 1;
+}
+
 ucs_status_t ucs_rcache_get(ucs_rcache_t *rcache, void *address, size_t length,
                             int prot, void *arg, ucs_rcache_region_t **region_p)
 {
     ucs_pgt_addr_t start = (uintptr_t)address;
     ucs_pgt_region_t *pgt_region;
     ucs_rcache_region_t *region;
+    ucs_status_t status;
 
     ucs_trace_func("rcache=%s, address=%p, length=%zu", rcache->name, address,
                    length);
 
-    pthread_rwlock_rdlock(&rcache->lock);
     UCS_STATS_UPDATE_COUNTER(rcache->stats, UCS_RCACHE_GETS, 1);
+    ucs_pgtable_reader_enter();
+    /* Check the invalidation queue inside the reader section, so unmap events
+     * which were queued before the lookup are not missed */
     if (ucs_queue_is_empty(&rcache->inv_q)) {
-        pgt_region = UCS_PROFILE_CALL(ucs_pgtable_lookup, &rcache->pgtable,
-                                      start);
-        if (ucs_likely(pgt_region != NULL)) {
+        /* The region can't be released before the reader section is finished,
+         * so hold it inside the section */
+        status = UCS_PROFILE_CALL(ucs_pgtable_lookup_concurrent,
+                                  &rcache->pgtable, start, &pgt_region);
+        if (ucs_likely((status == UCS_OK) && (pgt_region != NULL))) {
             region = ucs_derived_of(pgt_region, ucs_rcache_region_t);
             if (((start + length) <= region->super.end) &&
-                ucs_rcache_region_test(region, prot))
+                ucs_rcache_region_test(region, prot) &&
+                ucs_rcache_region_try_hold(rcache, region))
             {
-                ucs_rcache_region_hold(rcache, region);
+                ucs_pgtable_reader_exit();
+                ucs_memory_cpu_load_fence();
                 ucs_rcache_region_validate_pfn(rcache, region);
                 *region_p = region;
                 UCS_STATS_UPDATE_COUNTER(rcache->stats, UCS_RCACHE_HITS_FAST, 1);
-                pthread_rwlock_unlock(&rcache->lock);
                 return UCS_OK;
             }
         }
     }
-    pthread_rwlock_unlock(&rcache->lock);
+    ucs_pgtable_reader_exit();
 
     /* Fall back to slow version (with rw lock) in following cases:
      * - invalidation list not empty
+     * - page table was modified during the lookup
      * - could not find cached region
      * - found unregistered region
      */
@@ -624,6 +800,12 @@ ucs_status_t ucs_rcache_get(ucs_rcache_t *rcache, void *address, size_t length,
 
 void ucs_rcache_region_put(ucs_rcache_t *rcache, ucs_rcache_region_t *region)
 {
+    /* If this is the last user, the region becomes the most recently used of
+     * the unused ones. The check is racy, but only affects eviction order. */
+    if (ucs_rcache_is_limited(rcache) && (region->refcount == 2)) {
+        ucs_rcache_region_lru_touch(rcache, region);
+    }
+
     ucs_rcache_region_put_internal(rcache, region, 1, 0);
     UCS_STATS_UPDATE_COUNTER(rcache->stats, UCS_RCACHE_PUTS, 1);
 }
@@ -676,14 +858,25 @@ static UCS_CLASS_INIT_FUNC(ucs_rcache_t, const ucs_rcache_params_t *params,
         goto err_destroy_rwlock;
     }
 
+    status = ucs_spinlock_init(&self->lru_lock, 0);
+    if (status != UCS_OK) {
+        goto err_destroy_inv_q_lock;
+    }
+
+    ucs_list_head_init(&self->lru_list);
+    self->num_regions = 0;
+    self->total_size  = 0;
+
     status = ucs_pgtable_init(&self->pgtable, ucs_rcache_pgt_dir_alloc,
                               ucs_rcache_pgt_dir_release);
     if (status != UCS_OK) {
-        goto err_destroy_inv_q_lock;
+        goto err_destroy_lru_lock;
     }
 
-    status = ucs_mpool_init(&self->inv_mp, 0, sizeof(ucs_rcache_inv_entry_t), 0,
-                            1, 1024, UINT_MAX, &ucs_rcache_mp_ops, "rcache_inv_mp");
+    status = ucs_mpool_mt_init(&self->inv_mp, 0,
+                               sizeof(ucs_rcache_inv_entry_t), 0, 1, 1024,
+                               UINT_MAX, UCS_RCACHE_INV_MP_BATCH,
+                               &ucs_rcache_mp_ops, "rcache_inv_mp");
     if (status != UCS_OK) {
         goto err_cleanup_pgtable;
     }
@@ -699,9 +892,14 @@ static UCS_CLASS_INIT_FUNC(ucs_rcache_t, const ucs_rcache_params_t *params,
     return UCS_OK;
 
 err_destroy_mp:
-    ucs_mpool_cleanup(&self->inv_mp, 1);
+    ucs_mpool_mt_cleanup(&self->inv_mp, 1);
 err_cleanup_pgtable:
     ucs_pgtable_cleanup(&self->pgtable);
+err_destroy_lru_lock:
+    spinlock_status = ucs_spinlock_destroy(&self->lru_lock);
+    if (spinlock_status != UCS_OK) {
+        ucs_warn("ucs_spinlock_destroy() failed (%d)", spinlock_status);
+    }
 err_destroy_inv_q_lock:
     spinlock_status = ucs_recursive_spinlock_destroy(&self->inv_lock);
     if (spinlock_status != UCS_OK) {
@@ -726,8 +924,12 @@ static UCS_CLASS_CLEANUP_FUNC(ucs_rcache_t)
     ucs_rcache_check_inv_queue(self);
     ucs_rcache_purge(self);
 
-    ucs_mpool_cleanup(&self->inv_mp, 1);
+    ucs_mpool_mt_cleanup(&self->inv_mp, 1);
     ucs_pgtable_cleanup(&self->pgtable);
+    status = ucs_spinlock_destroy(&self->lru_lock);
+    if (status != UCS_OK) {
+        ucs_warn("ucs_spinlock_destroy() failed (%d)", status);
+    }
     status = ucs_recursive_spinlock_destroy(&self->inv_lock);
     if (status != UCS_OK) {
         ucs_warn("ucs_recursive_spinlock_destroy() failed (%d)", status);
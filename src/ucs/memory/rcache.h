@@ -18,6 +18,8 @@
 #include <ucs/datastruct/mpool.h>
 #include <ucs/stats/stats_fwd.h>
 #include <sys/mman.h>
+#include <limits.h>
+#include <stdint.h>
 
 
 #define UCS_RCACHE_PROT_FMT "%c%c"
@@ -113,18 +115,28 @@ struct ucs_rcache_params {
     const ucs_rcache_ops_t *ops;                /**< Memory operations functions */
     void                   *context;            /**< User-defined context that will
                                                      be passed to mem_reg/mem_dereg */
+    unsigned long          max_regions;         /**< Maximal number of registered
+                                                     regions, ULONG_MAX for
+                                                     unlimited */
+    size_t                 max_size;            /**< Maximal total size of
+                                                     registered regions, SIZE_MAX
+                                                     for unlimited */
 };
 
 
 struct ucs_rcache_region {
     ucs_pgt_region_t       super;    /**< Base class - page table region */
     ucs_list_link_t        list;     /**< List element */
+    ucs_list_link_t        lru_list; /**< Element in the LRU list */
     volatile uint32_t      refcount; /**< Reference count, including +1 if it's
                                           in the page table */
     ucs_status_t           status;   /**< Current status code */
     uint8_t                prot;     /**< Protection bits */
+    uint8_t                lru_flags; /**< LRU flags. Protected by LRU lock. */
     uint16_t               flags;    /**< Status flags. Protected by page table lock. */
     uint64_t               priv;     /**< Used internally */
+    ucs_pgt_deferred_t     deferred; /**< Releases the region after concurrent
+                                          lookups finish */
 };
 
 
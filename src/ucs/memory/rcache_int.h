@@ -22,6 +22,11 @@ enum {
     UCS_RCACHE_PUTS,                /* number of put operations */
     UCS_RCACHE_REGS,                /* number of memory registrations */
     UCS_RCACHE_DEREGS,              /* number of memory deregistrations */
+    UCS_RCACHE_EVICTS,              /* number of unused regions evicted because
+                                       of the cache limits */
+    UCS_RCACHE_OVER_LIMIT,          /* number of registrations which exceeded
+                                       the cache limits, because there were no
+                                       unused regions to evict */
     UCS_RCACHE_STAT_LAST
 };
 
@@ -32,16 +37,23 @@ struct ucs_rcache {
                                             whose refcount is 0 */
     ucs_pgtable_t            pgtable;  /**< page table to hold the regions */
 
-    ucs_recursive_spinlock_t inv_lock; /**< Lock for inv_q and inv_mp. This is a
+    ucs_recursive_spinlock_t inv_lock; /**< Lock for inv_q. This is a
                                           separate lock because we may want to put
                                           regions on inv_q while the page table
                                           lock is held by the calling context */
     ucs_queue_head_t         inv_q;    /**< Regions which were invalidated during
                                             memory events */
-    ucs_mpool_t              inv_mp;   /**< Memory pool to allocate entries for inv_q,
+    ucs_mpool_mt_t           inv_mp;   /**< Memory pool to allocate entries for inv_q,
                                             since we cannot use regulat malloc().
                                             The backing storage is original mmap()
                                             which does not generate memory events */
+    ucs_spinlock_t           lru_lock; /**< Lock for lru_list, taken without the
+                                            page table lock by region put */
+    ucs_list_link_t          lru_list; /**< Registered regions in the page table,
+                                            least recently used first. Used only
+                                            if the cache size is limited */
+    unsigned long            num_regions; /**< Number of registered regions */
+    size_t                   total_size;  /**< Total size of registered regions */
     char                     *name;
     UCS_STATS_NODE_DECLARE(stats)
 };
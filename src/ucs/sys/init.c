@@ -7,6 +7,8 @@
 #include <ucs/sys/compiler.h>
 #include <ucs/arch/cpu.h>
 #include <ucs/config/parser.h>
+#include <ucs/datastruct/mpool.h>
+#include <ucs/datastruct/pgtable.h>
 #include <ucs/debug/debug.h>
 #include <ucs/debug/log.h>
 #include <ucs/debug/memtrack.h>
@@ -85,6 +87,8 @@ static void UCS_F_CTOR ucs_init()
     ucs_memtrack_init();
     ucs_debug_init();
     ucs_profile_global_init();
+    ucs_mpool_global_init();
+    ucs_pgtable_global_init();
     ucs_async_global_init();
     ucs_debug("%s loaded at 0x%lx", ucs_debug_get_lib_path(),
               ucs_debug_get_lib_base_addr());
@@ -94,6 +98,8 @@ static void UCS_F_CTOR ucs_init()
 static void UCS_F_DTOR ucs_cleanup(void)
 {
     ucs_async_global_cleanup();
+    ucs_pgtable_global_cleanup();
+    ucs_mpool_global_cleanup();
     ucs_profile_global_cleanup();
     ucs_debug_cleanup(0);
     ucs_memtrack_cleanup();
@@ -5,6 +5,10 @@
 * See file LICENSE for terms.
 */
 
+#ifdef HAVE_CONFIG_H
+#  include "config.h"
+#endif
+
 #include <ucs/debug/log.h>
 #include <ucs/debug/assert.h>
 #include <ucs/sys/string.h>
@@ -17,6 +21,9 @@
 #include <sys/types.h>
 #include <sys/socket.h>
 #include <ifaddrs.h>
+#if HAVE_DECL_SO_EE_ORIGIN_ZEROCOPY
+#  include <linux/errqueue.h>
+#endif
 #include <unistd.h>
 #include <errno.h>
 #include <string.h>
@@ -470,7 +477,7 @@ ucs_socket_do_io_b(int fd, void *data, size_t length,
 
 static inline ucs_status_t
 ucs_socket_do_iov_nb(int fd, struct iovec *iov, size_t iov_cnt, size_t *length_p,
-                     ucs_socket_iov_func_t iov_func, const char *name,
+                     int flags, ucs_socket_iov_func_t iov_func, const char *name,
                      ucs_socket_io_err_cb_t err_cb, void *err_cb_arg)
 {
     struct msghdr msg = {
@@ -479,7 +486,7 @@ ucs_socket_do_iov_nb(int fd, struct iovec *iov, size_t iov_cnt, size_t *length_p
     };
     ssize_t ret;
 
-    ret = iov_func(fd, &msg, MSG_NOSIGNAL);
+    ret = iov_func(fd, &msg, MSG_NOSIGNAL | flags);
     return ucs_socket_handle_io(fd, iov, iov_cnt, length_p, 1,
                                 ret, errno, name, err_cb, err_cb_arg);
 }
@@ -529,10 +536,97 @@ ucs_status_t
 ucs_socket_sendv_nb(int fd, struct iovec *iov, size_t iov_cnt, size_t *length_p,
                     ucs_socket_io_err_cb_t err_cb, void *err_cb_arg)
 {
-    return ucs_socket_do_iov_nb(fd, iov, iov_cnt, length_p, sendmsg,
+    return ucs_socket_do_iov_nb(fd, iov, iov_cnt, length_p, 0, sendmsg,
                                 "sendv", err_cb, err_cb_arg);
 }
 
+#if HAVE_DECL_SO_ZEROCOPY && HAVE_DECL_MSG_ZEROCOPY && \
+    HAVE_DECL_SO_EE_ORIGIN_ZEROCOPY
+
+ucs_status_t ucs_socket_set_zcopy(int fd)
+{
+    int optval = 1;
+
+    return ucs_socket_setopt(fd, SOL_SOCKET, SO_ZEROCOPY, &optval,
+                             sizeof(optval));
+}
+
+ucs_status_t
+ucs_socket_sendv_zcopy_nb(int fd, struct iovec *iov, size_t iov_cnt,
+                          size_t *length_p, ucs_socket_io_err_cb_t err_cb,
+                          void *err_cb_arg)
+{
+    return ucs_socket_do_iov_nb(fd, iov, iov_cnt, length_p, MSG_ZEROCOPY,
+                                sendmsg, "sendv_zcopy", err_cb, err_cb_arg);
+}
+
+ucs_status_t ucs_socket_zcopy_comp_nb(int fd, uint32_t *lo_p, uint32_t *hi_p,
+                                      int *copied_p)
+{
+    char control[CMSG_SPACE(sizeof(struct sock_extended_err))];
+    struct msghdr msg = {
+        .msg_control    = control,
+        .msg_controllen = sizeof(control)
+    };
+    struct sock_extended_err *serr;
+    struct cmsghdr *cmsg;
+    int ret;
+
+    ret = recvmsg(fd, &msg, MSG_ERRQUEUE);
+    if (ret < 0) {
+        if ((errno == EAGAIN) || (errno == EWOULDBLOCK) || (errno == EINTR)) {
+            return UCS_ERR_NO_PROGRESS;
+        }
+
+        ucs_error("recvmsg(fd=%d, MSG_ERRQUEUE) failed: %m", fd);
+        return UCS_ERR_IO_ERROR;
+    }
+
+    cmsg = CMSG_FIRSTHDR(&msg);
+    if ((cmsg == NULL) ||
+        !(((cmsg->cmsg_level == SOL_IP) && (cmsg->cmsg_type == IP_RECVERR)) ||
+          ((cmsg->cmsg_level == SOL_IPV6) && (cmsg->cmsg_type == IPV6_RECVERR)))) {
+        ucs_error("fd %d: unexpected control message on the error queue", fd);
+        return UCS_ERR_IO_ERROR;
+    }
+
+    serr = (struct sock_extended_err*)CMSG_DATA(cmsg);
+    if ((serr->ee_errno != 0) || (serr->ee_origin != SO_EE_ORIGIN_ZEROCOPY)) {
+        ucs_error("fd %d: unexpected error queue notification (errno %u "
+                  "origin %u)", fd, serr->ee_errno, serr->ee_origin);
+        return UCS_ERR_IO_ERROR;
+    }
+
+    *lo_p     = serr->ee_info;
+    *hi_p     = serr->ee_data;
+    *copied_p = !!(serr->ee_code & SO_EE_CODE_ZEROCOPY_COPIED);
+    return UCS_OK;
+}
+
+#else
+
+ucs_status_t ucs_socket_set_zcopy(int fd)
+{
+    ucs_error("zero-copy socket send is not supported");
+    return UCS_ERR_UNSUPPORTED;
+}
+
+ucs_status_t
+ucs_socket_sendv_zcopy_nb(int fd, struct iovec *iov, size_t iov_cnt,
+                          size_t *length_p, ucs_socket_io_err_cb_t err_cb,
+                          void *err_cb_arg)
+{
+    return UCS_ERR_UNSUPPORTED;
+}
+
+ucs_status_t ucs_socket_zcopy_comp_nb(int fd, uint32_t *lo_p, uint32_t *hi_p,
+                                      int *copied_p)
+{
+    return UCS_ERR_UNSUPPORTED;
+}
+
+#endif
+
 ucs_status_t ucs_sockaddr_sizeof(const struct sockaddr *addr, size_t *size_p)
 {
     switch (addr->sa_family) {
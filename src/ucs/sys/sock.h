@@ -305,6 +305,66 @@ ucs_status_t ucs_socket_sendv_nb(int fd, struct iovec *iov, size_t iov_cnt,
                                  void *err_cb_arg);
 
 
+/**
+ * Enable zero-copy transmission (SO_ZEROCOPY) on the socket referred to by
+ * the file descriptor `fd`, so that @ref ucs_socket_sendv_zcopy_nb could be
+ * used on it.
+ *
+ * @param [in]      fd              Socket fd.
+ *
+ * @return UCS_OK on success, UCS_ERR_UNSUPPORTED if zero-copy transmission is
+ *         not supported by the system, or UCS_ERR_IO_ERROR on failure.
+ */
+ucs_status_t ucs_socket_set_zcopy(int fd);
+
+
+/**
+ * Non-blocking zero-copy send operation sends I/O vector on the connected
+ * socket referred to by the file descriptor `fd` using MSG_ZEROCOPY flag.
+ * The socket has to be prepared by @ref ucs_socket_set_zcopy. The buffers
+ * pointed to by `iov` mustn't be modified or released until the completion
+ * of the send operation is reported by @ref ucs_socket_zcopy_comp_nb.
+ * Every successful call (i.e. the one that returned UCS_OK) is assigned
+ * a 32-bit sequence number by the kernel, starting from 0.
+ *
+ * @param [in]      fd              Socket fd.
+ * @param [in]      iov             A pointer to an array of iovec buffers.
+ * @param [in]      iov_cnt         The number of buffers pointed to by
+ *                                  the iov parameter.
+ * @param [out]     length_p        The amount of data transmitted is written to
+ *                                  this argument.
+ * @param [in]      err_cb          Error callback.
+ * @param [in]      err_cb_arg      User's argument for the error callback.
+ *
+ * @return Same values as @ref ucs_socket_sendv_nb.
+ */
+ucs_status_t ucs_socket_sendv_zcopy_nb(int fd, struct iovec *iov,
+                                       size_t iov_cnt, size_t *length_p,
+                                       ucs_socket_io_err_cb_t err_cb,
+                                       void *err_cb_arg);
+
+
+/**
+ * Non-blocking receive of a zero-copy send completion notification from
+ * the error queue of the socket referred to by the file descriptor `fd`.
+ *
+ * @param [in]      fd              Socket fd.
+ * @param [out]     lo_p            Sequence number of the first completed
+ *                                  zero-copy send operation.
+ * @param [out]     hi_p            Sequence number of the last completed
+ *                                  zero-copy send operation.
+ * @param [out]     copied_p        Set to 1 if the kernel had to fall back to
+ *                                  copying the data, otherwise - to 0.
+ *
+ * @return UCS_OK if a completion notification was received,
+ *         UCS_ERR_NO_PROGRESS if there are no pending notifications,
+ *         UCS_ERR_UNSUPPORTED if zero-copy transmission is not supported,
+ *         or UCS_ERR_IO_ERROR on failure.
+ */
+ucs_status_t ucs_socket_zcopy_comp_nb(int fd, uint32_t *lo_p, uint32_t *hi_p,
+                                      int *copied_p);
+
+
 /**
  * Blocking receive operation receives data from the connected (or bound
  * connectionless) socket referred to by the file descriptor `fd`.
@@ -933,6 +933,9 @@ struct uct_iface_attr {
                                                 achieve higher total bandwidth
                                                 compared to using only a single
                                                 endpoint. */
+    int                      numa_node;    /**< NUMA node on which the
+                                                interface's receive resources
+                                                are placed, or -1 if unknown */
 };
 
 
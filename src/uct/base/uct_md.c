@@ -39,6 +39,17 @@ ucs_config_field_t uct_md_config_rcache_table[] = {
      "between "UCS_PP_MAKE_STRING(UCS_PGT_ADDR_ALIGN)"and system page size",
      ucs_offsetof(uct_md_rcache_config_t, alignment), UCS_CONFIG_TYPE_UINT},
 
+    {"RCACHE_MAX_REGIONS", "inf",
+     "Maximal number of regions in the registration cache. When the limit is\n"
+     "reached, least recently used regions which are not in use are deregistered.",
+     ucs_offsetof(uct_md_rcache_config_t, max_regions), UCS_CONFIG_TYPE_ULUNITS},
+
+    {"RCACHE_MAX_SIZE", "inf",
+     "Maximal total size of registered memory in the registration cache. When\n"
+     "the limit is reached, least recently used regions which are not in use\n"
+     "are deregistered.",
+     ucs_offsetof(uct_md_rcache_config_t, max_size), UCS_CONFIG_TYPE_MEMUNITS},
+
     {NULL}
 };
 
@@ -388,6 +388,8 @@ uct_gdr_copy_md_open(uct_component_t *component, const char *md_name,
         rcache_params.ucm_event_priority = md_config->rcache.event_prio;
         rcache_params.context            = md;
         rcache_params.ops                = &uct_gdr_copy_rcache_ops;
+        rcache_params.max_regions        = md_config->rcache.max_regions;
+        rcache_params.max_size           = md_config->rcache.max_size;
         status = ucs_rcache_create(&rcache_params, "gdr_copy", NULL, &md->rcache);
         if (status == UCS_OK) {
             md->super.ops         = &md_rcache_ops;
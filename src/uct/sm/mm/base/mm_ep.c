@@ -86,6 +86,15 @@ static void uct_mm_ep_signal_remote(uct_mm_ep_t *ep)
     char dummy = 0;
     int ret;
 
+    /* Make sure the written element is visible before checking the flag, the
+     * receiver checks the FIFO after setting it. Only one of the senders
+     * signals the remote interface after it was armed. */
+    ucs_memory_bus_fence();
+    if (!ep->signal.fifo_ctl->signal_armed ||
+        (ucs_atomic_cswap32(&ep->signal.fifo_ctl->signal_armed, 1, 0) != 1)) {
+        return;
+    }
+
     for (;;) {
         ret = sendto(iface->signal_fd, &dummy, sizeof(dummy), 0,
                      (const struct sockaddr*)&ep->signal.sockaddr,
@@ -114,6 +123,84 @@ static void uct_mm_ep_signal_remote(uct_mm_ep_t *ep)
     }
 }
 
+/* Switch to the claimed lane when it's ready and the receiver consumed all
+ * messages which were sent to the shared FIFO, to keep the order. Pending
+ * requests are sent to the shared FIFO before switching. */
+static void uct_mm_ep_lane_progress(uct_mm_ep_t *ep)
+{
+    if (!ep->lane.fifo_ctl->lane_ready ||
+        !ucs_arbiter_group_is_empty(&ep->arb_group) ||
+        UCS_CIRCULAR_COMPARE64(ep->fifo_ctl->tail, <, ep->lane.wait_head)) {
+        return;
+    }
+
+    ucs_memory_cpu_load_fence();
+
+    ep->fifo_ctl    = ep->lane.fifo_ctl;
+    ep->fifo_elems  = ep->lane.fifo_elems;
+    ep->cached_tail = ep->fifo_ctl->tail;
+    ep->flags       = (ep->flags & ~UCT_MM_EP_FLAG_LANE_WAIT) |
+                      UCT_MM_EP_FLAG_LANE;
+    ucs_debug("mm ep %p switched to remote lane", ep);
+}
+
+/* Claim a dedicated lane of the remote interface, so the head of the FIFO
+ * would not be shared with other senders */
+static void uct_mm_ep_claim_lane(uct_mm_ep_t *ep)
+{
+    uct_mm_iface_t *iface        = ucs_derived_of(ep->super.super.iface,
+                                                  uct_mm_iface_t);
+    uct_mm_fifo_ctl_t *fifo_ctl  = ep->fifo_ctl;
+    uint32_t num_lanes           = fifo_ctl->num_lanes;
+    uct_mm_fifo_ctl_t *lane_ctl;
+    ucs_status_t status;
+    void *lane_elems;
+    void *lanes_ptr;
+    uint32_t i;
+
+    if (num_lanes == 0) {
+        return;
+    }
+
+    ucs_memory_cpu_load_fence();
+
+    status = uct_mm_ep_get_remote_seg(ep, fifo_ctl->lanes_seg_id,
+                                      fifo_ctl->lanes_seg_size, &lanes_ptr);
+    if (status != UCS_OK) {
+        ucs_debug("mm ep %p failed to attach remote lanes: %s, using shared "
+                  "FIFO", ep, ucs_status_string(status));
+        return;
+    }
+
+    for (i = 0; i < num_lanes; ++i) {
+        uct_mm_iface_set_fifo_ptrs(UCT_MM_IFACE_GET_LANE(iface, lanes_ptr, i),
+                                   &lane_ctl, &lane_elems);
+        if ((lane_ctl->lane_owned == 0) &&
+            (ucs_atomic_cswap32(&lane_ctl->lane_owned, 0, 1) == 0)) {
+            break;
+        }
+    }
+
+    if (i == num_lanes) {
+        ucs_debug("mm ep %p: no free lanes, using shared FIFO", ep);
+        return;
+    }
+
+    ep->lane.fifo_ctl   = lane_ctl;
+    ep->lane.fifo_elems = lane_elems;
+    ep->lane.wait_head  = 0;
+    ep->flags          |= UCT_MM_EP_FLAG_LANE_WAIT;
+
+    /* the receiver assigns descriptors to the lane on its next progress, and
+     * until then the shared FIFO is used */
+    if (!lane_ctl->lane_ready) {
+        ucs_atomic_add32(&fifo_ctl->lanes_claimed, 1);
+    }
+
+    ucs_debug("mm ep %p claimed remote lane %u", ep, i);
+    uct_mm_ep_lane_progress(ep);
+}
+
 static UCS_CLASS_INIT_FUNC(uct_mm_ep_t, const uct_ep_params_t *params)
 {
     uct_mm_iface_t            *iface = ucs_derived_of(params->iface, uct_mm_iface_t);
@@ -127,6 +214,9 @@ static UCS_CLASS_INIT_FUNC(uct_mm_ep_t, const uct_ep_params_t *params)
 
     kh_init_inplace(uct_mm_remote_seg, &self->remote_segs);
     ucs_arbiter_group_init(&self->arb_group);
+    ucs_arbiter_group_set_weight(&self->arb_group,
+                                 iface->config.pending_weight);
+    self->flags = 0;
 
     /* save remote md address */
     if (md->iface_addr_len > 0) {
@@ -153,9 +243,12 @@ static UCS_CLASS_INIT_FUNC(uct_mm_ep_t, const uct_ep_params_t *params)
     /* Initialize remote FIFO control structure */
     uct_mm_iface_set_fifo_ptrs(fifo_ptr, &self->fifo_ctl, &self->fifo_elems);
     self->cached_tail     = self->fifo_ctl->tail;
+    self->signal.fifo_ctl = self->fifo_ctl;
     self->signal.addrlen  = self->fifo_ctl->signal_addrlen;
     self->signal.sockaddr = self->fifo_ctl->signal_sockaddr;
 
+    uct_mm_ep_claim_lane(self);
+
     ucs_debug("created mm ep %p, connected to remote FIFO id 0x%lx",
               self, addr->fifo_seg_id);
 
@@ -174,6 +267,13 @@ static UCS_CLASS_CLEANUP_FUNC(uct_mm_ep_t)
 
     uct_mm_ep_pending_purge(&self->super.super, NULL, NULL);
 
+    if (self->flags & (UCT_MM_EP_FLAG_LANE | UCT_MM_EP_FLAG_LANE_WAIT)) {
+        /* the receiver keeps polling the lane, so the elements which were not
+         * read yet would be received before the next sender writes to it */
+        ucs_memory_cpu_store_fence();
+        self->lane.fifo_ctl->lane_owned = 0;
+    }
+
     kh_foreach_value(&self->remote_segs, remote_seg, {
         uct_mm_iface_mapper_call(iface, mem_detach, &remote_seg);
     })
@@ -198,12 +298,22 @@ static inline ucs_status_t uct_mm_ep_get_remote_elem(uct_mm_ep_t *ep, uint64_t h
     elem_index = ep->fifo_ctl->head & iface->fifo_mask;
     *elem      = UCT_MM_IFACE_GET_FIFO_ELEM(iface, ep->fifo_elems, elem_index);
 
+    if (ep->flags & UCT_MM_EP_FLAG_LANE) {
+        /* the lane has a single producer */
+        ep->fifo_ctl->head = head + 1;
+        return UCS_OK;
+    }
+
     /* try to get ownership of the head element */
     returned_val = ucs_atomic_cswap64(ucs_unaligned_ptr(&ep->fifo_ctl->head), head, head+1);
     if (returned_val != head) {
         return UCS_ERR_NO_RESOURCE;
     }
 
+    if (ucs_unlikely(ep->flags & UCT_MM_EP_FLAG_LANE_WAIT)) {
+        ep->lane.wait_head = head + 1;
+    }
+
     return UCS_OK;
 }
 
@@ -233,6 +343,10 @@ uct_mm_ep_am_common_send(uct_mm_send_op_t send_op, uct_mm_ep_t *ep,
 
     UCT_CHECK_AM_ID(am_id);
 
+    if (ucs_unlikely(ep->flags & UCT_MM_EP_FLAG_LANE_WAIT)) {
+        uct_mm_ep_lane_progress(ep);
+    }
+
 retry:
     head = ep->fifo_ctl->head;
     /* check if there is room in the remote process's receive FIFO to write */
@@ -294,6 +408,7 @@ retry:
     }
 
     elem->am_id = am_id;
+    iface->tx_bytes += elem->length;
 
     /* memory barrier - make sure that the memory is flushed before setting the
      * 'writing is complete' flag which the reader checks */
@@ -381,6 +496,9 @@ ucs_arbiter_cb_result_t uct_mm_ep_process_pending(ucs_arbiter_t *arbiter,
     uct_pending_req_t *req = ucs_container_of(elem, uct_pending_req_t, priv);
     ucs_status_t status;
     uct_mm_ep_t *ep = ucs_container_of(ucs_arbiter_elem_group(elem), uct_mm_ep_t, arb_group);
+    uct_mm_iface_t *iface = ucs_derived_of(ep->super.super.iface,
+                                           uct_mm_iface_t);
+    size_t tx_bytes;
 
     /* update the local tail with its actual value from the remote peer
      * making sure that the pending sends would use the real tail value */
@@ -391,10 +509,14 @@ ucs_arbiter_cb_result_t uct_mm_ep_process_pending(ucs_arbiter_t *arbiter,
     }
 
     ucs_trace_data("progressing pending request %p", req);
-    status = req->func(req);
+    tx_bytes = iface->tx_bytes;
+    status   = req->func(req);
     ucs_trace_data("status returned from progress pending: %s",
                    ucs_status_string(status));
 
+    /* weighted endpoints are charged by the active message bytes */
+    ucs_arbiter_elem_charge(arbiter, iface->tx_bytes - tx_bytes);
+
     if (status == UCS_OK) {
         /* sent successfully. remove from the arbiter */
         return UCS_ARBITER_CB_RESULT_REMOVE_ELEM;
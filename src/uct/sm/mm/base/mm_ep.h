@@ -17,6 +17,13 @@ KHASH_INIT(uct_mm_remote_seg, uintptr_t, uct_mm_remote_seg_t, 1,
            kh_int64_hash_func, kh_int64_hash_equal)
 
 
+enum {
+    UCT_MM_EP_FLAG_LANE      = UCS_BIT(0), /* Sending to a dedicated lane */
+    UCT_MM_EP_FLAG_LANE_WAIT = UCS_BIT(1), /* Claimed a lane, sending to the
+                                              shared FIFO until switching to it */
+};
+
+
 /**
  * MM transport endpoint
  */
@@ -24,8 +31,18 @@ typedef struct uct_mm_ep {
     uct_base_ep_t              super;
 
     /* Remote peer */
-    uct_mm_fifo_ctl_t          *fifo_ctl;   /* pointer to the destination's ctl struct in the receive fifo */
-    void                       *fifo_elems; /* fifo elements (destination's receive fifo) */
+    uct_mm_fifo_ctl_t          *fifo_ctl;   /* pointer to the destination's ctl struct in the receive fifo,
+                                               or in the dedicated lane */
+    void                       *fifo_elems; /* fifo elements (destination's receive fifo or lane) */
+    uint8_t                    flags;       /* UCT_MM_EP_FLAG_xx */
+
+    /* Dedicated lane of the remote peer */
+    struct {
+        uct_mm_fifo_ctl_t      *fifo_ctl;   /* lane ctl struct */
+        void                   *fifo_elems; /* lane fifo elements */
+        uint64_t               wait_head;   /* shared FIFO head after the last
+                                               message sent to it */
+    } lane;
 
     uint64_t                   cached_tail; /* the sender's own copy of the remote FIFO's tail.
                                                it is not always updated with the actual remote tail value */
@@ -40,6 +57,8 @@ typedef struct uct_mm_ep {
 
     /* Used for signaling remote side wakeup */
     struct {
+        uct_mm_fifo_ctl_t      *fifo_ctl; /* shared FIFO ctl, holds the
+                                             signal_armed flag */
         struct sockaddr_un     sockaddr;  /* address of signaling socket */
         socklen_t              addrlen;   /* address length of signaling socket */
     } signal;
@@ -18,6 +18,8 @@
 #include <ucs/async/async.h>
 #include <ucs/sys/string.h>
 #include <sys/poll.h>
+#include <limits.h>
+#include <sched.h>
 
 
 /* Maximal number of events to clear from the signaling pipe in single call */
@@ -57,6 +59,42 @@ ucs_config_field_t uct_mm_iface_config_table[] = {
      "Size of the FIFO element size (data + header) in the MM UCTs.",
      ucs_offsetof(uct_mm_iface_config_t, fifo_elem_size), UCS_CONFIG_TYPE_UINT},
 
+    {"FIFO_LANES", "0",
+     "Number of dedicated receive FIFOs (lanes) for the senders. A sender claims\n"
+     "a free lane when it connects and writes to it without synchronizing with\n"
+     "other senders. If there is no free lane, the sender uses the shared receive\n"
+     "FIFO. Every claimed lane holds FIFO_SIZE receive descriptors.",
+     ucs_offsetof(uct_mm_iface_config_t, fifo_lanes), UCS_CONFIG_TYPE_UINT},
+
+    {"FIFO_LANES_POLL", "4",
+     "Maximal number of lanes to poll in one progress call. The lanes are polled\n"
+     "in round-robin order.",
+     ucs_offsetof(uct_mm_iface_config_t, fifo_lanes_poll), UCS_CONFIG_TYPE_UINT},
+
+    {"PENDING_WEIGHT", "0",
+     "Credit of every endpoint when progressing pending sends, in bytes. If set,\n"
+     "pending sends of the endpoints are progressed by deficit round-robin, so the\n"
+     "endpoints get an equal share of the active message bandwidth regardless of\n"
+     "the message sizes. 0 progresses one pending send of every endpoint in turn.",
+     ucs_offsetof(uct_mm_iface_config_t, pending_weight),
+     UCS_CONFIG_TYPE_MEMUNITS},
+
+    {"NUMA_POLICY", "default",
+     "NUMA memory policy of the receive FIFO, lanes and receive descriptors. The\n"
+     "memory is placed on the NUMA node of the CPU which opens the interface, or\n"
+     "of the first CPU in the interface CPU mask.\n"
+     " default   - Do not set a memory policy, the pages are placed by first touch.\n"
+     " preferred - Prefer the local node, fall back to other nodes if it is full.\n"
+     " bind      - Allocate memory only on the local node.",
+     ucs_offsetof(uct_mm_iface_config_t, numa_policy),
+     UCS_CONFIG_TYPE_ENUM(ucs_numa_policy_names)},
+
+    {"FIFO_MAX_POLL", "16",
+     "Maximal number of receive FIFO elements to process in one progress call.\n"
+     "Polling stops earlier if there are no more ready elements. The same limit\n"
+     "applies to every polled lane.",
+     ucs_offsetof(uct_mm_iface_config_t, fifo_max_poll), UCS_CONFIG_TYPE_UINT},
+
     {NULL}
 };
 
@@ -119,6 +157,8 @@ static ucs_status_t uct_mm_iface_query(uct_iface_h tl_iface,
 
     uct_base_iface_query(&iface->super.super, iface_attr);
 
+    iface_attr->numa_node               = iface->numa.node;
+
     /* default values for all shared memory transports */
     iface_attr->cap.put.max_short       = UINT_MAX;
     iface_attr->cap.put.max_bcopy       = SIZE_MAX;
@@ -184,14 +224,16 @@ static ucs_status_t uct_mm_iface_query(uct_iface_h tl_iface,
     return UCS_OK;
 }
 
-static inline void uct_mm_progress_fifo_tail(uct_mm_iface_t *iface)
+static inline void uct_mm_progress_fifo_tail(uct_mm_iface_t *iface,
+                                             uct_mm_fifo_ctl_t *fifo_ctl,
+                                             uint64_t read_index)
 {
     /* don't progress the tail every time - release in batches. improves performance */
-    if (iface->read_index & iface->fifo_release_factor_mask) {
+    if (read_index & iface->fifo_release_factor_mask) {
         return;
     }
 
-    iface->recv_fifo_ctl->tail = iface->read_index;
+    fifo_ctl->tail = read_index;
 }
 
 ucs_status_t uct_mm_assign_desc_to_fifo_elem(uct_mm_iface_t *iface,
@@ -242,30 +284,49 @@ static inline ucs_status_t uct_mm_iface_process_recv(uct_mm_iface_t *iface,
     return status;
 }
 
-static inline unsigned uct_mm_iface_poll_fifo(uct_mm_iface_t *iface)
+/* check the read_index to see if there is a new item to read (checking the
+ * owner bit) */
+static UCS_F_ALWAYS_INLINE int
+uct_mm_iface_fifo_has_new_data(uct_mm_iface_t *iface, void *fifo_elems,
+                               uint64_t read_index)
+{
+    uct_mm_fifo_element_t *elem;
+
+    elem = UCT_MM_IFACE_GET_FIFO_ELEM(iface, fifo_elems,
+                                      read_index & iface->fifo_mask);
+    return ((read_index >> iface->fifo_shift) & 1) == (elem->flags & 1);
+}
+
+static inline unsigned uct_mm_iface_poll_fifo(uct_mm_iface_t *iface,
+                                              uct_mm_fifo_ctl_t *fifo_ctl,
+                                              void *fifo_elems,
+                                              uint64_t *read_index_p)
 {
-    uint64_t read_index_loc, read_index;
+    uint64_t read_index = *read_index_p;
     uct_mm_fifo_element_t* read_index_elem;
     ucs_status_t status;
+    unsigned count;
 
-    /* check the memory pool to make sure that there is a new descriptor available */
-    if (ucs_unlikely(iface->last_recv_desc == NULL)) {
-        UCT_TL_IFACE_GET_RX_DESC(&iface->super.super, &iface->recv_desc_mp,
-                                 iface->last_recv_desc, return 0);
-    }
+    for (count = 0; count < iface->config.fifo_max_poll; ++count) {
+        /* check the memory pool to make sure that there is a new descriptor
+         * available */
+        if (ucs_unlikely(iface->last_recv_desc == NULL)) {
+            UCT_TL_IFACE_GET_RX_DESC(&iface->super.super, &iface->recv_desc_mp,
+                                     iface->last_recv_desc, break);
+        }
 
-    read_index = iface->read_index;
-    read_index_loc = (read_index & iface->fifo_mask);
-    /* the fifo_element which the read_index points to */
-    read_index_elem = UCT_MM_IFACE_GET_FIFO_ELEM(iface, iface->recv_fifo_elems,
-                                                 read_index_loc);
+        if (!uct_mm_iface_fifo_has_new_data(iface, fifo_elems, read_index)) {
+            break;
+        }
 
-    /* check the read_index to see if there is a new item to read (checking the owner bit) */
-    if (((read_index >> iface->fifo_shift) & 1) == ((read_index_elem->flags) & 1)) {
+        /* the fifo_element which the read_index points to */
+        read_index_elem = UCT_MM_IFACE_GET_FIFO_ELEM(iface, fifo_elems,
+                                                     read_index &
+                                                     iface->fifo_mask);
 
         /* read from read_index_elem */
         ucs_memory_cpu_load_fence();
-        ucs_assert(iface->read_index <= iface->recv_fifo_ctl->head);
+        ucs_assert(read_index <= fifo_ctl->head);
 
         status = uct_mm_iface_process_recv(iface, read_index_elem);
         if (status != UCS_OK) {
@@ -275,14 +336,89 @@ static inline unsigned uct_mm_iface_poll_fifo(uct_mm_iface_t *iface)
         }
 
         /* raise the read_index. */
-        iface->read_index++;
+        *read_index_p = ++read_index;
 
-        uct_mm_progress_fifo_tail(iface);
+        uct_mm_progress_fifo_tail(iface, fifo_ctl, read_index);
+    }
 
-        return 1;
-    } else {
-        return 0;
+    return count;
+}
+
+static void uct_mm_iface_free_rx_descs(uct_mm_iface_t *iface,
+                                       void *fifo_elems, unsigned num_elems)
+{
+    uct_mm_fifo_element_t *elem;
+    uct_mm_recv_desc_t *desc;
+    unsigned i;
+
+    for (i = 0; i < num_elems; i++) {
+        elem = UCT_MM_IFACE_GET_FIFO_ELEM(iface, fifo_elems, i);
+        desc = (uct_mm_recv_desc_t*)UCS_PTR_BYTE_OFFSET(elem->desc_data,
+                                                        -iface->rx_headroom) - 1;
+        ucs_mpool_put(desc);
+    }
+}
+
+/* Assign receive descriptors to the lanes which were claimed by senders since
+ * the last check. The senders don't use a lane until it's ready. */
+static void uct_mm_iface_init_claimed_lanes(uct_mm_iface_t *iface)
+{
+    uint32_t claimed = iface->recv_fifo_ctl->lanes_claimed;
+    uct_mm_recv_lane_t *lane;
+    ucs_status_t status;
+    unsigned lane_index, i;
+
+    ucs_memory_cpu_load_fence();
+
+    for (lane_index = 0; lane_index < iface->config.fifo_lanes; ++lane_index) {
+        lane = &iface->lanes.array[lane_index];
+        if (lane->fifo_ctl->lane_ready || !lane->fifo_ctl->lane_owned) {
+            continue;
+        }
+
+        for (i = 0; i < iface->config.fifo_size; i++) {
+            status = uct_mm_assign_desc_to_fifo_elem(
+                    iface, UCT_MM_IFACE_GET_FIFO_ELEM(iface, lane->fifo_elems, i),
+                    1);
+            if (status != UCS_OK) {
+                /* retry on next progress */
+                uct_mm_iface_free_rx_descs(iface, lane->fifo_elems, i);
+                return;
+            }
+        }
+
+        ucs_memory_cpu_store_fence();
+        lane->fifo_ctl->lane_ready                   = 1;
+        iface->lanes.ready[iface->lanes.num_ready++] = lane;
+        ucs_debug("mm_iface %p: lane %u is ready", iface, lane_index);
     }
+
+    iface->lanes.claimed = claimed;
+}
+
+static unsigned uct_mm_iface_poll_lanes(uct_mm_iface_t *iface)
+{
+    unsigned count = 0;
+    uct_mm_recv_lane_t *lane;
+    unsigned i, num_poll;
+
+    if (ucs_unlikely(iface->recv_fifo_ctl->lanes_claimed !=
+                     iface->lanes.claimed)) {
+        uct_mm_iface_init_claimed_lanes(iface);
+    }
+
+    num_poll = ucs_min(iface->config.fifo_lanes_poll, iface->lanes.num_ready);
+    for (i = 0; i < num_poll; ++i) {
+        lane = iface->lanes.ready[iface->lanes.poll_index];
+        if (++iface->lanes.poll_index == iface->lanes.num_ready) {
+            iface->lanes.poll_index = 0;
+        }
+
+        count += uct_mm_iface_poll_fifo(iface, lane->fifo_ctl, lane->fifo_elems,
+                                        &lane->read_index);
+    }
+
+    return count;
 }
 
 unsigned uct_mm_iface_progress(void *arg)
@@ -291,7 +427,11 @@ unsigned uct_mm_iface_progress(void *arg)
     unsigned count;
 
     /* progress receive */
-    count = uct_mm_iface_poll_fifo(iface);
+    count = uct_mm_iface_poll_fifo(iface, iface->recv_fifo_ctl,
+                                   iface->recv_fifo_elems, &iface->read_index);
+    if (iface->config.fifo_lanes > 0) {
+        count += uct_mm_iface_poll_lanes(iface);
+    }
 
     /* progress the pending sends (if there are any) */
     ucs_arbiter_dispatch(&iface->arbiter, 1, uct_mm_ep_process_pending, NULL);
@@ -305,6 +445,27 @@ static ucs_status_t uct_mm_iface_event_fd_get(uct_iface_h tl_iface, int *fd_p)
     return UCS_OK;
 }
 
+static int uct_mm_iface_has_new_data(uct_mm_iface_t *iface)
+{
+    uct_mm_recv_lane_t *lane;
+    unsigned i;
+
+    if (uct_mm_iface_fifo_has_new_data(iface, iface->recv_fifo_elems,
+                                       iface->read_index)) {
+        return 1;
+    }
+
+    for (i = 0; i < iface->lanes.num_ready; ++i) {
+        lane = iface->lanes.ready[i];
+        if (uct_mm_iface_fifo_has_new_data(iface, lane->fifo_elems,
+                                           lane->read_index)) {
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
 static ucs_status_t uct_mm_iface_event_fd_arm(uct_iface_h tl_iface,
                                               unsigned events)
 {
@@ -316,18 +477,26 @@ static ucs_status_t uct_mm_iface_event_fd_arm(uct_iface_h tl_iface,
     if (ret > 0) {
         return UCS_ERR_BUSY;
     } else if (ret == -1) {
-        if (errno == EAGAIN) {
-            return UCS_OK;
-        } else if (errno == EINTR) {
+        if (errno == EINTR) {
             return UCS_ERR_BUSY;
-        } else {
+        } else if (errno != EAGAIN) {
             ucs_error("failed to retrieve message from signal pipe: %m");
             return UCS_ERR_IO_ERROR;
         }
     } else {
         ucs_assert(ret == 0);
-        return UCS_OK;
     }
+
+    /* Senders signal only if the interface is armed, and only the first one
+     * sends the signal. A message written before the flag was set would not
+     * be signaled, so check the FIFOs after setting it. */
+    iface->recv_fifo_ctl->signal_armed = 1;
+    ucs_memory_bus_fence();
+    if (uct_mm_iface_has_new_data(iface)) {
+        return UCS_ERR_BUSY;
+    }
+
+    return UCS_OK;
 }
 
 static UCS_CLASS_DECLARE_DELETE_FUNC(uct_mm_iface_t, uct_iface_t);
@@ -364,6 +533,51 @@ static uct_iface_ops_t uct_mm_iface_ops = {
     .iface_is_reachable       = uct_mm_iface_is_reachable
 };
 
+static void uct_mm_iface_init_numa(uct_mm_iface_t *iface,
+                                   const uct_mm_iface_config_t *mm_config,
+                                   const uct_iface_params_t *params)
+{
+    int cpu;
+
+    iface->numa.policy        = mm_config->numa_policy;
+    iface->numa.node          = -1;
+    iface->numa.last_desc_seg = NULL;
+
+    if (iface->numa.policy == UCS_NUMA_POLICY_DEFAULT) {
+        return;
+    }
+
+    if (params->field_mask & UCT_IFACE_PARAM_FIELD_CPU_MASK) {
+        cpu = ucs_cpu_set_find_lcs(&params->cpu_mask);
+    } else {
+        cpu = sched_getcpu();
+    }
+
+    if (cpu >= 0) {
+        iface->numa.node = ucs_numa_node_of_cpu(cpu);
+    }
+}
+
+static ucs_status_t uct_mm_iface_numa_bind(uct_mm_iface_t *iface,
+                                           void *address, size_t length,
+                                           const char *name)
+{
+    ucs_status_t status;
+
+    if (iface->numa.node < 0) {
+        return UCS_ERR_UNSUPPORTED;
+    }
+
+    status = ucs_numa_mem_bind(address, length, iface->numa.policy,
+                               iface->numa.node);
+    if (status != UCS_OK) {
+        ucs_debug("mm_iface %p: failed to place %s on numa node %d: %s",
+                  iface, name, iface->numa.node, ucs_status_string(status));
+    }
+
+    return status;
+}
+
 static void uct_mm_iface_recv_desc_init(uct_iface_h tl_iface, void *obj,
                                         uct_mem_h memh)
 {
@@ -383,25 +597,19 @@ static void uct_mm_iface_recv_desc_init(uct_iface_h tl_iface, void *obj,
     offset = UCS_PTR_BYTE_DIFF(seg->address, desc + 1) + iface->rx_headroom;
     ucs_assert(offset <= UINT_MAX);
 
+    /* the descriptors of a memory pool chunk are initialized one after the
+     * other, so place the whole segment when its first descriptor is seen */
+    if (seg != iface->numa.last_desc_seg) {
+        uct_mm_iface_numa_bind(iface, seg->address, seg->length,
+                               "receive descriptors");
+        iface->numa.last_desc_seg = seg;
+    }
+
     desc->info.seg_id   = seg->seg_id;
     desc->info.seg_size = seg->length;
     desc->info.offset   = offset;
 }
 
-static void uct_mm_iface_free_rx_descs(uct_mm_iface_t *iface, unsigned num_elems)
-{
-    uct_mm_fifo_element_t *elem;
-    uct_mm_recv_desc_t *desc;
-    unsigned i;
-
-    for (i = 0; i < num_elems; i++) {
-        elem = UCT_MM_IFACE_GET_FIFO_ELEM(iface, iface->recv_fifo_elems, i);
-        desc = (uct_mm_recv_desc_t*)UCS_PTR_BYTE_OFFSET(elem->desc_data,
-                                                        -iface->rx_headroom) - 1;
-        ucs_mpool_put(desc);
-    }
-}
-
 void uct_mm_iface_set_fifo_ptrs(void *fifo_mem, uct_mm_fifo_ctl_t **fifo_ctl_p,
                                 void **fifo_elems_p)
 {
@@ -480,6 +688,99 @@ err:
     return status;
 }
 
+static ucs_status_t uct_mm_iface_create_lanes(uct_mm_iface_t *iface)
+{
+    unsigned num_lanes = iface->config.fifo_lanes;
+    uct_mm_recv_lane_t *lane;
+    ucs_status_t status;
+    unsigned lane_index, i;
+    uct_mm_seg_t *seg;
+
+    iface->lanes.array                  = NULL;
+    iface->lanes.ready                  = NULL;
+    iface->lanes.num_ready              = 0;
+    iface->lanes.poll_index             = 0;
+    iface->lanes.claimed                = 0;
+    iface->recv_fifo_ctl->num_lanes     = 0;
+    iface->recv_fifo_ctl->lanes_claimed = 0;
+
+    if (num_lanes == 0) {
+        return UCS_OK;
+    }
+
+    status = uct_iface_mem_alloc(&iface->super.super.super,
+                                 UCT_MM_GET_LANES_SIZE(iface, num_lanes),
+                                 UCT_MD_MEM_ACCESS_ALL, "mm_recv_lanes",
+                                 &iface->lanes.mem);
+    if (status != UCS_OK) {
+        ucs_error("mm_iface failed to allocate receive lanes");
+        return status;
+    }
+
+    uct_mm_iface_numa_bind(iface, iface->lanes.mem.address,
+                           iface->lanes.mem.length, "receive lanes");
+
+    iface->lanes.array = ucs_calloc(num_lanes, sizeof(*iface->lanes.array),
+                                    "mm_recv_lanes");
+    iface->lanes.ready = ucs_calloc(num_lanes, sizeof(*iface->lanes.ready),
+                                    "mm_ready_lanes");
+    if ((iface->lanes.array == NULL) || (iface->lanes.ready == NULL)) {
+        ucs_error("failed to allocate mm receive lanes array");
+        status = UCS_ERR_NO_MEMORY;
+        goto err_free;
+    }
+
+    for (lane_index = 0; lane_index < num_lanes; ++lane_index) {
+        lane = &iface->lanes.array[lane_index];
+        uct_mm_iface_set_fifo_ptrs(UCT_MM_IFACE_GET_LANE(iface,
+                                                         iface->lanes.mem.address,
+                                                         lane_index),
+                                   &lane->fifo_ctl, &lane->fifo_elems);
+        lane->fifo_ctl->head       = 0;
+        lane->fifo_ctl->tail       = 0;
+        lane->fifo_ctl->lane_owned = 0;
+        lane->fifo_ctl->lane_ready = 0;
+        lane->read_index           = 0;
+
+        for (i = 0; i < iface->config.fifo_size; i++) {
+            UCT_MM_IFACE_GET_FIFO_ELEM(iface, lane->fifo_elems, i)->flags =
+                    UCT_MM_FIFO_ELEM_FLAG_OWNER;
+        }
+    }
+
+    /* publish the lanes to the senders */
+    seg                                  = iface->lanes.mem.memh;
+    iface->recv_fifo_ctl->lanes_seg_id   = seg->seg_id;
+    iface->recv_fifo_ctl->lanes_seg_size = seg->length;
+    ucs_memory_cpu_store_fence();
+    iface->recv_fifo_ctl->num_lanes      = num_lanes;
+    return UCS_OK;
+
+err_free:
+    ucs_free(iface->lanes.ready);
+    ucs_free(iface->lanes.array);
+    uct_iface_mem_free(&iface->lanes.mem);
+    return status;
+}
+
+static void uct_mm_iface_destroy_lanes(uct_mm_iface_t *iface)
+{
+    unsigned i;
+
+    if (iface->config.fifo_lanes == 0) {
+        return;
+    }
+
+    for (i = 0; i < iface->lanes.num_ready; ++i) {
+        uct_mm_iface_free_rx_descs(iface, iface->lanes.ready[i]->fifo_elems,
+                                   iface->config.fifo_size);
+    }
+
+    ucs_free(iface->lanes.ready);
+    ucs_free(iface->lanes.array);
+    uct_iface_mem_free(&iface->lanes.mem);
+}
+
 static void uct_mm_iface_log_created(uct_mm_iface_t *iface)
 {
     uct_mm_seg_t UCS_V_UNUSED *seg = iface->recv_fifo_mem.memh;
@@ -530,9 +831,34 @@ static UCS_CLASS_INIT_FUNC(uct_mm_iface_t, uct_md_h md, uct_worker_h worker,
         goto err;
     }
 
+    if (mm_config->fifo_max_poll == 0) {
+        ucs_error("The MM FIFO max poll count must be larger than 0.");
+        status = UCS_ERR_INVALID_PARAM;
+        goto err;
+    }
+
+    if (mm_config->pending_weight > INT_MAX) {
+        ucs_error("The MM pending weight (%zu) must not be larger than %d.",
+                  mm_config->pending_weight, INT_MAX);
+        status = UCS_ERR_INVALID_PARAM;
+        goto err;
+    }
+
+    if ((mm_config->fifo_lanes > 0) && (mm_config->fifo_lanes_poll == 0)) {
+        ucs_error("The MM FIFO lanes poll count must be larger than 0 if "
+                  "FIFO lanes are used.");
+        status = UCS_ERR_INVALID_PARAM;
+        goto err;
+    }
+
     self->config.fifo_size         = mm_config->fifo_size;
     self->config.fifo_elem_size    = mm_config->fifo_elem_size;
     self->config.seg_size          = mm_config->seg_size;
+    self->config.fifo_lanes        = mm_config->fifo_lanes;
+    self->config.fifo_lanes_poll   = mm_config->fifo_lanes_poll;
+    self->config.fifo_max_poll     = mm_config->fifo_max_poll;
+    self->config.pending_weight    = mm_config->pending_weight;
+    self->tx_bytes                 = 0;
     /* cppcheck-suppress internalAstError */
     self->fifo_release_factor_mask = UCS_MASK(ucs_ilog2(ucs_max((int)
                                      (mm_config->fifo_size * mm_config->release_fifo_factor),
@@ -544,6 +870,8 @@ static UCS_CLASS_INIT_FUNC(uct_mm_iface_t, uct_md_h md, uct_worker_h worker,
                                      params->rx_headroom : 0;
     self->release_desc.cb          = uct_mm_iface_release_desc;
 
+    uct_mm_iface_init_numa(self, mm_config, params);
+
     /* Allocate the receive FIFO */
     status = uct_iface_mem_alloc(&self->super.super.super,
                                  UCT_MM_GET_FIFO_SIZE(self),
@@ -554,11 +882,19 @@ static UCS_CLASS_INIT_FUNC(uct_mm_iface_t, uct_md_h md, uct_worker_h worker,
         return status;
     }
 
+    /* report the node only if the FIFO could be placed on it */
+    if (uct_mm_iface_numa_bind(self, self->recv_fifo_mem.address,
+                               self->recv_fifo_mem.length,
+                               "receive FIFO") != UCS_OK) {
+        self->numa.node = -1;
+    }
+
     uct_mm_iface_set_fifo_ptrs(self->recv_fifo_mem.address,
                                &self->recv_fifo_ctl, &self->recv_fifo_elems);
-    self->recv_fifo_ctl->head = 0;
-    self->recv_fifo_ctl->tail = 0;
-    self->read_index          = 0;
+    self->recv_fifo_ctl->head         = 0;
+    self->recv_fifo_ctl->tail         = 0;
+    self->recv_fifo_ctl->signal_armed = 0;
+    self->read_index                  = 0;
 
     /* create a unix file descriptor to receive event notifications */
     status = uct_mm_iface_create_signal_fd(self);
@@ -606,13 +942,18 @@ static UCS_CLASS_INIT_FUNC(uct_mm_iface_t, uct_md_h md, uct_worker_h worker,
         }
     }
 
+    status = uct_mm_iface_create_lanes(self);
+    if (status != UCS_OK) {
+        goto destroy_descs;
+    }
+
     ucs_arbiter_init(&self->arbiter);
     uct_mm_iface_log_created(self);
 
     return UCS_OK;
 
 destroy_descs:
-    uct_mm_iface_free_rx_descs(self, i);
+    uct_mm_iface_free_rx_descs(self, self->recv_fifo_elems, i);
     ucs_mpool_put(self->last_recv_desc);
 destroy_recv_mpool:
     ucs_mpool_cleanup(&self->recv_desc_mp, 1);
@@ -631,7 +972,9 @@ static UCS_CLASS_CLEANUP_FUNC(uct_mm_iface_t)
 
     /* return all the descriptors that are now 'assigned' to the FIFO,
      * to their mpool */
-    uct_mm_iface_free_rx_descs(self, self->config.fifo_size);
+    uct_mm_iface_free_rx_descs(self, self->recv_fifo_elems,
+                               self->config.fifo_size);
+    uct_mm_iface_destroy_lanes(self);
 
     ucs_mpool_put(self->last_recv_desc);
     ucs_mpool_cleanup(&self->recv_desc_mp, 1);
@@ -15,6 +15,7 @@
 #include <ucs/arch/cpu.h>
 #include <ucs/debug/memtrack.h>
 #include <ucs/datastruct/arbiter.h>
+#include <ucs/memory/numa.h>
 #include <ucs/sys/compiler.h>
 #include <ucs/sys/sys.h>
 #include <sys/shm.h>
@@ -42,6 +43,25 @@ enum {
      UCS_PTR_BYTE_OFFSET(_fifo, (_index) * (_iface)->config.fifo_elem_size))
 
 
+/* Size of a dedicated sender FIFO (lane), which has the same layout as the
+ * shared receive FIFO */
+#define UCT_MM_GET_LANE_SIZE(_iface) \
+    ucs_align_up(UCT_MM_FIFO_CTL_SIZE + \
+                 ((_iface)->config.fifo_size * (_iface)->config.fifo_elem_size), \
+                 UCS_SYS_CACHE_LINE_SIZE)
+
+
+#define UCT_MM_GET_LANES_SIZE(_iface, _num_lanes) \
+    (((_num_lanes) * UCT_MM_GET_LANE_SIZE(_iface)) + \
+     (UCS_SYS_CACHE_LINE_SIZE - 1))
+
+
+#define UCT_MM_IFACE_GET_LANE(_iface, _lanes, _index) \
+    UCS_PTR_BYTE_OFFSET(ucs_align_up_pow2((uintptr_t)(_lanes), \
+                                          UCS_SYS_CACHE_LINE_SIZE), \
+                        (_index) * UCT_MM_GET_LANE_SIZE(_iface))
+
+
 #define uct_mm_iface_mapper_call(_iface, _func, ...) \
     ({ \
         uct_mm_md_t *md = ucs_derived_of((_iface)->super.super.md, uct_mm_md_t); \
@@ -58,6 +78,16 @@ typedef struct uct_mm_iface_config {
                                                * descriptor (for payload) */
     unsigned                 fifo_size;       /* Size of the receive FIFO */
     double                   release_fifo_factor; /* Tail index update frequency */
+    unsigned                 fifo_lanes;      /* Number of dedicated FIFOs
+                                               * for the senders */
+    unsigned                 fifo_lanes_poll; /* Number of lanes to poll in
+                                               * one progress call */
+    unsigned                 fifo_max_poll;   /* Maximal number of FIFO elements
+                                               * to poll in one progress call */
+    size_t                   pending_weight;  /* Credit of every endpoint when
+                                               * progressing pending sends */
+    ucs_numa_policy_t        numa_policy;     /* NUMA policy of the receive
+                                               * FIFO and descriptors */
     ucs_ternary_value_t      hugetlb_mode;    /* Enable using huge pages for
                                                * shared memory buffers */
     unsigned                 fifo_elem_size;  /* Size of the FIFO element size */
@@ -88,6 +118,23 @@ typedef struct uct_mm_fifo_ctl {
 
     /* 2nd cacheline */
     volatile uint64_t         tail;           /* How much was consumed */
+    UCS_CACHELINE_PADDING(uint64_t);
+
+    /* 3rd cacheline */
+    uct_mm_seg_id_t           lanes_seg_id;   /* Shared memory identifier of
+                                                 the dedicated sender FIFOs */
+    uint64_t                  lanes_seg_size; /* Size of the lanes segment */
+    uint32_t                  num_lanes;      /* Number of lanes, 0 if the
+                                                 senders use only this FIFO */
+    volatile uint32_t         lanes_claimed;  /* Incremented by a sender after
+                                                 it claimed a lane */
+    volatile uint32_t         lane_owned;     /* Lane: 1 if it is used by a
+                                                 sender */
+    volatile uint32_t         lane_ready;     /* Lane: 1 if the receiver
+                                                 assigned descriptors to it */
+    volatile uint32_t         signal_armed;   /* 1 if the receiver is armed and
+                                                 waits for a signal. Cleared by
+                                                 the first signaling sender */
 } UCS_S_PACKED UCS_V_ALIGNED(UCS_SYS_CACHE_LINE_SIZE) uct_mm_fifo_ctl_t;
 
 
@@ -134,6 +181,16 @@ typedef struct uct_mm_recv_desc {
 } uct_mm_recv_desc_t;
 
 
+/**
+ * Dedicated sender FIFO, as seen by the receiver
+ */
+typedef struct uct_mm_recv_lane {
+    uct_mm_fifo_ctl_t       *fifo_ctl;        /* lane control structure */
+    void                    *fifo_elems;      /* lane FIFO elements */
+    uint64_t                read_index;       /* actual reading location */
+} uct_mm_recv_lane_t;
+
+
 /**
  * MM trandport interface
  */
@@ -164,12 +221,40 @@ typedef struct uct_mm_iface {
 
     size_t                  rx_headroom;
     ucs_arbiter_t           arbiter;
+    size_t                  tx_bytes;         /* active message bytes sent, to
+                                                 charge the pending sends */
     uct_recv_desc_t         release_desc;
 
+    /* NUMA placement of the receive FIFO, lanes and descriptors */
+    struct {
+        ucs_numa_policy_t   policy;
+        int                 node;             /* -1 if not placed */
+        void                *last_desc_seg;   /* last descriptors segment which
+                                                 was placed on the node */
+    } numa;
+
+    /* Dedicated sender FIFOs */
+    struct {
+        uct_allocated_memory_t mem;           /* shared memory of the lanes */
+        uct_mm_recv_lane_t  *array;           /* all lanes */
+        uct_mm_recv_lane_t  **ready;          /* lanes which have receive
+                                                 descriptors, polled in
+                                                 round-robin order */
+        unsigned            num_ready;        /* number of ready lanes */
+        unsigned            poll_index;       /* next ready lane to poll */
+        uint32_t            claimed;          /* last seen lanes_claimed */
+    } lanes;
+
     struct {
         unsigned            fifo_size;
         unsigned            fifo_elem_size;
         unsigned            seg_size;         /* size of the receive descriptor (for payload)*/
+        unsigned            fifo_lanes;       /* number of dedicated sender FIFOs */
+        unsigned            fifo_lanes_poll;  /* lanes to poll per progress */
+        unsigned            fifo_max_poll;    /* FIFO elements to poll per
+                                                 progress */
+        unsigned            pending_weight;   /* arbiter weight of the endpoints,
+                                                 0 - not weighted */
     } config;
 } uct_mm_iface_t;
 
@@ -44,6 +44,10 @@
  * operation */
 #define UCT_TCP_EP_PUT_ZCOPY_MAX              SIZE_MAX
 
+/* Maximum size of a data that can be received by GET Zcopy
+ * operation */
+#define UCT_TCP_EP_GET_ZCOPY_MAX              SIZE_MAX
+
 /* Length of a data that is used by PUT protocol */
 #define UCT_TCP_EP_PUT_SERVICE_LENGTH        (sizeof(uct_tcp_am_hdr_t) + \
                                               sizeof(uct_tcp_ep_put_req_hdr_t))
@@ -74,7 +78,18 @@ typedef enum uct_tcp_ep_ctx_type {
     UCT_TCP_EP_CTX_TYPE_PUT_TX_WAITING_ACK,
     /* - PUT RX operation is waiting for resources to send an ACK
      *   for received PUT operations on a given EP */
-    UCT_TCP_EP_CTX_TYPE_PUT_RX_SENDING_ACK
+    UCT_TCP_EP_CTX_TYPE_PUT_RX_SENDING_ACK,
+    /* - EP is an additional connection of a user's EP that is used to send
+     *   striped PUT Zcopy data. This EP is hidden from a user and from
+     *   Connection Manager, it is destroyed along with the user's EP. */
+    UCT_TCP_EP_CTX_TYPE_STRIPE_TX,
+    /* - EP is accepted from an additional connection of a peer's EP and
+     *   is used only to receive striped PUT Zcopy data. This EP is hidden
+     *   from a user and TCP is responsible to free memory allocated for it. */
+    UCT_TCP_EP_CTX_TYPE_STRIPE_RX,
+    /* - GET RX operation is in progress on a given EP, i.e. PUT RX
+     *   operation receives the data of a GET response */
+    UCT_TCP_EP_CTX_TYPE_GET_RX
 } uct_tcp_ep_ctx_type_t;
 
 
@@ -183,7 +198,17 @@ typedef enum uct_tcp_cm_conn_event {
      * `UCT_TCP_CM_CONN_REQ` was sent) and want to have RX capability on a
      * peer's EP in order to send AM data. */
     UCT_TCP_CM_CONN_ACK_WITH_WAIT_REQ = (UCT_TCP_CM_CONN_WAIT_REQ |
-                                         UCT_TCP_CM_CONN_ACK)
+                                         UCT_TCP_CM_CONN_ACK),
+    /* Flag of a connection request that is sent from an additional
+     * connection of a EP to stripe PUT Zcopy data. The message is not
+     * sent separately (only along with a connection request). */
+    UCT_TCP_CM_CONN_STRIPE            = UCS_BIT(3),
+    /* Connection request from an additional connection of a EP. A peer
+     * accepts it as a hidden EP that is used only to receive PUT Zcopy
+     * data and doesn't match it with other EPs during simultaneous
+     * connection establishment. */
+    UCT_TCP_CM_CONN_REQ_STRIPE        = (UCT_TCP_CM_CONN_REQ |
+                                         UCT_TCP_CM_CONN_STRIPE)
 } uct_tcp_cm_conn_event_t;
 
 
@@ -210,11 +235,15 @@ typedef struct uct_tcp_am_hdr {
  */
 typedef enum uct_tcp_ep_am_id {
     /* AM ID reserved for TCP internal Connection Manager messages */
-    UCT_TCP_EP_CM_AM_ID      = UCT_AM_ID_MAX,
+    UCT_TCP_EP_CM_AM_ID       = UCT_AM_ID_MAX,
     /* AM ID reserved for TCP internal PUT REQ message */
-    UCT_TCP_EP_PUT_REQ_AM_ID = UCT_AM_ID_MAX + 1,
+    UCT_TCP_EP_PUT_REQ_AM_ID  = UCT_AM_ID_MAX + 1,
     /* AM ID reserved for TCP internal PUT ACK message */
-    UCT_TCP_EP_PUT_ACK_AM_ID = UCT_AM_ID_MAX + 2
+    UCT_TCP_EP_PUT_ACK_AM_ID  = UCT_AM_ID_MAX + 2,
+    /* AM ID reserved for TCP internal GET REQ message */
+    UCT_TCP_EP_GET_REQ_AM_ID  = UCT_AM_ID_MAX + 3,
+    /* AM ID reserved for TCP internal GET RESP message */
+    UCT_TCP_EP_GET_RESP_AM_ID = UCT_AM_ID_MAX + 4
 } uct_tcp_ep_am_id_t;
 
 
@@ -236,6 +265,43 @@ typedef struct uct_tcp_ep_put_ack_hdr {
 } UCS_S_PACKED uct_tcp_ep_put_ack_hdr_t;
 
 
+/**
+ * TCP GET request header
+ */
+typedef struct uct_tcp_ep_get_req_hdr {
+    uint64_t                      addr;        /* Address of a remote memory buffer */
+    size_t                        length;      /* Length of a remote memory buffer */
+    uint64_t                      resp_addr;   /* Address of a requester's memory buffer
+                                                * to write the data to. It is sent back
+                                                * as the address of GET response that is
+                                                * received in the same way as PUT REQ */
+    uint32_t                      sn;          /* Sequence number of the current GET operation */
+} UCS_S_PACKED uct_tcp_ep_get_req_hdr_t;
+
+
+/**
+ * TCP GET request that waits for resources to send the response
+ */
+typedef struct uct_tcp_ep_get_resp {
+    uct_tcp_ep_get_req_hdr_t      get_req;     /* Received GET request */
+    ucs_queue_elem_t              elem;        /* Element to insert the request into
+                                                * TCP EP GET response queue */
+} uct_tcp_ep_get_resp_t;
+
+
+/**
+ * TCP GET completion
+ */
+typedef struct uct_tcp_ep_get_completion {
+    uct_completion_t              *comp;       /* User's completion passed to
+                                                * uct_ep_get_zcopy or uct_ep_flush */
+    uint32_t                      wait_get_sn; /* Sequence number of the GET operation
+                                                * that has to be completed */
+    ucs_queue_elem_t              elem;        /* Element to insert completion into
+                                                * TCP EP GET completion queue */
+} uct_tcp_ep_get_completion_t;
+
+
 /**
  * TCP PUT completion
  */
@@ -245,17 +311,37 @@ typedef struct uct_tcp_ep_put_completion {
     uint32_t                      wait_put_sn;     /* Sequence number of the last unacked
                                                     * PUT operations that was in-progress
                                                     * when uct_ep_flush was called */
+    uint32_t                      wait_msg_zcopy_sn; /* Sequence number of the last
+                                                      * MSG_ZEROCOPY send that was
+                                                      * in-progress when uct_ep_flush
+                                                      * was called */
     ucs_queue_elem_t              elem;            /* Element to insert completion into
                                                     * TCP EP PUT operation pending queue */
 } uct_tcp_ep_put_completion_t;
 
 
+/**
+ * TCP striped PUT Zcopy completion
+ */
+typedef struct uct_tcp_ep_stripe_completion {
+    uct_completion_t              super;           /* Counts the fragments which
+                                                    * are in-flight */
+    uct_completion_t              *comp;           /* User's completion passed to
+                                                    * uct_ep_put_zcopy */
+    ucs_status_t                  status;          /* Error status of a failed
+                                                    * fragment */
+} uct_tcp_ep_stripe_completion_t;
+
+
 /**
  * TCP endpoint communication context
  */
 typedef struct uct_tcp_ep_ctx {
     uint32_t                      put_sn;         /* Sequence number of last sent
                                                    * or received PUT operation */
+    uint32_t                      get_sn;         /* Sequence number of last sent
+                                                   * GET request (TX) or last received
+                                                   * GET response (RX) */
     void                          *buf;           /* Partial send/recv data */
     size_t                        length;         /* How much data in the buffer */
     size_t                        offset;         /* How much data was sent (TX) or was
@@ -270,6 +356,12 @@ typedef struct uct_tcp_ep_ctx {
 typedef struct uct_tcp_ep_zcopy_tx {
     uct_tcp_am_hdr_t              super;     /* UCT TCP AM header */
     uct_completion_t              *comp;     /* Local UCT completion object */
+    int                           msg_zcopy; /* Whether the data is sent with
+                                              * MSG_ZEROCOPY flag */
+    uint32_t                      msg_zcopy_sn; /* Kernel sequence number of the
+                                                 * last MSG_ZEROCOPY send */
+    ucs_queue_elem_t              queue;     /* Element to insert the context into
+                                              * TCP EP MSG_ZEROCOPY completion queue */
     size_t                        iov_index; /* Current IOV index */
     size_t                        iov_cnt;   /* Number of IOVs that should be sent */
     struct iovec                  iov[0];    /* IOVs that should be sent */
@@ -281,7 +373,7 @@ typedef struct uct_tcp_ep_zcopy_tx {
  */
 struct uct_tcp_ep {
     uct_base_ep_t                 super;
-    uint8_t                       ctx_caps;         /* Which contexts are supported */
+    uint16_t                      ctx_caps;         /* Which contexts are supported */
     int                           fd;               /* Socket file descriptor */
     uct_tcp_ep_conn_state_t       conn_state;       /* State of connection with peer */
     unsigned                      conn_retries;     /* Number of connection attempts done */
@@ -292,6 +384,26 @@ struct uct_tcp_ep {
     ucs_queue_head_t              pending_q;        /* Pending operations */
     ucs_queue_head_t              put_comp_q;       /* Flush completions waiting for
                                                      * outstanding PUTs acknowledgment */
+    struct {
+        uint32_t                  tx_sn;            /* Kernel sequence number of the
+                                                     * next MSG_ZEROCOPY send */
+        ucs_queue_head_t          comp_q;           /* Zcopy operations waiting for
+                                                     * the kernel to release their
+                                                     * buffers */
+        ucs_queue_head_t          flush_q;          /* Flush completions waiting for
+                                                     * outstanding MSG_ZEROCOPY sends */
+    } msg_zcopy;
+    struct {
+        ucs_queue_head_t          comp_q;           /* Completions of GET operations
+                                                     * and flushes waiting for GET
+                                                     * responses */
+        ucs_queue_head_t          resp_q;           /* GET requests from a peer waiting
+                                                     * for resources to send the
+                                                     * responses */
+    } get;
+    ucs_list_link_t               stripe_list;      /* Additional connections to the
+                                                     * peer that are used to stripe
+                                                     * PUT Zcopy data */
     ucs_list_link_t               list;             /* List element to insert into TCP EP list */
 };
 
@@ -309,11 +421,17 @@ typedef struct uct_tcp_iface {
     ucs_sys_event_set_t           *event_set;        /* Event set identifier */
     ucs_mpool_t                   tx_mpool;          /* TX memory pool */
     ucs_mpool_t                   rx_mpool;          /* RX memory pool */
+    ucs_time_t                    last_event_time;   /* When the progress handled
+                                                      * events last time */
     size_t                        outstanding;       /* How much data in the EP send buffers
                                                       * + how many non-blocking connections
                                                       * are in progress + how many EPs are
                                                       * waiting for PUT Zcopy operation ACKs
-                                                      * (0/1 for each EP) */
+                                                      * (0/1 for each EP) + how many EPs
+                                                      * are waiting for MSG_ZEROCOPY
+                                                      * completions (0/1 for each EP)
+                                                      * + how many EPs are waiting for
+                                                      * GET responses (0/1 for each EP) */
 
     struct {
         size_t                    tx_seg_size;       /* TX AM buffer size */
@@ -327,13 +445,29 @@ typedef struct uct_tcp_iface {
             size_t                max_hdr;           /* Maximum supported AM Zcopy header */
             size_t                hdr_offset;        /* Offset in TX buffer to empty space that
                                                       * can be used for AM Zcopy header */
+            size_t                msg_thresh;        /* Minimum size of Zcopy payload from
+                                                      * which MSG_ZEROCOPY send is used */
         } zcopy;
+        struct {
+            unsigned              conns;             /* Number of connections used by EP
+                                                      * to send PUT Zcopy data */
+            size_t                thresh;            /* Minimum size of PUT Zcopy payload
+                                                      * from which it is striped */
+        } stripe;
         struct sockaddr_in        ifaddr;            /* Network address */
         struct sockaddr_in        netmask;           /* Network address mask */
         int                       prefer_default;    /* Prefer default gateway */
         int                       put_enable;        /* Enable PUT Zcopy operation support */
+        int                       get_enable;        /* Enable GET Zcopy operation support */
         int                       conn_nb;           /* Use non-blocking connect() */
         unsigned                  max_poll;          /* Number of events to poll per socket*/
+        ucs_time_t                poll_spin;         /* How long to keep the iface busy after
+                                                      * the last handled event */
+        unsigned                  rx_drain;          /* Number of messages to handle per
+                                                      * socket in one progress call before
+                                                      * stopping to drain it */
+        int                       tx_coalesce;       /* Append short and bcopy AMs to the
+                                                      * TX buffer which is being sent */
         unsigned                  max_conn_retries;  /* How many connection establishment attmepts
                                                       * should be done if dropped connection was
                                                       * detected due to lack of system resources */
@@ -343,6 +477,9 @@ typedef struct uct_tcp_iface {
         int                       nodelay;           /* TCP_NODELAY */
         size_t                    sndbuf;            /* SO_SNDBUF */
         size_t                    rcvbuf;            /* SO_RCVBUF */
+        int                       busy_poll;         /* SO_BUSY_POLL, in usec */
+        int                       prefer_busy_poll;  /* SO_PREFER_BUSY_POLL */
+        int                       incoming_cpu;      /* SO_INCOMING_CPU */
     } sockopt;
 } uct_tcp_iface_t;
 
@@ -356,14 +493,24 @@ typedef struct uct_tcp_iface_config {
     size_t                        rx_seg_size;
     size_t                        max_iov;
     size_t                        sendv_thresh;
+    size_t                        msg_zcopy_thresh;
+    unsigned                      stripe_conns;
+    size_t                        stripe_thresh;
     int                           prefer_default;
     int                           put_enable;
+    int                           get_enable;
     int                           conn_nb;
     unsigned                      max_poll;
+    double                        poll_spin;
+    unsigned                      rx_drain;
+    int                           tx_coalesce;
     unsigned                      max_conn_retries;
     int                           sockopt_nodelay;
     size_t                        sockopt_sndbuf;
     size_t                        sockopt_rcvbuf;
+    double                        sockopt_busy_poll;
+    int                           sockopt_prefer_busy_poll;
+    int                           sockopt_incoming_cpu;
     uct_iface_mpool_config_t      tx_mpool;
     uct_iface_mpool_config_t      rx_mpool;
 } uct_tcp_iface_config_t;
@@ -405,9 +552,9 @@ ucs_status_t uct_tcp_ep_init(uct_tcp_iface_t *iface, int fd,
 ucs_status_t uct_tcp_ep_create(const uct_ep_params_t *params,
                                uct_ep_h *ep_p);
 
-const char *uct_tcp_ep_ctx_caps_str(uint8_t ep_ctx_caps, char *str_buffer);
+const char *uct_tcp_ep_ctx_caps_str(uint16_t ep_ctx_caps, char *str_buffer);
 
-void uct_tcp_ep_change_ctx_caps(uct_tcp_ep_t *ep, uint8_t new_caps);
+void uct_tcp_ep_change_ctx_caps(uct_tcp_ep_t *ep, uint16_t new_caps);
 
 ucs_status_t uct_tcp_ep_add_ctx_cap(uct_tcp_ep_t *ep,
                                     uct_tcp_ep_ctx_type_t cap);
@@ -434,6 +581,8 @@ void uct_tcp_ep_mod_events(uct_tcp_ep_t *ep, int add, int remove);
 
 void uct_tcp_ep_pending_queue_dispatch(uct_tcp_ep_t *ep);
 
+unsigned uct_tcp_ep_progress_msg_zcopy(uct_tcp_ep_t *ep);
+
 ucs_status_t uct_tcp_ep_am_short(uct_ep_h uct_ep, uint8_t am_id, uint64_t header,
                                  const void *payload, unsigned length);
 
@@ -450,6 +599,10 @@ ucs_status_t uct_tcp_ep_put_zcopy(uct_ep_h uct_ep, const uct_iov_t *iov,
                                   size_t iovcnt, uint64_t remote_addr,
                                   uct_rkey_t rkey, uct_completion_t *comp);
 
+ucs_status_t uct_tcp_ep_get_zcopy(uct_ep_h uct_ep, const uct_iov_t *iov,
+                                  size_t iovcnt, uint64_t remote_addr,
+                                  uct_rkey_t rkey, uct_completion_t *comp);
+
 ucs_status_t uct_tcp_ep_pending_add(uct_ep_h tl_ep, uct_pending_req_t *req,
                                     unsigned flags);
 
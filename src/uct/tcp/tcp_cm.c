@@ -129,6 +129,16 @@ static void uct_tcp_cm_trace_conn_pkt(const uct_tcp_ep_t *ep,
         p += strlen(event_str);
     }
 
+    if (event & UCT_TCP_CM_CONN_STRIPE) {
+        if (p != event_str) {
+            ucs_snprintf_zero(p, sizeof(event_str) - (p - event_str), " | ");
+            p += strlen(p);
+        }
+        ucs_snprintf_zero(p, sizeof(event_str) - (p - event_str), "%s",
+                          UCS_PP_MAKE_STRING(UCT_TCP_CM_CONN_STRIPE));
+        p += strlen(p);
+    }
+
     if (event_str == p) {
         ucs_snprintf_zero(event_str, sizeof(event_str), "UNKNOWN (%d)", event);
         log_level = UCS_LOG_LEVEL_ERROR;
@@ -186,7 +196,10 @@ ucs_status_t uct_tcp_cm_send_event(uct_tcp_ep_t *ep, uct_tcp_cm_conn_event_t eve
         }
 
         conn_pkt             = (uct_tcp_cm_conn_req_pkt_t*)(pkt_hdr + 1);
-        conn_pkt->event      = UCT_TCP_CM_CONN_REQ;
+        conn_pkt->event      = (ep->ctx_caps &
+                                UCS_BIT(UCT_TCP_EP_CTX_TYPE_STRIPE_TX)) ?
+                               UCT_TCP_CM_CONN_REQ_STRIPE :
+                               UCT_TCP_CM_CONN_REQ;
         conn_pkt->iface_addr = iface->config.ifaddr;
     } else {
         pkt_event            = (uct_tcp_cm_conn_event_t*)(pkt_hdr + 1);
@@ -456,6 +469,37 @@ out:
     return progress_count;
 }
 
+static unsigned
+uct_tcp_cm_handle_conn_req_stripe(uct_tcp_ep_t **ep_p,
+                                  const uct_tcp_cm_conn_req_pkt_t *cm_req_pkt)
+{
+    uct_tcp_ep_t *ep = *ep_p;
+    ucs_status_t status;
+
+    ep->peer_addr = cm_req_pkt->iface_addr;
+    uct_tcp_cm_trace_conn_pkt(ep, UCS_LOG_LEVEL_TRACE,
+                              "%s received from", UCT_TCP_CM_CONN_REQ_STRIPE);
+
+    ucs_assertv(ep->conn_state == UCT_TCP_EP_CONN_STATE_ACCEPTING,
+                "ep=%p", ep);
+    ucs_assertv(ep->ctx_caps == 0, "ep=%p", ep);
+
+    /* The EP is used only to receive striped PUT Zcopy data, so it isn't
+     * added to the EP map and isn't checked for simultaneous connection
+     * establishment with our EPs */
+    uct_tcp_ep_change_ctx_caps(ep, UCS_BIT(UCT_TCP_EP_CTX_TYPE_STRIPE_RX));
+
+    status = uct_tcp_cm_send_event(ep, UCT_TCP_CM_CONN_ACK);
+    if (status != UCS_OK) {
+        uct_tcp_ep_destroy_internal(&ep->super.super);
+        *ep_p = NULL;
+        return 0;
+    }
+
+    uct_tcp_cm_change_conn_state(ep, UCT_TCP_EP_CONN_STATE_CONNECTED);
+    return 1;
+}
+
 void uct_tcp_cm_handle_conn_ack(uct_tcp_ep_t *ep, uct_tcp_cm_conn_event_t cm_event,
                                 uct_tcp_ep_conn_state_t new_conn_state)
 {
@@ -484,6 +528,10 @@ unsigned uct_tcp_cm_handle_conn_pkt(uct_tcp_ep_t **ep_p, void *pkt, uint32_t len
         ucs_assertv(length == sizeof(*cm_req_pkt), "ep=%p", *ep_p);
         cm_req_pkt = (uct_tcp_cm_conn_req_pkt_t*)pkt;
         return uct_tcp_cm_handle_conn_req(ep_p, cm_req_pkt);
+    case UCT_TCP_CM_CONN_REQ_STRIPE:
+        ucs_assertv(length == sizeof(*cm_req_pkt), "ep=%p", *ep_p);
+        cm_req_pkt = (uct_tcp_cm_conn_req_pkt_t*)pkt;
+        return uct_tcp_cm_handle_conn_req_stripe(ep_p, cm_req_pkt);
     case UCT_TCP_CM_CONN_ACK_WITH_WAIT_REQ:
         if (!((*ep_p)->ctx_caps & UCS_BIT(UCT_TCP_EP_CTX_TYPE_RX))) {
             new_conn_state = UCT_TCP_EP_CONN_STATE_WAITING_REQ;
@@ -506,6 +554,10 @@ unsigned uct_tcp_cm_handle_conn_pkt(uct_tcp_ep_t **ep_p, void *pkt, uint32_t len
         ucs_error("tcp_ep %p: CM event for waiting REQ (%d) "
                   "must be sent along with ACK", *ep_p, cm_event);
         return 0;
+    case UCT_TCP_CM_CONN_STRIPE:
+        ucs_error("tcp_ep %p: CM event for striping (%d) "
+                  "must be sent along with REQ", *ep_p, cm_event);
+        return 0;
     }
 
     ucs_error("tcp_ep %p: unknown CM event received %d", *ep_p, cm_event);
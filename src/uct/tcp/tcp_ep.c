@@ -95,6 +95,7 @@ static inline void uct_tcp_ep_ctx_rewind(uct_tcp_ep_ctx_t *ctx)
 static inline void uct_tcp_ep_ctx_init(uct_tcp_ep_ctx_t *ctx)
 {
     ctx->put_sn = UINT32_MAX;
+    ctx->get_sn = UINT32_MAX;
     ctx->buf    = NULL;
     uct_tcp_ep_ctx_rewind(ctx);
 }
@@ -106,6 +107,102 @@ static inline void uct_tcp_ep_ctx_reset(uct_tcp_ep_ctx_t *ctx)
     uct_tcp_ep_ctx_rewind(ctx);
 }
 
+static inline int uct_tcp_ep_get_in_progress(uct_tcp_ep_t *ep)
+{
+    return ep->tx.get_sn != ep->rx.get_sn;
+}
+
+static inline int uct_tcp_ep_msg_zcopy_in_progress(uct_tcp_ep_t *ep)
+{
+    return !ucs_queue_is_empty(&ep->msg_zcopy.comp_q);
+}
+
+static void uct_tcp_ep_msg_zcopy_flush_comp(uct_tcp_ep_t *ep,
+                                            uct_tcp_ep_put_completion_t *put_comp,
+                                            ucs_status_t status)
+{
+    if ((status == UCS_OK) &&
+        (ep->ctx_caps & UCS_BIT(UCT_TCP_EP_CTX_TYPE_PUT_TX_WAITING_ACK))) {
+        /* The flush has to wait for PUT ACKs as well */
+        ucs_queue_push(&ep->put_comp_q, &put_comp->elem);
+    } else {
+        uct_invoke_completion(put_comp->comp, status);
+        ucs_free(put_comp);
+    }
+}
+
+/* Release the buffers of MSG_ZEROCOPY operations with sequence numbers up to
+ * and including `sn` (or all of them if `purge` is set), and invoke their
+ * completions if `status` is not UCS_ERR_CANCELED */
+static void uct_tcp_ep_msg_zcopy_release(uct_tcp_ep_t *ep, int purge,
+                                         uint32_t sn, ucs_status_t status)
+{
+    uct_tcp_iface_t *iface = ucs_derived_of(ep->super.super.iface,
+                                            uct_tcp_iface_t);
+    uct_tcp_ep_put_completion_t *put_comp;
+    uct_tcp_ep_zcopy_tx_t *ctx;
+
+    if (!uct_tcp_ep_msg_zcopy_in_progress(ep)) {
+        return;
+    }
+
+    ucs_queue_for_each_extract(ctx, &ep->msg_zcopy.comp_q, queue,
+                               purge || UCS_CIRCULAR_COMPARE32(ctx->msg_zcopy_sn,
+                                                               <=, sn)) {
+        if ((ctx->comp != NULL) && (status != UCS_ERR_CANCELED)) {
+            uct_invoke_completion(ctx->comp, status);
+        }
+        ucs_mpool_put_inline(ctx);
+    }
+
+    ucs_queue_for_each_extract(put_comp, &ep->msg_zcopy.flush_q, elem,
+                               purge ||
+                               UCS_CIRCULAR_COMPARE32(put_comp->wait_msg_zcopy_sn,
+                                                      <=, sn)) {
+        if (status != UCS_ERR_CANCELED) {
+            uct_tcp_ep_msg_zcopy_flush_comp(ep, put_comp, status);
+        } else {
+            ucs_free(put_comp);
+        }
+    }
+
+    if (!uct_tcp_ep_msg_zcopy_in_progress(ep)) {
+        ucs_assert(ucs_queue_is_empty(&ep->msg_zcopy.flush_q));
+        uct_tcp_iface_outstanding_dec(iface);
+        if (ep->fd != -1) {
+            uct_tcp_ep_mod_events(ep, 0, UCS_EVENT_SET_EVERR);
+        }
+    }
+
+    if (purge) {
+        /* The kernel counter starts from 0 for a new socket */
+        ep->msg_zcopy.tx_sn = 0;
+    }
+}
+
+/* Pass ownership of the TX buffer of the completely sent MSG_ZEROCOPY
+ * operation to the EP completion queue until the kernel releases the
+ * user's buffers */
+static void uct_tcp_ep_msg_zcopy_add(uct_tcp_ep_t *ep,
+                                     uct_tcp_ep_zcopy_tx_t *ctx)
+{
+    uct_tcp_iface_t *iface = ucs_derived_of(ep->super.super.iface,
+                                            uct_tcp_iface_t);
+
+    ucs_assert(ctx->msg_zcopy && (ep->tx.buf == ctx));
+
+    if (!uct_tcp_ep_msg_zcopy_in_progress(ep)) {
+        /* The notifications are reported as errors on the socket */
+        uct_tcp_iface_outstanding_inc(iface);
+        uct_tcp_ep_mod_events(ep, UCS_EVENT_SET_EVERR, 0);
+    }
+
+    ucs_queue_push(&ep->msg_zcopy.comp_q, &ctx->queue);
+    ep->ctx_caps &= ~UCS_BIT(UCT_TCP_EP_CTX_TYPE_ZCOPY_TX);
+    ep->tx.buf    = NULL;
+    uct_tcp_ep_ctx_rewind(&ep->tx);
+}
+
 static void uct_tcp_ep_addr_cleanup(struct sockaddr_in *sock_addr)
 {
     memset(sock_addr, 0, sizeof(*sock_addr));
@@ -184,8 +281,14 @@ static UCS_CLASS_INIT_FUNC(uct_tcp_ep_t, uct_tcp_iface_t *iface,
     self->conn_state    = UCT_TCP_EP_CONN_STATE_CLOSED;
 
     ucs_list_head_init(&self->list);
+    ucs_list_head_init(&self->stripe_list);
     ucs_queue_head_init(&self->pending_q);
     ucs_queue_head_init(&self->put_comp_q);
+    ucs_queue_head_init(&self->msg_zcopy.comp_q);
+    ucs_queue_head_init(&self->msg_zcopy.flush_q);
+    ucs_queue_head_init(&self->get.comp_q);
+    ucs_queue_head_init(&self->get.resp_q);
+    self->msg_zcopy.tx_sn = 0;
 
     /* Make a socket non-blocking if an EP is created during accepting
      * a connection or non-blocking connection mode is requested */
@@ -213,7 +316,7 @@ err_cleanup:
     return status;
 }
 
-const char *uct_tcp_ep_ctx_caps_str(uint8_t ep_ctx_caps, char *str_buffer)
+const char *uct_tcp_ep_ctx_caps_str(uint16_t ep_ctx_caps, char *str_buffer)
 {
     ucs_snprintf_zero(str_buffer, UCT_TCP_EP_CTX_CAPS_STR_MAX, "[%s:%s]",
                       (ep_ctx_caps & UCS_BIT(UCT_TCP_EP_CTX_TYPE_TX)) ?
@@ -223,7 +326,7 @@ const char *uct_tcp_ep_ctx_caps_str(uint8_t ep_ctx_caps, char *str_buffer)
     return str_buffer;
 }
 
-void uct_tcp_ep_change_ctx_caps(uct_tcp_ep_t *ep, uint8_t new_caps)
+void uct_tcp_ep_change_ctx_caps(uct_tcp_ep_t *ep, uint16_t new_caps)
 {
     char str_prev_ctx_caps[UCT_TCP_EP_CTX_CAPS_STR_MAX];
     char str_cur_ctx_caps[UCT_TCP_EP_CTX_CAPS_STR_MAX];
@@ -241,7 +344,7 @@ ucs_status_t uct_tcp_ep_add_ctx_cap(uct_tcp_ep_t *ep,
 {
     uct_tcp_iface_t *iface = ucs_derived_of(ep->super.super.iface,
                                             uct_tcp_iface_t);
-    uint8_t prev_caps      = ep->ctx_caps;
+    uint16_t prev_caps     = ep->ctx_caps;
 
     uct_tcp_ep_change_ctx_caps(ep, ep->ctx_caps | UCS_BIT(cap));
     if (!uct_tcp_ep_is_self(ep) && (prev_caps != ep->ctx_caps)) {
@@ -262,7 +365,7 @@ ucs_status_t uct_tcp_ep_remove_ctx_cap(uct_tcp_ep_t *ep,
 {
     uct_tcp_iface_t *iface = ucs_derived_of(ep->super.super.iface,
                                             uct_tcp_iface_t);
-    uint8_t prev_caps      = ep->ctx_caps;
+    uint16_t prev_caps     = ep->ctx_caps;
 
     uct_tcp_ep_change_ctx_caps(ep, ep->ctx_caps & ~UCS_BIT(cap));
     if (!uct_tcp_ep_is_self(ep)) {
@@ -291,12 +394,56 @@ ucs_status_t uct_tcp_ep_move_ctx_cap(uct_tcp_ep_t *from_ep, uct_tcp_ep_t *to_ep,
     return uct_tcp_ep_add_ctx_cap(to_ep, ctx_cap);
 }
 
+/* Complete all PUT operations in-flight with an error, since their ACKs
+ * can't be received anymore */
+static void uct_tcp_ep_put_comp_purge(uct_tcp_ep_t *ep, ucs_status_t status)
+{
+    uct_tcp_iface_t *iface = ucs_derived_of(ep->super.super.iface,
+                                            uct_tcp_iface_t);
+    uct_tcp_ep_stripe_completion_t *stripe_comp;
+    uct_tcp_ep_put_completion_t *put_comp;
+
+    if (ep->ctx_caps & UCS_BIT(UCT_TCP_EP_CTX_TYPE_PUT_TX_WAITING_ACK)) {
+        ep->ctx_caps &= ~UCS_BIT(UCT_TCP_EP_CTX_TYPE_PUT_TX_WAITING_ACK);
+        uct_tcp_iface_outstanding_dec(iface);
+    }
+
+    ucs_queue_for_each_extract(put_comp, &ep->put_comp_q, elem, 1) {
+        if (ep->ctx_caps & UCS_BIT(UCT_TCP_EP_CTX_TYPE_STRIPE_TX)) {
+            /* A striped PUT fragment may be completed before the others, so
+             * keep its error for the user's completion */
+            stripe_comp         = ucs_container_of(put_comp->comp,
+                                                   uct_tcp_ep_stripe_completion_t,
+                                                   super);
+            stripe_comp->status = status;
+        }
+
+        uct_invoke_completion(put_comp->comp, status);
+        ucs_free(put_comp);
+    }
+}
+
+static void uct_tcp_ep_stripe_destroy(uct_tcp_ep_t *ep)
+{
+    uct_tcp_ep_t *stripe_ep, *tmp;
+
+    ucs_list_for_each_safe(stripe_ep, tmp, &ep->stripe_list, list) {
+        /* PUT ACKs will never be received for this connection */
+        uct_tcp_ep_put_comp_purge(stripe_ep, UCS_ERR_CANCELED);
+        uct_tcp_ep_change_ctx_caps(stripe_ep, 0);
+        uct_tcp_ep_destroy_internal(&stripe_ep->super.super);
+    }
+}
+
 static UCS_CLASS_CLEANUP_FUNC(uct_tcp_ep_t)
 {
-    uct_tcp_iface_t UCS_V_UNUSED *iface =
-        ucs_derived_of(self->super.super.iface, uct_tcp_iface_t);
+    uct_tcp_iface_t *iface = ucs_derived_of(self->super.super.iface,
+                                            uct_tcp_iface_t);
     uct_tcp_ep_put_completion_t *put_comp;
+    uct_tcp_ep_get_completion_t *get_comp;
+    uct_tcp_ep_get_resp_t *get_resp;
 
+    uct_tcp_ep_stripe_destroy(self);
     uct_tcp_ep_mod_events(self, 0, self->events);
 
     if (self->ctx_caps & UCS_BIT(UCT_TCP_EP_CTX_TYPE_TX)) {
@@ -307,12 +454,32 @@ static UCS_CLASS_CLEANUP_FUNC(uct_tcp_ep_t)
         uct_tcp_ep_remove_ctx_cap(self, UCT_TCP_EP_CTX_TYPE_RX);
     }
 
+    if (self->ctx_caps & UCS_BIT(UCT_TCP_EP_CTX_TYPE_STRIPE_RX)) {
+        uct_tcp_ep_change_ctx_caps(self, self->ctx_caps &
+                                   ~UCS_BIT(UCT_TCP_EP_CTX_TYPE_STRIPE_RX));
+    }
+
     ucs_assertv(!self->ctx_caps, "ep=%p", self);
 
     ucs_queue_for_each_extract(put_comp, &self->put_comp_q, elem, 1) {
         ucs_free(put_comp);
     }
 
+    ucs_queue_for_each_extract(get_comp, &self->get.comp_q, elem, 1) {
+        ucs_free(get_comp);
+    }
+
+    ucs_queue_for_each_extract(get_resp, &self->get.resp_q, elem, 1) {
+        ucs_free(get_resp);
+    }
+
+    if (uct_tcp_ep_get_in_progress(self)) {
+        /* GET responses will never be received for this EP */
+        uct_tcp_iface_outstanding_dec(iface);
+    }
+
+    uct_tcp_ep_msg_zcopy_release(self, 1, 0, UCS_ERR_CANCELED);
+
     uct_tcp_iface_remove_ep(self);
 
     if (self->conn_state != UCT_TCP_EP_CONN_STATE_CLOSED) {
@@ -341,6 +508,7 @@ void uct_tcp_ep_destroy(uct_ep_h tl_ep)
                            UCS_BIT(UCT_TCP_EP_CTX_TYPE_RX) |
                            UCS_BIT(UCT_TCP_EP_CTX_TYPE_TX))) {
         /* remove TX capability, but still will be able to receive data */
+        uct_tcp_ep_stripe_destroy(ep);
         uct_tcp_ep_remove_ctx_cap(ep, UCT_TCP_EP_CTX_TYPE_TX);
     } else {
         uct_tcp_ep_destroy_internal(tl_ep);
@@ -356,6 +524,15 @@ void uct_tcp_ep_set_failed(uct_tcp_ep_t *ep)
         uct_tcp_cm_change_conn_state(ep, UCT_TCP_EP_CONN_STATE_CLOSED);
     }
 
+    if (ep->ctx_caps & UCS_BIT(UCT_TCP_EP_CTX_TYPE_STRIPE_TX)) {
+        /* The connection is hidden from a user, so just stop striping
+         * data over it */
+        uct_tcp_ep_put_comp_purge(ep, UCS_ERR_CONNECTION_RESET);
+        uct_tcp_ep_mod_events(ep, 0, ep->events);
+        uct_tcp_ep_close_fd(&ep->fd);
+        return;
+    }
+
     uct_set_ep_failed(&UCS_CLASS_NAME(uct_tcp_ep_t),
                       &ep->super.super, &iface->super.super,
                       UCS_ERR_UNREACHABLE);
@@ -389,6 +566,12 @@ uct_tcp_ep_create_socket_and_connect(uct_tcp_iface_t *iface,
     } else {
         ep     = *ep_p;
         ep->fd = fd;
+
+        status = uct_tcp_iface_set_sockopt(iface, ep->fd);
+        if (status != UCS_OK) {
+            ep->fd = -1;
+            goto err_close_fd;
+        }
     }
 
     status = uct_tcp_cm_conn_start(ep);
@@ -437,6 +620,54 @@ err_ep_destroy:
     return status;
 }
 
+static void uct_tcp_ep_stripe_create(uct_tcp_ep_t *ep)
+{
+    uct_tcp_iface_t *iface = ucs_derived_of(ep->super.super.iface,
+                                            uct_tcp_iface_t);
+    uct_tcp_ep_t *stripe_ep;
+    ucs_status_t status;
+    unsigned i;
+    int fd;
+
+    if (!iface->config.put_enable ||
+        (iface->config.zcopy.max_iov <= UCT_TCP_EP_ZCOPY_SERVICE_IOV_COUNT)) {
+        return;
+    }
+
+    ucs_assertv(ucs_list_is_empty(&ep->stripe_list), "ep=%p", ep);
+
+    for (i = 1; i < iface->config.stripe.conns; i++) {
+        status = ucs_socket_create(AF_INET, SOCK_STREAM, &fd);
+        if (status != UCS_OK) {
+            break;
+        }
+
+        status = uct_tcp_ep_init(iface, fd, &ep->peer_addr, &stripe_ep);
+        if (status != UCS_OK) {
+            uct_tcp_ep_close_fd(&fd);
+            break;
+        }
+
+        /* The connection is owned by the user's EP */
+        uct_tcp_iface_remove_ep(stripe_ep);
+        ucs_list_add_tail(&ep->stripe_list, &stripe_ep->list);
+        uct_tcp_ep_change_ctx_caps(stripe_ep,
+                                   UCS_BIT(UCT_TCP_EP_CTX_TYPE_STRIPE_TX));
+
+        status = uct_tcp_cm_conn_start(stripe_ep);
+        if (status != UCS_OK) {
+            uct_tcp_ep_change_ctx_caps(stripe_ep, 0);
+            uct_tcp_ep_destroy_internal(&stripe_ep->super.super);
+            break;
+        }
+    }
+
+    if (i < iface->config.stripe.conns) {
+        ucs_debug("tcp_ep %p: only %u of %u connections are used to stripe "
+                  "PUT Zcopy data", ep, i, iface->config.stripe.conns);
+    }
+}
+
 ucs_status_t uct_tcp_ep_create(const uct_ep_params_t *params,
                                uct_ep_h *ep_p)
 {
@@ -479,6 +710,7 @@ ucs_status_t uct_tcp_ep_create(const uct_ep_params_t *params,
     } while (ep == NULL);
 
     if (status == UCS_OK) {
+        uct_tcp_ep_stripe_create(ep);
         /* cppcheck-suppress autoVariables */
         *ep_p = &ep->super.super;
     }
@@ -551,22 +783,56 @@ void uct_tcp_ep_pending_queue_dispatch(uct_tcp_ep_t *ep)
     }
 }
 
+/* Complete all GET operations in-flight with an error, since their responses
+ * can't be received anymore */
+static void uct_tcp_ep_get_comp_purge(uct_tcp_ep_t *ep, ucs_status_t status)
+{
+    uct_tcp_iface_t *iface = ucs_derived_of(ep->super.super.iface,
+                                            uct_tcp_iface_t);
+    uct_tcp_ep_get_completion_t *get_comp;
+
+    if (!uct_tcp_ep_get_in_progress(ep)) {
+        return;
+    }
+
+    ep->rx.get_sn = ep->tx.get_sn;
+    uct_tcp_iface_outstanding_dec(iface);
+
+    ucs_queue_for_each_extract(get_comp, &ep->get.comp_q, elem, 1) {
+        uct_invoke_completion(get_comp->comp, status);
+        ucs_free(get_comp);
+    }
+}
+
 static void uct_tcp_ep_handle_disconnected(uct_tcp_ep_t *ep,
                                            uct_tcp_ep_ctx_t *ctx)
 {
     ucs_debug("tcp_ep %p: remote disconnected", ep);
 
     uct_tcp_ep_ctx_reset(ctx);
+    uct_tcp_ep_get_comp_purge(ep, UCS_ERR_CONNECTION_RESET);
 
-    if (ep->ctx_caps & UCS_BIT(UCT_TCP_EP_CTX_TYPE_TX)) {
+    if (ep->ctx_caps & (UCS_BIT(UCT_TCP_EP_CTX_TYPE_TX) |
+                        UCS_BIT(UCT_TCP_EP_CTX_TYPE_STRIPE_TX))) {
         if (ep->ctx_caps & UCS_BIT(UCT_TCP_EP_CTX_TYPE_RX)) {
             uct_tcp_ep_remove_ctx_cap(ep, UCT_TCP_EP_CTX_TYPE_RX);
         }
 
+        /* Completion notifications can't be received after closing the
+         * socket */
+        uct_tcp_ep_msg_zcopy_release(ep, 1, 0, UCS_ERR_CONNECTION_RESET);
+        uct_tcp_ep_put_comp_purge(ep, UCS_ERR_CONNECTION_RESET);
         uct_tcp_ep_mod_events(ep, 0, ep->events);
         uct_tcp_ep_close_fd(&ep->fd);
+
+        if ((ep->ctx_caps & UCS_BIT(UCT_TCP_EP_CTX_TYPE_STRIPE_TX)) &&
+            (ep->conn_state != UCT_TCP_EP_CONN_STATE_CLOSED)) {
+            /* The user's EP stops striping data over this connection */
+            uct_tcp_cm_change_conn_state(ep, UCT_TCP_EP_CONN_STATE_CLOSED);
+        }
     } else if ((ep->ctx_caps == 0) ||
-               (ep->ctx_caps & UCS_BIT(UCT_TCP_EP_CTX_TYPE_RX))) {
+               (ep->ctx_caps & (UCS_BIT(UCT_TCP_EP_CTX_TYPE_RX) |
+                                UCS_BIT(UCT_TCP_EP_CTX_TYPE_STRIPE_RX)))) {
         /* If the EP supports RX only or no capabilities set, destroy it */
         uct_tcp_ep_destroy_internal(&ep->super.super);
     }
@@ -618,9 +884,15 @@ static inline ssize_t uct_tcp_ep_sendv(uct_tcp_ep_t *ep)
     ucs_assertv((ep->tx.offset < ep->tx.length) &&
                 (ctx->iov_cnt > 0), "ep=%p", ep);
 
-    status = ucs_socket_sendv_nb(ep->fd, &ctx->iov[ctx->iov_index],
-                                 ctx->iov_cnt - ctx->iov_index,
-                                 &sent_length, NULL, NULL);
+    if (!ctx->msg_zcopy) {
+        status = ucs_socket_sendv_nb(ep->fd, &ctx->iov[ctx->iov_index],
+                                     ctx->iov_cnt - ctx->iov_index,
+                                     &sent_length, NULL, NULL);
+    } else {
+        status = ucs_socket_sendv_zcopy_nb(ep->fd, &ctx->iov[ctx->iov_index],
+                                           ctx->iov_cnt - ctx->iov_index,
+                                           &sent_length, NULL, NULL);
+    }
 
     if (ucs_unlikely(status != UCS_OK)) {
         if (status == UCS_ERR_NO_PROGRESS) {
@@ -632,12 +904,18 @@ static inline ssize_t uct_tcp_ep_sendv(uct_tcp_ep_t *ep)
         return status;
     }
 
+    if (ctx->msg_zcopy) {
+        ctx->msg_zcopy_sn = ep->msg_zcopy.tx_sn++;
+    }
+
     ep->tx.offset      += sent_length;
     iface->outstanding -= sent_length;
 
     if (ep->tx.offset != ep->tx.length) {
         ucs_iov_advance(ctx->iov, ctx->iov_cnt,
                         &ctx->iov_index, sent_length);
+    } else if (ctx->msg_zcopy) {
+        uct_tcp_ep_msg_zcopy_add(ep, ctx);
     } else {
         uct_tcp_ep_comp_zcopy(ep, ctx->comp, UCS_OK);
     }
@@ -700,7 +978,8 @@ static ucs_status_t uct_tcp_ep_io_err_handler_cb(void *arg,
     if (uct_tcp_ep_is_conn_closed_by_peer(io_status) &&
         ((ep->conn_state == UCT_TCP_EP_CONN_STATE_ACCEPTING) ||
          ((ep->conn_state == UCT_TCP_EP_CONN_STATE_CONNECTED) &&
-          (ep->ctx_caps == UCS_BIT(UCT_TCP_EP_CTX_TYPE_RX)) /* only RX cap */))) {
+          ((ep->ctx_caps == UCS_BIT(UCT_TCP_EP_CTX_TYPE_RX)) /* only RX cap */ ||
+           (ep->ctx_caps & UCS_BIT(UCT_TCP_EP_CTX_TYPE_STRIPE_RX)))))) {
         ucs_debug("tcp_ep %p: detected that [%s <-> %s] connection was "
                   "dropped by the peer", ep,
                   ucs_sockaddr_str((const struct sockaddr*)&iface->config.ifaddr,
@@ -753,10 +1032,43 @@ static inline unsigned uct_tcp_ep_recv(uct_tcp_ep_t *ep, size_t recv_length)
     return 1;
 }
 
+unsigned uct_tcp_ep_progress_msg_zcopy(uct_tcp_ep_t *ep)
+{
+    unsigned count = 0;
+    uint32_t lo, hi;
+    ucs_status_t status;
+    int copied;
+
+    while (uct_tcp_ep_msg_zcopy_in_progress(ep)) {
+        status = ucs_socket_zcopy_comp_nb(ep->fd, &lo, &hi, &copied);
+        if (status == UCS_ERR_NO_PROGRESS) {
+            break;
+        } else if (ucs_unlikely(status != UCS_OK)) {
+            /* The error queue can't be trusted anymore, so fail all
+             * outstanding operations and close the connection */
+            uct_tcp_ep_msg_zcopy_release(ep, 1, 0, status);
+            uct_tcp_ep_handle_disconnected(ep, &ep->tx);
+            return count + 1;
+        }
+
+        ucs_trace_data("tcp_ep %p fd %d: MSG_ZEROCOPY sends [%u..%u] "
+                       "completed%s", ep, ep->fd, lo, hi,
+                       copied ? " (data was copied)" : "");
+        uct_tcp_ep_msg_zcopy_release(ep, 0, hi, UCS_OK);
+        count++;
+    }
+
+    return count;
+}
+
 /* Forward declaration - the function depends on AM send
  * functions implemented below */
 static void uct_tcp_ep_post_put_ack(uct_tcp_ep_t *ep);
 
+/* Forward declaration - the function depends on AM and Zcopy send
+ * functions implemented below */
+static ucs_status_t uct_tcp_ep_post_get_resps(uct_tcp_ep_t *ep);
+
 static unsigned uct_tcp_ep_progress_data_tx(uct_tcp_ep_t *ep)
 {
     unsigned ret = 0;
@@ -777,7 +1089,9 @@ static unsigned uct_tcp_ep_progress_data_tx(uct_tcp_ep_t *ep)
         ucs_trace_data("ep %p fd %d sent %zu/%zu bytes, moved by offset %zd",
                        ep, ep->fd, ep->tx.offset, ep->tx.length, offset);
 
-        if (!uct_tcp_ep_ctx_buf_need_progress(&ep->tx)) {
+        /* TX buffer could be passed to MSG_ZEROCOPY completion queue */
+        if ((ep->tx.buf != NULL) &&
+            !uct_tcp_ep_ctx_buf_need_progress(&ep->tx)) {
             uct_tcp_ep_ctx_reset(&ep->tx);
         }
     }
@@ -786,6 +1100,12 @@ static unsigned uct_tcp_ep_progress_data_tx(uct_tcp_ep_t *ep)
         uct_tcp_ep_post_put_ack(ep);
     }
 
+    if (!ucs_queue_is_empty(&ep->get.resp_q) &&
+        (uct_tcp_ep_post_get_resps(ep) != UCS_OK)) {
+        /* The EP could be destroyed */
+        return 1;
+    }
+
     if (!ucs_queue_is_empty(&ep->pending_q)) {
         uct_tcp_ep_pending_queue_dispatch(ep);
         return ret;
@@ -810,35 +1130,72 @@ uct_tcp_ep_comp_recv_am(uct_tcp_iface_t *iface, uct_tcp_ep_t *ep,
     uct_iface_invoke_am(&iface->super, hdr->am_id, hdr + 1, hdr->length, 0);
 }
 
+static void uct_tcp_ep_get_rx_complete(uct_tcp_ep_t *ep, uint32_t get_sn)
+{
+    uct_tcp_iface_t *iface = ucs_derived_of(ep->super.super.iface,
+                                            uct_tcp_iface_t);
+    uct_tcp_ep_get_completion_t *get_comp;
+
+    ucs_assert(uct_tcp_ep_get_in_progress(ep));
+    ep->rx.get_sn = get_sn;
+
+    if (!uct_tcp_ep_get_in_progress(ep)) {
+        /* Since there are no other GET operations in-flight, decrement
+         * iface outstanding operations counter */
+        uct_tcp_iface_outstanding_dec(iface);
+    }
+
+    ucs_queue_for_each_extract(get_comp, &ep->get.comp_q, elem,
+                               (UCS_CIRCULAR_COMPARE32(get_comp->wait_get_sn,
+                                                       <=, get_sn))) {
+        uct_invoke_completion(get_comp->comp, UCS_OK);
+        ucs_free(get_comp);
+    }
+}
+
 static inline ucs_status_t
 uct_tcp_ep_put_rx_advance(uct_tcp_ep_t *ep, uct_tcp_ep_put_req_hdr_t *put_req,
-                          size_t recv_length)
+                          size_t recv_length, int is_get_resp)
 {
-    ucs_assert(!(ep->ctx_caps & UCS_BIT(UCT_TCP_EP_CTX_TYPE_PUT_RX_SENDING_ACK)));
+    uint32_t sn;
+
+    ucs_assert(is_get_resp ||
+               !(ep->ctx_caps & UCS_BIT(UCT_TCP_EP_CTX_TYPE_PUT_RX_SENDING_ACK)));
     ucs_assert(recv_length <= put_req->length);
     put_req->addr   += recv_length;
     put_req->length -= recv_length;
 
     if (!put_req->length) {
-        uct_tcp_ep_post_put_ack(ep);
+        sn = put_req->sn;
 
         /* EP's ctx_caps doesn't have UCT_TCP_EP_CTX_TYPE_PUT_RX flag
          * set in case of entire PUT payload was received through
          * AM protocol */
         if (ep->ctx_caps & UCS_BIT(UCT_TCP_EP_CTX_TYPE_PUT_RX)) {
-            ep->ctx_caps &= ~UCS_BIT(UCT_TCP_EP_CTX_TYPE_PUT_RX);
+            ep->ctx_caps &= ~(UCS_BIT(UCT_TCP_EP_CTX_TYPE_PUT_RX) |
+                              UCS_BIT(UCT_TCP_EP_CTX_TYPE_GET_RX));
             uct_tcp_ep_ctx_reset(&ep->rx);
         }
 
+        if (!is_get_resp) {
+            uct_tcp_ep_post_put_ack(ep);
+        } else {
+            uct_tcp_ep_get_rx_complete(ep, sn);
+        }
+
         return UCS_OK;
     }
 
     return UCS_INPROGRESS;
 }
 
+/* Handle PUT REQ or GET RESP, which is received in the same way as PUT REQ
+ * (the data is written directly to the requester's buffer), but it completes
+ * the GET operation instead of sending PUT ACK */
 static inline void uct_tcp_ep_handle_put_req(uct_tcp_ep_t *ep,
                                              uct_tcp_ep_put_req_hdr_t *put_req,
-                                             size_t extra_recvd_length)
+                                             size_t extra_recvd_length,
+                                             int is_get_resp)
 {
     size_t copied_length;
     ucs_status_t status;
@@ -850,15 +1207,19 @@ static inline void uct_tcp_ep_handle_put_req(uct_tcp_ep_t *ep,
            UCS_PTR_BYTE_OFFSET(ep->rx.buf, ep->rx.offset),
            copied_length);
     ep->rx.offset += copied_length;
-    ep->rx.put_sn  = put_req->sn;
 
-    /* Remove the flag that indicates that EP is sending PUT RX ACK in order
-     * to not ack the uncompleted PUT RX operation for which PUT REQ is being
-     * handled here. ACK for both operations will be sent after the completion
-     * of the last received PUT operation */
-    ep->ctx_caps &= ~UCS_BIT(UCT_TCP_EP_CTX_TYPE_PUT_RX_SENDING_ACK);
+    if (!is_get_resp) {
+        ep->rx.put_sn  = put_req->sn;
 
-    status = uct_tcp_ep_put_rx_advance(ep, put_req, copied_length);
+        /* Remove the flag that indicates that EP is sending PUT RX ACK in
+         * order to not ack the uncompleted PUT RX operation for which PUT
+         * REQ is being handled here. ACK for both operations will be sent
+         * after the completion of the last received PUT operation */
+        ep->ctx_caps &= ~UCS_BIT(UCT_TCP_EP_CTX_TYPE_PUT_RX_SENDING_ACK);
+    }
+
+    status = uct_tcp_ep_put_rx_advance(ep, put_req, copied_length,
+                                       is_get_resp);
     if (status == UCS_OK) {
         return;
     }
@@ -868,8 +1229,17 @@ static inline void uct_tcp_ep_handle_put_req(uct_tcp_ep_t *ep,
     /* Since RX buffer and PUT request can be ovelapped, use memmove() */
     memmove(ep->rx.buf, put_req, sizeof(*put_req));
     ep->ctx_caps |= UCS_BIT(UCT_TCP_EP_CTX_TYPE_PUT_RX);
+    if (is_get_resp) {
+        ep->ctx_caps |= UCS_BIT(UCT_TCP_EP_CTX_TYPE_GET_RX);
+    }
 }
 
+/* Forward declaration - the function depends on AM and Zcopy send
+ * functions implemented below */
+static ucs_status_t
+uct_tcp_ep_handle_get_req(uct_tcp_ep_t *ep,
+                          const uct_tcp_ep_get_req_hdr_t *get_req);
+
 static unsigned uct_tcp_ep_progress_am_rx(uct_tcp_ep_t *ep)
 {
     uct_tcp_iface_t *iface = ucs_derived_of(ep->super.super.iface,
@@ -877,10 +1247,13 @@ static unsigned uct_tcp_ep_progress_am_rx(uct_tcp_ep_t *ep)
     unsigned handled       = 0;
     uct_tcp_am_hdr_t *hdr;
     size_t recv_length;
+    size_t prev_length;
     size_t remainder;
+    int drained;
 
     ucs_trace_func("ep=%p", ep);
 
+recv_more:
     if (!uct_tcp_ep_ctx_buf_need_progress(&ep->rx)) {
         ucs_assert(ep->rx.buf == NULL);
         ep->rx.buf = ucs_mpool_get_inline(&iface->rx_mpool);
@@ -906,10 +1279,14 @@ static unsigned uct_tcp_ep_progress_am_rx(uct_tcp_ep_t *ep)
         recv_length = hdr->length - (ep->rx.length - ep->rx.offset - sizeof(*hdr));
     }
 
+    prev_length = ep->rx.length;
     if (!uct_tcp_ep_recv(ep, recv_length)) {
         goto out;
     }
 
+    /* If less data than requested was received, the socket is drained */
+    drained = (ep->rx.length - prev_length) < recv_length;
+
     /* Parse received active messages */
     while (uct_tcp_ep_ctx_buf_need_progress(&ep->rx)) {
         remainder = ep->rx.length - ep->rx.offset;
@@ -920,7 +1297,7 @@ static unsigned uct_tcp_ep_progress_am_rx(uct_tcp_ep_t *ep)
             ep->rx.offset = 0;
             ep->rx.length = remainder;
             handled++;
-            goto out;
+            goto check_drained;
         }
 
         hdr = UCS_PTR_BYTE_OFFSET(ep->rx.buf, ep->rx.offset);
@@ -931,7 +1308,7 @@ static unsigned uct_tcp_ep_progress_am_rx(uct_tcp_ep_t *ep)
 
         if (remainder < (sizeof(*hdr) + hdr->length)) {
             handled++;
-            goto out;
+            goto check_drained;
         }
 
         /* Full message was received */
@@ -941,10 +1318,12 @@ static unsigned uct_tcp_ep_progress_am_rx(uct_tcp_ep_t *ep)
         if (ucs_likely(hdr->am_id < UCT_AM_ID_MAX)) {
             uct_tcp_ep_comp_recv_am(iface, ep, hdr);
             handled++;
-        } else if (hdr->am_id == UCT_TCP_EP_PUT_REQ_AM_ID) {
+        } else if ((hdr->am_id == UCT_TCP_EP_PUT_REQ_AM_ID) ||
+                   (hdr->am_id == UCT_TCP_EP_GET_RESP_AM_ID)) {
             ucs_assert(hdr->length == sizeof(uct_tcp_ep_put_req_hdr_t));
             uct_tcp_ep_handle_put_req(ep, (uct_tcp_ep_put_req_hdr_t*)(hdr + 1),
-                                      ep->rx.length - ep->rx.offset);
+                                      ep->rx.length - ep->rx.offset,
+                                      hdr->am_id == UCT_TCP_EP_GET_RESP_AM_ID);
             handled++;
             if (ep->ctx_caps & UCS_BIT(UCT_TCP_EP_CTX_TYPE_PUT_RX)) {
                 /* It means that PUT RX is in progress and EP RX buffer
@@ -956,6 +1335,14 @@ static unsigned uct_tcp_ep_progress_am_rx(uct_tcp_ep_t *ep)
             ucs_assert(hdr->length == sizeof(uint32_t));
             uct_tcp_ep_handle_put_ack(ep, (uct_tcp_ep_put_ack_hdr_t*)(hdr + 1));
             handled++;
+        } else if (hdr->am_id == UCT_TCP_EP_GET_REQ_AM_ID) {
+            ucs_assert(hdr->length == sizeof(uct_tcp_ep_get_req_hdr_t));
+            handled++;
+            if (uct_tcp_ep_handle_get_req(ep, (uct_tcp_ep_get_req_hdr_t*)
+                                              (hdr + 1)) != UCS_OK) {
+                /* The EP could be destroyed */
+                goto out;
+            }
         } else {
             ucs_assert(hdr->am_id == UCT_TCP_EP_CM_AM_ID);
             handled += 1 + uct_tcp_cm_handle_conn_pkt(&ep, hdr + 1, hdr->length);
@@ -970,6 +1357,16 @@ static unsigned uct_tcp_ep_progress_am_rx(uct_tcp_ep_t *ep)
 
     uct_tcp_ep_ctx_reset(&ep->rx);
 
+check_drained:
+    /* Receive the rest of the data from the socket if only a few messages
+     * were handled, so small messages arriving one by one don't cost a
+     * progress call each. The limit keeps the amount of work per progress
+     * call bounded and doesn't starve other endpoints */
+    if (!drained && (handled < iface->config.rx_drain) &&
+        (ep->conn_state == UCT_TCP_EP_CONN_STATE_CONNECTED)) {
+        goto recv_more;
+    }
+
 out:
     return handled;
 }
@@ -1026,7 +1423,9 @@ static unsigned uct_tcp_ep_progress_put_rx(uct_tcp_ep_t *ep)
 
     ucs_assertv(recv_length, "ep=%p", ep);
 
-    uct_tcp_ep_put_rx_advance(ep, put_req, recv_length);
+    uct_tcp_ep_put_rx_advance(ep, put_req, recv_length,
+                              !!(ep->ctx_caps &
+                                 UCS_BIT(UCT_TCP_EP_CTX_TYPE_GET_RX)));
 
     return 1;
 }
@@ -1095,6 +1494,17 @@ err:
     return 0;
 }
 
+static inline void
+uct_tcp_ep_zcopy_copy_hdr(uct_tcp_iface_t *iface, uct_tcp_ep_t *ep,
+                          uct_tcp_ep_zcopy_tx_t *ctx, const void *header,
+                          unsigned header_length)
+{
+    ucs_assert(header_length <= iface->config.zcopy.max_hdr);
+    ctx->iov[1].iov_base = UCS_PTR_BYTE_OFFSET(ep->tx.buf,
+                                               iface->config.zcopy.hdr_offset);
+    memcpy(ctx->iov[1].iov_base, header, header_length);
+}
+
 static inline void
 uct_tcp_ep_set_outstanding_zcopy(uct_tcp_iface_t *iface, uct_tcp_ep_t *ep,
                                  uct_tcp_ep_zcopy_tx_t *ctx, const void *header,
@@ -1103,16 +1513,13 @@ uct_tcp_ep_set_outstanding_zcopy(uct_tcp_iface_t *iface, uct_tcp_ep_t *ep,
     ctx->comp     = comp;
     ep->ctx_caps |= UCS_BIT(UCT_TCP_EP_CTX_TYPE_ZCOPY_TX);
 
-    if ((header_length != 0) &&
+    if ((header_length != 0) && !ctx->msg_zcopy &&
         /* check whether a user's header was sent or not */
         (ep->tx.offset < (sizeof(uct_tcp_am_hdr_t) + header_length))) {
-        ucs_assert(header_length <= iface->config.zcopy.max_hdr);
         /* if the user's header wasn't sent completely, copy it to
          * the EP TX buffer (after Zcopy context and IOVs) for
          * retransmission. iov_len is already set to the proper value */
-        ctx->iov[1].iov_base = UCS_PTR_BYTE_OFFSET(ep->tx.buf,
-                                                   iface->config.zcopy.hdr_offset);
-        memcpy(ctx->iov[1].iov_base, header, header_length);
+        uct_tcp_ep_zcopy_copy_hdr(iface, ep, ctx, header, header_length);
     }
 
     ctx->iov_index = 0;
@@ -1120,6 +1527,49 @@ uct_tcp_ep_set_outstanding_zcopy(uct_tcp_iface_t *iface, uct_tcp_ep_t *ep,
     uct_tcp_ep_mod_events(ep, UCS_EVENT_SET_EVWRITE, 0);
 }
 
+/* Get a space for an active message at the end of the TX buffer which is
+ * still being sent. So, several messages are sent by one system call when
+ * the socket becomes writable, instead of returning UCS_ERR_NO_RESOURCE.
+ * The TX buffer is twice as large as TX segment, so it always has a space for
+ * the message if its length doesn't exceed TX segment */
+static inline uct_tcp_am_hdr_t *
+uct_tcp_ep_am_coalesce_prepare(uct_tcp_iface_t *iface, uct_tcp_ep_t *ep,
+                               uint8_t am_id)
+{
+    uct_tcp_am_hdr_t *hdr;
+
+    if (!iface->config.tx_coalesce ||
+        (ep->conn_state != UCT_TCP_EP_CONN_STATE_CONNECTED) ||
+        !uct_tcp_ep_ctx_buf_need_progress(&ep->tx) ||
+        (ep->ctx_caps & UCS_BIT(UCT_TCP_EP_CTX_TYPE_ZCOPY_TX)) ||
+        (ep->tx.length > iface->config.tx_seg_size) ||
+        /* Don't overtake the operations added to the pending queue */
+        !ucs_queue_is_empty(&ep->pending_q)) {
+        return NULL;
+    }
+
+    hdr        = UCS_PTR_BYTE_OFFSET(ep->tx.buf, ep->tx.length);
+    hdr->am_id = am_id;
+    return hdr;
+}
+
+static inline void
+uct_tcp_ep_am_coalesce_commit(uct_tcp_iface_t *iface, uct_tcp_ep_t *ep,
+                              const uct_tcp_am_hdr_t *hdr)
+{
+    size_t length = sizeof(*hdr) + hdr->length;
+
+    ucs_assert((ep->tx.length + length) <= (iface->config.tx_seg_size * 2));
+
+    ep->tx.length      += length;
+    iface->outstanding += length;
+
+    uct_iface_trace_am(&iface->super, UCT_AM_TRACE_TYPE_SEND, hdr->am_id,
+                       hdr + 1, hdr->length, "SEND: ep %p fd %d coalesced "
+                       "%zu bytes, %zu/%zu bytes in TX buffer",
+                       ep, ep->fd, length, ep->tx.offset, ep->tx.length);
+}
+
 static inline ucs_status_t
 uct_tcp_ep_am_send(uct_tcp_iface_t *iface, uct_tcp_ep_t *ep,
                    const uct_tcp_am_hdr_t *hdr)
@@ -1171,6 +1621,7 @@ uct_tcp_ep_am_sendv(uct_tcp_iface_t *iface, uct_tcp_ep_t *ep,
                     size_t send_limit, const void *header,
                     struct iovec *iov, size_t iov_cnt)
 {
+    uct_tcp_ep_zcopy_tx_t *ctx;
     ucs_status_t status;
 
     ep->tx.length += hdr->length + sizeof(*hdr);
@@ -1178,8 +1629,17 @@ uct_tcp_ep_am_sendv(uct_tcp_iface_t *iface, uct_tcp_ep_t *ep,
     ucs_assertv((ep->tx.length <= send_limit) &&
                 (iov_cnt > 0), "ep=%p", ep);
 
-    status = ucs_socket_sendv_nb(ep->fd, iov, iov_cnt,
-                                 &ep->tx.offset, NULL, NULL);
+    ctx = ucs_derived_of(hdr, uct_tcp_ep_zcopy_tx_t);
+    if (short_sendv || !ctx->msg_zcopy) {
+        status = ucs_socket_sendv_nb(ep->fd, iov, iov_cnt,
+                                     &ep->tx.offset, NULL, NULL);
+    } else {
+        status = ucs_socket_sendv_zcopy_nb(ep->fd, iov, iov_cnt,
+                                           &ep->tx.offset, NULL, NULL);
+        if (status == UCS_OK) {
+            ctx->msg_zcopy_sn = ep->msg_zcopy.tx_sn++;
+        }
+    }
 
     uct_iface_trace_am(&iface->super, UCT_AM_TRACE_TYPE_SEND, hdr->am_id,
                        /* the function will be invoked only in case of
@@ -1256,6 +1716,15 @@ ucs_status_t uct_tcp_ep_am_short(uct_ep_h uct_ep, uint8_t am_id, uint64_t header
                      "am_short");
     UCT_CHECK_AM_ID(am_id);
 
+    hdr = uct_tcp_ep_am_coalesce_prepare(iface, ep, am_id);
+    if (hdr != NULL) {
+        hdr->length = length + sizeof(header);
+        uct_am_short_fill_data(hdr + 1, header, payload, length);
+        uct_tcp_ep_am_coalesce_commit(iface, ep, hdr);
+        UCT_TL_EP_STAT_OP(&ep->super, AM, SHORT, hdr->length);
+        return UCS_OK;
+    }
+
     status = uct_tcp_ep_am_prepare(iface, ep, am_id, &hdr);
     if (status != UCS_OK) {
         return status;
@@ -1327,6 +1796,14 @@ ssize_t uct_tcp_ep_am_bcopy(uct_ep_h uct_ep, uint8_t am_id,
 
     UCT_CHECK_AM_ID(am_id);
 
+    hdr = uct_tcp_ep_am_coalesce_prepare(iface, ep, am_id);
+    if (hdr != NULL) {
+        hdr->length = payload_length = pack_cb(hdr + 1, arg);
+        uct_tcp_ep_am_coalesce_commit(iface, ep, hdr);
+        UCT_TL_EP_STAT_OP(&ep->super, AM, BCOPY, payload_length);
+        return payload_length;
+    }
+
     status = uct_tcp_ep_am_prepare(iface, ep, am_id, &hdr);
     if (status != UCS_OK) {
         return status;
@@ -1349,29 +1826,16 @@ ssize_t uct_tcp_ep_am_bcopy(uct_ep_h uct_ep, uint8_t am_id,
     return payload_length;
 }
 
-static inline ucs_status_t
-uct_tcp_ep_prepare_zcopy(uct_tcp_iface_t *iface, uct_tcp_ep_t *ep, uint8_t am_id,
-                         const void *header, unsigned header_length,
-                         const uct_iov_t *iov, size_t iovcnt, const char *name,
-                         size_t *zcopy_payload_p, uct_tcp_ep_zcopy_tx_t **ctx_p)
+static inline uct_tcp_ep_zcopy_tx_t *
+uct_tcp_ep_zcopy_init_ctx(uct_tcp_iface_t *iface, uct_tcp_am_hdr_t *hdr,
+                          const void *header, unsigned header_length,
+                          const uct_iov_t *iov, size_t iovcnt,
+                          ucs_iov_iter_t *uct_iov_iter_p, size_t max_length,
+                          size_t *zcopy_payload_p)
 {
-    uct_tcp_am_hdr_t *hdr = NULL;
+    uct_tcp_ep_zcopy_tx_t *ctx = ucs_derived_of(hdr, uct_tcp_ep_zcopy_tx_t);
     size_t io_vec_cnt;
-    ucs_iov_iter_t uct_iov_iter;
-    uct_tcp_ep_zcopy_tx_t *ctx;
-    ucs_status_t status;
-
-    UCT_CHECK_IOV_SIZE(iovcnt, iface->config.zcopy.max_iov, name);
-    UCT_CHECK_LENGTH(header_length, 0, iface->config.zcopy.max_hdr, name);
-
-    status = uct_tcp_ep_am_prepare(iface, ep, am_id, &hdr);
-    if (ucs_unlikely(status != UCS_OK)) {
-        return status;
-    }
-
-    ucs_assertv(hdr != NULL, "ep=%p", ep);
 
-    ctx          = ucs_derived_of(hdr, uct_tcp_ep_zcopy_tx_t);
     ctx->iov_cnt = 0;
 
     /* TCP transport header */
@@ -1388,13 +1852,40 @@ uct_tcp_ep_prepare_zcopy(uct_tcp_iface_t *iface, uct_tcp_ep_t *ep, uint8_t am_id
     }
 
     /* User-defined payload */
-    ucs_iov_iter_init(&uct_iov_iter);
-    io_vec_cnt       = iovcnt; 
+    io_vec_cnt       = iovcnt;
     *zcopy_payload_p = uct_iov_to_iovec(&ctx->iov[ctx->iov_cnt], &io_vec_cnt,
-                                        iov, iovcnt, SIZE_MAX, &uct_iov_iter);
-    *ctx_p           = ctx;
+                                        iov, iovcnt, max_length,
+                                        uct_iov_iter_p);
     ctx->iov_cnt    += io_vec_cnt;
+    ctx->msg_zcopy   = (*zcopy_payload_p >= iface->config.zcopy.msg_thresh);
+
+    return ctx;
+}
+
+static inline ucs_status_t
+uct_tcp_ep_prepare_zcopy(uct_tcp_iface_t *iface, uct_tcp_ep_t *ep, uint8_t am_id,
+                         const void *header, unsigned header_length,
+                         const uct_iov_t *iov, size_t iovcnt, const char *name,
+                         size_t *zcopy_payload_p, uct_tcp_ep_zcopy_tx_t **ctx_p)
+{
+    uct_tcp_am_hdr_t *hdr = NULL;
+    ucs_iov_iter_t uct_iov_iter;
+    ucs_status_t status;
+
+    UCT_CHECK_IOV_SIZE(iovcnt, iface->config.zcopy.max_iov, name);
+    UCT_CHECK_LENGTH(header_length, 0, iface->config.zcopy.max_hdr, name);
+
+    status = uct_tcp_ep_am_prepare(iface, ep, am_id, &hdr);
+    if (ucs_unlikely(status != UCS_OK)) {
+        return status;
+    }
+
+    ucs_assertv(hdr != NULL, "ep=%p", ep);
 
+    ucs_iov_iter_init(&uct_iov_iter);
+    *ctx_p = uct_tcp_ep_zcopy_init_ctx(iface, hdr, header, header_length,
+                                       iov, iovcnt, &uct_iov_iter, SIZE_MAX,
+                                       zcopy_payload_p);
     return UCS_OK;
 }
 
@@ -1423,6 +1914,11 @@ ucs_status_t uct_tcp_ep_am_zcopy(uct_ep_h uct_ep, uint8_t am_id, const void *hea
 
     ctx->super.length = payload_length + header_length;
 
+    if (ctx->msg_zcopy && (header_length != 0)) {
+        /* The kernel may access the header after the send call returns */
+        uct_tcp_ep_zcopy_copy_hdr(iface, ep, ctx, header, header_length);
+    }
+
     status = uct_tcp_ep_am_sendv(iface, ep, 0, &ctx->super,
                                  iface->config.rx_seg_size,
                                  header, ctx->iov, ctx->iov_cnt);
@@ -1440,40 +1936,49 @@ ucs_status_t uct_tcp_ep_am_zcopy(uct_ep_h uct_ep, uint8_t am_id, const void *hea
 
     ucs_assert(status == UCS_OK);
 
+    if (ctx->msg_zcopy) {
+        ctx->comp = comp;
+        uct_tcp_ep_msg_zcopy_add(ep, ctx);
+        return UCS_INPROGRESS;
+    }
+
 out:
     uct_tcp_ep_ctx_reset(&ep->tx);
     return status;
 }
 
-ucs_status_t uct_tcp_ep_put_zcopy(uct_ep_h uct_ep, const uct_iov_t *iov,
-                                  size_t iovcnt, uint64_t remote_addr,
-                                  uct_rkey_t rkey, uct_completion_t *comp)
+/* Send a PUT Zcopy operation for up to `max_length` bytes of the payload
+ * starting from the current position of `uct_iov_iter_p`. The TX buffer of
+ * the EP has to be already allocated to `hdr` and it is released by the
+ * function if the operation fails */
+static ucs_status_t
+uct_tcp_ep_put_zcopy_send(uct_tcp_iface_t *iface, uct_tcp_ep_t *ep,
+                          uct_tcp_am_hdr_t *hdr, const uct_iov_t *iov,
+                          size_t iovcnt, ucs_iov_iter_t *uct_iov_iter_p,
+                          size_t max_length, uint64_t remote_addr,
+                          uct_completion_t *comp, size_t *length_p)
 {
-    uct_tcp_ep_t *ep                 = ucs_derived_of(uct_ep, uct_tcp_ep_t);
-    uct_tcp_iface_t *iface           = ucs_derived_of(uct_ep->iface, uct_tcp_iface_t);
-    uct_tcp_ep_zcopy_tx_t *ctx       = NULL;
     uct_tcp_ep_put_req_hdr_t put_req = {0}; /* Suppress Cppcheck false-positive */
+    uct_tcp_ep_zcopy_tx_t *ctx;
     ucs_status_t status;
 
-    UCT_CHECK_LENGTH(sizeof(put_req) + uct_iov_total_length(iov, iovcnt), 0,
-                     UCT_TCP_EP_PUT_ZCOPY_MAX - sizeof(uct_tcp_am_hdr_t),
-                     "put_zcopy");
-
-    status = uct_tcp_ep_prepare_zcopy(iface, ep, UCT_TCP_EP_PUT_REQ_AM_ID,
-                                      &put_req, sizeof(put_req),
-                                      iov, iovcnt, "put_zcopy",
-                                      /* Set a payload length directly to the
-                                       * TX length, since PUT Zcopy doesn't
-                                       * set the payload length to TCP AM hdr */
-                                      &ep->tx.length, &ctx);
-    if (ucs_unlikely(status != UCS_OK)) {
-        return status;
-    }
+    ctx = uct_tcp_ep_zcopy_init_ctx(iface, hdr, &put_req, sizeof(put_req),
+                                    iov, iovcnt, uct_iov_iter_p, max_length,
+                                    /* Set a payload length directly to the
+                                     * TX length, since PUT Zcopy doesn't
+                                     * set the payload length to TCP AM hdr */
+                                    &ep->tx.length);
 
     ctx->super.length = sizeof(put_req);
     put_req.addr      = remote_addr;
     put_req.length    = ep->tx.length;
     put_req.sn        = ep->tx.put_sn + 1;
+    *length_p         = put_req.length;
+
+    if (ctx->msg_zcopy) {
+        /* The kernel may access the header after the send call returns */
+        uct_tcp_ep_zcopy_copy_hdr(iface, ep, ctx, &put_req, sizeof(put_req));
+    }
 
     status = uct_tcp_ep_am_sendv(iface, ep, 0, &ctx->super, UCT_TCP_EP_PUT_ZCOPY_MAX,
                                  &put_req, ctx->iov, ctx->iov_cnt);
@@ -1503,11 +2008,402 @@ ucs_status_t uct_tcp_ep_put_zcopy(uct_ep_h uct_ep, const uct_iov_t *iov,
 
     ucs_assert(status == UCS_OK);
 
+    if (ctx->msg_zcopy) {
+        ctx->comp = comp;
+        uct_tcp_ep_msg_zcopy_add(ep, ctx);
+        return UCS_INPROGRESS;
+    }
+
+out:
+    uct_tcp_ep_ctx_reset(&ep->tx);
+    return status;
+}
+
+static void uct_tcp_ep_stripe_comp_func(uct_completion_t *self,
+                                        ucs_status_t status)
+{
+    uct_tcp_ep_stripe_completion_t *stripe_comp =
+            ucs_container_of(self, uct_tcp_ep_stripe_completion_t, super);
+
+    if (stripe_comp->status != UCS_OK) {
+        status = stripe_comp->status;
+    }
+
+    uct_invoke_completion(stripe_comp->comp, status);
+    ucs_free(stripe_comp);
+}
+
+/* Split the PUT Zcopy payload to fragments and send them over the additional
+ * connections of the EP which are able to send data now, the last fragment
+ * is sent over the EP itself. The remote side writes each fragment directly
+ * to its destination, so no ordering between the fragments is required.
+ * The fragments sent over the additional connections are completed upon
+ * receiving PUT ACKs, so the data is placed on the remote side before the
+ * completion is invoked and a user's AM sent after that over the EP can't
+ * overtake it */
+static ucs_status_t
+uct_tcp_ep_put_zcopy_stripe(uct_tcp_iface_t *iface, uct_tcp_ep_t *ep,
+                            uct_tcp_am_hdr_t *hdr, const uct_iov_t *iov,
+                            size_t iovcnt, size_t total_length,
+                            uint64_t remote_addr, uct_completion_t *comp)
+{
+    unsigned num_inprogress                     = 0;
+    unsigned num_ready                          = 1; /* The EP itself */
+    size_t offset                               = 0;
+    uct_tcp_ep_put_completion_t *put_comp       = NULL;
+    uct_tcp_ep_stripe_completion_t *stripe_comp = NULL;
+    uct_tcp_am_hdr_t *stripe_hdr;
+    ucs_iov_iter_t uct_iov_iter, prev_uct_iov_iter;
+    uct_tcp_ep_t *stripe_ep;
+    size_t frag_length, length;
+    ucs_status_t status;
+
+    ucs_list_for_each(stripe_ep, &ep->stripe_list, list) {
+        if (uct_tcp_ep_check_tx_res(stripe_ep) == UCS_OK) {
+            num_ready++;
+        }
+    }
+
+    frag_length = ucs_div_round_up(total_length, num_ready);
+    ucs_iov_iter_init(&uct_iov_iter);
+
+    if (comp != NULL) {
+        stripe_comp = ucs_malloc(sizeof(*stripe_comp), "stripe completion");
+        if (stripe_comp == NULL) {
+            /* Send the whole payload over the EP itself */
+            num_ready = 1;
+        }
+    }
+
+    ucs_list_for_each(stripe_ep, &ep->stripe_list, list) {
+        if ((num_ready == 1) || ((offset + frag_length) >= total_length)) {
+            break;
+        }
+
+        if (uct_tcp_ep_check_tx_res(stripe_ep) != UCS_OK) {
+            continue;
+        }
+
+        if ((comp != NULL) && (put_comp == NULL)) {
+            put_comp = ucs_calloc(1, sizeof(*put_comp), "put completion");
+            if (put_comp == NULL) {
+                break;
+            }
+        }
+
+        if (uct_tcp_ep_am_prepare(iface, stripe_ep, UCT_TCP_EP_PUT_REQ_AM_ID,
+                                  &stripe_hdr) != UCS_OK) {
+            continue;
+        }
+
+        prev_uct_iov_iter = uct_iov_iter;
+
+        status = uct_tcp_ep_put_zcopy_send(iface, stripe_ep, stripe_hdr, iov,
+                                           iovcnt, &uct_iov_iter, frag_length,
+                                           remote_addr + offset, NULL, &length);
+        if (UCS_STATUS_IS_ERR(status)) {
+            /* The fragment will be sent over another connection */
+            uct_iov_iter = prev_uct_iov_iter;
+            continue;
+        }
+
+        if (put_comp != NULL) {
+            /* If MSG_ZEROCOPY is used, the kernel releases the user's buffer
+             * upon processing TCP ACKs for the data, which is done prior to
+             * receiving PUT ACK from the same socket */
+            put_comp->wait_put_sn = stripe_ep->tx.put_sn;
+            put_comp->comp        = &stripe_comp->super;
+            ucs_queue_push(&stripe_ep->put_comp_q, &put_comp->elem);
+            put_comp              = NULL;
+            num_inprogress++;
+        }
+
+        offset += length;
+    }
+
+    ucs_free(put_comp);
+
+    if (num_inprogress == 0) {
+        ucs_free(stripe_comp);
+        status = uct_tcp_ep_put_zcopy_send(iface, ep, hdr, iov, iovcnt,
+                                           &uct_iov_iter, SIZE_MAX,
+                                           remote_addr + offset, comp, &length);
+        ucs_assert(UCS_STATUS_IS_ERR(status) ||
+                   ((offset + length) == total_length));
+        return status;
+    }
+
+    /* The user's completion is invoked once all fragments are completed,
+     * including the last one which is sent over the EP itself */
+    stripe_comp->super.func  = uct_tcp_ep_stripe_comp_func;
+    stripe_comp->super.count = num_inprogress + 1;
+    stripe_comp->comp        = comp;
+    stripe_comp->status      = UCS_OK;
+
+    status = uct_tcp_ep_put_zcopy_send(iface, ep, hdr, iov, iovcnt,
+                                       &uct_iov_iter, SIZE_MAX,
+                                       remote_addr + offset,
+                                       &stripe_comp->super, &length);
+    ucs_assert(UCS_STATUS_IS_ERR(status) ||
+               ((offset + length) == total_length));
+    if (status != UCS_INPROGRESS) {
+        /* The fragments in-flight still refer to the user's buffer, so the
+         * operation is reported as in-progress, and the error of the last
+         * fragment is reported by the user's completion */
+        if (UCS_STATUS_IS_ERR(status)) {
+            ucs_debug("tcp_ep %p: failed to send the last PUT Zcopy fragment: "
+                      "%s", ep, ucs_status_string(status));
+            stripe_comp->status = status;
+        }
+
+        uct_invoke_completion(&stripe_comp->super, status);
+    }
+
+    return UCS_INPROGRESS;
+}
+
+ucs_status_t uct_tcp_ep_put_zcopy(uct_ep_h uct_ep, const uct_iov_t *iov,
+                                  size_t iovcnt, uint64_t remote_addr,
+                                  uct_rkey_t rkey, uct_completion_t *comp)
+{
+    uct_tcp_ep_t *ep       = ucs_derived_of(uct_ep, uct_tcp_ep_t);
+    uct_tcp_iface_t *iface = ucs_derived_of(uct_ep->iface, uct_tcp_iface_t);
+    uct_tcp_am_hdr_t *hdr  = NULL;
+    ucs_iov_iter_t uct_iov_iter;
+    size_t total_length, length;
+    ucs_status_t status;
+
+    total_length = uct_iov_total_length(iov, iovcnt);
+    UCT_CHECK_LENGTH(sizeof(uct_tcp_ep_put_req_hdr_t) + total_length, 0,
+                     UCT_TCP_EP_PUT_ZCOPY_MAX - sizeof(uct_tcp_am_hdr_t),
+                     "put_zcopy");
+    UCT_CHECK_IOV_SIZE(iovcnt, iface->config.zcopy.max_iov, "put_zcopy");
+
+    status = uct_tcp_ep_am_prepare(iface, ep, UCT_TCP_EP_PUT_REQ_AM_ID, &hdr);
+    if (ucs_unlikely(status != UCS_OK)) {
+        return status;
+    }
+
+    ucs_assertv(hdr != NULL, "ep=%p", ep);
+
+    if (ucs_unlikely(!ucs_list_is_empty(&ep->stripe_list) &&
+                     (total_length >= iface->config.stripe.thresh))) {
+        return uct_tcp_ep_put_zcopy_stripe(iface, ep, hdr, iov, iovcnt,
+                                           total_length, remote_addr, comp);
+    }
+
+    ucs_iov_iter_init(&uct_iov_iter);
+    return uct_tcp_ep_put_zcopy_send(iface, ep, hdr, iov, iovcnt,
+                                     &uct_iov_iter, SIZE_MAX, remote_addr,
+                                     comp, &length);
+}
+
+/* Send a GET RESP operation which delivers the requested data from the local
+ * memory to the requester's buffer. The response is sent in the same way as
+ * PUT Zcopy, but without waiting for PUT ACK */
+static ucs_status_t
+uct_tcp_ep_send_get_resp(uct_tcp_ep_t *ep,
+                         const uct_tcp_ep_get_req_hdr_t *get_req)
+{
+    uct_tcp_iface_t *iface           = ucs_derived_of(ep->super.super.iface,
+                                                      uct_tcp_iface_t);
+    uct_tcp_ep_put_req_hdr_t put_req = {0}; /* Suppress Cppcheck false-positive */
+    uct_tcp_am_hdr_t *hdr            = NULL;
+    uct_tcp_ep_zcopy_tx_t *ctx;
+    ucs_iov_iter_t uct_iov_iter;
+    uct_iov_t iov;
+    ucs_status_t status;
+
+    status = uct_tcp_ep_am_prepare(iface, ep, UCT_TCP_EP_GET_RESP_AM_ID, &hdr);
+    if (status != UCS_OK) {
+        return status;
+    }
+
+    iov.buffer = (void*)(uintptr_t)get_req->addr;
+    iov.length = get_req->length;
+    iov.memh   = UCT_MEM_HANDLE_NULL;
+    iov.stride = 0;
+    iov.count  = 1;
+
+    ucs_iov_iter_init(&uct_iov_iter);
+    ctx = uct_tcp_ep_zcopy_init_ctx(iface, hdr, &put_req, sizeof(put_req),
+                                    &iov, 1, &uct_iov_iter, SIZE_MAX,
+                                    &ep->tx.length);
+
+    ctx->super.length = sizeof(put_req);
+    put_req.addr      = get_req->resp_addr;
+    put_req.length    = ep->tx.length;
+    put_req.sn        = get_req->sn;
+
+    if (ctx->msg_zcopy) {
+        /* The kernel may access the header after the send call returns */
+        uct_tcp_ep_zcopy_copy_hdr(iface, ep, ctx, &put_req, sizeof(put_req));
+    }
+
+    status = uct_tcp_ep_am_sendv(iface, ep, 0, &ctx->super,
+                                 UCT_TCP_EP_PUT_ZCOPY_MAX, &put_req,
+                                 ctx->iov, ctx->iov_cnt);
+    if (ucs_unlikely((status != UCS_OK) && (status != UCS_ERR_NO_PROGRESS))) {
+        goto out;
+    }
+
+    if (uct_tcp_ep_ctx_buf_need_progress(&ep->tx)) {
+        uct_tcp_ep_set_outstanding_zcopy(iface, ep, ctx, &put_req,
+                                         sizeof(put_req), NULL);
+        return UCS_OK;
+    }
+
+    if (ctx->msg_zcopy) {
+        ctx->comp = NULL;
+        uct_tcp_ep_msg_zcopy_add(ep, ctx);
+        return UCS_OK;
+    }
+
 out:
     uct_tcp_ep_ctx_reset(&ep->tx);
     return status;
 }
 
+/* Close the connection if a GET response can't be delivered, so the
+ * requester completes its GET operations with an error instead of waiting
+ * for the response forever. The EP could be destroyed by the function */
+static void uct_tcp_ep_get_resp_failed(uct_tcp_ep_t *ep,
+                                       uct_tcp_ep_ctx_t *ctx,
+                                       ucs_status_t status)
+{
+    ucs_debug("tcp_ep %p: failed to send GET response: %s", ep,
+              ucs_status_string(status));
+    uct_tcp_ep_handle_disconnected(ep, ctx);
+}
+
+static ucs_status_t uct_tcp_ep_post_get_resps(uct_tcp_ep_t *ep)
+{
+    uct_tcp_ep_get_resp_t *get_resp;
+    ucs_status_t status;
+
+    while (!ucs_queue_is_empty(&ep->get.resp_q) &&
+           uct_tcp_ep_ctx_buf_empty(&ep->tx)) {
+        get_resp = ucs_queue_head_elem_non_empty(&ep->get.resp_q,
+                                                 uct_tcp_ep_get_resp_t, elem);
+        status   = uct_tcp_ep_send_get_resp(ep, &get_resp->get_req);
+        if (status == UCS_ERR_NO_RESOURCE) {
+            break;
+        } else if (ucs_unlikely(status != UCS_OK)) {
+            uct_tcp_ep_get_resp_failed(ep, &ep->tx, status);
+            return status;
+        }
+
+        ucs_queue_pull_non_empty(&ep->get.resp_q);
+        ucs_free(get_resp);
+    }
+
+    return UCS_OK;
+}
+
+static ucs_status_t
+uct_tcp_ep_handle_get_req(uct_tcp_ep_t *ep,
+                          const uct_tcp_ep_get_req_hdr_t *get_req)
+{
+    uct_tcp_ep_get_resp_t *get_resp;
+    ucs_status_t status;
+
+    ucs_assert(get_req->addr || !get_req->length);
+
+    if (ucs_queue_is_empty(&ep->get.resp_q)) {
+        status = uct_tcp_ep_send_get_resp(ep, get_req);
+        if (ucs_likely(status == UCS_OK)) {
+            return UCS_OK;
+        } else if (ucs_unlikely(status != UCS_ERR_NO_RESOURCE)) {
+            goto err;
+        }
+    }
+
+    /* Keep the order of GET responses, since the requester completes GET
+     * operations according to their sequence numbers */
+    get_resp = ucs_malloc(sizeof(*get_resp), "get resp");
+    if (get_resp == NULL) {
+        ucs_error("tcp_ep %p: unable to allocate GET response", ep);
+        status = UCS_ERR_NO_MEMORY;
+        goto err;
+    }
+
+    get_resp->get_req = *get_req;
+    ucs_queue_push(&ep->get.resp_q, &get_resp->elem);
+    return UCS_OK;
+
+err:
+    uct_tcp_ep_get_resp_failed(ep, &ep->rx, status);
+    return status;
+}
+
+ucs_status_t uct_tcp_ep_get_zcopy(uct_ep_h uct_ep, const uct_iov_t *iov,
+                                  size_t iovcnt, uint64_t remote_addr,
+                                  uct_rkey_t rkey, uct_completion_t *comp)
+{
+    uct_tcp_ep_t *ep                      = ucs_derived_of(uct_ep, uct_tcp_ep_t);
+    uct_tcp_iface_t *iface                = ucs_derived_of(uct_ep->iface,
+                                                           uct_tcp_iface_t);
+    uct_tcp_am_hdr_t *hdr                 = NULL;
+    uct_tcp_ep_get_completion_t *get_comp = NULL;
+    uct_tcp_ep_get_req_hdr_t *get_req;
+    size_t length;
+    ucs_status_t status;
+
+    UCT_CHECK_IOV_SIZE(iovcnt, 1ul, "get_zcopy");
+    length = uct_iov_total_length(iov, iovcnt);
+    UCT_CHECK_LENGTH(length, 0, UCT_TCP_EP_GET_ZCOPY_MAX, "get_zcopy");
+
+    status = uct_tcp_ep_am_prepare(iface, ep, UCT_TCP_EP_GET_REQ_AM_ID, &hdr);
+    if (ucs_unlikely(status != UCS_OK)) {
+        return status;
+    }
+
+    ucs_assertv(hdr != NULL, "ep=%p", ep);
+
+    if (comp != NULL) {
+        get_comp = ucs_malloc(sizeof(*get_comp), "get completion");
+        if (ucs_unlikely(get_comp == NULL)) {
+            status = UCS_ERR_NO_MEMORY;
+            goto err_reset;
+        }
+    }
+
+    hdr->length        = sizeof(*get_req);
+    get_req            = (uct_tcp_ep_get_req_hdr_t*)(hdr + 1);
+    get_req->addr      = remote_addr;
+    get_req->length    = length;
+    get_req->resp_addr = (iovcnt != 0) ? (uintptr_t)iov[0].buffer : 0;
+    get_req->sn        = ep->tx.get_sn + 1;
+
+    status = uct_tcp_ep_am_send(iface, ep, hdr);
+    if (ucs_unlikely(status != UCS_OK)) {
+        ucs_free(get_comp);
+        goto err_reset;
+    }
+
+    if (!uct_tcp_ep_get_in_progress(ep)) {
+        /* Increment iface outstanding operations counter in order to ensure
+         * returning UCS_INPROGRESS from flush functions and do progressing
+         * until all GET responses are received */
+        uct_tcp_iface_outstanding_inc(iface);
+    }
+
+    ep->tx.get_sn++;
+
+    if (get_comp != NULL) {
+        get_comp->comp        = comp;
+        get_comp->wait_get_sn = ep->tx.get_sn;
+        ucs_queue_push(&ep->get.comp_q, &get_comp->elem);
+    }
+
+    UCT_TL_EP_STAT_OP(&ep->super, GET, ZCOPY, length);
+    return UCS_INPROGRESS;
+
+err_reset:
+    uct_tcp_ep_ctx_reset(&ep->tx);
+    return status;
+}
+
 ucs_status_t uct_tcp_ep_pending_add(uct_ep_h tl_ep, uct_pending_req_t *req,
                                     unsigned flags)
 {
@@ -1531,15 +2427,26 @@ void uct_tcp_ep_pending_purge(uct_ep_h tl_ep, uct_pending_purge_callback_t cb,
     uct_pending_queue_purge(priv, &ep->pending_q, 1, cb, arg);
 }
 
-ucs_status_t uct_tcp_ep_flush(uct_ep_h tl_ep, unsigned flags,
-                              uct_completion_t *comp)
+static ucs_status_t uct_tcp_ep_flush_add_comp(uct_tcp_ep_t *ep,
+                                              uct_completion_t *comp)
 {
-    uct_tcp_ep_t *ep = ucs_derived_of(tl_ep, uct_tcp_ep_t);
     uct_tcp_ep_put_completion_t *put_comp;
 
-    if (uct_tcp_ep_check_tx_res(ep) == UCS_ERR_NO_RESOURCE) {
-        UCT_TL_EP_STAT_FLUSH_WAIT(&ep->super);
-        return UCS_ERR_NO_RESOURCE;
+    if (uct_tcp_ep_msg_zcopy_in_progress(ep)) {
+        if (comp != NULL) {
+            put_comp = ucs_calloc(1, sizeof(*put_comp), "zcopy completion");
+            if (put_comp == NULL) {
+                return UCS_ERR_NO_MEMORY;
+            }
+
+            /* PUT ACKs are checked after all MSG_ZEROCOPY sends are completed */
+            put_comp->wait_put_sn       = ep->tx.put_sn;
+            put_comp->wait_msg_zcopy_sn = ep->msg_zcopy.tx_sn - 1;
+            put_comp->comp              = comp;
+            ucs_queue_push(&ep->msg_zcopy.flush_q, &put_comp->elem);
+        }
+
+        return UCS_INPROGRESS;
     }
 
     if (ep->ctx_caps & UCS_BIT(UCT_TCP_EP_CTX_TYPE_PUT_TX_WAITING_ACK)) {
@@ -1557,7 +2464,65 @@ ucs_status_t uct_tcp_ep_flush(uct_ep_h tl_ep, unsigned flags,
         return UCS_INPROGRESS;
     }
 
-    UCT_TL_EP_STAT_FLUSH(&ep->super);
     return UCS_OK;
 }
 
+ucs_status_t uct_tcp_ep_flush(uct_ep_h tl_ep, unsigned flags,
+                              uct_completion_t *comp)
+{
+    uct_tcp_ep_t *ep        = ucs_derived_of(tl_ep, uct_tcp_ep_t);
+    unsigned num_inprogress = 0;
+    uct_tcp_ep_get_completion_t *get_comp;
+    uct_tcp_ep_t *stripe_ep;
+    ucs_status_t status;
+
+    if (uct_tcp_ep_check_tx_res(ep) == UCS_ERR_NO_RESOURCE) {
+        UCT_TL_EP_STAT_FLUSH_WAIT(&ep->super);
+        return UCS_ERR_NO_RESOURCE;
+    }
+
+    status = uct_tcp_ep_flush_add_comp(ep, comp);
+    if (status == UCS_INPROGRESS) {
+        num_inprogress++;
+    } else if (status != UCS_OK) {
+        return status;
+    }
+
+    /* PUT Zcopy fragments sent over the additional connections have to be
+     * acknowledged as well. The data of these connections is sent as part
+     * of PUT Zcopy operations, so it's enough to wait for PUT ACKs */
+    ucs_list_for_each(stripe_ep, &ep->stripe_list, list) {
+        status = uct_tcp_ep_flush_add_comp(stripe_ep, comp);
+        if (status == UCS_INPROGRESS) {
+            num_inprogress++;
+        } else if (status != UCS_OK) {
+            return status;
+        }
+    }
+
+    if (uct_tcp_ep_get_in_progress(ep)) {
+        if (comp != NULL) {
+            get_comp = ucs_malloc(sizeof(*get_comp), "get completion");
+            if (get_comp == NULL) {
+                return UCS_ERR_NO_MEMORY;
+            }
+
+            get_comp->wait_get_sn = ep->tx.get_sn;
+            get_comp->comp        = comp;
+            ucs_queue_push(&ep->get.comp_q, &get_comp->elem);
+        }
+
+        num_inprogress++;
+    }
+
+    if (num_inprogress != 0) {
+        if (comp != NULL) {
+            comp->count += num_inprogress - 1;
+        }
+
+        return UCS_INPROGRESS;
+    }
+
+    UCT_TL_EP_STAT_FLUSH(&ep->super);
+    return UCS_OK;
+}
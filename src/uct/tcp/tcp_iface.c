@@ -43,6 +43,25 @@ static ucs_config_field_t uct_tcp_iface_config_table[] = {
    "Threshold for switching from send() to sendmsg() for short active messages",
    ucs_offsetof(uct_tcp_iface_config_t, sendv_thresh), UCS_CONFIG_TYPE_MEMUNITS},
 
+  {"MSG_ZEROCOPY_THRESH", "inf",
+   "Minimal size of AM/PUT Zcopy payload from which the data is sent with\n"
+   "MSG_ZEROCOPY flag, so the kernel transmits it directly from the user's\n"
+   "buffer instead of copying it. The operation is completed only after the\n"
+   "kernel releases the buffer. \"inf\" disables zero-copy socket send",
+   ucs_offsetof(uct_tcp_iface_config_t, msg_zcopy_thresh), UCS_CONFIG_TYPE_MEMUNITS},
+
+  {"STRIPE_CONNS", "1",
+   "Number of TCP connections that an endpoint establishes to a peer. PUT Zcopy\n"
+   "operations of size above STRIPE_THRESH are split to fragments that are sent\n"
+   "over these connections in parallel, so the traffic of a single endpoint can be\n"
+   "spread across multiple NIC queues and CPU cores.",
+   ucs_offsetof(uct_tcp_iface_config_t, stripe_conns), UCS_CONFIG_TYPE_UINT},
+
+  {"STRIPE_THRESH", "256kb",
+   "Minimum size of PUT Zcopy payload from which it is striped across multiple\n"
+   "connections, if STRIPE_CONNS > 1.",
+   ucs_offsetof(uct_tcp_iface_config_t, stripe_thresh), UCS_CONFIG_TYPE_MEMUNITS},
+
   {"PREFER_DEFAULT", "y",
    "Give higher priority to the default network interface on the host",
    ucs_offsetof(uct_tcp_iface_config_t, prefer_default), UCS_CONFIG_TYPE_BOOL},
@@ -51,6 +70,11 @@ static ucs_config_field_t uct_tcp_iface_config_table[] = {
    "Enable PUT Zcopy support",
    ucs_offsetof(uct_tcp_iface_config_t, put_enable), UCS_CONFIG_TYPE_BOOL},
 
+  {"GET_ENABLE", "y",
+   "Enable GET Zcopy support. The data is requested from a peer, which sends it\n"
+   "back directly from its memory buffer",
+   ucs_offsetof(uct_tcp_iface_config_t, get_enable), UCS_CONFIG_TYPE_BOOL},
+
   {"CONN_NB", "n",
    "Enable non-blocking connection establishment. It may improve startup "
    "time, but can lead to connection resets due to high load on TCP/IP stack",
@@ -60,6 +84,28 @@ static ucs_config_field_t uct_tcp_iface_config_table[] = {
    "Number of times to poll on a ready socket. 0 - no polling, -1 - until drained",
    ucs_offsetof(uct_tcp_iface_config_t, max_poll), UCS_CONFIG_TYPE_UINT},
 
+  {"POLL_SPIN", "0us",
+   "Keep the interface busy for this time after the last handled event: the\n"
+   "event arming fails with UCS_ERR_BUSY, so a user waiting for events keeps\n"
+   "calling the progress instead of blocking on the event fd. It reduces the\n"
+   "latency of request-response traffic at the cost of CPU time.\n"
+   "0 - allow blocking on the event fd right away.",
+   ucs_offsetof(uct_tcp_iface_config_t, poll_spin), UCS_CONFIG_TYPE_TIME},
+
+  {"RX_DRAIN", "0",
+   "Keep receiving from a ready socket in one progress call until there is no\n"
+   "more data or at least this number of messages is handled. All complete\n"
+   "active messages are dispatched after each receive operation.\n"
+   "0 - receive once from a ready socket in each progress call.",
+   ucs_offsetof(uct_tcp_iface_config_t, rx_drain), UCS_CONFIG_TYPE_UINT},
+
+  {"TX_COALESCE", "n",
+   "Append short and bcopy active messages to the send buffer of the endpoint\n"
+   "if it is still being sent instead of returning UCS_ERR_NO_RESOURCE, so\n"
+   "several messages are sent by one system call. It doubles the size of the\n"
+   "send buffers.",
+   ucs_offsetof(uct_tcp_iface_config_t, tx_coalesce), UCS_CONFIG_TYPE_BOOL},
+
   {UCT_TCP_CONFIG_MAX_CONN_RETRIES, "25",
    "How many connection establishment attmepts should be done if dropped "
    "connection was detected due to lack of system resources",
@@ -78,6 +124,25 @@ static ucs_config_field_t uct_tcp_iface_config_table[] = {
    "Socket receive buffer size",
    ucs_offsetof(uct_tcp_iface_config_t, sockopt_rcvbuf), UCS_CONFIG_TYPE_MEMUNITS},
 
+  {"BUSY_POLL", "0us",
+   "Set SO_BUSY_POLL socket option to busy poll the device receive queue for\n"
+   "this time when there is no data on a socket. Increasing it above the\n"
+   "system default (net.core.busy_read) requires CAP_NET_ADMIN capability.\n"
+   "0 - do not set the option.",
+   ucs_offsetof(uct_tcp_iface_config_t, sockopt_busy_poll), UCS_CONFIG_TYPE_TIME},
+
+  {"PREFER_BUSY_POLL", "n",
+   "Set SO_PREFER_BUSY_POLL socket option to let busy polling suppress the\n"
+   "device interrupts. Effective only if BUSY_POLL is set.",
+   ucs_offsetof(uct_tcp_iface_config_t, sockopt_prefer_busy_poll),
+   UCS_CONFIG_TYPE_BOOL},
+
+  {"INCOMING_CPU", "-1",
+   "Set SO_INCOMING_CPU socket option to hint the CPU which processes the\n"
+   "socket, e.g. the one the application thread is bound to.\n"
+   "-1 - do not set the option.",
+   ucs_offsetof(uct_tcp_iface_config_t, sockopt_incoming_cpu), UCS_CONFIG_TYPE_INT},
+
   UCT_IFACE_MPOOL_CONFIG_FIELDS("TX_", -1, 8, "send",
                                 ucs_offsetof(uct_tcp_iface_config_t, tx_mpool), ""),
 
@@ -163,6 +228,14 @@ static ucs_status_t uct_tcp_iface_query(uct_iface_h tl_iface, uct_iface_attr_t *
             attr->cap.put.opt_zcopy_align  = 1;
             attr->cap.flags               |= UCT_IFACE_FLAG_PUT_ZCOPY;
         }
+
+        if (iface->config.get_enable) {
+            /* GET */
+            attr->cap.get.max_iov          = 1;
+            attr->cap.get.max_zcopy        = UCT_TCP_EP_GET_ZCOPY_MAX;
+            attr->cap.get.opt_zcopy_align  = 1;
+            attr->cap.flags               |= UCT_IFACE_FLAG_GET_ZCOPY;
+        }
     }
 
     attr->bandwidth.dedicated = 0;
@@ -190,6 +263,21 @@ static ucs_status_t uct_tcp_iface_event_fd_get(uct_iface_h tl_iface, int *fd_p)
     return ucs_event_set_fd_get(iface->event_set, fd_p);
 }
 
+static ucs_status_t uct_tcp_iface_event_arm(uct_iface_h tl_iface,
+                                            unsigned events)
+{
+    uct_tcp_iface_t *iface = ucs_derived_of(tl_iface, uct_tcp_iface_t);
+
+    if ((iface->config.poll_spin != 0) &&
+        ((ucs_get_time() - iface->last_event_time) < iface->config.poll_spin)) {
+        /* A response is likely to arrive soon, so let the user spin on the
+         * progress, and block on the event fd only after the spin time */
+        return UCS_ERR_BUSY;
+    }
+
+    return UCS_OK;
+}
+
 static void uct_tcp_iface_handle_events(void *callback_data,
                                         int events, void *arg)
 {
@@ -198,6 +286,15 @@ static void uct_tcp_iface_handle_events(void *callback_data,
 
     ucs_assertv(ep->conn_state != UCT_TCP_EP_CONN_STATE_CLOSED, "ep=%p", ep);
 
+    /* Handle the socket error queue first, since RX progress may
+     * destroy the EP */
+    if (events & UCS_EVENT_SET_EVERR) {
+        *count += uct_tcp_ep_progress_msg_zcopy(ep);
+        if (ucs_unlikely(ep->fd == -1)) {
+            /* The connection was closed due to an error queue failure */
+            return;
+        }
+    }
     if (events & UCS_EVENT_SET_EVREAD) {
         *count += uct_tcp_ep_cm_state[ep->conn_state].rx_progress(ep);
     }
@@ -206,9 +303,8 @@ static void uct_tcp_iface_handle_events(void *callback_data,
     }
 }
 
-unsigned uct_tcp_iface_progress(uct_iface_h tl_iface)
+static unsigned uct_tcp_iface_poll(uct_tcp_iface_t *iface)
 {
-    uct_tcp_iface_t *iface = ucs_derived_of(tl_iface, uct_tcp_iface_t);
     unsigned max_events    = iface->config.max_poll;
     unsigned count         = 0;
     unsigned read_events;
@@ -230,6 +326,19 @@ unsigned uct_tcp_iface_progress(uct_iface_h tl_iface)
     return count;
 }
 
+unsigned uct_tcp_iface_progress(uct_iface_h tl_iface)
+{
+    uct_tcp_iface_t *iface = ucs_derived_of(tl_iface, uct_tcp_iface_t);
+    unsigned count;
+
+    count = uct_tcp_iface_poll(iface);
+    if ((count > 0) && (iface->config.poll_spin != 0)) {
+        iface->last_event_time = ucs_get_time();
+    }
+
+    return count;
+}
+
 static ucs_status_t uct_tcp_iface_flush(uct_iface_h tl_iface, unsigned flags,
                                         uct_completion_t *comp)
 {
@@ -315,6 +424,55 @@ ucs_status_t uct_tcp_iface_set_sockopt(uct_tcp_iface_t *iface, int fd)
         }
     }
 
+    if (iface->sockopt.busy_poll != 0) {
+#ifdef SO_BUSY_POLL
+        status = ucs_socket_setopt(fd, SOL_SOCKET, SO_BUSY_POLL,
+                                   (const void*)&iface->sockopt.busy_poll,
+                                   sizeof(int));
+        if (status != UCS_OK) {
+            return status;
+        }
+#else
+        ucs_error("SO_BUSY_POLL socket option is not supported");
+        return UCS_ERR_UNSUPPORTED;
+#endif
+    }
+
+    if (iface->sockopt.prefer_busy_poll) {
+#ifdef SO_PREFER_BUSY_POLL
+        status = ucs_socket_setopt(fd, SOL_SOCKET, SO_PREFER_BUSY_POLL,
+                                   (const void*)&iface->sockopt.prefer_busy_poll,
+                                   sizeof(int));
+        if (status != UCS_OK) {
+            return status;
+        }
+#else
+        ucs_error("SO_PREFER_BUSY_POLL socket option is not supported");
+        return UCS_ERR_UNSUPPORTED;
+#endif
+    }
+
+    if (iface->sockopt.incoming_cpu != -1) {
+#ifdef SO_INCOMING_CPU
+        status = ucs_socket_setopt(fd, SOL_SOCKET, SO_INCOMING_CPU,
+                                   (const void*)&iface->sockopt.incoming_cpu,
+                                   sizeof(int));
+        if (status != UCS_OK) {
+            return status;
+        }
+#else
+        ucs_error("SO_INCOMING_CPU socket option is not supported");
+        return UCS_ERR_UNSUPPORTED;
+#endif
+    }
+
+    if (iface->config.zcopy.msg_thresh != UCS_MEMUNITS_INF) {
+        status = ucs_socket_set_zcopy(fd);
+        if (status != UCS_OK) {
+            return status;
+        }
+    }
+
     return UCS_OK;
 }
 
@@ -323,6 +481,7 @@ static uct_iface_ops_t uct_tcp_iface_ops = {
     .ep_am_bcopy              = uct_tcp_ep_am_bcopy,
     .ep_am_zcopy              = uct_tcp_ep_am_zcopy,
     .ep_put_zcopy             = uct_tcp_ep_put_zcopy,
+    .ep_get_zcopy             = uct_tcp_ep_get_zcopy,
     .ep_pending_add           = uct_tcp_ep_pending_add,
     .ep_pending_purge         = uct_tcp_ep_pending_purge,
     .ep_flush                 = uct_tcp_ep_flush,
@@ -335,7 +494,7 @@ static uct_iface_ops_t uct_tcp_iface_ops = {
     .iface_progress_disable   = uct_base_iface_progress_disable,
     .iface_progress           = uct_tcp_iface_progress,
     .iface_event_fd_get       = uct_tcp_iface_event_fd_get,
-    .iface_event_arm          = ucs_empty_function_return_success,
+    .iface_event_arm          = uct_tcp_iface_event_arm,
     .iface_close              = UCS_CLASS_DELETE_FUNC_NAME(uct_tcp_iface_t),
     .iface_query              = uct_tcp_iface_query,
     .iface_get_address        = uct_tcp_iface_get_address,
@@ -461,14 +620,26 @@ static UCS_CLASS_INIT_FUNC(uct_tcp_iface_t, uct_md_h md, uct_worker_h worker,
 
     self->config.zcopy.max_hdr     = self->config.tx_seg_size -
                                      self->config.zcopy.hdr_offset;
+    self->config.zcopy.msg_thresh  = config->msg_zcopy_thresh;
     self->config.prefer_default    = config->prefer_default;
     self->config.put_enable        = config->put_enable;
+    self->config.get_enable        = config->get_enable;
+    self->config.stripe.conns      = ucs_max(config->stripe_conns, 1);
+    self->config.stripe.thresh     = config->stripe_thresh;
     self->config.conn_nb           = config->conn_nb;
     self->config.max_poll          = config->max_poll;
+    self->config.poll_spin         = ucs_time_from_sec(config->poll_spin);
+    self->config.rx_drain          = config->rx_drain;
+    self->config.tx_coalesce       = config->tx_coalesce;
     self->config.max_conn_retries  = config->max_conn_retries;
     self->sockopt.nodelay          = config->sockopt_nodelay;
     self->sockopt.sndbuf           = config->sockopt_sndbuf;
     self->sockopt.rcvbuf           = config->sockopt_rcvbuf;
+    self->sockopt.busy_poll        = (int)(config->sockopt_busy_poll *
+                                           UCS_USEC_PER_SEC);
+    self->sockopt.prefer_busy_poll = config->sockopt_prefer_busy_poll;
+    self->sockopt.incoming_cpu     = config->sockopt_incoming_cpu;
+    self->last_event_time          = 0;
     ucs_list_head_init(&self->ep_list);
     kh_init_inplace(uct_tcp_cm_eps, &self->ep_cm_map);
 
@@ -478,7 +649,10 @@ static UCS_CLASS_INIT_FUNC(uct_tcp_iface_t, uct_md_h md, uct_worker_h worker,
         return UCS_ERR_INVALID_PARAM;
     }
 
-    status = ucs_mpool_init(&self->tx_mpool, 0, self->config.tx_seg_size,
+    /* TX buffer keeps up to two segments if active messages are coalesced */
+    status = ucs_mpool_init(&self->tx_mpool, 0,
+                            self->config.tx_seg_size *
+                            (self->config.tx_coalesce ? 2 : 1),
                             0, UCS_SYS_CACHE_LINE_SIZE,
                             (config->tx_mpool.bufs_grow == 0) ?
                             32 : config->tx_mpool.bufs_grow,
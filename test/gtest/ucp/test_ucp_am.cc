@@ -123,10 +123,111 @@ protected:
     void do_send_process_data_test(int test_release, uint16_t am_id,
                                    int send_reply);
     void do_send_process_data_iov_test(size_t size);
+    void do_send_user_data_test(size_t size, bool recv_iov,
+                                bool unpack_fail = false);
+    void do_send_interleaved_test(int test_release);
     void set_handlers(uint16_t am_id);
     void set_reply_handlers();
+
+    static ucs_status_t ucp_user_data_am_cb(void *arg, void *data,
+                                            size_t length, ucp_ep_h reply_ep,
+                                            unsigned flags);
+
+    static ucs_status_t ucp_recv_data_cb(void *arg, size_t length,
+                                         ucp_ep_h reply_ep, void **buffer_p,
+                                         size_t *count_p,
+                                         ucp_datatype_t *datatype_p);
+
+    static void *fail_dt_start_unpack(void *context, void *buffer,
+                                      size_t count);
+    static size_t fail_dt_packed_size(void *state);
+    static ucs_status_t fail_dt_unpack(void *state, size_t offset,
+                                       const void *src, size_t length);
+    static void fail_dt_finish(void *state);
+
+    std::vector<char> m_recv_buf;
+    ucp_dt_iov_t      m_recv_iov[2];
+    bool              m_recv_to_iov;
+    int               m_recv_data_calls;
+    ucp_datatype_t    m_recv_fail_dt;  /* Generic datatype failing unpack,
+                                          0 if not used */
+    int               m_recv_finish_calls;
 };
 
+void *test_ucp_am::fail_dt_start_unpack(void *context, void *buffer,
+                                        size_t count)
+{
+    return context;
+}
+
+size_t test_ucp_am::fail_dt_packed_size(void *state)
+{
+    return reinterpret_cast<test_ucp_am*>(state)->m_recv_buf.size();
+}
+
+ucs_status_t test_ucp_am::fail_dt_unpack(void *state, size_t offset,
+                                         const void *src, size_t length)
+{
+    /* fail in the middle of the message */
+    return (offset == 0) ? UCS_OK : UCS_ERR_IO_ERROR;
+}
+
+void test_ucp_am::fail_dt_finish(void *state)
+{
+    reinterpret_cast<test_ucp_am*>(state)->m_recv_finish_calls++;
+}
+
+ucs_status_t test_ucp_am::ucp_recv_data_cb(void *arg, size_t length,
+                                           ucp_ep_h reply_ep, void **buffer_p,
+                                           size_t *count_p,
+                                           ucp_datatype_t *datatype_p)
+{
+    test_ucp_am *self = reinterpret_cast<test_ucp_am*>(arg);
+
+    EXPECT_EQ(self->m_recv_buf.size(), length);
+    self->m_recv_data_calls++;
+
+    if (self->m_recv_fail_dt != 0) {
+        *buffer_p                  = &self->m_recv_buf[0];
+        *count_p                   = length;
+        *datatype_p                = self->m_recv_fail_dt;
+    } else if (self->m_recv_to_iov) {
+        self->m_recv_iov[0].buffer = &self->m_recv_buf[0];
+        self->m_recv_iov[0].length = length / 3;
+        self->m_recv_iov[1].buffer = &self->m_recv_buf[length / 3];
+        self->m_recv_iov[1].length = length - (length / 3);
+        *buffer_p                  = self->m_recv_iov;
+        *count_p                   = 2;
+        *datatype_p                = ucp_dt_make_iov();
+    } else {
+        *buffer_p                  = &self->m_recv_buf[0];
+        *count_p                   = length;
+        *datatype_p                = ucp_dt_make_contig(1);
+    }
+
+    return UCS_OK;
+}
+
+ucs_status_t test_ucp_am::ucp_user_data_am_cb(void *arg, void *data,
+                                              size_t length, ucp_ep_h reply_ep,
+                                              unsigned flags)
+{
+    test_ucp_am *self = reinterpret_cast<test_ucp_am*>(arg);
+
+    EXPECT_EQ(self->m_recv_buf.size(), length);
+    EXPECT_FALSE(flags & UCP_CB_PARAM_FLAG_DATA);
+    EXPECT_EQ(self->m_recv_fail_dt != 0,
+              !!(flags & UCP_CB_PARAM_FLAG_ERROR));
+    if (self->m_recv_to_iov) {
+        EXPECT_EQ((void*)self->m_recv_iov, data);
+    } else {
+        EXPECT_EQ((void*)&self->m_recv_buf[0], data);
+    }
+
+    self->recv_ams++;
+    return UCS_OK;
+}
+
 void test_ucp_am::set_reply_handlers()
 {
     ucp_worker_set_am_handler(sender().worker(), UCP_REPLY_ID,
@@ -244,6 +345,109 @@ void test_ucp_am::do_send_process_data_iov_test(size_t size)
     }
 }
 
+void test_ucp_am::do_send_user_data_test(size_t size, bool recv_iov,
+                                         bool unpack_fail)
+{
+    static ucp_generic_dt_ops_t fail_dt_ops = {
+        NULL,
+        fail_dt_start_unpack,
+        fail_dt_packed_size,
+        NULL,
+        fail_dt_unpack,
+        fail_dt_finish
+    };
+    std::vector<char> sendbuf(size);
+    ucs_status_ptr_t sstatus;
+    ucs_status_t status;
+
+    ucs::fill_random(sendbuf);
+    m_recv_buf.assign(size, 0);
+    m_recv_to_iov       = recv_iov;
+    m_recv_data_calls   = 0;
+    m_recv_finish_calls = 0;
+    m_recv_fail_dt      = 0;
+    recv_ams            = 0;
+
+    if (unpack_fail) {
+        status = ucp_dt_create_generic(&fail_dt_ops, this, &m_recv_fail_dt);
+        ASSERT_UCS_OK(status);
+    }
+
+    for (int i = 0; i < 2; ++i) {
+        ucp_worker_h worker = i ? receiver().worker() : sender().worker();
+
+        status = ucp_worker_set_am_handler(worker, UCP_SEND_ID,
+                                           ucp_user_data_am_cb, this,
+                                           UCP_AM_FLAG_WHOLE_MSG);
+        ASSERT_UCS_OK(status);
+        status = ucp_worker_set_am_recv_data_handler(worker, UCP_SEND_ID,
+                                                     ucp_recv_data_cb);
+        ASSERT_UCS_OK(status);
+    }
+
+    sstatus = ucp_am_send_nb(receiver().ep(), UCP_SEND_ID, sendbuf.data(),
+                             size, ucp_dt_make_contig(1),
+                             (ucp_send_callback_t) ucs_empty_function, 0);
+    EXPECT_FALSE(UCS_PTR_IS_ERR(sstatus));
+    wait(sstatus);
+
+    while (recv_ams == 0) {
+        progress();
+    }
+
+    EXPECT_EQ(1, m_recv_data_calls);
+    if (unpack_fail) {
+        /* the datatype state is finished once, when the unpack fails */
+        EXPECT_EQ(1, m_recv_finish_calls);
+        ucp_dt_destroy(m_recv_fail_dt);
+        m_recv_fail_dt = 0;
+    } else {
+        EXPECT_EQ(sendbuf, m_recv_buf);
+    }
+}
+
+void test_ucp_am::do_send_interleaved_test(int test_release)
+{
+    /* Sizes span several reassembly size classes and the malloc fallback */
+    const size_t sizes[] = { 20 * UCS_KBYTE, 100 * UCS_KBYTE + 7,
+                             UCS_MBYTE, 2 * UCS_MBYTE + 1 };
+    const size_t num_sizes = sizeof(sizes) / sizeof(sizes[0]);
+    std::vector<std::vector<char> > sendbufs;
+    std::vector<void*> sstatuses;
+
+    recv_ams      = 0;
+    this->release = test_release;
+    set_handlers(UCP_SEND_ID);
+
+    /* Post all sends before progressing, so fragments of different messages
+     * are reassembled at the same time */
+    for (size_t i = 0; i < 2 * num_sizes; ++i) {
+        size_t size = sizes[i % num_sizes];
+
+        sendbufs.push_back(std::vector<char>(size, (char)size));
+        sstatuses.push_back(ucp_am_send_nb(receiver().ep(), UCP_SEND_ID,
+                                           sendbufs.back().data(), size,
+                                           ucp_dt_make_contig(1),
+                                           (ucp_send_callback_t)
+                                           ucs_empty_function, 0));
+        EXPECT_FALSE(UCS_PTR_IS_ERR(sstatuses.back()));
+    }
+
+    for (size_t i = 0; i < sstatuses.size(); ++i) {
+        wait(sstatuses[i]);
+    }
+
+    while (recv_ams < (int)sstatuses.size()) {
+        progress();
+    }
+
+    if (test_release) {
+        for (int i = 0; i < recv_ams; i++) {
+            ucp_am_data_release(receiver().worker(), for_release[i]);
+        }
+    }
+}
+
 void test_ucp_am::do_set_am_handler_realloc_test()
 {
     set_handlers(UCP_SEND_ID);
@@ -292,4 +496,114 @@ UCS_TEST_P(test_ucp_am, set_am_handler_realloc)
     do_set_am_handler_realloc_test();
 }
 
+UCS_TEST_P(test_ucp_am, send_user_data, "AM_RNDV_THRESH=inf")
+{
+    do_send_user_data_test(200 * UCS_KBYTE + 1, false);
+    do_send_user_data_test(UCS_MBYTE, true);
+}
+
+UCS_TEST_P(test_ucp_am, send_interleaved, "AM_RNDV_THRESH=inf")
+{
+    do_send_interleaved_test(0);
+    do_send_interleaved_test(UCP_RELEASE);
+}
+
+UCS_TEST_P(test_ucp_am, send_user_data_unpack_fail, "AM_RNDV_THRESH=inf")
+{
+    scoped_log_handler wrap_err(wrap_errors_logger);
+
+    do_send_user_data_test(200 * UCS_KBYTE + 1, false, true);
+}
+
+UCS_TEST_P(test_ucp_am, set_recv_data_handler_no_am_handler)
+{
+    EXPECT_EQ(UCS_ERR_INVALID_PARAM,
+              ucp_worker_set_am_recv_data_handler(receiver().worker(),
+                                                  UCP_REALLOC_ID,
+                                                  ucp_recv_data_cb));
+}
+
 UCP_INSTANTIATE_TEST_CASE(test_ucp_am)
+
+
+class test_ucp_am_rndv : public test_ucp_am {
+public:
+    virtual void init() {
+        modify_config("AM_RNDV_THRESH", "1024");
+        test_ucp_am::init();
+    }
+
+protected:
+    void do_send_large_test(size_t size);
+};
+
+void test_ucp_am_rndv::do_send_large_test(size_t size)
+{
+    std::vector<char> sendbuf(size, (char)size);
+    ucs_status_ptr_t sstatus;
+
+    recv_ams = 0;
+    release  = 0;
+
+    set_handlers(UCP_SEND_ID);
+
+    sstatus = ucp_am_send_nb(receiver().ep(), UCP_SEND_ID, sendbuf.data(),
+                             size, ucp_dt_make_contig(1),
+                             (ucp_send_callback_t) ucs_empty_function, 0);
+    EXPECT_FALSE(UCS_PTR_IS_ERR(sstatus));
+    wait(sstatus);
+
+    while (recv_ams == 0) {
+        progress();
+    }
+}
+
+UCS_TEST_P(test_ucp_am_rndv, send_process_am)
+{
+    set_handlers(UCP_SEND_ID);
+    do_send_process_data_test(0, UCP_SEND_ID, 0);
+
+    set_reply_handlers();
+    do_send_process_data_test(0, UCP_SEND_ID, UCP_AM_SEND_REPLY);
+}
+
+UCS_TEST_P(test_ucp_am_rndv, send_process_am_release)
+{
+    set_handlers(UCP_SEND_ID);
+    do_send_process_data_test(UCP_RELEASE, 0, 0);
+}
+
+UCS_TEST_P(test_ucp_am_rndv, send_process_iov_am)
+{
+    for (size_t size = 1; size <= UCS_MBYTE; size *= 4) {
+        do_send_process_data_iov_test(size);
+    }
+}
+
+UCS_TEST_P(test_ucp_am_rndv, send_large)
+{
+    do_send_large_test(4 * UCS_MBYTE + 3);
+}
+
+UCS_TEST_P(test_ucp_am_rndv, send_user_data)
+{
+    do_send_user_data_test(200 * UCS_KBYTE + 1, false);
+    do_send_user_data_test(UCS_MBYTE, true);
+}
+
+UCS_TEST_P(test_ucp_am_rndv, send_no_handler)
+{
+    std::vector<char> sendbuf(64 * UCS_KBYTE, 0);
+    ucs_status_ptr_t sstatus;
+
+    /* No handler is set for this id, the message should be dropped on the
+     * receiver, and the send operation should complete anyway */
+    scoped_log_handler wrap_warn(hide_warns_logger);
+    sstatus = ucp_am_send_nb(receiver().ep(), UCP_REALLOC_ID, sendbuf.data(),
+                             sendbuf.size(), ucp_dt_make_contig(1),
+                             (ucp_send_callback_t) ucs_empty_function, 0);
+    EXPECT_FALSE(UCS_PTR_IS_ERR(sstatus));
+    wait(sstatus);
+}
+
+UCP_INSTANTIATE_TEST_CASE(test_ucp_am_rndv)
@@ -12,6 +12,8 @@
 #include "ucp_datatype.h"
 #include "ucp_test.h"
 
+#include <ucp/core/ucp_ep.inl>
+
 
 class test_ucp_stream_base : public ucp_test {
 public:
@@ -180,6 +182,7 @@ protected:
     template <typename T, unsigned recv_flags>
     void do_send_exp_recv_test(ucp_datatype_t datatype);
     void do_send_recv_data_recv_test(ucp_datatype_t datatype);
+    void do_send_recv_rndv_test(bool is_exp, unsigned recv_flags);
 
     /* for self-validation of generic datatype
      * NOTE: it's tested only with byte array data since it's recv completion
@@ -449,6 +452,76 @@ void test_ucp_stream::do_send_recv_data_recv_test(ucp_datatype_t datatype)
     EXPECT_EQ(check_pattern, rbuf);
 }
 
+/* Sends large messages with rendezvous protocol between small eager ones,
+ * without waiting for the send completion, and checks the stream order */
+void test_ucp_stream::do_send_recv_rndv_test(bool is_exp, unsigned recv_flags)
+{
+    const size_t      sizes[] = { 10, 256 * UCS_KBYTE, 100, 64 * UCS_KBYTE,
+                                  UCS_KBYTE, 300 * UCS_KBYTE, 7 };
+    const size_t      num_sizes = sizeof(sizes) / sizeof(sizes[0]);
+    std::vector<std::vector<char> > sbufs(num_sizes);
+    std::vector<char> check_pattern;
+    std::vector<void*> sreqs;
+    size_t            ssize   = 0;
+    size_t            roffset = 0;
+    void              *rreq   = NULL;
+    size_t            length;
+
+    if (ucp_ep_config(sender().ep())->stream.rndv_thresh == SIZE_MAX) {
+        UCS_TEST_SKIP_R("stream rendezvous is not supported");
+    }
+
+    for (size_t i = 0; i < num_sizes; ++i) {
+        ssize += sizes[i];
+    }
+
+    std::vector<char> rbuf(ssize, 'r');
+
+    if (is_exp) {
+        /* the receive is posted with enough room for all the data */
+        rreq = ucp_stream_recv_nb(receiver().ep(), &rbuf[0], ssize, DATATYPE,
+                                  ucp_recv_cb, &length, recv_flags);
+        ASSERT_TRUE(UCS_PTR_IS_PTR(rreq));
+    }
+
+    for (size_t i = 0; i < num_sizes; ++i) {
+        sbufs[i].resize(sizes[i]);
+        ucs::fill_random(sbufs[i]);
+        check_pattern.insert(check_pattern.end(), sbufs[i].begin(),
+                             sbufs[i].end());
+
+        void *sreq = ucp_stream_send_nb(sender().ep(), &sbufs[i][0], sizes[i],
+                                        DATATYPE, ucp_send_cb, 0);
+        ASSERT_FALSE(UCS_PTR_IS_ERR(sreq));
+        sreqs.push_back(sreq);
+    }
+
+    if (is_exp) {
+        roffset = wait_stream_recv(rreq);
+    }
+
+    while (roffset < ssize) {
+        void *rdata;
+
+        progress();
+        rdata = ucp_stream_recv_data_nb(receiver().ep(), &length);
+        ASSERT_FALSE(UCS_PTR_IS_ERR(rdata));
+        if (rdata != NULL) {
+            ASSERT_LE(roffset + length, ssize);
+            memcpy(&rbuf[roffset], rdata, length);
+            roffset += length;
+            ucp_stream_data_release(receiver().ep(), rdata);
+        }
+    }
+
+    for (size_t i = 0; i < sreqs.size(); ++i) {
+        wait(sreqs[i]);
+    }
+
+    EXPECT_EQ(ssize, roffset);
+    EXPECT_EQ(check_pattern, rbuf);
+}
+
 UCS_TEST_P(test_ucp_stream, send_recv_data) {
     do_send_recv_data_test(DATATYPE);
 }
@@ -609,6 +682,24 @@ UCS_TEST_P(test_ucp_stream, send_zero_ending_iov_recv_data) {
     }
 }
 
+UCS_TEST_P(test_ucp_stream, send_recv_data_rndv, "STREAM_RNDV_THRESH=8k") {
+    do_send_recv_rndv_test(false, 0);
+}
+
+UCS_TEST_P(test_ucp_stream, send_exp_recv_rndv, "STREAM_RNDV_THRESH=8k") {
+    do_send_recv_rndv_test(true, 0);
+}
+
+UCS_TEST_P(test_ucp_stream, send_exp_recv_rndv_waitall,
+           "STREAM_RNDV_THRESH=8k") {
+    do_send_recv_rndv_test(true, UCP_STREAM_RECV_FLAG_WAITALL);
+}
+
+UCS_TEST_P(test_ucp_stream, rndv_disabled_by_default) {
+    /* stream sends are eager unless STREAM_RNDV_THRESH is set */
+    EXPECT_EQ(SIZE_MAX, ucp_ep_config(sender().ep())->stream.rndv_thresh);
+}
+
 UCP_INSTANTIATE_TEST_CASE(test_ucp_stream)
 
 class test_ucp_stream_many2one : public test_ucp_stream_base {
@@ -635,6 +726,7 @@ public:
     static void ucp_recv_cb(void *request, ucs_status_t status, size_t length) {}
 
     void do_send_worker_poll_test(ucp_datatype_t dt);
+    void do_send_worker_poll_data_test(ucp_datatype_t dt);
     void do_send_recv_test(ucp_datatype_t dt);
 
 protected:
@@ -722,6 +814,48 @@ void test_ucp_stream_many2one::do_send_worker_poll_test(ucp_datatype_t dt)
     check_recv_data(niter, dt);
 }
 
+void test_ucp_stream_many2one::do_send_worker_poll_data_test(ucp_datatype_t dt)
+{
+    const size_t                   niter = 2018;
+    std::vector<request_wrapper_t> sreqs;
+    size_t                         total_len;
+
+    total_len = send_all_nb(dt, niter, sreqs);
+
+    /* Recv and progress all data */
+    do {
+        ssize_t count;
+        do {
+            const size_t           max_data = 16;
+            ucp_stream_poll_data_t poll_data[max_data];
+            progress();
+            count = ucp_stream_worker_poll_data(e(m_receiver_idx).worker(),
+                                                poll_data, max_data, 0);
+            EXPECT_LE(0, count);
+            EXPECT_GE(ssize_t(max_data), count);
+
+            for (ssize_t i = 0; i < count; ++i) {
+                const char *rdata = (const char*)poll_data[i].data;
+                size_t sender_idx = uintptr_t(poll_data[i].user_data);
+
+                ASSERT_LT(sender_idx, m_nsenders);
+                EXPECT_EQ(e(m_receiver_idx).ep(0, sender_idx), poll_data[i].ep);
+                std::vector<char> &dst = m_recv_data[sender_idx];
+                dst.insert(dst.end(), rdata, rdata + poll_data[i].length);
+                total_len -= poll_data[i].length;
+            }
+
+            ucp_stream_data_release_bulk(e(m_receiver_idx).worker(), poll_data,
+                                         count);
+        } while (count > 0);
+
+        erase_completed_reqs(sreqs);
+    } while (!sreqs.empty() || (total_len != 0));
+
+    check_no_data();
+    check_recv_data(niter, dt);
+}
+
 void test_ucp_stream_many2one::do_send_recv_test(ucp_datatype_t dt)
 {
     const size_t                                       niter = 2018;
@@ -1022,6 +1156,14 @@ UCS_TEST_P(test_ucp_stream_many2one, send_worker_poll_generic) {
     ucp_dt_destroy(dt);
 }
 
+UCS_TEST_P(test_ucp_stream_many2one, send_worker_poll_data) {
+    do_send_worker_poll_data_test(DATATYPE);
+}
+
+UCS_TEST_P(test_ucp_stream_many2one, send_worker_poll_data_iov) {
+    do_send_worker_poll_data_test(DATATYPE_IOV);
+}
+
 UCS_TEST_P(test_ucp_stream_many2one, send_recv_nb) {
     do_send_recv_test(DATATYPE);
 }
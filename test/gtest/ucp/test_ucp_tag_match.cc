@@ -11,6 +11,7 @@
 extern "C" {
 #include <ucp/core/ucp_request.h>
 #include <ucp/core/ucp_types.h>
+#include <ucp/core/ucp_worker.h>
 }
 
 using namespace ucs; /* For vector<char> serialization */
@@ -450,6 +451,107 @@ UCS_TEST_P(test_ucp_tag_match, sync_send_unexp) {
     request_release(my_send_req);
 }
 
+UCS_TEST_P(test_ucp_tag_match, unexp_wild_index_lazy) {
+    static const ucp_tag_t wild_mask = 0xffffffff00000000UL;
+    static const unsigned  count     = 16;
+    ucp_tag_match_shard_t *shard     = receiver().worker()->tm.shards;
+    ucp_tag_recv_info_t info;
+    uint64_t send_data, recv_data;
+    ucs_status_t status;
+
+    /* Unexpected messages alternate between two keys of the wild index */
+    for (unsigned i = 0; i < count; ++i) {
+        send_data = i;
+        send_b(&send_data, sizeof(send_data), DATATYPE,
+               ((ucp_tag_t)(i % 2) << 32) | i);
+    }
+    short_progress_loop();
+
+    /* Full-mask receives do not build the wild index */
+    status = recv_b(&recv_data, sizeof(recv_data), DATATYPE, 0, (ucp_tag_t)-1,
+                    &info);
+    ASSERT_UCS_OK(status);
+    EXPECT_EQ(0u, recv_data);
+    EXPECT_FALSE(shard->unexpected.wild_indexed);
+
+    /* The first wildcard receive builds it, keeping the arrival order */
+    for (unsigned i = 1; i < count; i += 2) {
+        status = recv_b(&recv_data, sizeof(recv_data), DATATYPE,
+                        (ucp_tag_t)1 << 32, wild_mask, &info);
+        ASSERT_UCS_OK(status);
+        EXPECT_EQ(i, recv_data);
+        EXPECT_TRUE(shard->unexpected.wild_indexed);
+    }
+
+    /* Messages which arrive after the build are indexed as well */
+    send_data = count;
+    send_b(&send_data, sizeof(send_data), DATATYPE,
+           ((ucp_tag_t)1 << 32) | count);
+    short_progress_loop();
+
+    for (unsigned i = 2; i < count; i += 2) {
+        status = recv_b(&recv_data, sizeof(recv_data), DATATYPE, 0, wild_mask,
+                        &info);
+        ASSERT_UCS_OK(status);
+        EXPECT_EQ(i, recv_data);
+    }
+
+    status = recv_b(&recv_data, sizeof(recv_data), DATATYPE,
+                    (ucp_tag_t)1 << 32, wild_mask, &info);
+    ASSERT_UCS_OK(status);
+    EXPECT_EQ(count, recv_data);
+    EXPECT_TRUE(ucp_tag_unexp_is_empty(&receiver().worker()->tm));
+}
+
+UCS_TEST_P(test_ucp_tag_match, release_idle_memory) {
+    const unsigned count = 1000;
+    ucp_worker_h worker  = receiver().worker();
+    std::vector<uint64_t> recv_data(count, 0);
+    std::vector<request*> reqs;
+    uint64_t send_data;
+
+    for (unsigned i = 0; i < count; ++i) {
+        /* use the worker requests pool regardless of the test variant */
+        request *my_recv_req = (request*)ucp_tag_recv_nb(worker, &recv_data[i],
+                                                         sizeof(recv_data[i]),
+                                                         DATATYPE, i,
+                                                         (ucp_tag_t)-1,
+                                                         recv_callback);
+        ASSERT_TRUE(!UCS_PTR_IS_ERR(my_recv_req));
+        ASSERT_TRUE(my_recv_req != NULL);
+        reqs.push_back(my_recv_req);
+    }
+
+    unsigned peak_chunks = worker->req_mp.data->num_chunks;
+
+    for (unsigned i = 0; i < count; ++i) {
+        send_data = i;
+        send_b(&send_data, sizeof(send_data), DATATYPE, i);
+    }
+
+    for (unsigned i = 0; i < count; ++i) {
+        wait(reqs[i]);
+        EXPECT_EQ(i, recv_data[i]);
+        request_release(reqs[i]);
+    }
+
+    /* the requests pool has grown during the burst and shrinks back */
+    ucp_worker_release_idle_memory(worker);
+    EXPECT_LT(worker->req_mp.data->num_chunks, peak_chunks);
+    EXPECT_GE(worker->req_mp.data->peak_elems, count);
+
+    /* the worker is usable after releasing the memory */
+    send_data = 0x0102030405060708;
+    recv_data[0] = 0;
+    request *my_recv_req = recv_nb(&recv_data[0], sizeof(recv_data[0]),
+                                   DATATYPE, 0x1337, 0xffff);
+    ASSERT_TRUE(!UCS_PTR_IS_ERR(my_recv_req));
+    send_b(&send_data, sizeof(send_data), DATATYPE, 0x1337);
+    wait(my_recv_req);
+    EXPECT_EQ(send_data, recv_data[0]);
+    request_release(my_recv_req);
+}
+
 UCP_INSTANTIATE_TEST_CASE(test_ucp_tag_match)
 
 class test_ucp_tag_match_rndv : public test_ucp_tag_match {
@@ -88,3 +88,80 @@ UCS_TEST_P(test_ucp_tag_mt, send_recv) {
 }
 
 UCP_INSTANTIATE_TEST_CASE(test_ucp_tag_mt)
+
+
+class test_ucp_tag_mt_shards : public test_ucp_tag_mt {
+protected:
+    static const ucp_tag_t SHARD_MASK = 0xff;
+
+    virtual ucp_worker_params_t get_worker_params() {
+        ucp_worker_params_t params = test_ucp_tag_mt::get_worker_params();
+        params.field_mask    |= UCP_WORKER_PARAM_FIELD_TAG_SHARD_MASK;
+        params.tag_shard_mask = SHARD_MASK;
+        return params;
+    }
+};
+
+UCS_TEST_P(test_ucp_tag_mt_shards, send_recv_exp_unexp) {
+#if _OPENMP && ENABLE_MT
+#pragma omp parallel for
+    for (int i = 0; i < MT_TEST_NUM_THREADS; i++) {
+        int worker_index = 0;
+
+        if (GetParam().thread_type == MULTI_THREAD_CONTEXT) {
+            worker_index = i;
+        }
+
+        for (int j = 0; j < 20; ++j) {
+            /* Every thread receives from its own shard */
+            ucp_tag_t tag      = (ucp_tag_t)j << 8 | i;
+            uint64_t send_data = 0xdeadbeefdeadbeef + j;
+            uint64_t recv_data = 0;
+            ucp_tag_recv_info_t info;
+            ucs_status_t status;
+            request *rreq;
+
+            if (j % 2) {
+                /* Expected */
+                rreq = recv_nb(&recv_data, sizeof(recv_data), DATATYPE, tag,
+                               0xffff, i);
+                send_b(&send_data, sizeof(send_data), DATATYPE, tag, i);
+                wait(rreq, i);
+                status = rreq->status;
+                info   = rreq->info;
+                request_release(rreq);
+            } else {
+                /* Unexpected */
+                send_b(&send_data, sizeof(send_data), DATATYPE, tag, i);
+                short_progress_loop(worker_index);
+                status = recv_b(&recv_data, sizeof(recv_data), DATATYPE, tag,
+                                0xffff, &info, i);
+            }
+
+            ASSERT_UCS_OK(status);
+            EXPECT_EQ(sizeof(send_data), info.length);
+            EXPECT_EQ(tag,               info.sender_tag);
+            EXPECT_EQ(send_data,         recv_data);
+        }
+    }
+#endif
+}
+
+UCS_TEST_P(test_ucp_tag_mt_shards, mask_not_in_shard) {
+    uint64_t recv_data;
+    ucp_tag_recv_info_t info;
+    ucs_status_ptr_t rreq;
+
+    scoped_log_handler slh(hide_errors_logger);
+
+    /* A receive which may match tags from different shards is not allowed */
+    rreq = ucp_tag_recv_nb(receiver().worker(), &recv_data, sizeof(recv_data),
+                           DATATYPE, 0x1300, 0xff00, recv_callback);
+    ASSERT_TRUE(UCS_PTR_IS_ERR(rreq));
+    EXPECT_EQ(UCS_ERR_INVALID_PARAM, UCS_PTR_STATUS(rreq));
+
+    EXPECT_TRUE(ucp_tag_probe_nb(receiver().worker(), 0x1300, 0xff00, 0,
+                                 &info) == NULL);
+}
+
+UCP_INSTANTIATE_TEST_CASE(test_ucp_tag_mt_shards)
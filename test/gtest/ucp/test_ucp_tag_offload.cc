@@ -101,14 +101,14 @@ UCS_TEST_P(test_ucp_tag_offload, post_after_cancel)
     request *req = recv_nb_and_check(&small_val, sizeof(small_val), DATATYPE,
                                      tag, UCP_TAG_MASK_FULL);
 
-    EXPECT_EQ(1u, receiver().worker()->tm.expected.sw_all_count);
+    EXPECT_EQ(1u, receiver().worker()->tm.shards->expected.sw_all_count);
     req_cancel(receiver(), req);
-    EXPECT_EQ(0u, receiver().worker()->tm.expected.sw_all_count);
+    EXPECT_EQ(0u, receiver().worker()->tm.shards->expected.sw_all_count);
 
     req = recv_nb_and_check(&recvbuf, recvbuf.size(), DATATYPE, tag,
                             UCP_TAG_MASK_FULL);
 
-    EXPECT_EQ(0u, receiver().worker()->tm.expected.sw_all_count);
+    EXPECT_EQ(0u, receiver().worker()->tm.shards->expected.sw_all_count);
     req_cancel(receiver(), req);
 }
 
@@ -123,17 +123,17 @@ UCS_TEST_P(test_ucp_tag_offload, post_after_comp)
     request *req = recv_nb_and_check(&small_val, sizeof(small_val), DATATYPE,
                                      tag, UCP_TAG_MASK_FULL);
 
-    EXPECT_EQ(1u, receiver().worker()->tm.expected.sw_all_count);
+    EXPECT_EQ(1u, receiver().worker()->tm.shards->expected.sw_all_count);
 
     send_b(&small_val, sizeof(small_val), DATATYPE, tag);
     wait(req);
     request_free(req);
-    EXPECT_EQ(0u, receiver().worker()->tm.expected.sw_all_count);
+    EXPECT_EQ(0u, receiver().worker()->tm.shards->expected.sw_all_count);
 
     req = recv_nb_and_check(&recvbuf, recvbuf.size(), DATATYPE, tag,
                             UCP_TAG_MASK_FULL);
 
-    EXPECT_EQ(0u, receiver().worker()->tm.expected.sw_all_count);
+    EXPECT_EQ(0u, receiver().worker()->tm.shards->expected.sw_all_count);
     req_cancel(receiver(), req);
 }
 
@@ -148,14 +148,14 @@ UCS_TEST_P(test_ucp_tag_offload, post_wild)
 
     request *req1 = recv_nb_and_check(&small_val, sizeof(small_val), DATATYPE,
                                       tag1, 0);
-    EXPECT_EQ(1u, receiver().worker()->tm.expected.sw_all_count);
+    EXPECT_EQ(1u, receiver().worker()->tm.shards->expected.sw_all_count);
 
     request *req2 = recv_nb_and_check(&recvbuf, recvbuf.size(), DATATYPE, tag2,
                                       UCP_TAG_MASK_FULL);
     // Second request should not be posted as well. Even though it has another
     // tag, the first request is a wildcard, which needs to be handled in SW,
     // so it blocks all other requests
-    EXPECT_EQ(2u, receiver().worker()->tm.expected.sw_all_count);
+    EXPECT_EQ(2u, receiver().worker()->tm.shards->expected.sw_all_count);
     req_cancel(receiver(), req1);
     req_cancel(receiver(), req2);
 }
@@ -182,14 +182,14 @@ UCS_TEST_P(test_ucp_tag_offload, post_dif_buckets)
 
     // The first request was not offloaded due to small size and the second
     // is blocked by the first one.
-    EXPECT_EQ(2u, receiver().worker()->tm.expected.sw_all_count);
+    EXPECT_EQ(2u, receiver().worker()->tm.shards->expected.sw_all_count);
 
     req = recv_nb_and_check(&recvbuf, recvbuf.size(), DATATYPE, tag2,
                             UCP_TAG_MASK_FULL);
     reqs.push_back(req);
 
     // Check that another request with different tag is offloaded.
-    EXPECT_EQ(2u, receiver().worker()->tm.expected.sw_all_count);
+    EXPECT_EQ(2u, receiver().worker()->tm.shards->expected.sw_all_count);
 
     for (std::vector<request*>::const_iterator iter = reqs.begin();
          iter != reqs.end(); ++iter) {
@@ -217,7 +217,8 @@ UCS_TEST_P(test_ucp_tag_offload, force_thresh_basic, "TM_FORCE_THRESH=4k",
 
     // No requests should be posted to the transport, because their sizes less
     // than TM_THRESH
-    EXPECT_EQ((unsigned)(num_reqs - 1), receiver().worker()->tm.expected.sw_all_count);
+    EXPECT_EQ((unsigned)(num_reqs - 1),
+              receiver().worker()->tm.shards->expected.sw_all_count);
 
     std::vector<char> recvbuf_big(big_size, 0);
 
@@ -227,7 +228,7 @@ UCS_TEST_P(test_ucp_tag_offload, force_thresh_basic, "TM_FORCE_THRESH=4k",
 
     // Now, all requests should be posted to the transport, because receive
     // buffer bigger than FORCE_THRESH has been posted
-    EXPECT_EQ((unsigned)0, receiver().worker()->tm.expected.sw_all_count);
+    EXPECT_EQ((unsigned)0, receiver().worker()->tm.shards->expected.sw_all_count);
 
     std::vector<request*>::const_iterator iter;
     for (iter = reqs.begin(); iter != reqs.end(); ++iter) {
@@ -271,7 +272,8 @@ UCS_TEST_P(test_ucp_tag_offload, force_thresh_blocked, "TM_FORCE_THRESH=4k",
     for (i = 0; i < 2; ++i) {
         req = recv_nb_and_check(&recvbuf_big[0], recvbuf_big.size(), DATATYPE, tag,
                                 UCP_TAG_MASK_FULL);
-        EXPECT_EQ((unsigned)(num_reqs - i), receiver().worker()->tm.expected.sw_all_count);
+        EXPECT_EQ((unsigned)(num_reqs - i),
+                  receiver().worker()->tm.shards->expected.sw_all_count);
         req_cancel(receiver(), req);
 
         req_cancel(receiver(), reqs.back());
@@ -284,7 +286,7 @@ UCS_TEST_P(test_ucp_tag_offload, force_thresh_blocked, "TM_FORCE_THRESH=4k",
 
     // Now, all requests should be posted to the transport, because receive
     // buffer bigger than FORCE_THRESH has been posted
-    EXPECT_EQ((unsigned)0, receiver().worker()->tm.expected.sw_all_count);
+    EXPECT_EQ((unsigned)0, receiver().worker()->tm.shards->expected.sw_all_count);
 
     std::vector<request*>::const_iterator iter;
     for (iter = reqs.begin(); iter != reqs.end(); ++iter) {
@@ -402,7 +404,8 @@ public:
         request *req = recv_nb_and_check(&recvbuf, recvbuf.size(), DATATYPE,
                                          make_tag(e, tag), UCP_TAG_MASK_FULL);
 
-        EXPECT_EQ(sw_count, receiver().worker()->tm.expected.sw_all_count);
+        EXPECT_EQ(sw_count,
+                  receiver().worker()->tm.shards->expected.sw_all_count);
         req_cancel(receiver(), req);
     }
 
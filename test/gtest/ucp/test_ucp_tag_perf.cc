@@ -17,15 +17,47 @@ public:
     }
 
 protected:
-    static const size_t    COUNT    = 8192;
-    static const ucp_tag_t TAG_MASK = 0xffffffffffffffffUL;
-
-    double check_perf(size_t count, bool is_exp);
-    void check_scalability(double max_growth, bool is_exp);
-    void do_sends(size_t count);
+    static const size_t    COUNT       = 8192;
+    static const size_t    COUNT_LARGE = 256 * 1024; /* Much more than the
+                                                        initial hash size */
+    static const ucp_tag_t TAG_MASK    = 0xffffffffffffffffUL;
+    static const ucp_tag_t WILD_MASK   = 0xffffffff00000000UL; /* Any sender
+                                                                 in low bits */
+
+    double check_perf(size_t count, bool is_exp, ucp_tag_t tag_mask);
+    void check_scalability(double max_growth, bool is_exp,
+                           size_t max_count = COUNT,
+                           ucp_tag_t tag_mask = TAG_MASK);
+    void do_sends(size_t count, ucp_tag_t tag_mask);
+    static ucp_tag_t make_tag(size_t index, ucp_tag_t tag_mask);
+    static size_t large_count();
+
+    /* Extra growth allowed for large queues, which are more sensitive to cache
+     * misses and timer noise */
+    static double growth_tolerance() {
+        return 0.2;
+    }
 };
 
-double test_ucp_tag_perf::check_perf(size_t count, bool is_exp)
+size_t test_ucp_tag_perf::large_count()
+{
+    /* Slow environments get proportionally shorter queues, but still longer
+     * than the regular test */
+    return ucs_max(2 * COUNT, COUNT_LARGE / ucs::test_time_multiplier());
+}
+
+ucp_tag_t test_ucp_tag_perf::make_tag(size_t index, ucp_tag_t tag_mask)
+{
+    if (tag_mask == TAG_MASK) {
+        return index;
+    }
+
+    /* Put the index in the masked-in bits, and a "sender" in the rest */
+    return (index << 32) | (~tag_mask & 0xbeef);
+}
+
+double test_ucp_tag_perf::check_perf(size_t count, bool is_exp,
+                                     ucp_tag_t tag_mask)
 {
     ucs_time_t start_time;
 
@@ -33,14 +65,15 @@ double test_ucp_tag_perf::check_perf(size_t count, bool is_exp)
         std::vector<request*> rreqs;
 
         for (size_t i = 0; i < count; ++i) {
-            request *rreq = recv_nb(NULL, 0, DATATYPE, i, TAG_MASK);
+            request *rreq = recv_nb(NULL, 0, DATATYPE,
+                                    make_tag(i, tag_mask), tag_mask);
             assert(!UCS_PTR_IS_ERR(rreq));
             EXPECT_FALSE(rreq->completed);
             rreqs.push_back(rreq);
         }
 
         start_time = ucs_get_time();
-        do_sends(count);
+        do_sends(count, tag_mask);
         while (!rreqs.empty()) {
             request *rreq = rreqs.back();
             rreqs.pop_back();
@@ -50,28 +83,29 @@ double test_ucp_tag_perf::check_perf(size_t count, bool is_exp)
         ucp_tag_recv_info_t info;
 
         send_b(NULL, 0, DATATYPE, 0xdeadbeef);
-        do_sends(count);
+        do_sends(count, tag_mask);
         recv_b(NULL, 0, DATATYPE, 0xdeadbeef, TAG_MASK, &info);
 
         start_time = ucs_get_time();
         for (size_t i = 0; i < count; ++i) {
-            recv_b(NULL, 0, DATATYPE, i, TAG_MASK, &info);
+            recv_b(NULL, 0, DATATYPE, make_tag(i, tag_mask), tag_mask, &info);
         }
     }
 
     return ucs_time_to_sec(ucs_get_time() - start_time) / count;
 }
 
-void test_ucp_tag_perf::do_sends(size_t count)
+void test_ucp_tag_perf::do_sends(size_t count, ucp_tag_t tag_mask)
 {
     size_t i = count;
     while (i > 0) {
         --i;
-        send_b(NULL, 0, DATATYPE, i);
+        send_b(NULL, 0, DATATYPE, make_tag(i, tag_mask));
     }
 }
 
-void test_ucp_tag_perf::check_scalability(double max_growth, bool is_exp)
+void test_ucp_tag_perf::check_scalability(double max_growth, bool is_exp,
+                                          size_t max_count, ucp_tag_t tag_mask)
 {
     double prev_time = 0.0, total_growth = 0.0, avg_growth;
     size_t n = 0;
@@ -82,11 +116,11 @@ void test_ucp_tag_perf::check_scalability(double max_growth, bool is_exp)
          * length grows by 2x. A result close to 1.0 means O(1) scalability (which
          * is good), while a result of 2.0 or higher means O(n) or higher.
          */
-        for (size_t count = 1; count <= COUNT; count *= 2) {
-            size_t iters = 10 * ucs_max(1ul, COUNT / count);
+        for (size_t count = 1; count <= max_count; count *= 2) {
+            size_t iters = ucs_max(1ul, (10 * COUNT) / count);
             double total_time = 0;
             for (size_t i = 0; i < iters; ++i) {
-                total_time += check_perf(count, is_exp);
+                total_time += check_perf(count, is_exp, tag_mask);
             }
 
             double time = total_time / iters;
@@ -122,4 +156,16 @@ UCS_TEST_P(test_ucp_tag_perf, multi_unexp) {
     check_scalability(1.5, false);
 }
 
+UCS_TEST_P(test_ucp_tag_perf, multi_exp_large) {
+    check_scalability(1.5 + growth_tolerance(), true, large_count());
+}
+
+UCS_TEST_P(test_ucp_tag_perf, multi_unexp_large) {
+    check_scalability(1.5 + growth_tolerance(), false, large_count());
+}
+
+UCS_TEST_P(test_ucp_tag_perf, multi_unexp_wild) {
+    check_scalability(1.5, false, COUNT, WILD_MASK);
+}
+
 UCP_INSTANTIATE_TEST_CASE(test_ucp_tag_perf)
@@ -11,6 +11,8 @@
 
 extern "C" {
 #include <ucp/core/ucp_ep.inl>
+#include <ucp/core/ucp_request.h>
+#include <ucp/tag/rndv_est.h>
 #include <ucs/datastruct/queue.h>
 }
 
@@ -776,6 +778,158 @@ UCS_TEST_P(test_ucp_tag_xfer, send_contig_recv_contig_exp_rndv_probe, "RNDV_THRE
     test_xfer_probe(true, true, true, false);
 }
 
+/* rndv send_contig_recv_contig with host buffers registered by fragments */
+
+UCS_TEST_P(test_ucp_tag_xfer, send_contig_recv_contig_exp_rndv_frag_reg,
+           "RNDV_THRESH=1000", "RNDV_FRAG_REG_THRESH=1000",
+           "RNDV_FRAG_SIZE=64k") {
+    test_run_xfer(true, true, true, false, false);
+}
+
+UCS_TEST_P(test_ucp_tag_xfer, send_contig_recv_contig_unexp_rndv_frag_reg,
+           "RNDV_THRESH=1000", "RNDV_FRAG_REG_THRESH=1000",
+           "RNDV_FRAG_SIZE=64k") {
+    test_run_xfer(true, true, false, false, false);
+}
+
+UCS_TEST_P(test_ucp_tag_xfer, send_contig_recv_contig_exp_sync_rndv_frag_reg,
+           "RNDV_THRESH=1000", "RNDV_FRAG_REG_THRESH=1000",
+           "RNDV_FRAG_SIZE=64k") {
+    /* because ucp_tag_send_req return status (instead request) if send operation
+     * completed immediately */
+    skip_loopback();
+    test_run_xfer(true, true, true, true, false);
+}
+
+UCS_TEST_P(test_ucp_tag_xfer, send_contig_recv_contig_exp_rndv_frag_reg_truncated,
+           "RNDV_THRESH=1000", "RNDV_FRAG_REG_THRESH=1000",
+           "RNDV_FRAG_SIZE=64k") {
+    check_offload_support(false);
+    test_run_xfer(true, true, true, false, true);
+}
+
+/* adaptive rndv threshold retuned by runtime measurements */
+
+UCS_TEST_P(test_ucp_tag_xfer, send_contig_recv_contig_exp_rndv_adaptive,
+           "RNDV_ADAPTIVE=y", "RNDV_ADAPTIVE_INTERVAL=16") {
+    static const size_t max_size = 256 * UCS_KBYTE;
+    static const int num_iters   = 8;
+    std::vector<char> sendbuf(max_size), recvbuf(max_size);
+    ucp_rndv_est_t *est;
+    char *info;
+    size_t info_length;
+    FILE *stream;
+    size_t recvd;
+
+    /* eager sends are measured only if they are synchronous */
+    for (int iter = 0; iter < num_iters; ++iter) {
+        for (size_t size = 1; size <= max_size; size *= 4) {
+            ucs::fill_random(sendbuf, size);
+            recvd = do_xfer(&sendbuf[0], &recvbuf[0], size, DATATYPE, DATATYPE,
+                            true, iter % 2, false);
+            ASSERT_EQ(size, recvd);
+            EXPECT_EQ(0, memcmp(&sendbuf[0], &recvbuf[0], size)) << "size "
+                                                                  << size;
+        }
+    }
+
+    est = ucp_ep_config(sender().ep())->tag.rndv.est;
+    if (est == NULL) {
+        UCS_TEST_SKIP_R("rendezvous estimator is not used");
+    }
+
+    EXPECT_GT(est->num_retunes, 0u);
+
+    /* the learned tables are dumped with the worker info */
+    stream = open_memstream(&info, &info_length);
+    ASSERT_TRUE(stream != NULL);
+    ucp_worker_print_info(sender().worker(), stream);
+    fclose(stream);
+    EXPECT_NE(std::string::npos,
+              std::string(info, info_length).find("rndv estimator"));
+    free(info);
+}
+
+/* Replace the estimator measurements by synthetic ones, in which eager and
+ * rendezvous have constant bandwidths, and retune the thresholds */
+static void rndv_est_retune(ucp_ep_h ep, double eager_bw, double rndv_bw)
+{
+    ucp_context_h context = ep->worker->context;
+    ucp_rndv_est_t *est   = ucp_ep_config(ep)->tag.rndv.est;
+    ucp_rndv_est_entry_t *entry;
+    ucp_request_t req;
+
+    for (unsigned bucket = 0; bucket <= 40; ++bucket) {
+        entry        = &est->entries[UCP_RNDV_EST_PROTO_EAGER][bucket];
+        entry->count = 1000;
+        entry->bytes = entry->count * (double)UCS_BIT(bucket);
+        entry->time  = entry->bytes / eager_bw;
+
+        entry        = &est->entries[UCP_RNDV_EST_PROTO_RNDV_GET][bucket];
+        entry->count = 1000;
+        entry->bytes = entry->count * (double)UCS_BIT(bucket);
+        entry->time  = entry->bytes / rndv_bw;
+    }
+
+    /* complete one more measured send to trigger the retune */
+    memset(&req, 0, sizeof(req));
+    req.flags               = UCP_REQUEST_FLAG_SYNC;
+    req.send.ep             = ep;
+    req.send.length         = 1;
+    req.send.rndv_est_proto = UCP_RNDV_EST_PROTO_EAGER;
+    req.send.rndv_est_start = ucs_get_time();
+    est->num_samples        = context->config.ext.rndv_adaptive_interval - 1;
+    ucp_rndv_est_send_completed(&req);
+}
+
+UCS_TEST_P(test_ucp_tag_xfer, rndv_adaptive_thresh_direction,
+           "RNDV_ADAPTIVE=y", "RNDV_THRESH=auto") {
+    ucp_ep_config_t *config = ucp_ep_config(sender().ep());
+    ucp_rndv_est_t *est     = config->tag.rndv.est;
+    size_t static_thresh, expected_thresh, *thresh;
+    unsigned num_retunes, num_samples;
+    ucp_request_t req;
+
+    if (est == NULL) {
+        UCS_TEST_SKIP_R("rendezvous estimator is not used");
+    }
+
+    if (est->static_rma_thresh != SIZE_MAX) {
+        static_thresh = est->static_rma_thresh;
+        thresh        = &config->tag.rndv.rma_thresh;
+    } else if (est->static_am_thresh != SIZE_MAX) {
+        static_thresh = est->static_am_thresh;
+        thresh        = &config->tag.rndv.am_thresh;
+    } else {
+        UCS_TEST_SKIP_R("rendezvous is disabled");
+    }
+
+    /* a non-synchronous eager send completes before the remote side got the
+     * data, so it is not measured */
+    num_samples = est->num_samples;
+    memset(&req, 0, sizeof(req));
+    req.send.ep             = sender().ep();
+    req.send.length         = static_thresh;
+    req.send.rndv_est_proto = UCP_RNDV_EST_PROTO_EAGER;
+    req.send.rndv_est_start = ucs_get_time();
+    ucp_rndv_est_send_completed(&req);
+    EXPECT_EQ(num_samples, est->num_samples);
+
+    /* rendezvous is faster for all sizes: the threshold goes down to the
+     * minimal one */
+    num_retunes = est->num_retunes;
+    rndv_est_retune(sender().ep(), 1.0, 2.0);
+    EXPECT_EQ(num_retunes + 1, est->num_retunes);
+    EXPECT_EQ(est->min_thresh, *thresh);
+
+    /* eager is faster for all sizes: the threshold goes above the largest
+     * measured size */
+    rndv_est_retune(sender().ep(), 2.0, 1.0);
+    EXPECT_EQ(num_retunes + 2, est->num_retunes);
+    expected_thresh = ucs_max(UCS_BIT(41), est->min_thresh);
+    EXPECT_EQ(expected_thresh, *thresh);
+}
+
 /* rndv send_generic_recv_generic am_rndv with bcopy on the sender side */
 
 UCS_TEST_P(test_ucp_tag_xfer, send_generic_recv_generic_exp_rndv, "RNDV_THRESH=1000") {
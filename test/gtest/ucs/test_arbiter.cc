@@ -801,3 +801,202 @@ UCS_TEST_F(test_arbiter_resched_from_dispatch, remove_and_resched) {
 
     ucs_arbiter_group_purge(&m_arb, &m_group2, purge_cb, NULL);
 }
+
+class test_arbiter_weighted : public ucs::test {
+public:
+    virtual void init() {
+        ucs::test::init();
+        ucs_arbiter_init(&m_arb);
+        for (unsigned i = 0; i < NUM_GROUPS; ++i) {
+            ucs_arbiter_group_init(&m_groups[i]);
+            m_bytes[i] = 0;
+            m_count[i] = 0;
+        }
+        m_budget       = 0;
+        m_resched_cost = 0;
+    }
+
+    virtual void cleanup() {
+        for (unsigned i = 0; i < NUM_GROUPS; ++i) {
+            ucs_arbiter_group_purge(&m_arb, &m_groups[i], purge_cb, NULL);
+            ucs_arbiter_group_cleanup(&m_groups[i]);
+        }
+        ucs_arbiter_cleanup(&m_arb);
+        ucs::test::cleanup();
+    }
+
+protected:
+    static const unsigned NUM_GROUPS = 2;
+
+    struct weighted_elem {
+        unsigned           group_idx;
+        size_t             cost;
+        ucs_arbiter_elem_t elem;
+    };
+
+    void push_elems(unsigned group_idx, size_t cost, unsigned count) {
+        for (unsigned i = 0; i < count; ++i) {
+            weighted_elem *e = new weighted_elem;
+            e->group_idx     = group_idx;
+            e->cost          = cost;
+            ucs_arbiter_elem_init(&e->elem);
+            ucs_arbiter_group_push_elem(&m_groups[group_idx], &e->elem);
+            m_elems.push_back(e);
+        }
+        ucs_arbiter_group_schedule(&m_arb, &m_groups[group_idx]);
+    }
+
+    /* dispatch elements until their total cost reaches the budget */
+    void dispatch_bytes(size_t budget) {
+        m_budget = budget;
+        ucs_arbiter_dispatch(&m_arb, 1, dispatch_cb, this);
+    }
+
+    ucs_arbiter_cb_result_t dispatch(ucs_arbiter_t *arbiter,
+                                     ucs_arbiter_elem_t *elem) {
+        weighted_elem *e = ucs_container_of(elem, weighted_elem, elem);
+
+        if (m_resched_cost != 0) {
+            /* report a cost, but do not send anything */
+            ucs_arbiter_elem_charge(arbiter, m_resched_cost);
+            m_resched_cost = 0;
+            return UCS_ARBITER_CB_RESULT_RESCHED_GROUP;
+        }
+
+        if (m_budget < e->cost) {
+            return UCS_ARBITER_CB_RESULT_STOP;
+        }
+
+        m_budget               -= e->cost;
+        m_bytes[e->group_idx]  += e->cost;
+        ++m_count[e->group_idx];
+        ucs_arbiter_elem_charge(arbiter, e->cost);
+        return UCS_ARBITER_CB_RESULT_REMOVE_ELEM;
+    }
+
+    static ucs_arbiter_cb_result_t dispatch_cb(ucs_arbiter_t *arbiter,
+                                               ucs_arbiter_elem_t *elem,
+                                               void *arg)
+    {
+        test_arbiter_weighted *self =
+                reinterpret_cast<test_arbiter_weighted*>(arg);
+        return self->dispatch(arbiter, elem);
+    }
+
+    static ucs_arbiter_cb_result_t purge_cb(ucs_arbiter_t *arbiter,
+                                            ucs_arbiter_elem_t *elem, void *arg)
+    {
+        return UCS_ARBITER_CB_RESULT_REMOVE_ELEM;
+    }
+
+    ucs_arbiter_t                   m_arb;
+    ucs_arbiter_group_t             m_groups[NUM_GROUPS];
+    size_t                          m_bytes[NUM_GROUPS];
+    unsigned                        m_count[NUM_GROUPS];
+    size_t                          m_budget;
+    size_t                          m_resched_cost;
+    ucs::ptr_vector<weighted_elem>  m_elems;
+};
+
+/* bandwidth is shared in proportion to the weights */
+UCS_TEST_F(test_arbiter_weighted, proportional) {
+    ucs_arbiter_group_set_weight(&m_groups[0], 1000);
+    ucs_arbiter_group_set_weight(&m_groups[1], 3000);
+    push_elems(0, 100, 1000);
+    push_elems(1, 100, 1000);
+
+    dispatch_bytes(80000);
+
+    EXPECT_EQ(80000ul, m_bytes[0] + m_bytes[1]);
+    EXPECT_NEAR(3.0, (double)m_bytes[1] / m_bytes[0], 0.05);
+}
+
+/* a group of large elements does not starve a group of small ones */
+UCS_TEST_F(test_arbiter_weighted, large_and_small) {
+    const size_t large = 65536, small = 64, weight = 8192;
+
+    ucs_arbiter_group_set_weight(&m_groups[0], weight);
+    ucs_arbiter_group_set_weight(&m_groups[1], weight);
+    push_elems(0, large, 100);
+    push_elems(1, small, 40000);
+
+    dispatch_bytes(20 * large);
+
+    EXPECT_NEAR(1.0, (double)m_bytes[1] / m_bytes[0], 0.2);
+    EXPECT_GT(m_count[1], (large / small / 2) * m_count[0]);
+}
+
+/* a weighted group gets its weight of elements per round, and a group
+ * without weight gets 'per_group' elements */
+UCS_TEST_F(test_arbiter_weighted, mixed) {
+    ucs_arbiter_group_set_weight(&m_groups[0], 500);
+    push_elems(0, 100, 1000);
+    push_elems(1, 100, 1000);
+
+    dispatch_bytes(60000);
+
+    EXPECT_EQ(500u, m_count[0]);
+    EXPECT_EQ(100u, m_count[1]);
+}
+
+/* the only scheduled group is not blocked by its debt */
+UCS_TEST_F(test_arbiter_weighted, single_group_debt) {
+    const size_t cost = UCS_GBYTE;
+
+    ucs_arbiter_group_set_weight(&m_groups[0], 1);
+    push_elems(0, cost, 3);
+
+    dispatch_bytes(3 * cost);
+
+    EXPECT_EQ(3u, m_count[0]);
+    EXPECT_TRUE(ucs_arbiter_is_empty(&m_arb));
+}
+
+/* every element costs at least 1, so zero-cost elements do not monopolize
+ * the arbiter */
+UCS_TEST_F(test_arbiter_weighted, count_elems) {
+    ucs_arbiter_group_set_weight(&m_groups[0], 2);
+    ucs_arbiter_group_set_weight(&m_groups[1], 4);
+    push_elems(0, 0, 100);
+    push_elems(1, 0, 100);
+
+    m_budget = 0;
+    ucs_arbiter_dispatch(&m_arb, 1, dispatch_cb, this);
+
+    EXPECT_EQ(100u, m_count[0]);
+    EXPECT_EQ(100u, m_count[1]);
+    EXPECT_TRUE(ucs_arbiter_is_empty(&m_arb));
+}
+
+/* groups in a deep debt are not polled round by round until it is repaid */
+UCS_TEST_F(test_arbiter_weighted, deep_debt) {
+    const size_t cost = UCS_GBYTE;
+
+    ucs_arbiter_group_set_weight(&m_groups[0], 1);
+    ucs_arbiter_group_set_weight(&m_groups[1], 3);
+    push_elems(0, cost, 4);
+    push_elems(1, cost, 4);
+
+    dispatch_bytes(4 * cost);
+
+    /* the group with the higher weight repays its debt earlier */
+    EXPECT_EQ(1u, m_count[0]);
+    EXPECT_EQ(3u, m_count[1]);
+}
+
+/* an element which was not dispatched is not charged */
+UCS_TEST_F(test_arbiter_weighted, charge_dispatched) {
+    ucs_arbiter_group_set_weight(&m_groups[0], 100);
+    ucs_arbiter_group_set_weight(&m_groups[1], 100);
+    push_elems(0, 100, 10);
+    push_elems(1, 100, 10);
+
+    m_resched_cost = 100000;
+    dispatch_bytes(500);
+    EXPECT_EQ(0u, m_count[0]);
+    EXPECT_EQ(5u, m_count[1]);
+
+    dispatch_bytes(200);
+    EXPECT_EQ(1u, m_count[0]);
+    EXPECT_EQ(6u, m_count[1]);
+}
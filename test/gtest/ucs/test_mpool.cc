@@ -10,6 +10,7 @@ extern "C" {
 }
 
 #include <limits.h>
+#include <pthread.h>
 #include <vector>
 #include <queue>
 
@@ -44,6 +45,41 @@ protected:
         return UCS_LOG_FUNC_RC_CONTINUE;
     }
 
+    struct mt_thread_arg {
+        ucs_mpool_mt_t     *mp;
+        unsigned           count;
+        std::vector<void*> remote; /* objects to be released by another thread */
+    };
+
+    static void *mt_thread_func(void *arg) {
+        mt_thread_arg *targ = (mt_thread_arg*)arg;
+        std::vector<void*> objs;
+
+        for (unsigned iter = 0; iter < targ->count; ++iter) {
+            for (unsigned i = 0; i < 100; ++i) {
+                void *obj = ucs_mpool_mt_get(targ->mp);
+                if (obj == NULL) {
+                    break;
+                }
+                memset(obj, 0xee, data_size);
+                objs.push_back(obj);
+            }
+
+            while (!objs.empty()) {
+                ucs_mpool_mt_put(objs.back());
+                objs.pop_back();
+            }
+        }
+
+        for (unsigned i = 0; i < 200; ++i) {
+            void *obj = ucs_mpool_mt_get(targ->mp);
+            if (obj != NULL) {
+                targ->remote.push_back(obj);
+            }
+        }
+        return NULL;
+    }
+
     static const size_t header_size = 30;
     static const size_t data_size = 152;
     static const size_t align = 128;
@@ -203,3 +239,242 @@ UCS_TEST_F(test_mpool, infinite) {
 
     ucs_mpool_cleanup(&mp, 1);
 }
+
+UCS_TEST_F(test_mpool, mt_basic) {
+    const unsigned NUM_ELEMS = 1000;
+    ucs_status_t status;
+    ucs_mpool_mt_t mp;
+
+    ucs_mpool_ops_t ops = {
+       ucs_mpool_chunk_malloc,
+       ucs_mpool_chunk_free,
+       NULL,
+       NULL
+    };
+
+    status = ucs_mpool_mt_init(&mp, 0, header_size + data_size, header_size,
+                               align, 64, NUM_ELEMS, 16, &ops, "test");
+    ASSERT_UCS_OK(status);
+
+    for (unsigned loop = 0; loop < 3; ++loop) {
+        std::vector<void*> objs;
+        for (unsigned i = 0; i < NUM_ELEMS; ++i) {
+            void *obj = ucs_mpool_mt_get(&mp);
+            ASSERT_TRUE(obj != NULL);
+            EXPECT_EQ(0ul, ((uintptr_t)obj + header_size) % align) << obj;
+            memset(obj, 0xcc, data_size);
+            objs.push_back(obj);
+        }
+
+        /* quota is exhausted */
+        EXPECT_TRUE(ucs_mpool_mt_get(&mp) == NULL);
+
+        for (std::vector<void*>::iterator iter = objs.begin();
+             iter != objs.end(); ++iter) {
+            ucs_mpool_mt_put(*iter);
+        }
+    }
+
+    ucs_mpool_mt_cleanup(&mp, 1);
+}
+
+UCS_TEST_F(test_mpool, mt_threads) {
+    const unsigned NUM_THREADS = 4;
+    ucs_status_t status;
+    ucs_mpool_mt_t mp;
+
+    ucs_mpool_ops_t ops = {
+       ucs_mpool_chunk_malloc,
+       ucs_mpool_chunk_free,
+       NULL,
+       NULL
+    };
+
+    status = ucs_mpool_mt_init(&mp, 0, header_size + data_size, header_size,
+                               align, 128, UINT_MAX, 32, &ops, "test");
+    ASSERT_UCS_OK(status);
+
+    std::vector<pthread_t> threads(NUM_THREADS);
+    std::vector<mt_thread_arg> args(NUM_THREADS);
+    for (unsigned i = 0; i < NUM_THREADS; ++i) {
+        args[i].mp    = &mp;
+        args[i].count = 1000 / ucs::test_time_multiplier();
+        pthread_create(&threads[i], NULL, mt_thread_func, &args[i]);
+    }
+
+    for (unsigned i = 0; i < NUM_THREADS; ++i) {
+        pthread_join(threads[i], NULL);
+        EXPECT_EQ(200ul, args[i].remote.size());
+    }
+
+    /* Release objects allocated by other threads, the caches of which were
+     * returned to the shared pool on thread exit */
+    for (unsigned i = 0; i < NUM_THREADS; ++i) {
+        for (unsigned j = 0; j < args[i].remote.size(); ++j) {
+            ucs_mpool_mt_put(args[i].remote[j]);
+        }
+    }
+
+    /* The calling thread cache is released by cleanup */
+    void *obj = ucs_mpool_mt_get(&mp);
+    ASSERT_TRUE(obj != NULL);
+    ucs_mpool_mt_put(obj);
+
+    ucs_mpool_mt_cleanup(&mp, 1);
+}
+
+/* a full thread cache returns its least recently used elements */
+UCS_TEST_F(test_mpool, mt_flush_oldest) {
+    const unsigned BATCH = 4, NUM_OBJS = 9;
+    ucs_status_t status;
+    ucs_mpool_mt_t mp;
+
+    ucs_mpool_ops_t ops = {
+       ucs_mpool_chunk_malloc,
+       ucs_mpool_chunk_free,
+       NULL,
+       NULL
+    };
+
+    status = ucs_mpool_mt_init(&mp, 0, header_size + data_size, header_size,
+                               align, 64, UINT_MAX, BATCH, &ops, "test");
+    ASSERT_UCS_OK(status);
+
+    std::vector<void*> objs;
+    for (unsigned i = 0; i < NUM_OBJS; ++i) {
+        objs.push_back(ucs_mpool_mt_get(&mp));
+        ASSERT_TRUE(objs.back() != NULL);
+    }
+
+    /* the cache overflows on the 6th object, and keeps the last BATCH ones */
+    for (unsigned i = 0; i < NUM_OBJS; ++i) {
+        ucs_mpool_mt_put(objs[i]);
+    }
+
+    std::vector<void*> cached;
+    for (unsigned i = NUM_OBJS; i > 2; --i) {
+        cached.push_back(ucs_mpool_mt_get(&mp));
+        EXPECT_EQ(objs[i - 1], cached.back()) << "i=" << i;
+    }
+
+    for (unsigned i = 0; i < cached.size(); ++i) {
+        ucs_mpool_mt_put(cached[i]);
+    }
+
+    ucs_mpool_mt_cleanup(&mp, 1);
+}
+
+/* per-thread caches of many pools */
+UCS_TEST_F(test_mpool, mt_many_pools) {
+    const unsigned NUM_POOLS = 300;
+    std::vector<ucs_mpool_mt_t> mps(NUM_POOLS);
+    std::vector<void*> objs;
+    ucs_status_t status;
+
+    ucs_mpool_ops_t ops = {
+       ucs_mpool_chunk_malloc,
+       ucs_mpool_chunk_free,
+       NULL,
+       NULL
+    };
+
+    for (unsigned i = 0; i < NUM_POOLS; ++i) {
+        status = ucs_mpool_mt_init(&mps[i], 0, header_size + data_size,
+                                   header_size, align, 8, UINT_MAX, 4, &ops,
+                                   "test");
+        ASSERT_UCS_OK(status);
+    }
+
+    for (unsigned i = 0; i < NUM_POOLS; ++i) {
+        objs.push_back(ucs_mpool_mt_get(&mps[i]));
+        ASSERT_TRUE(objs.back() != NULL);
+    }
+
+    for (unsigned i = 0; i < NUM_POOLS; ++i) {
+        ucs_mpool_mt_put(objs[i]);
+    }
+
+    /* a pool which reuses the index of a released pool gets a new cache */
+    ucs_mpool_mt_cleanup(&mps[0], 1);
+    status = ucs_mpool_mt_init(&mps[0], 0, header_size + data_size,
+                               header_size, align, 8, UINT_MAX, 4, &ops,
+                               "test");
+    ASSERT_UCS_OK(status);
+    void *obj = ucs_mpool_mt_get(&mps[0]);
+    ASSERT_TRUE(obj != NULL);
+    ucs_mpool_mt_put(obj);
+
+    for (unsigned i = 0; i < NUM_POOLS; ++i) {
+        ucs_mpool_mt_cleanup(&mps[i], 1);
+    }
+}
+
+UCS_TEST_F(test_mpool, shrink) {
+    const unsigned NUM_ELEMS = 100;
+    const unsigned ELEMS_PER_CHUNK = 10;
+    ucs_status_t status;
+    ucs_mpool_t mp;
+
+    ucs_mpool_ops_t ops = {
+       ucs_mpool_chunk_malloc,
+       ucs_mpool_chunk_free,
+       NULL,
+       NULL
+    };
+
+    status = ucs_mpool_init(&mp, 0, header_size + data_size, header_size, align,
+                            ELEMS_PER_CHUNK, NUM_ELEMS, &ops, "test");
+    ASSERT_UCS_OK(status);
+
+    /* nothing to release */
+    EXPECT_EQ(0u, ucs_mpool_shrink(&mp));
+
+    std::vector<void*> objs;
+    for (unsigned i = 0; i < NUM_ELEMS; ++i) {
+        void *obj = ucs_mpool_get(&mp);
+        ASSERT_TRUE(obj != NULL);
+        objs.push_back(obj);
+    }
+
+    EXPECT_EQ(NUM_ELEMS / ELEMS_PER_CHUNK, mp.data->num_chunks);
+    EXPECT_EQ(NUM_ELEMS, mp.data->num_elems);
+    EXPECT_TRUE(ucs_mpool_is_empty(&mp));
+
+    /* all elements are in use */
+    EXPECT_EQ(0u, ucs_mpool_shrink(&mp));
+
+    /* keep one element in use, all other chunks are idle */
+    void *used_obj = objs[NUM_ELEMS / 2];
+    for (unsigned i = 0; i < NUM_ELEMS; ++i) {
+        if (objs[i] != used_obj) {
+            ucs_mpool_put(objs[i]);
+        }
+    }
+    objs.clear();
+
+    EXPECT_EQ(NUM_ELEMS / ELEMS_PER_CHUNK - 1, ucs_mpool_shrink(&mp));
+    EXPECT_EQ(1u, mp.data->num_chunks);
+    EXPECT_EQ(ELEMS_PER_CHUNK, mp.data->num_elems);
+    EXPECT_EQ(NUM_ELEMS, mp.data->peak_elems);
+    EXPECT_LT(mp.data->num_bytes, mp.data->peak_bytes);
+
+    /* the quota of released chunks can be allocated again */
+    objs.push_back(used_obj);
+    for (unsigned i = 1; i < NUM_ELEMS; ++i) {
+        void *obj = ucs_mpool_get(&mp);
+        ASSERT_TRUE(obj != NULL);
+        objs.push_back(obj);
+    }
+    EXPECT_TRUE(ucs_mpool_get(&mp) == NULL);
+
+    for (unsigned i = 0; i < NUM_ELEMS; ++i) {
+        ucs_mpool_put(objs[i]);
+    }
+
+    EXPECT_EQ(NUM_ELEMS / ELEMS_PER_CHUNK, ucs_mpool_shrink(&mp));
+    EXPECT_EQ(0u, mp.data->num_chunks);
+    EXPECT_EQ(0u, mp.data->num_bytes);
+    EXPECT_TRUE(mp.freelist == NULL);
+
+    ucs_mpool_cleanup(&mp, 1);
+}
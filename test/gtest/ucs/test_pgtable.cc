@@ -19,6 +19,12 @@ protected:
 
     typedef std::vector<ucs_pgt_region_t*> search_result_t;
 
+    struct deferred_region {
+        ucs_pgt_region_t   super;
+        ucs_pgt_deferred_t deferred;
+        bool               released;
+    };
+
     virtual void init() {
         ucs::test::init();
         ucs_status_t status = ucs_pgtable_init(&m_pgtable, pgd_alloc, pgd_free);
@@ -53,6 +59,16 @@ protected:
         }
     }
 
+    void defer(deferred_region *region, ucs_pgt_deferred_cb_t cb) {
+        region->released = false;
+        ucs_pgtable_defer(&m_pgtable, &region->deferred, cb);
+    }
+
+    static void region_release(ucs_pgtable_t *pgtable,
+                               ucs_pgt_deferred_t *deferred) {
+        ucs_container_of(deferred, deferred_region, deferred)->released = true;
+    }
+
     ucs_pgt_region_t *lookup(ucs_pgt_addr_t address) {
         return ucs_pgtable_lookup(&m_pgtable, address);
     }
@@ -405,6 +421,186 @@ UCS_TEST_F(test_pgtable, search_adjacent_regions) {
     remove(&region3);
 }
 
+UCS_TEST_F(test_pgtable, lookup_concurrent) {
+    ucs_pgt_region_t region = {0x100000, 0x200000};
+    ucs_pgt_region_t *found;
+    ucs_status_t status;
+
+    insert(&region);
+
+    ucs_pgtable_reader_enter();
+
+    status = ucs_pgtable_lookup_concurrent(&m_pgtable, 0x180000, &found);
+    ASSERT_UCS_OK(status);
+    EXPECT_EQ(&region, found);
+
+    status = ucs_pgtable_lookup_concurrent(&m_pgtable, 0x200000, &found);
+    ASSERT_UCS_OK(status);
+    EXPECT_TRUE(found == NULL);
+
+    /* Lookups during an update do not return a result */
+    ucs_pgtable_update_begin(&m_pgtable);
+    status = ucs_pgtable_lookup_concurrent(&m_pgtable, 0x180000, &found);
+    EXPECT_EQ(UCS_ERR_BUSY, status);
+    ucs_pgtable_update_end(&m_pgtable);
+
+    status = ucs_pgtable_lookup_concurrent(&m_pgtable, 0x180000, &found);
+    ASSERT_UCS_OK(status);
+    EXPECT_EQ(&region, found);
+
+    ucs_pgtable_reader_exit();
+
+    remove(&region);
+}
+
+UCS_TEST_F(test_pgtable, defer_release) {
+    deferred_region region;
+    ucs_pgt_region_t *found;
+    ucs_status_t status;
+
+    region.super.start = 0x100000;
+    region.super.end   = 0x200000;
+    insert(&region.super);
+
+    ucs_pgtable_reader_enter();
+    status = ucs_pgtable_lookup_concurrent(&m_pgtable, 0x180000, &found);
+    ASSERT_UCS_OK(status);
+    EXPECT_EQ(&region.super, found);
+
+    /* Removing the region does not wait for the reader section */
+    remove(&region.super);
+    defer(&region, region_release);
+    ucs_pgtable_progress(&m_pgtable);
+    EXPECT_FALSE(region.released);
+    ucs_pgtable_reader_exit();
+
+    /* Reader sections which started later do not delay the release */
+    ucs_pgtable_reader_enter();
+    ucs_pgtable_progress(&m_pgtable);
+    EXPECT_TRUE(region.released);
+    ucs_pgtable_reader_exit();
+}
+
+class test_pgtable_concurrent : public test_pgtable {
+protected:
+    static const ucs_pgt_addr_t STABLE_START = 0x7f0000000000ul;
+    static const ucs_pgt_addr_t STABLE_END   = STABLE_START + UCS_BIT(20);
+    static const ucs_pgt_addr_t MOVING_START = STABLE_END;
+    static const unsigned       NUM_MOVING   = 64;
+
+    struct reader_arg {
+        test_pgtable_concurrent *test;
+        const ucs_pgt_region_t  *stable;
+        unsigned long           lookups;
+        unsigned long           errors;
+    };
+
+    static void *reader_thread(void *arg) {
+        reader_arg *rarg = reinterpret_cast<reader_arg*>(arg);
+        ucs_pgt_addr_t address;
+        ucs_pgt_region_t *region;
+        ucs_status_t status;
+        unsigned i = 0;
+
+        while (!rarg->test->m_stop) {
+            /* alternate between the stable region and the moving regions */
+            if (i % 2) {
+                address = STABLE_START + ((i * UCS_PGT_ADDR_ALIGN) %
+                                          (STABLE_END - STABLE_START));
+            } else {
+                address = MOVING_START + ((i / 2) % (NUM_MOVING * 2)) *
+                                         UCS_BIT(12);
+            }
+            ++i;
+
+            ucs_pgtable_reader_enter();
+
+            status = ucs_pgtable_lookup_concurrent(&rarg->test->m_pgtable,
+                                                   address, &region);
+            if (status == UCS_OK) {
+                ++rarg->lookups;
+                if (((address >= STABLE_START) && (address < STABLE_END) &&
+                     (region != rarg->stable)) ||
+                    ((region != NULL) && ((address < region->start) ||
+                                          (address >= region->end)))) {
+                    ++rarg->errors;
+                }
+            } else if (status != UCS_ERR_BUSY) {
+                ++rarg->errors;
+            }
+
+            ucs_pgtable_reader_exit();
+        }
+        return NULL;
+    }
+
+    static void region_delete(ucs_pgtable_t *pgtable,
+                              ucs_pgt_deferred_t *deferred) {
+        deferred_region *region = ucs_container_of(deferred, deferred_region,
+                                                   deferred);
+
+        /* Poison the memory, so readers would detect using it */
+        memset(&region->super, 0xff, sizeof(region->super));
+        delete region;
+    }
+
+    volatile bool m_stop;
+};
+
+UCS_TEST_F(test_pgtable_concurrent, readers_and_writer) {
+    const unsigned NUM_READERS = 3;
+    const unsigned NUM_ITERS   = 20000 / ucs::test_time_multiplier();
+    ucs_pgt_region_t stable    = {STABLE_START, STABLE_END};
+    std::vector<deferred_region*> moving(NUM_MOVING, NULL);
+    std::vector<reader_arg> args(NUM_READERS);
+    std::vector<pthread_t> threads(NUM_READERS);
+
+    insert(&stable);
+
+    m_stop = false;
+    for (unsigned i = 0; i < NUM_READERS; ++i) {
+        args[i].test    = this;
+        args[i].stable  = &stable;
+        args[i].lookups = 0;
+        args[i].errors  = 0;
+        pthread_create(&threads[i], NULL, reader_thread, &args[i]);
+    }
+
+    /* Insert and remove regions of different sizes, and release the removed
+     * regions when readers can't access them anymore */
+    for (unsigned iter = 0; iter < NUM_ITERS; ++iter) {
+        unsigned index = ucs::rand() % NUM_MOVING;
+        if (moving[index] == NULL) {
+            ucs_pgt_addr_t start = MOVING_START + index * UCS_BIT(13);
+            moving[index]              = new deferred_region;
+            moving[index]->super.start = start;
+            moving[index]->super.end   = start + UCS_BIT(12) *
+                                                 (1 + ucs::rand() % 2);
+            insert(&moving[index]->super);
+        } else {
+            remove(&moving[index]->super);
+            defer(moving[index], region_delete);
+            moving[index] = NULL;
+        }
+    }
+
+    m_stop = true;
+    for (unsigned i = 0; i < NUM_READERS; ++i) {
+        pthread_join(threads[i], NULL);
+        EXPECT_EQ(0ul, args[i].errors) << "reader " << i;
+        UCS_TEST_MESSAGE << "reader " << i << ": " << args[i].lookups
+                         << " lookups";
+    }
+
+    for (unsigned i = 0; i < NUM_MOVING; ++i) {
+        if (moving[i] != NULL) {
+            remove(&moving[i]->super);
+            defer(moving[i], region_delete);
+        }
+    }
+    remove(&stable);
+}
+
 class test_pgtable_perf : public test_pgtable {
 protected:
 
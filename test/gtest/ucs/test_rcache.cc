@@ -30,7 +30,9 @@ UCS_TEST_F(test_rcache_basic, create_fail) {
         UCS_BIT(30), /* non-existing event */
         1000,
         &ops,
-        NULL
+        NULL,
+        ULONG_MAX,
+        SIZE_MAX
     };
 
     ucs_rcache_t *rcache;
@@ -69,7 +71,9 @@ protected:
             UCM_EVENT_VM_UNMAPPED,
             1000,
             &ops,
-            reinterpret_cast<void*>(this)
+            reinterpret_cast<void*>(this),
+            max_regions(),
+            max_size()
         };
         UCS_TEST_CREATE_HANDLE(ucs_rcache_t*, m_rcache, ucs_rcache_destroy,
                                ucs_rcache_create, &params, "test", ucs_stats_get_root());
@@ -97,6 +101,14 @@ protected:
         ucs_rcache_region_put(m_rcache, &r->super);
     }
 
+    virtual unsigned long max_regions() const {
+        return ULONG_MAX;
+    }
+
+    virtual size_t max_size() const {
+        return SIZE_MAX;
+    }
+
     virtual ucs_status_t mem_reg(region *region)
     {
         int mem_prot = ucs_get_mem_prot(region->super.super.start, region->super.super.end);
@@ -637,6 +649,127 @@ UCS_MT_TEST_F(test_rcache_no_register, merge_invalid_prot_slow, 5)
     munmap(mem, size1+size2);
 }
 
+class test_rcache_lru : public test_rcache {
+protected:
+    static const unsigned MAX_REGIONS = 3;
+
+    virtual unsigned long max_regions() const {
+        return MAX_REGIONS;
+    }
+
+    virtual size_t max_size() const {
+        return MAX_REGIONS * ucs_get_page_size();
+    }
+
+    void *page(void *mem, unsigned index) {
+        /* leave gaps between the pages, to avoid merging regions */
+        return UCS_PTR_BYTE_OFFSET(mem, 2 * index * ucs_get_page_size());
+    }
+
+    uint32_t get_put(void *address) {
+        region *r = get(address, ucs_get_page_size());
+        uint32_t id = r->id;
+        put(r);
+        return id;
+    }
+};
+
+const unsigned test_rcache_lru::MAX_REGIONS;
+
+UCS_TEST_F(test_rcache_lru, evict_lru) {
+    static const size_t size = 16 * ucs_get_page_size();
+    void *mem = alloc_pages(size, PROT_READ|PROT_WRITE);
+    region *r[MAX_REGIONS + 1];
+    uint32_t id[MAX_REGIONS + 1];
+
+    for (unsigned i = 0; i < MAX_REGIONS; ++i) {
+        r[i]  = get(page(mem, i), ucs_get_page_size());
+        id[i] = r[i]->id;
+    }
+
+    /* least recently released first: 1, 0, 2 */
+    put(r[1]);
+    put(r[0]);
+    put(r[2]);
+    EXPECT_EQ(MAX_REGIONS, m_reg_count);
+
+    /* region 1 is evicted */
+    id[3] = get_put(page(mem, 3));
+    EXPECT_EQ(MAX_REGIONS, m_reg_count);
+
+    /* region 0 is still cached, and becomes the most recently used */
+    EXPECT_EQ(id[0], get_put(page(mem, 0)));
+
+    /* region 1 is registered again, and region 2 is evicted */
+    EXPECT_NE(id[1], get_put(page(mem, 1)));
+    EXPECT_EQ(MAX_REGIONS, m_reg_count);
+
+    EXPECT_EQ(id[0], get_put(page(mem, 0)));
+    EXPECT_NE(id[2], get_put(page(mem, 2)));
+    EXPECT_EQ(MAX_REGIONS, m_reg_count);
+
+    munmap(mem, size);
+}
+
+UCS_TEST_F(test_rcache_lru, in_use_not_evicted) {
+    static const size_t size = 16 * ucs_get_page_size();
+    void *mem = alloc_pages(size, PROT_READ|PROT_WRITE);
+    region *r[MAX_REGIONS + 2];
+
+    /* regions which are in use are kept above the limit */
+    for (unsigned i = 0; i < MAX_REGIONS + 2; ++i) {
+        r[i] = get(page(mem, i), ucs_get_page_size());
+    }
+    EXPECT_EQ(MAX_REGIONS + 2, m_reg_count);
+
+    for (unsigned i = 0; i < MAX_REGIONS + 2; ++i) {
+        put(r[i]);
+    }
+    EXPECT_EQ(MAX_REGIONS + 2, m_reg_count);
+
+    /* unused regions are evicted when a new region is created */
+    get_put(page(mem, MAX_REGIONS + 2));
+    EXPECT_EQ(MAX_REGIONS, m_reg_count);
+
+    munmap(mem, size);
+}
+
+UCS_TEST_F(test_rcache_lru, evict_by_size) {
+    static const size_t size = 16 * ucs_get_page_size();
+    void *mem = alloc_pages(size, PROT_READ|PROT_WRITE);
+
+    for (unsigned i = 0; i < MAX_REGIONS; ++i) {
+        get_put(page(mem, i));
+    }
+    EXPECT_EQ(MAX_REGIONS, m_reg_count);
+
+    /* a region of the maximal size requires evicting all others */
+    region *r = get(page(mem, MAX_REGIONS), max_size());
+    EXPECT_EQ(1u, m_reg_count);
+    put(r);
+
+    munmap(mem, size);
+}
+
+UCS_TEST_F(test_rcache_lru, unmap) {
+    static const size_t size = 16 * ucs_get_page_size();
+    void *mem1 = alloc_pages(size, PROT_READ|PROT_WRITE);
+    void *mem2 = alloc_pages(size, PROT_READ|PROT_WRITE);
+
+    for (unsigned i = 0; i < MAX_REGIONS; ++i) {
+        get_put(page(mem1, i));
+    }
+
+    /* invalidated regions are removed from the LRU list */
+    munmap(mem1, size);
+    for (unsigned i = 0; i < MAX_REGIONS + 1; ++i) {
+        get_put(page(mem2, i));
+    }
+    EXPECT_EQ(MAX_REGIONS, m_reg_count);
+
+    munmap(mem2, size);
+}
+
 #if ENABLE_STATS
 class test_rcache_stats : public test_rcache {
 protected:
@@ -226,6 +226,24 @@ private:
     }
 
 protected:
+    struct send_completion {
+        send_completion() : done(false), status(UCS_OK) {
+            super.func  = completion_cb;
+            super.count = 1;
+        }
+
+        static void completion_cb(uct_completion_t *self, ucs_status_t status) {
+            send_completion *comp = ucs_container_of(self, send_completion,
+                                                     super);
+            comp->status = status;
+            comp->done   = true;
+        }
+
+        uct_completion_t super;
+        volatile bool    done;
+        ucs_status_t     status;
+    };
+
     uct_tcp_iface *m_tcp_iface;
     entity        *m_ent;
 };
@@ -254,4 +272,81 @@ UCS_TEST_P(test_uct_tcp, listener_flood_connect_and_close) {
     test_listener_flood(*m_ent, max_conn, 0);
 }
 
+UCS_TEST_P(test_uct_tcp, listener_flood_connect_and_send_small_poll_spin,
+           "POLL_SPIN=10us", "INCOMING_CPU=0") {
+    const size_t max_conn =
+        ucs_min(static_cast<size_t>(max_connections()), 128lu) /
+        ucs::test_time_multiplier();
+    const size_t msg_size = 1;
+    test_listener_flood(*m_ent, max_conn, msg_size);
+}
+
+UCS_TEST_P(test_uct_tcp, poll_spin_event_arm, "POLL_SPIN=10s") {
+    /* Events were handled recently, so the interface has to stay busy
+     * instead of letting the user block on the event fd */
+    m_tcp_iface->last_event_time = ucs_get_time();
+    EXPECT_EQ(UCS_ERR_BUSY, uct_iface_event_arm(m_ent->iface(),
+                                                UCT_EVENT_RECV));
+
+    m_tcp_iface->last_event_time = ucs_get_time() - ucs_time_from_sec(20.0);
+    EXPECT_EQ(UCS_OK, uct_iface_event_arm(m_ent->iface(), UCT_EVENT_RECV));
+}
+
+UCS_TEST_P(test_uct_tcp, listener_flood_connect_and_send_small_drain_coalesce,
+           "RX_DRAIN=16", "TX_COALESCE=y") {
+    const size_t max_conn =
+        ucs_min(static_cast<size_t>(max_connections()), 128lu) /
+        ucs::test_time_multiplier();
+    const size_t msg_size = 1;
+    test_listener_flood(*m_ent, max_conn, msg_size);
+}
+
+UCS_TEST_P(test_uct_tcp, put_zcopy_stripe_conn_reset, "STRIPE_CONNS=2",
+           "STRIPE_THRESH=1k") {
+    const size_t length = 16 * UCS_KBYTE;
+    entity *receiver    = uct_test::create_entity(0);
+    m_entities.push_back(receiver);
+
+    m_ent->connect(0, *receiver, 0);
+
+    uct_tcp_ep_t *ep = ucs_derived_of(m_ent->ep(0), uct_tcp_ep_t);
+    ASSERT_FALSE(ucs_list_is_empty(&ep->stripe_list));
+    uct_tcp_ep_t *stripe_ep = ucs_list_head(&ep->stripe_list, uct_tcp_ep_t,
+                                            list);
+
+    ucs_time_t deadline = ucs_get_time() + ucs_time_from_sec(DEFAULT_TIMEOUT_SEC);
+    while (((ep->conn_state != UCT_TCP_EP_CONN_STATE_CONNECTED) ||
+            (stripe_ep->conn_state != UCT_TCP_EP_CONN_STATE_CONNECTED)) &&
+           (ucs_get_time() < deadline)) {
+        progress();
+    }
+    ASSERT_EQ(UCT_TCP_EP_CONN_STATE_CONNECTED, stripe_ep->conn_state);
+
+    mapped_buffer sendbuf(length, 0, *m_ent);
+    mapped_buffer recvbuf(length, 0, *receiver);
+    send_completion comp;
+
+    ucs_status_t status = uct_ep_put_zcopy(m_ent->ep(0), sendbuf.iov(), 1,
+                                           recvbuf.addr(), recvbuf.rkey(),
+                                           &comp.super);
+    ASSERT_EQ(UCS_INPROGRESS, status);
+    EXPECT_FALSE(ucs_queue_is_empty(&stripe_ep->put_comp_q));
+
+    /* Kill the stripe connection before its PUT ACK is received */
+    scoped_log_handler wrap_err(wrap_errors_logger);
+    shutdown(stripe_ep->fd, SHUT_RDWR);
+
+    wait_for_flag(&comp.done);
+    ASSERT_TRUE(comp.done);
+    EXPECT_EQ(UCS_ERR_CONNECTION_RESET, comp.status);
+
+    /* PUT ACK of the stripe connection is not waited for anymore */
+    deadline = ucs_get_time() + ucs_time_from_sec(DEFAULT_TIMEOUT_SEC);
+    do {
+        progress();
+        status = uct_ep_flush(m_ent->ep(0), 0, NULL);
+    } while ((status == UCS_INPROGRESS) && (ucs_get_time() < deadline));
+    EXPECT_UCS_OK(status);
+}
+
 _UCT_INSTANTIATE_TEST_CASE(test_uct_tcp, tcp)
@@ -59,6 +59,8 @@ public:
 
     void test_recv_am(unsigned arm_flags, unsigned send_flags);
 
+    void test_recv_am_burst(unsigned arm_flags, unsigned send_flags);
+
     static size_t pack_u64(void *dest, void *arg)
     {
         *reinterpret_cast<uint64_t*>(dest) = *reinterpret_cast<uint64_t*>(arg);
@@ -152,6 +154,64 @@ void test_uct_event_fd::test_recv_am(unsigned arm_flags, unsigned send_flags)
     free(recv_buffer);
 }
 
+/* Send several messages after arming once, all of them must be received and
+ * the interface must be armed again after processing them */
+void test_uct_event_fd::test_recv_am_burst(unsigned arm_flags,
+                                           unsigned send_flags)
+{
+    static const int num_sends = 16;
+    uint64_t send_data         = 0xdeadbeef;
+    int am_send_count          = 0;
+    ssize_t res;
+    recv_desc_t *recv_buffer;
+    struct pollfd wakeup_fd;
+    ucs_status_t status;
+
+    recv_buffer = (recv_desc_t *)malloc(sizeof(*recv_buffer) +
+                                        sizeof(send_data));
+    recv_buffer->length = 0;
+
+    flush();
+
+    uct_iface_set_am_handler(m_e2->iface(), 0, am_handler, recv_buffer, 0);
+
+    status = uct_iface_event_fd_get(m_e2->iface(), &wakeup_fd.fd);
+    ASSERT_EQ(UCS_OK, status);
+    wakeup_fd.events = POLLIN;
+
+    for (int iter = 0; iter < 3; ++iter) {
+        arm(m_e2, arm_flags);
+
+        for (int i = 0; i < num_sends; ++i) {
+            res = uct_ep_am_bcopy(m_e1->ep(0), 0, pack_u64, &send_data,
+                                  send_flags);
+            if (res == UCS_ERR_NO_RESOURCE) {
+                /* the rest of the burst is sent in the next iteration */
+                break;
+            }
+            ASSERT_EQ((ssize_t)sizeof(send_data), res);
+            ++am_send_count;
+        }
+
+        /* the file descriptor is signaled at least once */
+        ASSERT_EQ(1, poll(&wakeup_fd, 1, 1000 * ucs::test_time_multiplier()));
+
+        for (;;) {
+            if ((progress() == 0) && (m_am_count == am_send_count)) {
+                status = uct_iface_event_arm(m_e2->iface(), arm_flags);
+                if (status != UCS_ERR_BUSY) {
+                    break;
+                }
+            }
+        }
+        ASSERT_EQ(UCS_OK, status);
+    }
+
+    m_e1->flush();
+
+    free(recv_buffer);
+}
+
 UCS_TEST_SKIP_COND_P(test_uct_event_fd, am,
                      !check_caps(UCT_IFACE_FLAG_EVENT_RECV |
                                  UCT_IFACE_FLAG_CB_SYNC    |
@@ -168,4 +228,12 @@ UCS_TEST_SKIP_COND_P(test_uct_event_fd, sig_am,
     test_recv_am(UCT_EVENT_RECV_SIG, UCT_SEND_FLAG_SIGNALED);
 }
 
+UCS_TEST_SKIP_COND_P(test_uct_event_fd, sig_am_burst,
+                     !check_caps(UCT_IFACE_FLAG_EVENT_RECV_SIG |
+                                 UCT_IFACE_FLAG_CB_SYNC        |
+                                 UCT_IFACE_FLAG_AM_BCOPY))
+{
+    test_recv_am_burst(UCT_EVENT_RECV_SIG, UCT_SEND_FLAG_SIGNALED);
+}
+
 UCT_INSTANTIATE_NO_SELF_TEST_CASE(test_uct_event_fd);
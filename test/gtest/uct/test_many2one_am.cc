@@ -98,6 +98,8 @@ public:
         }
     }
 
+    void test_am_bcopy();
+
     static const size_t NUM_SENDERS = 10;
 
 protected:
@@ -107,9 +109,7 @@ protected:
 };
 
 
-UCS_TEST_SKIP_COND_P(test_many2one_am, am_bcopy,
-                     !check_caps(UCT_IFACE_FLAG_AM_BCOPY |
-                                 UCT_IFACE_FLAG_CB_SYNC))
+void test_many2one_am::test_am_bcopy()
 {
     const unsigned num_sends = 1000 / ucs::test_time_multiplier();
     ucs_status_t status;
@@ -170,4 +170,22 @@ UCS_TEST_SKIP_COND_P(test_many2one_am, am_bcopy,
     buffers.clear();
 }
 
+UCS_TEST_SKIP_COND_P(test_many2one_am, am_bcopy,
+                     !check_caps(UCT_IFACE_FLAG_AM_BCOPY |
+                                 UCT_IFACE_FLAG_CB_SYNC))
+{
+    test_am_bcopy();
+}
+
+/* Some of the senders use dedicated lanes, and the rest use the shared FIFO */
+UCS_TEST_SKIP_COND_P(test_many2one_am, am_bcopy_fifo_lanes,
+                     !check_caps(UCT_IFACE_FLAG_AM_BCOPY |
+                                 UCT_IFACE_FLAG_CB_SYNC) ||
+                     !(has_transport("posix") || has_transport("sysv") ||
+                       has_transport("xpmem")),
+                     "FIFO_LANES?=4", "FIFO_LANES_POLL?=2")
+{
+    test_am_bcopy();
+}
+
 UCT_INSTANTIATE_NO_SELF_TEST_CASE(test_many2one_am)
@@ -7,8 +7,14 @@
 extern "C" {
 #include <uct/api/uct.h>
 #include <uct/sm/mm/base/mm_md.h>
+#include <uct/sm/mm/base/mm_iface.h>
+#include <uct/sm/mm/base/mm_ep.h>
+#include <ucs/memory/numa.h>
 #include <ucs/time/time.h>
 }
+#if HAVE_NUMA
+#include <numaif.h>
+#endif
 #include "uct_p2p_test.h"
 #include <common/test.h>
 #include "uct_test.h"
@@ -255,6 +261,93 @@ UCS_TEST_SKIP_COND_P(test_uct_mm, reg,
     ASSERT_UCS_OK(status);
 }
 
+UCS_TEST_P(test_uct_mm, no_zcopy)
+{
+    /* The peer can't access the user's memory directly, so a zcopy operation
+     * would copy the data like the bcopy one does */
+    EXPECT_FALSE(m_e1->iface_attr().cap.flags & (UCT_IFACE_FLAG_AM_ZCOPY  |
+                                                 UCT_IFACE_FLAG_PUT_ZCOPY |
+                                                 UCT_IFACE_FLAG_GET_ZCOPY));
+    EXPECT_EQ(0ul, m_e1->iface_attr().cap.am.max_zcopy);
+}
+
+UCS_TEST_P(test_uct_mm, pending_weight, "PENDING_WEIGHT=4k")
+{
+    uct_mm_iface_t *iface = ucs_derived_of(m_e1->iface(), uct_mm_iface_t);
+    uct_mm_ep_t *ep       = ucs_derived_of(m_e1->ep(0), uct_mm_ep_t);
+    uint64_t send_data    = 0xdeadbeef;
+    recv_desc_t *recv_buffer;
+    size_t tx_bytes;
+
+    EXPECT_EQ(4 * UCS_KBYTE, ep->arb_group.weight);
+
+    recv_buffer = (recv_desc_t*)malloc(sizeof(*recv_buffer) +
+                                       sizeof(send_data));
+    recv_buffer->length = 0;
+    uct_iface_set_am_handler(m_e2->iface(), 0, mm_am_handler, recv_buffer, 0);
+
+    /* the sent bytes are counted to charge the pending sends */
+    tx_bytes = iface->tx_bytes;
+    ASSERT_UCS_OK(uct_ep_am_short(m_e1->ep(0), 0, 0xbeef, &send_data,
+                                  sizeof(send_data)));
+    EXPECT_EQ(tx_bytes + sizeof(uint64_t) + sizeof(send_data),
+              iface->tx_bytes);
+
+    wait_for_flag(&recv_buffer->length);
+    EXPECT_EQ(sizeof(send_data), recv_buffer->length);
+
+    uct_iface_set_am_handler(m_e2->iface(), 0, NULL, NULL, 0);
+    free(recv_buffer);
+}
+
+UCS_TEST_P(test_uct_mm, numa_node, "NUMA_POLICY=preferred")
+{
+    int numa_node = m_e1->iface_attr().numa_node;
+
+#if HAVE_NUMA
+    if (numa_available() < 0) {
+        EXPECT_EQ(-1, numa_node);
+    } else {
+        EXPECT_GE(numa_node, -1);
+        EXPECT_LE(numa_node, numa_max_node());
+    }
+#else
+    EXPECT_EQ(-1, numa_node);
+#endif
+}
+
+UCS_TEST_P(test_uct_mm, numa_node_default_policy, "NUMA_POLICY=default")
+{
+    EXPECT_EQ(-1, m_e1->iface_attr().numa_node);
+}
+
+UCS_TEST_P(test_uct_mm, numa_placement, "NUMA_POLICY=bind")
+{
+#if HAVE_NUMA
+    uct_mm_iface_t *iface = ucs_derived_of(m_e1->iface(), uct_mm_iface_t);
+    int numa_node         = m_e1->iface_attr().numa_node;
+    void *address         = iface->recv_fifo_mem.address;
+    int mode, node;
+    long ret;
+
+    if ((numa_available() < 0) || (numa_node < 0)) {
+        UCS_TEST_SKIP_R("NUMA is not available");
+    }
+
+    /* the receive FIFO is bound to the local node */
+    ret = get_mempolicy(&mode, NULL, 0, address, MPOL_F_ADDR);
+    ASSERT_EQ(0, ret) << strerror(errno);
+    EXPECT_EQ(MPOL_BIND, mode);
+
+    /* and its pages, which were touched by the initialization, reside there */
+    ret = move_pages(0, 1, &address, NULL, &node, 0);
+    ASSERT_EQ(0, ret) << strerror(errno);
+    EXPECT_EQ(numa_node, node);
+#else
+    UCS_TEST_SKIP_R("NUMA support is not compiled");
+#endif
+}
+
 _UCT_INSTANTIATE_TEST_CASE(test_uct_mm, posix)
 _UCT_INSTANTIATE_TEST_CASE(test_uct_mm, sysv)
 _UCT_INSTANTIATE_TEST_CASE(test_uct_mm, xpmem)
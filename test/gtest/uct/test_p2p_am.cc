@@ -552,6 +552,16 @@ UCS_TEST_SKIP_COND_P(uct_p2p_am_test, am_zcopy,
                     TEST_UCT_FLAG_DIR_SEND_TO_RECV);
 }
 
+UCS_TEST_SKIP_COND_P(uct_p2p_am_test, am_zcopy_msg_zerocopy,
+                     !check_caps(UCT_IFACE_FLAG_AM_ZCOPY,
+                                 UCT_IFACE_FLAG_AM_DUP) ||
+                     !has_transport("tcp"), "MSG_ZEROCOPY_THRESH?=1") {
+    test_xfer_multi(static_cast<send_func_t>(&uct_p2p_am_test::am_zcopy),
+                    0ul,
+                    sender().iface_attr().cap.am.max_zcopy,
+                    TEST_UCT_FLAG_DIR_SEND_TO_RECV);
+}
+
 UCT_INSTANTIATE_TEST_CASE(uct_p2p_am_test)
 
 const unsigned uct_p2p_am_misc::RX_MAX_BUFS  = 1024; /* due to hard coded 'grow'
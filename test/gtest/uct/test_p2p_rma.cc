@@ -111,6 +111,23 @@ UCS_TEST_SKIP_COND_P(uct_p2p_rma_test, put_zcopy,
                     TEST_UCT_FLAG_SEND_ZCOPY);
 }
 
+UCS_TEST_SKIP_COND_P(uct_p2p_rma_test, put_zcopy_msg_zerocopy,
+                     !check_caps(UCT_IFACE_FLAG_PUT_ZCOPY) ||
+                     !has_transport("tcp"), "MSG_ZEROCOPY_THRESH?=1") {
+    test_xfer_multi(static_cast<send_func_t>(&uct_p2p_rma_test::put_zcopy),
+                    0ul, sender().iface_attr().cap.put.max_zcopy,
+                    TEST_UCT_FLAG_SEND_ZCOPY);
+}
+
+UCS_TEST_SKIP_COND_P(uct_p2p_rma_test, put_zcopy_stripe,
+                     !check_caps(UCT_IFACE_FLAG_PUT_ZCOPY) ||
+                     !has_transport("tcp"), "STRIPE_CONNS?=4",
+                     "STRIPE_THRESH?=1k") {
+    test_xfer_multi(static_cast<send_func_t>(&uct_p2p_rma_test::put_zcopy),
+                    0ul, sender().iface_attr().cap.put.max_zcopy,
+                    TEST_UCT_FLAG_SEND_ZCOPY);
+}
+
 UCS_TEST_SKIP_COND_P(uct_p2p_rma_test, get_short,
                      !check_caps(UCT_IFACE_FLAG_GET_SHORT)) {
     test_xfer_multi(static_cast<send_func_t>(&uct_p2p_rma_test::get_short),
@@ -133,4 +150,86 @@ UCS_TEST_SKIP_COND_P(uct_p2p_rma_test, get_zcopy,
                     TEST_UCT_FLAG_RECV_ZCOPY);
 }
 
+UCS_TEST_SKIP_COND_P(uct_p2p_rma_test, get_zcopy_large_unaligned,
+                     !check_caps(UCT_IFACE_FLAG_GET_ZCOPY) ||
+                     !has_transport("tcp")) {
+    /* The buffers are allocated with odd offsets by test_xfer() */
+    test_xfer(static_cast<send_func_t>(&uct_p2p_rma_test::get_zcopy),
+              ucs_min(sender().iface_attr().cap.get.max_zcopy,
+                      (8 * UCS_MBYTE) + 7),
+              TEST_UCT_FLAG_RECV_ZCOPY, UCS_MEMORY_TYPE_HOST);
+}
+
+class uct_p2p_rma_get_completion {
+public:
+    uct_p2p_rma_get_completion(int count) : m_status(UCS_OK) {
+        m_uct.func  = completion_cb;
+        m_uct.count = count;
+    }
+
+    uct_completion_t *uct() {
+        return &m_uct;
+    }
+
+    ucs_status_t status() const {
+        return m_status;
+    }
+
+private:
+    static void completion_cb(uct_completion_t *self, ucs_status_t status) {
+        uct_p2p_rma_get_completion *comp =
+                ucs_container_of(self, uct_p2p_rma_get_completion, m_uct);
+        comp->m_status = status;
+    }
+
+    uct_completion_t m_uct;
+    ucs_status_t     m_status;
+};
+
+UCS_TEST_SKIP_COND_P(uct_p2p_rma_test, get_zcopy_queued_resps,
+                     !check_caps(UCT_IFACE_FLAG_GET_ZCOPY) ||
+                     !has_transport("tcp")) {
+    /* Post many GET operations without waiting, so the target side has to
+     * queue the responses while the socket is busy sending a previous one */
+    const size_t num_gets = 16;
+    const size_t length   = ucs_min(sender().iface_attr().cap.get.max_zcopy,
+                                    (256 * UCS_KBYTE) + 3);
+    mapped_buffer sendbuf(length * num_gets, SEED1, sender(), 1);
+    mapped_buffer recvbuf(length * num_gets, SEED2, receiver(), 3);
+    uct_p2p_rma_get_completion comp(num_gets);
+    ucs_status_t status;
+    uct_iov_t iov;
+
+    for (size_t i = 0; i < num_gets; ++i) {
+        iov.buffer = UCS_PTR_BYTE_OFFSET(sendbuf.ptr(), i * length);
+        iov.length = length;
+        iov.memh   = sendbuf.memh();
+        iov.stride = 0;
+        iov.count  = 1;
+
+        do {
+            status = uct_ep_get_zcopy(sender_ep(), &iov, 1,
+                                      recvbuf.addr() + (i * length),
+                                      recvbuf.rkey(), comp.uct());
+            if (status == UCS_ERR_NO_RESOURCE) {
+                progress();
+            }
+        } while (status == UCS_ERR_NO_RESOURCE);
+
+        if (status == UCS_OK) {
+            --comp.uct()->count;
+        } else {
+            ASSERT_EQ(UCS_INPROGRESS, status);
+        }
+    }
+
+    while (comp.uct()->count > 0) {
+        progress();
+    }
+
+    EXPECT_EQ(UCS_OK, comp.status());
+
+    sendbuf.pattern_check(SEED2);
+}
+
 UCT_INSTANTIATE_TEST_CASE(uct_p2p_rma_test)
@@ -171,4 +171,18 @@ UCS_TEST_P(test_uct_perf, envelope) {
     }
 }
 
+UCS_TEST_SKIP_COND_P(test_uct_perf, tcp_lat, !has_transport("tcp"),
+                     "POLL_SPIN?=50us", "INCOMING_CPU?=0") {
+    /* Run the latency tests with the polling options of the transport */
+    for (const test_spec *test_iter = tests; test_iter->title != NULL; ++test_iter) {
+        if (test_iter->test_type != UCX_PERF_TEST_TYPE_PINGPONG) {
+            continue;
+        }
+
+        test_spec test = *test_iter;
+        test.iters     = ucs_min(test.iters, 1000lu);
+        run_test(test, 0, false, GetParam()->tl_name, GetParam()->dev_name);
+    }
+}
+
 UCT_INSTANTIATE_NO_SELF_TEST_CASE(test_uct_perf);